@@ -0,0 +1,349 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Comentários para desabilitar algumas funções de análise do CLion:
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ....................................................................................................................
+//      Bibliotecas:
+#include <math.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BATCH_X86 1
+#else
+#define BATCH_X86 0
+#endif
+
+#include "batch.h"
+#include "cadence.h"
+// ....................................................................................................................
+//      !! Este arquivo deve ser compilado com -ffp-contract=off (veja o CMakeLists.txt). Caso contrário o compilador
+//  pode fundir multiplicações e somas em FMA nas versões vetoriais, e o resultado deixa de ser idêntico ao do Euler
+//  escalar do simulate.
+// ....................................................................................................................
+int batch_parse(const char* name) {
+    if (strcmp(name, "off") == 0) return SIMD_DESLIGADO;
+    if (strcmp(name, "auto") == 0) return SIMD_AUTO;
+    if (strcmp(name, "scalar") == 0) return SIMD_ESCALAR;
+    if (strcmp(name, "avx2") == 0) return SIMD_AVX2;
+    if (strcmp(name, "avx512") == 0) return SIMD_AVX512;
+    return -2;
+}
+// ....................................................................................................................
+int batch_select(const int isa) {
+#if BATCH_X86
+    __builtin_cpu_init();
+    const int has_avx2 = __builtin_cpu_supports("avx2");
+    const int has_avx512 = __builtin_cpu_supports("avx512f");
+#else
+    const int has_avx2 = 0;
+    const int has_avx512 = 0;
+#endif
+
+    switch (isa) {
+        case SIMD_AUTO: return has_avx512 ? SIMD_AVX512 : has_avx2 ? SIMD_AVX2 : SIMD_ESCALAR;
+        case SIMD_ESCALAR: return SIMD_ESCALAR;
+        case SIMD_AVX2: return has_avx2 ? SIMD_AVX2 : -1;
+        case SIMD_AVX512: return has_avx512 ? SIMD_AVX512 : -1;
+        default: return -1;
+    }
+}
+// ....................................................................................................................
+int batch_width(const int isa) {
+    return isa == SIMD_AVX512 ? 8 : 4;
+}
+// ....................................................................................................................
+const char* batch_name(const int isa) {
+    switch (isa) {
+        case SIMD_DESLIGADO: return "desligado";
+        case SIMD_ESCALAR: return "escalar (4 trajetórias por lote)";
+        case SIMD_AVX2: return "AVX2 (4 trajetórias por instrução)";
+        case SIMD_AVX512: return "AVX-512 (8 trajetórias por instrução)";
+        default: return "desconhecido";
+    }
+}
+// ....................................................................................................................
+//      Versão escalar: as mesmas contas do simulate, lane por lane.
+static void euler_run_scalar(batch_lanes* lanes, const batch_params* params, double* time) {
+    const double mu = params->mu;
+    const double dt = params->dt;
+    const float f_mu = (float) params->mu;
+    double t = *time;
+    double div;
+    double root;
+    double k;
+    double v2;
+    double x;
+    double y;
+    float f_div;
+    float f_root;
+    int event;
+    int l;
+
+    while (t < params->max_time) {
+        //      Eventos das lanes ativas (critérios de parada e linhas de saída).
+        event = 0;
+        for (l = 0; l < 4; l++) {
+            if (!lanes->active[l]) continue;
+            if (lanes->distance[l] < params->r_collision || (lanes->distance[l] >= params->r_stop && t > params->stop_gate) ||
+                lanes->progress[l] >= lanes->limit[l]) event = 1;
+        }
+        if (event) break;
+
+        for (l = 0; l < 4; l++) {
+            if (!lanes->active[l]) continue;
+            div = lanes->x[l] * lanes->x[l] + lanes->y[l] * lanes->y[l];
+            root = sqrt(div);
+            x = lanes->x[l];
+            y = lanes->y[l];
+
+            //  Medida da cadência no começo do passo (cadence_measure).
+            if (params->cadence == CADENCIA_TEMPO) lanes->progress[l] += dt;
+            else {
+                v2 = lanes->vx[l] * lanes->vx[l] + lanes->vy[l] * lanes->vy[l];
+                if (params->cadence == CADENCIA_ARCO) {
+                    lanes->progress[l] += (mu * fabs(x * lanes->vy[l] - y * lanes->vx[l]) / (div * root * v2) + sqrt(v2) / params->r_stop) * dt;
+                } else {
+                    lanes->progress[l] += (sqrt(v2) / root) * dt;
+                }
+            }
+
+            lanes->x[l] = x + lanes->vx[l] * dt;
+            lanes->y[l] = y + lanes->vy[l] * dt;
+            if (params->precision == PRECISAO_MISTA) {
+                f_div = (float) div;
+                f_root = sqrtf(f_div);
+                k = (double) (f_mu / (f_div * f_root));
+                lanes->vx[l] = lanes->vx[l] - (k * x) * dt;
+                lanes->vy[l] = lanes->vy[l] - (k * y) * dt;
+                root = (double) f_root;
+            } else {
+                lanes->vx[l] = lanes->vx[l] - (mu * x / (div * sqrt(div))) * dt;
+                lanes->vy[l] = lanes->vy[l] - (mu * y / (div * sqrt(div))) * dt;
+            }
+            lanes->distance[l] = root;
+            if (lanes->distance[l] < lanes->d_min[l]) lanes->d_min[l] = lanes->distance[l];
+        }
+        t += dt;
+    }
+
+    *time = t;
+}
+// ....................................................................................................................
+#if BATCH_X86
+//      Versão AVX2: 4 lanes por registrador. As lanes inativas são preservadas por blend com a máscara.
+__attribute__((target("avx2")))
+static void euler_run_avx2(batch_lanes* lanes, const batch_params* params, double* time) {
+    const __m256d mask = _mm256_castsi256_pd(_mm256_set_epi64x(lanes->active[3] ? -1 : 0, lanes->active[2] ? -1 : 0,
+        lanes->active[1] ? -1 : 0, lanes->active[0] ? -1 : 0));
+    const __m256d v_mu = _mm256_set1_pd(params->mu);
+    const __m256d v_dt = _mm256_set1_pd(params->dt);
+    const __m256d v_collision = _mm256_set1_pd(params->r_collision);
+    const __m256d v_stop = _mm256_set1_pd(params->r_stop);
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d limit = _mm256_load_pd(lanes->limit);
+    const __m128 f_mu = _mm_set1_ps((float) params->mu);
+    const int mixed = params->precision == PRECISAO_MISTA;
+    __m256d x = _mm256_load_pd(lanes->x);
+    __m256d y = _mm256_load_pd(lanes->y);
+    __m256d vx = _mm256_load_pd(lanes->vx);
+    __m256d vy = _mm256_load_pd(lanes->vy);
+    __m256d distance = _mm256_load_pd(lanes->distance);
+    __m256d d_min = _mm256_load_pd(lanes->d_min);
+    __m256d progress = _mm256_load_pd(lanes->progress);
+    __m256d div;
+    __m256d root;
+    __m256d den;
+    __m256d v2;
+    __m256d ds;
+    __m256d event;
+    __m256d x_new;
+    __m256d y_new;
+    __m256d vx_new;
+    __m256d vy_new;
+    __m256d factor;
+    __m256d radius;
+    __m128 f_div;
+    __m128 f_root;
+    double t = *time;
+
+    while (t < params->max_time) {
+        //      Eventos das lanes ativas (critérios de parada e linhas de saída).
+        event = _mm256_or_pd(_mm256_cmp_pd(distance, v_collision, _CMP_LT_OQ), _mm256_cmp_pd(progress, limit, _CMP_GE_OQ));
+        if (t > params->stop_gate) event = _mm256_or_pd(event, _mm256_cmp_pd(distance, v_stop, _CMP_GE_OQ));
+        if (_mm256_movemask_pd(_mm256_and_pd(event, mask)) != 0) break;
+
+        div = _mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y));
+
+        //  Na precisão mista, k = μ / |r|^3 e |r| saem do float32; a raiz em double só é calculada para a cadência.
+        if (mixed) {
+            f_div = _mm256_cvtpd_ps(div);
+            f_root = _mm_sqrt_ps(f_div);
+            factor = _mm256_cvtps_pd(_mm_div_ps(f_mu, _mm_mul_ps(f_div, f_root)));
+            radius = _mm256_cvtps_pd(f_root);
+        }
+        if (!mixed || params->cadence != CADENCIA_TEMPO) {
+            root = _mm256_sqrt_pd(div);
+            den = _mm256_mul_pd(div, root);
+            if (!mixed) radius = root;
+        }
+
+        //  Medida da cadência no começo do passo (cadence_measure).
+        if (params->cadence == CADENCIA_TEMPO) ds = v_dt;
+        else {
+            v2 = _mm256_add_pd(_mm256_mul_pd(vx, vx), _mm256_mul_pd(vy, vy));
+            if (params->cadence == CADENCIA_ARCO) {
+                ds = _mm256_andnot_pd(sign, _mm256_sub_pd(_mm256_mul_pd(x, vy), _mm256_mul_pd(y, vx)));
+                ds = _mm256_add_pd(_mm256_div_pd(_mm256_mul_pd(v_mu, ds), _mm256_mul_pd(den, v2)), _mm256_div_pd(_mm256_sqrt_pd(v2), v_stop));
+            } else {
+                ds = _mm256_div_pd(_mm256_sqrt_pd(v2), root);
+            }
+            ds = _mm256_mul_pd(ds, v_dt);
+        }
+
+        x_new = _mm256_add_pd(x, _mm256_mul_pd(vx, v_dt));
+        y_new = _mm256_add_pd(y, _mm256_mul_pd(vy, v_dt));
+        if (mixed) {
+            vx_new = _mm256_sub_pd(vx, _mm256_mul_pd(_mm256_mul_pd(factor, x), v_dt));
+            vy_new = _mm256_sub_pd(vy, _mm256_mul_pd(_mm256_mul_pd(factor, y), v_dt));
+        } else {
+            vx_new = _mm256_sub_pd(vx, _mm256_mul_pd(_mm256_div_pd(_mm256_mul_pd(v_mu, x), den), v_dt));
+            vy_new = _mm256_sub_pd(vy, _mm256_mul_pd(_mm256_div_pd(_mm256_mul_pd(v_mu, y), den), v_dt));
+        }
+
+        x = _mm256_blendv_pd(x, x_new, mask);
+        y = _mm256_blendv_pd(y, y_new, mask);
+        vx = _mm256_blendv_pd(vx, vx_new, mask);
+        vy = _mm256_blendv_pd(vy, vy_new, mask);
+        progress = _mm256_blendv_pd(progress, _mm256_add_pd(progress, ds), mask);
+        distance = _mm256_blendv_pd(distance, radius, mask);
+        //  min(a, b) devolve 'a' apenas se a < b, igual ao "if (distance < d_min)" do simulate.
+        d_min = _mm256_blendv_pd(d_min, _mm256_min_pd(radius, d_min), mask);
+        t += params->dt;
+    }
+
+    _mm256_store_pd(lanes->x, x);
+    _mm256_store_pd(lanes->y, y);
+    _mm256_store_pd(lanes->vx, vx);
+    _mm256_store_pd(lanes->vy, vy);
+    _mm256_store_pd(lanes->distance, distance);
+    _mm256_store_pd(lanes->d_min, d_min);
+    _mm256_store_pd(lanes->progress, progress);
+    *time = t;
+}
+// ....................................................................................................................
+//      Versão AVX-512: 8 lanes por registrador, com as máscaras nativas do AVX-512.
+__attribute__((target("avx512f")))
+static void euler_run_avx512(batch_lanes* lanes, const batch_params* params, double* time) {
+    const __m512d v_mu = _mm512_set1_pd(params->mu);
+    const __m512d v_dt = _mm512_set1_pd(params->dt);
+    const __m512d v_collision = _mm512_set1_pd(params->r_collision);
+    const __m512d v_stop = _mm512_set1_pd(params->r_stop);
+    const __m512d limit = _mm512_load_pd(lanes->limit);
+    const __m256 f_mu = _mm256_set1_ps((float) params->mu);
+    const int mixed = params->precision == PRECISAO_MISTA;
+    __mmask8 mask = 0;
+    __mmask8 event;
+    __m512d x = _mm512_load_pd(lanes->x);
+    __m512d y = _mm512_load_pd(lanes->y);
+    __m512d vx = _mm512_load_pd(lanes->vx);
+    __m512d vy = _mm512_load_pd(lanes->vy);
+    __m512d distance = _mm512_load_pd(lanes->distance);
+    __m512d d_min = _mm512_load_pd(lanes->d_min);
+    __m512d progress = _mm512_load_pd(lanes->progress);
+    __m512d div;
+    __m512d root;
+    __m512d den;
+    __m512d v2;
+    __m512d ds;
+    __m512d ax;
+    __m512d ay;
+    __m512d factor;
+    __m512d radius;
+    __m256 f_div;
+    __m256 f_root;
+    double t = *time;
+    int k;
+
+    for (k = 0; k < 8; k++) if (lanes->active[k]) mask |= (__mmask8) (1 << k);
+
+    while (t < params->max_time) {
+        //      Eventos das lanes ativas (critérios de parada e linhas de saída).
+        event = _mm512_mask_cmp_pd_mask(mask, distance, v_collision, _CMP_LT_OQ) | _mm512_mask_cmp_pd_mask(mask, progress, limit, _CMP_GE_OQ);
+        if (t > params->stop_gate) event |= _mm512_mask_cmp_pd_mask(mask, distance, v_stop, _CMP_GE_OQ);
+        if (event != 0) break;
+
+        div = _mm512_add_pd(_mm512_mul_pd(x, x), _mm512_mul_pd(y, y));
+
+        //  Na precisão mista, μ / |r|^3 e |r| saem do float32 (8 valores num registrador de 256 bits).
+        if (mixed) {
+            f_div = _mm512_cvtpd_ps(div);
+            f_root = _mm256_sqrt_ps(f_div);
+            factor = _mm512_cvtps_pd(_mm256_div_ps(f_mu, _mm256_mul_ps(f_div, f_root)));
+            radius = _mm512_cvtps_pd(f_root);
+        }
+        if (!mixed || params->cadence != CADENCIA_TEMPO) {
+            root = _mm512_sqrt_pd(div);
+            den = _mm512_mul_pd(div, root);
+            if (!mixed) radius = root;
+        }
+
+        //  Medida da cadência no começo do passo (cadence_measure).
+        if (params->cadence == CADENCIA_TEMPO) ds = v_dt;
+        else {
+            v2 = _mm512_add_pd(_mm512_mul_pd(vx, vx), _mm512_mul_pd(vy, vy));
+            if (params->cadence == CADENCIA_ARCO) {
+                ds = _mm512_abs_pd(_mm512_sub_pd(_mm512_mul_pd(x, vy), _mm512_mul_pd(y, vx)));
+                ds = _mm512_add_pd(_mm512_div_pd(_mm512_mul_pd(v_mu, ds), _mm512_mul_pd(den, v2)), _mm512_div_pd(_mm512_sqrt_pd(v2), v_stop));
+            } else {
+                ds = _mm512_div_pd(_mm512_sqrt_pd(v2), root);
+            }
+            ds = _mm512_mul_pd(ds, v_dt);
+        }
+
+        if (mixed) {
+            ax = _mm512_mul_pd(_mm512_mul_pd(factor, x), v_dt);
+            ay = _mm512_mul_pd(_mm512_mul_pd(factor, y), v_dt);
+        } else {
+            ax = _mm512_mul_pd(_mm512_div_pd(_mm512_mul_pd(v_mu, x), den), v_dt);
+            ay = _mm512_mul_pd(_mm512_div_pd(_mm512_mul_pd(v_mu, y), den), v_dt);
+        }
+
+        x = _mm512_mask_add_pd(x, mask, x, _mm512_mul_pd(vx, v_dt));
+        y = _mm512_mask_add_pd(y, mask, y, _mm512_mul_pd(vy, v_dt));
+        vx = _mm512_mask_sub_pd(vx, mask, vx, ax);
+        vy = _mm512_mask_sub_pd(vy, mask, vy, ay);
+        progress = _mm512_mask_add_pd(progress, mask, progress, ds);
+        distance = _mm512_mask_mov_pd(distance, mask, radius);
+        d_min = _mm512_mask_min_pd(d_min, mask, radius, d_min);
+        t += params->dt;
+    }
+
+    _mm512_store_pd(lanes->x, x);
+    _mm512_store_pd(lanes->y, y);
+    _mm512_store_pd(lanes->vx, vx);
+    _mm512_store_pd(lanes->vy, vy);
+    _mm512_store_pd(lanes->distance, distance);
+    _mm512_store_pd(lanes->d_min, d_min);
+    _mm512_store_pd(lanes->progress, progress);
+    *time = t;
+}
+#endif
+// ....................................................................................................................
+void batch_euler_run(const int isa, batch_lanes* lanes, const batch_params* params, double* time) {
+#if BATCH_X86
+    if (isa == SIMD_AVX512) {
+        euler_run_avx512(lanes, params, time);
+        return;
+    }
+    if (isa == SIMD_AVX2) {
+        euler_run_avx2(lanes, params, time);
+        return;
+    }
+#endif
+    euler_run_scalar(lanes, params, time);
+}
+// ....................................................................................................................
@@ -0,0 +1,89 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Integração em lote (SIMD) das trajetórias do problema de 2 corpos.
+//
+//  No pr2c as trajetórias só diferem no parâmetro de impacto (r[2] = b), então o mesmo passo de Euler pode ser aplicado
+//  a várias delas de uma vez. O estado fica no formato "structure of arrays" (x[], y[], v_x[], v_y[] ao longo das
+//  trajetórias, ou "lanes") e cada instrução AVX2/AVX-512 avança 4 ou 8 trajetórias. Uma lane desativada (colisão ou
+//  critério de parada) é mascarada: o estado dela não muda mais.
+//
+//  Os critérios de parada e a cadência da saída (cadence.h) são verificados em todas as lanes antes de cada passo. O
+//  lote avança até que alguma lane ativa tenha um "evento" (colisão, parada ou linha de saída devida); o programa trata
+//  o evento (exporta a linha, desativa a lane) e chama batch_euler_run de novo.
+//
+//  As operações são as mesmas, e na mesma ordem, do Euler escalar do simulate (sem FMA), então o resultado de cada lane
+//  é idêntico ao da integração trajetória por trajetória. O conjunto de instruções é escolhido em tempo de execução, e
+//  a versão escalar funciona em qualquer processador.
+//
+//  Na precisão mista (--precision mixed) o fator μ / |r|^3 e a distância são calculados em float32 (raiz e divisão com
+//  metade da latência, e o dobro de valores por registrador), enquanto a posição, a velocidade e os incrementos de
+//  cada passo continuam em double. Também aqui as contas são as mesmas do simulate, então o lote e a integração
+//  trajetória por trajetória continuam idênticos entre si (mas não iguais aos da precisão dupla).
+// ....................................................................................................................
+#ifndef FLY_BY_BATCH_H
+#define FLY_BY_BATCH_H
+// ....................................................................................................................
+//      Conjuntos de instruções (opção --simd).
+#define SIMD_DESLIGADO (-1)                             //  Sem lote: cada trajetória é integrada separadamente (padrão).
+#define SIMD_AUTO 0                                     //  Escolhe o melhor conjunto disponível no processador.
+#define SIMD_ESCALAR 1                                  //  Lote em C puro (qualquer processador).
+#define SIMD_AVX2 2                                     //  4 trajetórias por instrução.
+#define SIMD_AVX512 3                                   //  8 trajetórias por instrução.
+
+#define BATCH_MAX_LANES 8                               //  Número máximo de trajetórias em um lote.
+
+//      Precisão das forças (opção --precision).
+#define PRECISAO_DUPLA 0                                //  Tudo em double (padrão).
+#define PRECISAO_MISTA 1                                //  μ / |r|^3 e |r| em float32; estado e incrementos em double.
+// ....................................................................................................................
+//  - Estado de um lote. Os vetores são alinhados para as cargas e escritas vetoriais.
+typedef struct {
+    _Alignas(64) double x[BATCH_MAX_LANES];             // [m]      - Posição x de cada trajetória.
+    _Alignas(64) double y[BATCH_MAX_LANES];             // [m]      - Posição y de cada trajetória.
+    _Alignas(64) double vx[BATCH_MAX_LANES];            // [m/s]    - Velocidade x de cada trajetória.
+    _Alignas(64) double vy[BATCH_MAX_LANES];            // [m/s]    - Velocidade y de cada trajetória.
+    _Alignas(64) double distance[BATCH_MAX_LANES];      // [m]      - Distância a Marte no começo do último passo.
+    _Alignas(64) double d_min[BATCH_MAX_LANES];         // [m]      - Menor distância encontrada.
+    _Alignas(64) double progress[BATCH_MAX_LANES];      //          - Medida da cadência acumulada (output_cadence).
+    _Alignas(64) double limit[BATCH_MAX_LANES];         //          - Medida em que a próxima linha é devida (cadence_limit).
+    int active[BATCH_MAX_LANES];                        //          - 1 se a trajetória ainda está sendo integrada.
+} batch_lanes;
+
+//  - Parâmetros comuns a todas as lanes.
+typedef struct {
+    double mu;                                          // [m³/s²]  - G M de Marte.
+    double dt;                                          // [s]      - Passo de integração.
+    double max_time;                                    // [s]      - Tempo máximo de integração.
+    double r_collision;                                 // [m]      - Raio de Marte (colisão).
+    double r_stop;                                      // [m]      - Distância do critério de parada.
+    double stop_gate;                                   // [s]      - O critério de parada só vale depois deste tempo.
+    int cadence;                                        //          - Política da cadência (CADENCIA_*, veja cadence.h).
+    int precision;                                      //          - Precisão das forças (PRECISAO_*).
+} batch_params;
+
+//  - Converte o nome passado em --simd para o identificador (off, auto, scalar, avx2, avx512). Retorna -2 caso o
+//  nome seja desconhecido.
+int batch_parse(const char* name);
+
+//  - Resolve SIMD_AUTO para o melhor conjunto disponível. Retorna -1 caso o conjunto pedido não seja suportado pelo
+//  processador.
+int batch_select(int isa);
+
+//  - Número de trajetórias por lote de cada conjunto de instruções.
+int batch_width(int isa);
+
+//  - Nome legível de um conjunto de instruções.
+const char* batch_name(int isa);
+
+//  - Avança passos de Euler do problema de 2 corpos (Marte na origem) em todas as lanes ativas:
+//      r(t + dt) = r + v dt,       v(t + dt) = v - μ r / |r|^3 dt,
+//  (na precisão mista, v(t + dt) = v - (k r) dt, com k = μ / |r|^3 calculado em float32),
+//  atualizando distance (= |r| do começo do passo), d_min e progress, exatamente como no laço do simulate. Antes de
+//  cada passo, retorna se *time >= max_time ou se alguma lane ativa tem distance < r_collision, distance >= r_stop
+//  (com *time > stop_gate) ou progress >= limit. *time é acumulado passo a passo, como no simulate.
+void batch_euler_run(int isa, batch_lanes* lanes, const batch_params* params, double* time);
+// ....................................................................................................................
+#endif
@@ -0,0 +1,122 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Comentários para desabilitar algumas funções de análise do CLion:
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ....................................................................................................................
+//      Bibliotecas:
+#include <math.h>
+#include <string.h>
+
+#include "cadence.h"
+// ....................................................................................................................
+#define CADENCIA_INTERVALOS 256                         //  Intervalos da regra de Simpson na estimativa da medida total.
+// ....................................................................................................................
+int cadence_parse(const char* name) {
+    if (strcmp(name, "time") == 0) return CADENCIA_TEMPO;
+    if (strcmp(name, "arc") == 0) return CADENCIA_ARCO;
+    if (strcmp(name, "distance") == 0) return CADENCIA_DISTANCIA;
+    return -1;
+}
+// ....................................................................................................................
+const char* cadence_name(const int policy) {
+    switch (policy) {
+        case CADENCIA_TEMPO: return "tempo";
+        case CADENCIA_ARCO: return "ângulo de arco (curvatura)";
+        case CADENCIA_DISTANCIA: return "distância a Marte";
+        default: return "desconhecida";
+    }
+}
+// ....................................................................................................................
+//      Taxa da medida a partir de |r|, |v| e do momento angular h = r × v.
+static double rate(const output_cadence* c, const double radius, const double r2, const double speed, const double v2, const double h) {
+    switch (c->policy) {
+        case CADENCIA_ARCO: return c->mu * fabs(h) / (r2 * radius * v2) + speed / c->r_stop;
+        case CADENCIA_DISTANCIA: return speed / radius;
+        default: return 1.0;
+    }
+}
+// ....................................................................................................................
+double cadence_rate(const output_cadence* c, const double* r, const double* v) {
+    const double r2 = r[0] * r[0] + r[1] * r[1];
+    const double v2 = v[0] * v[0] + v[1] * v[1];
+
+    return rate(c, sqrt(r2), r2, sqrt(v2), v2, r[0] * v[1] - r[1] * v[0]);
+}
+// ....................................................................................................................
+//      Medida total ao longo da hipérbole kepleriana definida pelo estado inicial, do ponto inicial até o ponto de
+//  parada (a distância r_stop depois do periapsis, ou a superfície de Marte se o periapsis estiver abaixo dela).
+//  Pela anomalia hiperbólica F: r = |a| (e cosh F - 1) e dt/dF = r / (|a| n), com n = sqrt(μ / |a|³). A integral é
+//  feita pela regra de Simpson. Retorna um valor negativo quando a órbita não é hiperbólica.
+static double conic_total(const output_cadence* c, const double r_collision, const double* r, const double* v) {
+    const double r0 = sqrt(r[0] * r[0] + r[1] * r[1]);
+    const double v2 = v[0] * v[0] + v[1] * v[1];
+    const double h = r[0] * v[1] - r[1] * v[0];
+    const double energy = 0.5 * v2 - c->mu / r0;
+    double a;                                           //  Semi-eixo (em módulo).
+    double e;                                           //  Excentricidade.
+    double n;                                           //  "Movimento médio" hiperbólico.
+    double f_begin;                                     //  Anomalia hiperbólica inicial.
+    double f_end;                                       //  Anomalia hiperbólica final.
+    double f;
+    double radius;
+    double speed2;
+    double weight;
+    double sum;
+    int k;
+
+    if (!(energy > 0)) return -1.0;
+
+    a = c->mu / (2 * energy);
+    e = sqrt(1 + 2 * energy * h * h / (c->mu * c->mu));
+    n = sqrt(c->mu / (a * a * a));
+
+    //  O argumento do acosh é >= 1 para qualquer distância acima do periapsis.
+    f_begin = acosh(fmax((r0 / a + 1) / e, 1.0));
+    if (r[0] * v[0] + r[1] * v[1] < 0) f_begin = - f_begin;
+    if (a * (e - 1) < r_collision) f_end = - acosh(fmax((r_collision / a + 1) / e, 1.0));
+    else f_end = acosh(fmax((c->r_stop / a + 1) / e, 1.0));
+    if (f_end <= f_begin) return 0.0;
+
+    sum = 0.0;
+    for (k = 0; k <= CADENCIA_INTERVALOS; k++) {
+        f = f_begin + (f_end - f_begin) * k / CADENCIA_INTERVALOS;
+        radius = a * (e * cosh(f) - 1);
+        speed2 = c->mu * (2 / radius + 1 / a);
+        weight = (k == 0 || k == CADENCIA_INTERVALOS) ? 1.0 : (k % 2 == 1 ? 4.0 : 2.0);
+
+        sum += weight * rate(c, radius, radius * radius, sqrt(speed2), speed2, h) * radius / (a * n);
+    }
+
+    return sum * (f_end - f_begin) / (3.0 * CADENCIA_INTERVALOS);
+}
+// ....................................................................................................................
+void cadence_init(output_cadence* c, const int policy, const long budget, const double interval, const double slack, const double mu,
+    const double r_stop, const double r_collision, const double* r, const double* v) {
+    double total;                                       //  Medida total estimada da trajetória.
+
+    c->policy = policy;
+    c->mu = mu;
+    c->r_stop = r_stop;
+    c->slack = slack;
+    c->progress = 0.0;
+    c->next = 0.0;
+    c->rows = 0;
+    c->budget = budget > 0 || policy == CADENCIA_TEMPO ? budget : CADENCIA_LINHAS_PADRAO;
+
+    //      Política time sem orçamento: o intervalo fixo original.
+    if (c->budget <= 0) {
+        c->threshold = interval;
+        return;
+    }
+
+    //      Com orçamento, as budget - 1 primeiras linhas dividem a medida total (a última é o estado final). Fora de
+    //  uma hipérbole, a estimativa é a de uma linha reta de comprimento 2 r_stop.
+    total = conic_total(c, r_collision, r, v);
+    if (!(total > 0) || !isfinite(total)) total = cadence_rate(c, r, v) * 2 * r_stop / sqrt(v[0] * v[0] + v[1] * v[1]);
+    c->threshold = total / (double) (c->budget > 1 ? c->budget - 1 : 1);
+    if (!(c->threshold > 0) || !isfinite(c->threshold)) c->threshold = interval;
+}
+// ....................................................................................................................
@@ -0,0 +1,103 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Cadência da saída das trajetórias (opções --cadence e --rows), compartilhada pelos dois programas.
+//
+//  Cada trajetória acumula uma "medida" ao longo do caminho, e uma linha é exportada sempre que a medida avança um
+//  limiar desde a linha anterior. A medida depende da política escolhida:
+//  - time: o tempo (dt por passo). É o comportamento original: uma linha a cada STEPS_PARA_OUTPUT segundos.
+//  - arc: o ângulo que a velocidade relativa a Marte gira (curvatura da trajetória), μ |r × v| / (|r|³ |v|²) por
+//  segundo, mais o comprimento percorrido em unidades de stop_value, para que os trechos quase retos não fiquem vazios.
+//  - distance: |v| / |r| por segundo, ou seja, o comprimento percorrido relativo à distância a Marte. As linhas ficam
+//  uniformes em log(r), e o trecho do periapsis é o mais amostrado.
+//
+//  Com um orçamento de linhas (--rows), o limiar é a medida total da trajetória dividida pelo orçamento. A medida total
+//  é estimada pela hipérbole kepleriana do estado inicial (em torno de Marte), e o orçamento é também um limite rígido:
+//  a última linha fica reservada para o estado final. Os vetores aqui começam no índice 0 (recebem &r[1], &v[1]).
+// ....................................................................................................................
+#ifndef FLY_BY_CADENCE_H
+#define FLY_BY_CADENCE_H
+
+#include <math.h>
+// ....................................................................................................................
+//      Políticas disponíveis (opção --cadence).
+#define CADENCIA_TEMPO 0                                //  Linhas igualmente espaçadas no tempo (padrão).
+#define CADENCIA_ARCO 1                                 //  Linhas pelo ângulo de arco (curvatura).
+#define CADENCIA_DISTANCIA 2                            //  Linhas pela distância a Marte (uniformes em log r).
+
+#define CADENCIA_LINHAS_PADRAO 500                      //  Orçamento de linhas de arc e distance sem --rows.
+// ....................................................................................................................
+//  - Estado da cadência de uma trajetória.
+typedef struct {
+    int policy;                                         //  CADENCIA_*.
+    double mu;                                          //  G M de Marte.
+    double r_stop;                                      //  Escala do termo de comprimento da política arc.
+    double threshold;                                   //  Medida entre duas linhas.
+    double slack;                                       //  Tolerância na comparação (meio passo, no passo fixo).
+    double progress;                                    //  Medida acumulada desde o começo da trajetória.
+    double next;                                        //  Medida da próxima linha.
+    long rows;                                          //  Linhas já exportadas.
+    long budget;                                        //  Máximo de linhas (0 para sem limite).
+} output_cadence;
+// ....................................................................................................................
+//  - Converte o nome passado em --cadence para o identificador. Retorna -1 caso o nome seja desconhecido.
+int cadence_parse(const char* name);
+
+//  - Nome legível de uma política.
+const char* cadence_name(int policy);
+
+//  - Prepara a cadência de uma trajetória.
+//  int policy                              → CADENCIA_*.
+//  long budget                             → Orçamento de linhas (0: sem limite na política time, ou o padrão).
+//  double interval                         → Medida entre linhas da política time sem orçamento.
+//  double slack                            → Tolerância das comparações (meio passo no passo fixo, 0 no adaptativo).
+//  double mu                               → G M de Marte.
+//  double r_stop                           → Distância do critério de parada.
+//  double r_collision                      → Raio de Marte (a trajetória termina nele quando há colisão).
+//  const double* r, const double* v        → Posição e velocidade iniciais relativas a Marte.
+void cadence_init(output_cadence* c, int policy, long budget, double interval, double slack, double mu, double r_stop,
+    double r_collision, const double* r, const double* v);
+
+//  - Taxa da medida (por segundo) no estado (r, v) relativo a Marte.
+double cadence_rate(const output_cadence* c, const double* r, const double* v);
+
+//  - Medida acumulada em um passo de tamanho h a partir do estado (r, v). Na política time é o próprio h.
+static inline double cadence_measure(const output_cadence* c, const double* r, const double* v, const double h) {
+    return c->policy == CADENCIA_TEMPO ? h : cadence_rate(c, r, v) * h;
+}
+
+//  - Acumula a medida de um passo.
+static inline void cadence_advance(output_cadence* c, const double ds) {
+    c->progress += ds;
+}
+
+//  - Medida a partir da qual a próxima linha é devida (infinita quando o orçamento acabou).
+static inline double cadence_limit(const output_cadence* c) {
+    if (c->budget > 0 && c->rows >= c->budget - 1) return INFINITY;
+    return c->next - c->slack;
+}
+
+//  - Passo fixo: retorna 1 se o estado atual deve ser exportado (e conta a linha).
+static inline int cadence_due(output_cadence* c) {
+    if (c->progress < cadence_limit(c)) return 0;
+    c->rows++;
+    do c->next += c->threshold; while (c->next - c->slack <= c->progress);
+    return 1;
+}
+
+//  - Passo adaptativo: retorna 1 se a próxima linha cai dentro de um passo que acumula a medida ds, e devolve em
+//  'fraction' a posição dela no passo (em [0, 1], para a saída densa). Deve ser chamada até retornar 0, e só então
+//  o passo é acumulado com cadence_advance.
+static inline int cadence_next(output_cadence* c, const double ds, double* fraction) {
+    if (c->progress + ds < cadence_limit(c)) return 0;
+    *fraction = ds > 0 ? (c->next - c->progress) / ds : 0.0;
+    if (*fraction < 0.0) *fraction = 0.0;
+    if (*fraction > 1.0) *fraction = 1.0;
+    c->rows++;
+    c->next += c->threshold;
+    return 1;
+}
+// ....................................................................................................................
+#endif
@@ -7,12 +7,28 @@
 // ReSharper disable CppJoinDeclarationAndAssignment
 // ....................................................................................................................
 //      Bibliotecas:
+#include <errno.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <time.h>
+
+#include "batch.h"
+#include "cadence.h"
+#include "flyby.h"
+#include "grid.h"
+#include "integrators.h"
+#include "journal.h"
+#include "output.h"
+#include "profile.h"
+#include "progress.h"
+#include "reducers.h"
+#include "refine.h"
+#include "shard.h"
+#include "sweep.h"
 // ....................................................................................................................
 //      Constantes da simulação:
 //  → Definições gerais.
@@ -22,11 +38,15 @@
                                                         //  em nada, além de alocação extra de memória. Porém, diminuir pode
                                                         //  resultar em erros de acesso de memória.
 
-#define NUMERO_DE_TESTES 240                            //  Número de testes balísticos que serão realizados na simulação
+#define NUMERO_DE_TESTES 240                            //  Número padrão de testes balísticos da simulação (opção --tests)
 
 #define STEPS_PARA_OUTPUT 180                           //  Valor base para definir a cada quantos steps de integração
-                                                        //  ocorrerá a exportação de dados e checagem dos critérios de parada.
+                                                        //  ocorrerá a exportação de dados (na cadência por tempo, o padrão).
                                                         //  Pense que para dt = 1 segundo isso é feito a cada STEPS_PARA_OUTPUT segundos.
+                                                        //  Os critérios de parada são verificados a cada passo.
+
+#define INTERVALO_CONVERGENCIA 60.0                     //  Intervalo (em segundos) entre as verificações dos elementos
+                                                        //  osculadores na saída antecipada (opção --early-exit).
 
 //  → Constantes e massas.
 #define CONSTANTE_GRAVITACIONAL 6.6743e-11              //  Constante gravitacional de Newton no sistema internacional.
@@ -35,47 +55,560 @@
 //  → Condições iniciais fixas
 #define RAIO_MARTE 3.3895E6                             //  Raio do planeta Marte. (Em metros)
 
+//  → Validação do dopri5 contra a solução analítica (--analytic --validate N --integrator dopri5). Valem para as
+//  tolerâncias padrão do passo adaptativo (rtol = 1e-10, atol = 1e-6), com as quais os desvios medidos ficam cerca de
+//  cem vezes abaixo delas (pr2c padrão, dt = 10 s: d_min 1.5e-4 m, delta_v 6.6e-7 m/s, deflexão 7.1e-9 graus, t 6.5e-6 s).
+#define VALIDACAO_D_MIN 1e-2                            //  Desvio máximo do d_min. (Em metros)
+#define VALIDACAO_DELTA_V 1e-4                          //  Desvio máximo do delta_v. (Em metros por segundo)
+#define VALIDACAO_DEFLEXAO 1e-6                         //  Desvio máximo do ângulo de deflexão. (Em graus)
+#define VALIDACAO_TEMPO 1e-3                            //  Desvio máximo do tempo final. (Em segundos)
+
 //  → Matemática
 #define RAD_TO_DEG 57.2957795                           //  Converte radianos para graus.
 // ....................................................................................................................
+//      Resultados de um teste. É preenchida pela função simulate.
+typedef struct {
+    double b;                                       // [m]      - Parâmetro de impacto usado no teste.
+    double d_min;                                   // [m]      - Distância mínima encontrada entre a sonda e Marte.
+    double delta_v;                                 // [m/s]    - Variação de velocidade entre a sonda e Marte na entrada e saída.
+    double deflection_angle;                        // [rad]    - Ângulo de deflexão encontrado.
+    int collision;                                  //          - Indicador de colisão. É 0 caso não tenha ocorrido colisão; e 1 caso contrário.
+    double time_end;                                // [s]      - Tempo que levou para finalizar a simulação.
+    long steps_accepted;                            //          - Passos aceitos pelo integrador adaptativo (dopri5).
+    long steps_rejected;                            //          - Passos rejeitados pelo integrador adaptativo (dopri5).
+    double drift_energy;                            //          - Maior desvio relativo da energia específica (--drift).
+    double drift_momentum;                          //          - Maior desvio relativo do momento angular (--drift).
+    long long steps;                                //          - Passos de integração (no dopri5, aceitos e rejeitados).
+    double wall_time;                               // [s]      - Tempo de parede da trajetória (num lote, a parte dela).
+    int stop;                                       //          - Motivo do fim da trajetória (PARADA_*, veja profile.h).
+} simulation_result;
+
+//      Fatia do grid (--grid, veja grid.h): os parâmetros que não são o b, e as quantidades que dependem apenas deles.
+//  É calculada uma única vez por fatia no main, e lida (sem alterações) por todos os testes da fatia.
+typedef struct {
+    double x_init;                                  // [m]      - Valor inicial no eixo x.
+    double stop_value;                              // [m]      - Distância do critério de parada (|x_init|).
+    double v_infinite_in;                           // [m/s]    - Velocidade da sonda no infinito.
+    double v_x_init;                                // [m/s]    - Velocidade inicial da sonda (apenas no eixo x).
+    double parameters[2];                           //          - x_init_factor e velocity_infinity como foram fornecidos
+                                                    //            (colunas do arquivo global com --grid).
+} grid_slice;
+
+//      Saída antecipada (--early-exit): elementos osculadores medidos na última verificação depois do periapsis.
+typedef struct {
+    double next_check;                              // [s]      - Tempo da próxima verificação.
+    double energy;                                  // [J/kg]   - Energia específica.
+    double e[N_DIMS + 1];                           //          - Vetor excentricidade.
+    int valid;                                      //          - 1 se 'energy' e 'e' já foram medidos depois do periapsis.
+} exit_monitor;
+
+//      Quantidades conservadas no início do teste (--drift). No problema de 2 corpos a energia específica e o momento
+//  angular relativos a Marte são constantes; o quanto eles mudam ao longo da trajetória é o erro do integrador.
+typedef struct {
+    double energy;                                  // [J/kg]   - Energia específica inicial.
+    double momentum;                                // [m²/s]   - Momento angular específico inicial (x v_y - y v_x).
+    double scale;                                   // [m²/s]   - Escala do desvio do momento angular: |h(0)|, ou
+                                                    //            |r(0)| |v(0)| num teste frontal (b = 0, h(0) = 0).
+} drift_reference;
+
+//      Configuração da execução. É preenchida pelo main a partir da linha de comando e lida (sem alterações) por todas
+//  as threads; a trajetória em si é a 'config' da libflyby, completada pelo simulate com os parâmetros da fatia.
+typedef struct {
+    char test_name[100];                            //          - Nome da pasta onde os dados temporais serão salvos.
+    grid_spec grid;                                 //          - Parâmetros variados com --grid (veja grid.h).
+    grid_slice* slices;                             //          - Fatias do grid (uma só sem --grid).
+    long n_slices;                                  //          - Número de fatias.
+    int n_impacts;                                  //          - Valores do parâmetro de impacto por fatia (--tests).
+    int total_tests;                                //          - Número de testes do sweep (fatias × valores de b).
+    int n_threads;                                  //          - Número de threads usadas no sweep.
+    flyby_config config;                            //          - Tempo máximo, passo, integrador, tolerâncias do dopri5,
+                                                    //            precisão (--precision) e cadência (--cadence, --rows).
+    int analytic;                                   //          - 1 se os testes forem calculados pela solução analítica (--analytic).
+    int n_validate;                                 //          - Testes integrados numericamente para validar a solução analítica.
+    int simd;                                       //          - Conjunto de instruções da integração em lote (SIMD_*, veja batch.h).
+    int output_format;                              //          - Formato dos arquivos de trajetória (SAIDA_*, veja output.h).
+    trajectory_store* store;                        //          - Arquivo binário das trajetórias (apenas com --output binary).
+    int n_writers;                                  //          - Threads de escrita assíncrona (--writers; 0 escreve na própria thread).
+    double early_exit;                              //          - Tolerância da saída antecipada (--early-exit; 0 desliga).
+    int drift;                                      //          - 1 para medir a deriva da energia e do momento angular (--drift).
+    int resume;                                     //          - 1 para retomar uma execução interrompida (--resume, veja journal.h).
+    int refine_budget;                              //          - Orçamento de trajetórias do refinamento (--refine; 0 desliga).
+    double refine_tol;                              //          - Limiar do refinamento (--refine-tol, veja refine.h).
+    int profiling;                                  //          - 1 para medir o tempo de cada fase da execução (--profile).
+    int progress_format;                            //          - Formato do progresso (--progress, PROGRESSO_*).
+    double progress_interval;                       //          - Intervalo entre dois desenhos do progresso (0 usa o padrão).
+    int reducing;                                   //          - 1 para resumir os resultados com os redutores (--reduce).
+    shard_spec shard;                               //          - Parte da execução integrada por este processo (--shard).
+} run_settings;
+
+//      Estado compartilhado da execução, que muda durante o sweep: a escrita assíncrona (de cada sweep), o perfil (que
+//  tem a sua trava), os redutores e os níveis do refinamento (escritos apenas pelo write_result e pelo main).
+typedef struct {
+    output_pipeline* pipeline;                      //          - Escrita assíncrona das trajetórias (NULL com --writers 0).
+    int* levels;                                    //          - Nível de refinamento de cada teste (apenas com --refine).
+    profile_counters profile;                       //          - Tempo de cada fase (veja profile.h).
+    reducer_set reducers;                           //          - Redutores de streaming dos resultados (veja reducers.h).
+} run_state;
+
+//      Dados do laço da libflyby (flyby_integrate e flyby_batch) sobre uma trajetória do programa (veja sink_row).
+typedef struct {
+    const run_settings* settings;                   //          - Configuração da execução.
+    trajectory_output* out;                         //          - Saída da trajetória.
+    exit_monitor* monitor;                          //          - Elementos osculadores (--early-exit).
+    const drift_reference* reference;               //          - Quantidades conservadas iniciais (--drift).
+    const grid_slice* slice;                        //          - Fatia do grid do teste.
+    simulation_result* result;                      //          - Resultados do teste (recebe a deriva).
+} simulation_sink;
+// ....................................................................................................................
 //      Funções auxiliares (aqui temos um "mini-header" dentro do arquivo *.c)
 //  - Faz a simulação física do problema para as condições passadas nos argumentos.
+//  const run_settings* settings            → Configuração da execução.
+//  run_state* state                        → Estado da execução (escrita assíncrona e perfil).
 //  const int test                          → Número de identificação do teste.
 //  const double b                          → Parâmetro de impacto.
-//  double* d_min_value                     → Referência: altera a distância mínima encontrada entre a sonda e Marte.
-//  double* delta_v_value                   → Referência: altera a variação de velocidade entre a sonda e Marte na entrada e saída.
-//  double* deflection_angle_value          → Referência: altera o ângulo de deflexão encontrado.
-//  int* collision                          → Referência: altera o indicador de colisão. É 0 caso não tenha ocorrido colisão; e 1 caso contrário.
-//  double* time_end                        → Referência: altera o tempo em segundo que levou para finalizar a simulação.
+//  const grid_slice* slice                 → Fatia do grid do teste (posição inicial e velocidade no infinito).
+//  simulation_result* result               → Referência: recebe os resultados do teste (veja a estrutura acima).
+void simulate(const run_settings* settings, run_state* state, int test, double b, const grid_slice* slice, simulation_result* result);
+
+//  - Integra um lote de até BATCH_MAX_LANES testes em paralelo com SIMD (opção --simd, apenas com o Euler; o laço é o
+//  flyby_batch). Os arquivos e os resultados são idênticos aos do simulate para cada um dos testes. Todos os testes
+//  de um lote são da mesma fatia do grid.
+//  const run_settings* settings            → Configuração da execução.
+//  run_state* state                        → Estado da execução (escrita assíncrona e perfil).
+//  int count                               → Número de testes no lote.
+//  const int* tests                        → Índice de cada teste.
+//  const double* b_values                  → Parâmetro de impacto de cada teste.
+//  simulation_result* results              → Referência: recebe os resultados dos 'count' testes.
+void simulate_batch(const run_settings* settings, run_state* state, int count, const int* tests, const double* b_values, simulation_result* results);
+
+//  - Destino das linhas e acompanhamento dos passos da libflyby (flyby_sink, veja flyby.h; context é um
+//  simulation_sink). O sink_row escreve a linha na saída da trajetória; o sink_step mede a deriva (--drift) e verifica
+//  a saída antecipada (--early-exit) depois de cada passo.
+void sink_row(const double* values, void* context);
+int sink_step(double* time, double* r, double* v, int event, void* context);
+
+//  - Saída antecipada (--early-exit). Depois do periapsis, a cada INTERVALO_CONVERGENCIA segundos, compara a energia e o
+//  vetor excentricidade osculadores com os da verificação anterior. Quando os dois estão estáveis dentro da tolerância,
+//  o resto da trajetória é a hipérbole kepleriana: r e v são levados analiticamente até a distância stop_value.
+//  const run_settings* settings            → Configuração da execução (tolerância e tempo máximo).
+//  exit_monitor* monitor                   → Elementos da última verificação (zerado com next_check = 0 no início).
+//  double r[], double v[]                  → Estado da sonda; recebem o estado no ponto de parada.
+//  double* time                            → Tempo do estado; recebe o tempo no ponto de parada.
+//  const grid_slice* slice                 → Fatia do grid do teste (distância de parada).
 //
-//  * Os valores passados como "referência" são saídas da função simulate alterados em espaços de memória pré-alocados.
-void simulate(int test, double b, double* d_min_value, double* delta_v_value, double* deflection_angle_value, int* collision, double* time_end);
+//  * Retorna 1 se a integração pode parar (r, v e time já estão no ponto de parada).
+int check_early_exit(const run_settings* settings, exit_monitor* monitor, double r[], double v[], double* time, const grid_slice* slice);
 
-//  - Isso aqui é só uma função extra para converter o tempo de ETA de segundos para um formato "melhor"
-//  Pode ignorar =D
-void format_time(double seconds, char *buffer);
-// ....................................................................................................................
-//      Alocação global de memória:
-char test_name[100];                                //  Nome da pasta onde os dados temporais serão salvos.
+//  - Leva r e v pela hipérbole osculadora, no sentido do movimento, até a distância 'radius'. Retorna o tempo gasto, ou
+//  -1 caso a órbita não seja hiperbólica ou a sonda já esteja fora de 'radius'.
+double kepler_exit(double r[], double v[], double radius);
+
+//  - Deriva das quantidades conservadas (--drift). O drift_start guarda a energia e o momento angular do estado inicial;
+//  o drift_measure, chamado depois de cada passo, atualiza os maiores desvios relativos em result.
+void drift_start(drift_reference* reference, const double r[], const double v[]);
+void drift_measure(const drift_reference* reference, const double r[], const double v[], simulation_result* result);
+
+//  - Solução analítica do problema de 2 corpos (opção --analytic). A trajetória é a hipérbole kepleriana definida
+//  pelo estado inicial do teste, e os resultados são os mesmos que o simulate mede: d_min, variação de velocidade e
+//  ângulo de deflexão no ponto de parada, indicador de colisão e tempo final.
+//  const run_settings* settings            → Configuração da execução (tempo máximo).
+//  const double b                          → Parâmetro de impacto.
+//  const grid_slice* slice                 → Fatia do grid do teste.
+//  simulation_result* result               → Referência: recebe os resultados do teste.
+void analytic_solution(const run_settings* settings, double b, const grid_slice* slice, simulation_result* result);
+
+//  - Integra numericamente os testes listados em 'tests' (ou os testes desta parte da execução) usando o sweep com
+//  várias threads (sweep.h) e mostra a barra de progresso. Os resultados ficam num anel de sweep_slots(n_threads)
+//  jobs, então a memória não depende do número de testes. Retorna 0 em caso de sucesso, 2 se a execução foi
+//  interrompida (SIGINT/SIGTERM) antes de todos os testes e 1 em caso de erro.
+//  const run_settings* settings            → Configuração da execução.
+//  run_state* state                        → Estado da execução.
+//  int n_tests                             → Número de testes (de posições em 'tests', ou da parte, com 'tests' NULL).
+//  const int* tests                        → Índice de cada teste (NULL para shard.index + k × shard.count).
+//  const double* b_values                  → Parâmetro de impacto de todos os testes (NULL para calculá-lo pelo índice,
+//                                            com b_min e b_step; veja test_b).
+//  double b_min, double b_step             → Grade de b, usada quando b_values é NULL.
+//  const unsigned char* done               → Testes já concluídos, que são pulados (--resume, veja journal_done; pode
+//                                            ser NULL).
+//  simulation_result* results              → Recebe o resultado de cada um dos n_tests testes, na sua posição (pode ser
+//                                            NULL; apenas o refinamento e a validação precisam deles).
+//  FILE* global                            → Arquivo de dados globais, que recebe os testes na ordem dos índices, assim
+//                                            que todos os anteriores terminam (pode ser NULL, como na validação).
+int run_simulations(const run_settings* settings, run_state* state, int n_tests, const int* tests, const double* b_values, double b_min, double b_step, const unsigned char* done,
+    simulation_result* results, FILE* global);
+
+//  - Refinamento adaptativo (--refine, veja refine.h): integra a grade inicial e, em rodadas, os pontos médios dos
+//  intervalos marcados pelo refine_select, até o orçamento acabar ou nada mais precisar ser refinado. Os testes novos
+//  ocupam as posições n_coarse, n_coarse + 1, ... dos vetores. Retorna o mesmo que o run_simulations.
+//  const run_settings* settings            → Configuração da execução.
+//  run_state* state                        → Estado da execução (recebe os níveis do refinamento).
+//  int n_coarse                            → Testes da grade inicial (--tests).
+//  double* b_values                        → Parâmetro de impacto de cada teste (recebe os valores das rodadas).
+//  simulation_result* results              → Recebe o resultado de cada teste.
+//  FILE* global                            → Arquivo de dados globais.
+int run_refinement(const run_settings* settings, run_state* state, int n_coarse, double* b_values, simulation_result* results, FILE* global);
 
-double x_init;                                      //  Valor inicial no eixo x.
-double v_infinite_in;                               //  Velocidade da sonda no infinito.
-double v_x_init;                                    //  Velocidade da sonda inicial (apenas no eixo x)
-double max_int_time;                                //  Tempo total de simulação (critério de parada de emergência)
-double dt;                                          //  Timestep de integração.
-double stop_value;                                  //  Fator de parada da simulação. (em relação a órbitas de Marte)
+//  - Escreve uma linha do arquivo de dados globais.
+//  const run_settings* settings            → Configuração da execução (colunas do arquivo).
+//  const int* levels                       → Nível de refinamento de cada teste (apenas com --refine).
+//  int test                                → Índice do teste (começa em 0).
+//  const simulation_result* result         → Resultados do teste.
+//
+//  * Com --profile, a linha ganha os passos, o tempo de parede, os passos por segundo e o motivo do fim do teste; com
+//  --grid, ela termina com a fatia e os valores dos parâmetros dela; com --refine, com o nível de refinamento.
+void write_global(const run_settings* settings, const int* levels, FILE* fo, int test, const simulation_result* result);
+
+//  - Verificação do --resume (veja journal.h; context é o run_settings): retorna 1 se o arquivo de trajetória do teste
+//  está completo.
+int trajectory_complete(int test, double time_end, void* context);
+
+//  - Acrescenta um teste aos redutores (--reduce, veja reducers.h): d_min, Δv e deflexão (as duas últimas apenas sem
+//  colisão).
+void reduce_result(reducer_set* reducers, const simulation_result* result);
+
+//  - Na retomada, passa pelos redutores os testes que já estão no arquivo global. Retorna 0 em caso de sucesso.
+int reduce_global(reducer_set* reducers, const char* path);
+
+//  - Estima, de forma barata, o número de passos de integração de um teste. É usada apenas para ordenar os testes
+//  no sweep com várias threads (os mais caros começam primeiro).
+//  const run_settings* settings            → Configuração da execução (passo e integrador).
+//  const double b                          → Parâmetro de impacto.
+//  const grid_slice* slice                 → Fatia do grid do teste.
+double estimate_cost(const run_settings* settings, double b, const grid_slice* slice);
+
+//  - Funções chamadas pelo sweep (sweep.h): estima o custo de um job, executa o job, atualiza a barra de progresso
+//  (na ordem em que os jobs terminam) e escreve os testes do job no arquivo global (na ordem dos índices).
+double job_cost(int test, void* context);
+void run_test(int test, void* context);
+void report_progress(int test, int done, void* context);
+void write_result(int test, void* context);
+
+//  - Índice do teste de uma posição do sweep, o parâmetro de impacto de um teste (de b_values ou da grade b_min +
+//  b_step × (test % n_impacts)) e as posições de um job que ainda precisam ser feitas (um teste, ou os testes de um
+//  lote com --simd; retorna quantas são).
+int sweep_test(const void* context, int position);
+double test_b(const void* context, int test);
+int job_positions(const void* context, int job, int* positions);
 
-int steps_to_output;                                //  Passos de integração para a exportação.
+//  - Imprime as estatísticas da escrita assíncrona (--writers): profundidade da fila, espera por buffers e vazão.
+void report_writers(const pipeline_stats* stats);
+
+//  - Imprime a maior deriva da energia e do momento angular entre os testes do sweep sem colisão (--drift), acumulada
+//  pelo write_result.
+void report_drift(double energy, double momentum);
+// ....................................................................................................................
+//      Dados do sweep. Cada job escreve apenas nas suas posições do anel de resultados ((job % n_slots) × width, que o
+//  sweep.c só reaproveita depois do write_result), então não é preciso nenhuma trava. O arquivo global, o vetor
+//  'results' e a deriva só são escritos pelo write_result, que o sweep.c nunca roda em paralelo.
+typedef struct {
+    const run_settings* settings;                   //  Configuração da execução.
+    run_state* state;                               //  Estado compartilhado da execução.
+    int n_tests;                                    //  Número de posições do sweep.
+    const int* tests;                               //  Índice de cada teste (NULL para os testes da parte).
+    const double* b_values;                         //  Parâmetro de impacto de todos os testes (NULL: calculado pelo índice).
+    double b_min;                                   //  Grade de b, usada quando b_values é NULL.
+    double b_step;
+    const unsigned char* done;                      //  Testes já concluídos (--resume; NULL sem retomada).
+    simulation_result* slots;                       //  Anel com os resultados dos jobs em aberto ('width' por job).
+    int n_slots;                                    //  Jobs no anel (sweep_slots).
+    simulation_result* results;                     //  Resultado de cada posição do sweep (ou NULL).
+    int width;                                      //  Testes por job: 1, ou o tamanho do lote SIMD (--simd).
+    int n_jobs;                                     //  Número de jobs do sweep (testes ou lotes).
+    const int* starts;                              //  Primeira posição de cada job, mais o fim (lotes de uma lista).
+    int batches;                                    //  Lotes por fatia do grid (lotes dos testes da parte).
+    double drift_energy;                            //  Maiores derivas entre os testes sem colisão (--drift).
+    double drift_momentum;
+    FILE* global;                                   //  Arquivo de dados globais (NULL para não escrever).
+    time_t flushed;                                 //  Última vez em que o arquivo global foi descarregado no disco.
+    progress_state progress;                        //  Progresso do sweep (barra de progresso, veja progress.h).
+} sweep_context;
 // ....................................................................................................................
 //      Função de entrada do programa:
-//  Compilação: gcc fly_by.c -lm -o fly_by
+//  Compilação: gcc fly_by_pr2c.c sweep.c integrators.c -lm -lpthread -o fly_by_pr2c
 //  Permissão: chmod +x fly_by
-//  Execução: ./fly_by [test_name] [x_init_factor] [velocity_infinity] [b_min_factor] [b_max_factor] [max_time] [dt]
+//  Execução: ./fly_by [test_name] [x_init_factor] [velocity_infinity] [b_min_factor] [b_max_factor] [max_time] [dt] [opções]
 int main(const int argc, const char *argv[]) {
+    // ................................................................................................................
+    //      Declara as variáveis locais.
+    run_settings settings;                              //              - Configuração da execução (linha de comando).
+    run_state state;                                    //              - Estado compartilhado da execução.
+    double* b_values;                                   // [m]          - Parâmetro de impacto de cada teste (apenas com
+                                                        //              --refine; no sweep ele vem do índice).
+    simulation_result* results;                         //              - Resultados de cada teste (distância mínima,
+                                                        //              variação de velocidade, deflexão, colisão, tempo).
+    simulation_result exact;                            //              - Solução analítica de um teste (--analytic).
+    simulation_result* numeric;                         //              - Resultados numéricos dos testes validados (--validate).
+    simulation_result* mixed;                           //              - Resultados na precisão mista dos testes validados.
+    const simulation_result* reference;                 //              - Resultado de referência de um teste validado.
+    const simulation_result* compared;                  //              - Resultado comparado com a referência.
+    int* validated;                                     //              - Índices dos testes validados.
+    clock_t begin;                                      //              - Início do cálculo analítico.
+    double deviation[4];                                //              - Maiores desvios da validação (d_min, delta_v, deflexão, tempo).
+    int mismatches;                                     //              - Testes em que a colisão não coincide na validação.
+    int rejected;                                       //              - 1 se o dopri5 ficou fora das tolerâncias VALIDACAO_*.
+
+    double min_b_factor;                                // [m]          - Fator mínimo para o parâmetro b
+    double max_b_factor;                                // [m]          - Fator máximo para o parâmetro b
+    double b_step;                                      // [m]          - "Passo" entre os valores max e min de b.
+    int n_coarse;                                       //              - Valores de b da grade uniforme (--tests).
+
+    double x_init_factor;                               //              - Fator de x(0) (argumento posicional).
+    double v_infinity;                                  // [m/s]        - Velocidade no infinito (argumento posicional).
+    grid_slice* slice;                                  //              - Fatia do grid sendo preparada.
+    flyby_conditions conditions;                        //              - Condições iniciais da fatia (veja flyby.h).
+    const char* grid_names[2];                          //              - Parâmetros que podem ser variados com --grid.
+    const char* invalid;                                //              - Parâmetro do --grid desconhecido.
+    const char* reducer_names[3];                       //              - Quantidades dos redutores (--reduce).
+    int status;
+
+    unsigned char* done;                                //              - Um bit por teste já concluído (apenas com --resume).
+    long n_done;                                        //              - Testes recuperados do arquivo global.
+    const char* neutral[5];                             //              - Opções que podem mudar na retomada.
+    int interrupted;                                    //              - 1 se a execução foi interrompida por um sinal.
+
+    const char* args[8];                                //              - Argumentos posicionais (args[0] é o programa).
+    int n_args;                                         //              - Número de argumentos posicionais encontrados.
+
+    int i;                                              //              - Variável para iterações em primeiro nível.
+    int j;                                              //              - Variável para iterações em segundo nível.
+
+    char filename[200];                                 //              - Nome do arquivo onde os dados globais serão salvos.
+    FILE *fo;                                           //              - Ponteiro para o arquivo onde os dados serão salvos.
+    // ................................................................................................................
+    //      Separa os argumentos posicionais das opções (que começam com "--"). As opções podem aparecer em qualquer
+    //  posição da linha de comando.
+    args[0] = argv[0];
+    n_args = 0;
+    settings.n_impacts = NUMERO_DE_TESTES;
+    settings.grid.n_axes = 0;
+    settings.n_threads = 1;
+    //  A trajetória começa com os padrões da libflyby (Euler, precisão dupla, cadência por tempo e as tolerâncias do
+    //  dopri5); o tempo máximo e o passo vêm dos argumentos posicionais, e os parâmetros físicos, de cada fatia.
+    settings.config = flyby_default_config(0.0, 0.0, 0.0, 0.0);
+    settings.analytic = 0;
+    settings.n_validate = 0;
+    rejected = 0;
+    settings.simd = SIMD_DESLIGADO;
+    settings.output_format = SAIDA_CSV;
+    settings.store = NULL;
+    settings.n_writers = 1;
+    state.pipeline = NULL;
+    settings.early_exit = 0.0;
+    settings.drift = 0;
+    settings.profiling = 0;
+    settings.progress_format = PROGRESSO_AUTO;
+    settings.progress_interval = 0.0;
+    settings.resume = 0;
+    settings.refine_budget = 0;
+    settings.refine_tol = REFINAMENTO_LIMIAR;
+    state.levels = NULL;
+    settings.reducing = 0;
+    settings.shard.index = 0;
+    settings.shard.count = 1;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--tests") == 0 && i + 1 < argc) {
+            settings.n_impacts = (int) strtol(argv[++i], NULL, 10);
+            if (settings.n_impacts < 2) {
+                printf("O número de testes (--tests) precisa ser maior ou igual a 2.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--grid") == 0 && i + 1 < argc) {
+            status = grid_add(&settings.grid, argv[++i]);
+            if (status != 0) {
+                if (status == -1) printf("Intervalo inválido (--grid): %s. Use nome=min:max:n, por exemplo velocity_infinity=2000:3000:11.\n", argv[i]);
+                else printf("Parâmetro repetido ou grid com mais de %d parâmetros (--grid): %s.\n", GRID_MAX_EIXOS, argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            settings.n_threads = (int) strtol(argv[++i], NULL, 10);
+            if (settings.n_threads < 1) {
+                printf("O número de threads (--threads) precisa ser maior ou igual a 1.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--integrator") == 0 && i + 1 < argc) {
+            settings.config.integrator = integrator_parse(argv[++i]);
+            if (settings.config.integrator < 0) {
+                printf("Integrador desconhecido (--integrator): %s. Use euler, leapfrog, rk4, yoshida ou dopri5.\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--rtol") == 0 && i + 1 < argc) {
+            settings.config.tol_rel = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--atol") == 0 && i + 1 < argc) {
+            settings.config.tol_abs = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--simd") == 0 && i + 1 < argc) {
+            settings.simd = batch_parse(argv[++i]);
+            if (settings.simd == -2) {
+                printf("Opção desconhecida para --simd: %s. Use off, auto, scalar, avx2 ou avx512.\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--precision") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "double") == 0) settings.config.precision = PRECISAO_DUPLA;
+            else if (strcmp(argv[i], "mixed") == 0) settings.config.precision = PRECISAO_MISTA;
+            else {
+                printf("Precisão desconhecida (--precision): %s. Use double ou mixed.\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            settings.output_format = output_parse(argv[++i]);
+            if (settings.output_format < 0) {
+                printf("Formato desconhecido (--output): %s. Use csv, binary ou none.\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--writers") == 0 && i + 1 < argc) {
+            settings.n_writers = (int) strtol(argv[++i], NULL, 10);
+            if (settings.n_writers < 0) {
+                printf("O número de threads de escrita (--writers) não pode ser negativo.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--cadence") == 0 && i + 1 < argc) {
+            settings.config.cadence = cadence_parse(argv[++i]);
+            if (settings.config.cadence < 0) {
+                printf("Cadência desconhecida (--cadence): %s. Use time, arc ou distance.\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--rows") == 0 && i + 1 < argc) {
+            settings.config.rows = strtol(argv[++i], NULL, 10);
+            if (settings.config.rows < 2) {
+                printf("O orçamento de linhas (--rows) precisa ser maior ou igual a 2.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--early-exit") == 0 && i + 1 < argc) {
+            settings.early_exit = strtod(argv[++i], NULL);
+            if (!(settings.early_exit > 0)) {
+                printf("A tolerância da saída antecipada (--early-exit) precisa ser positiva.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--refine") == 0 && i + 1 < argc) {
+            settings.refine_budget = (int) strtol(argv[++i], NULL, 10);
+            if (settings.refine_budget < 2) {
+                printf("O orçamento de trajetórias (--refine) precisa ser maior ou igual a 2.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--refine-tol") == 0 && i + 1 < argc) {
+            settings.refine_tol = strtod(argv[++i], NULL);
+            if (!(settings.refine_tol > 0)) {
+                printf("O limiar do refinamento (--refine-tol) precisa ser positivo.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--drift") == 0) {
+            settings.drift = 1;
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            settings.profiling = 1;
+        } else if (strcmp(argv[i], "--reduce") == 0) {
+            settings.reducing = 1;
+        } else if (strcmp(argv[i], "--shard") == 0 && i + 1 < argc) {
+            if (shard_parse(argv[++i], &settings.shard) != 0) {
+                printf("Parte inválida (--shard): %s. Use k/N, com 0 <= k < N (por exemplo 0/4, 1/4, 2/4 e 3/4).\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--progress") == 0 && i + 1 < argc) {
+            settings.progress_format = progress_mode(argv[++i]);
+            if (settings.progress_format < 0) {
+                printf("Formato de progresso desconhecido (--progress): %s. Use auto, bar, json ou none.\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--progress-interval") == 0 && i + 1 < argc) {
+            settings.progress_interval = strtod(argv[++i], NULL);
+            if (!(settings.progress_interval > 0)) {
+                printf("O intervalo do progresso (--progress-interval) precisa ser positivo.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--resume") == 0) {
+            settings.resume = 1;
+        } else if (strcmp(argv[i], "--analytic") == 0) {
+            settings.analytic = 1;
+        } else if (strcmp(argv[i], "--validate") == 0 && i + 1 < argc) {
+            settings.n_validate = (int) strtol(argv[++i], NULL, 10);
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            printf("Opção desconhecida (ou sem valor): %s\n", argv[i]);
+            return 1;
+        } else {
+            if (n_args < 7) args[n_args + 1] = argv[i];
+            n_args++;
+        }
+    }
+    grid_names[0] = "x_init_factor";
+    grid_names[1] = "velocity_infinity";
+    invalid = grid_check(&settings.grid, grid_names, 2);
+    if (invalid != NULL) {
+        printf("O parâmetro %s não pode ser variado com --grid. Use x_init_factor ou velocity_infinity.\n", invalid);
+        return 1;
+    }
+    settings.n_slices = grid_slices(&settings.grid);
+
+    //      No refinamento, a grade uniforme de --tests valores é só a primeira rodada; os vetores dos testes têm uma
+    //  posição por trajetória do orçamento.
+    n_coarse = settings.n_impacts;
+    if (settings.refine_budget > 0) {
+        if (settings.grid.n_axes > 0 || settings.resume || settings.analytic) {
+            printf("O refinamento adaptativo (--refine) não pode ser usado junto com --grid, --resume ou --analytic.\n");
+            return 1;
+        }
+        if (settings.refine_budget < n_coarse) {
+            printf("O orçamento de trajetórias (--refine) precisa ser maior ou igual ao número de testes (--tests: %d).\n", n_coarse);
+            return 1;
+        }
+        settings.n_impacts = settings.refine_budget;
+    }
+    if ((double) settings.n_slices * settings.n_impacts > 2147483647.0) {
+        printf("O grid tem testes demais (%ld fatias × %d valores de b).\n", settings.n_slices, settings.n_impacts);
+        return 1;
+    }
+    settings.total_tests = (int) settings.n_slices * settings.n_impacts;
+
+    if (settings.config.tol_rel < 0 || settings.config.tol_abs < 0 || settings.config.tol_rel + settings.config.tol_abs <= 0) {
+        printf("As tolerâncias --rtol e --atol não podem ser negativas, e pelo menos uma delas precisa ser positiva.\n");
+        return 1;
+    }
+    if (settings.simd != SIMD_DESLIGADO) {
+        if (settings.config.integrator != INTEGRADOR_EULER) {
+            printf("A integração em lote (--simd) está disponível apenas para o método de Euler.\n");
+            return 1;
+        }
+        if (settings.early_exit > 0) {
+            printf("A saída antecipada (--early-exit) não está disponível na integração em lote (--simd).\n");
+            return 1;
+        }
+        if (settings.drift) {
+            printf("A medida da deriva (--drift) não está disponível na integração em lote (--simd).\n");
+            return 1;
+        }
+        settings.simd = batch_select(settings.simd);
+        if (settings.simd < 0) {
+            printf("O processador não suporta o conjunto de instruções pedido em --simd.\n");
+            return 1;
+        }
+    }
+    if (settings.n_validate < 0 || settings.n_validate > settings.total_tests) {
+        printf("O número de testes validados (--validate) precisa estar entre 0 e %d.\n", settings.total_tests);
+        return 1;
+    }
+    if (settings.drift && settings.analytic) {
+        printf("A medida da deriva (--drift) avalia o integrador, então não pode ser usada junto com --analytic.\n");
+        return 1;
+    }
+    if (settings.profiling && settings.analytic) {
+        printf("O perfil (--profile) mede a integração numérica, então não pode ser usado junto com --analytic.\n");
+        return 1;
+    }
+    if (settings.config.precision == PRECISAO_MISTA && (settings.config.integrator != INTEGRADOR_EULER || settings.analytic)) {
+        printf("A precisão mista (--precision mixed) está disponível apenas para o método de Euler.\n");
+        return 1;
+    }
+    if (settings.n_validate > 0 && !settings.analytic && settings.config.precision != PRECISAO_MISTA) {
+        printf("A opção --validate compara a solução analítica com a numérica (ou a precisão mista com a dupla), então precisa ser usada junto com --analytic ou --precision mixed.\n");
+        return 1;
+    }
+    if (settings.shard.count > 1 && (settings.refine_budget > 0 || settings.n_validate > 0)) {
+        printf("A execução em partes (--shard) não pode ser usada junto com --refine (os testes de uma rodada dependem dos anteriores) ou --validate.\n");
+        return 1;
+    }
     // ................................................................................................................
     //      Verifica o número de argumentos do input.
-    if (argc != 8) {
-        printf("Use: %s <test_name> <x_init_factor> <velocity_infinity> <b_min_factor> <b_max_factor> <max_time> <dt>\n",
+    if (n_args != 7) {
+        printf("Use: %s <test_name> <x_init_factor> <velocity_infinity> <b_min_factor> <b_max_factor> <max_time> <dt> [opções]\n",
             argv[0]);
         printf("- <test_name>: Nome do teste, e da pasta onde a saída será salva.\n");
         printf("- <x_init_factor>: Fator multiplicando R_Marte na definição de x(0). No trabalho usamos um valor igual a 50. Também é usado no critério de parada.\n");
@@ -83,160 +616,358 @@ int main(const int argc, const char *argv[]) {
         printf("- <b_min_factor>: Fator mínimo usado na definição do intervalo de valores para o parâmetro de impacto. No trabalho usamos um valor igual a -10\n");
         printf("- <b_max_factor>: Fator máximo usado na definição do intervalo de valores para o parâmetro de impacto. No trabalho usamos um valor igual a 10.\n");
         printf("- <max_time>: Critério de parada de emergência. É o tempo máximo que pode ser gasto com a integração antes dela ser abortada, sem segundos. No trabalho foi utilizado 10e10 segundos.\n");
-        printf("- <dt>: Passo temporal utilizado na integração, em segundos. Não deve ser muito grande já que é usado o método de Euler. No trabalho foi utilizado 0,001 s.\n");
+        printf("- <dt>: Passo temporal utilizado na integração, em segundos. Com o método de Euler (padrão) não deve ser muito grande. No trabalho foi utilizado 0,001 s.\n");
+        printf("Opções:\n");
+        printf("- --tests <N>: Número de valores do parâmetro de impacto, igualmente espaçados entre os dois fatores (padrão: %d).\n", NUMERO_DE_TESTES);
+        printf("- --grid <nome>=<min>:<max>:<n>: Troca o argumento posicional <nome> (x_init_factor ou velocity_infinity) por n valores igualmente espaçados. Pode ser repetida; o sweep cobre o produto cartesiano de todos os intervalos e de b.\n");
+        printf("- --threads <N>: Número de threads usadas para simular as trajetórias em paralelo (padrão: 1). O resultado é idêntico ao da execução serial.\n");
+        printf("- --integrator <método>: Método de integração: euler (padrão, 1ª ordem), leapfrog (velocity-Verlet, 2ª ordem), rk4 (Runge-Kutta clássico) ou yoshida (Forest-Ruth, 4ª ordem) ou dopri5 (Dormand-Prince 5(4) com passo adaptativo; nesse caso <dt> é só o passo inicial). Os métodos de ordem alta permitem um dt muito maior.\n");
+        printf("- --rtol <valor>, --atol <valor>: Tolerâncias relativa e absoluta (em metros e metros por segundo) do dopri5 (padrão: 1e-10 e 1e-6).\n");
+        printf("- --simd <modo>: Integra as trajetórias do Euler em lotes, várias por instrução: off (padrão), auto (o melhor conjunto do processador), avx512 (8 por instrução), avx2 (4) ou scalar (lote sem SIMD). O resultado é idêntico ao do modo off.\n");
+        printf("- --precision <modo>: Precisão das forças do Euler: double (padrão) ou mixed (μ / |r|^3 e a distância em float32; posição, velocidade e incrementos em double). Serve para sweeps de triagem (d_min e colisão); com --validate N, compara N testes com a precisão dupla no fim.\n");
+        printf("- --output <formato>: Formato dos arquivos de trajetória: csv (padrão, um arquivo data_NNN.csv por teste), binary (um único arquivo pr2c/trajectories.bin, com colunas float64 que podem ser lidas por mmap; veja output.h) ou none (nenhum arquivo de trajetória, apenas o arquivo global).\n");
+        printf("- --writers <N>: Threads que formatam e gravam os arquivos de trajetória enquanto a integração continua (padrão: 1). Com 0 as linhas são escritas pela própria thread que integra, como antes.\n");
+        printf("- --cadence <política>: Quando as linhas dos arquivos de trajetória são exportadas: time (padrão, a cada %d segundos), arc (pelo ângulo que a trajetória faz, concentrando as linhas no periapsis) ou distance (uniformes no logaritmo da distância a Marte). Os critérios de parada são verificados a cada passo em todos os casos.\n", STEPS_PARA_OUTPUT);
+        printf("- --rows <N>: Orçamento de linhas por trajetória (padrão: %d com arc e distance; sem limite com time). O estado final é sempre a última linha.\n", CADENCIA_LINHAS_PADRAO);
+        printf("- --early-exit <tol>: Depois do periapsis, para a integração quando a energia e o vetor excentricidade osculadores ficam estáveis (variação relativa menor que tol entre verificações a cada %.0f s) e leva a sonda até o ponto de parada pela hipérbole kepleriana. Corta cerca de metade dos passos das trajetórias sem colisão.\n", INTERVALO_CONVERGENCIA);
+        printf("- --refine <N>: Refinamento adaptativo de b: começa com a grade de --tests valores e, em rodadas, divide ao meio os intervalos em que a colisão muda ou a deflexão/Δv variam mais que o limiar, até N trajetórias no total. O arquivo global ganha a coluna 'level' (0 na grade inicial).\n");
+        printf("- --refine-tol <fração>: Limiar do --refine, em fração da variação total da deflexão e do Δv, aplicado à diferença e à curvatura entre amostras vizinhas (padrão: %.2f).\n", REFINAMENTO_LIMIAR);
+        printf("- --drift: Mede, a cada passo, o desvio relativo da energia específica e do momento angular relativos a Marte em relação aos valores iniciais, e escreve o maior de cada um nas colunas drift_energy e drift_momentum do arquivo global. Serve para escolher o maior dt com erro aceitável.\n");
+        printf("- --profile: Mede o tempo de parede de cada fase (integração, linhas e arquivos de trajetória, arquivo global, barra de progresso) e imprime uma tabela no fim. O arquivo global ganha as colunas steps, wall_time, steps_per_s e stop (collision, soi, max_time ou early_exit).\n");
+        printf("- --reduce: Resume os resultados com redutores de streaming, de memória fixa: média, desvio padrão e quantis aproximados (erro relativo de %.0f%%) de d_min, Δv e deflexão, probabilidade de colisão, histograma 2-D de b × deflexão e os intervalos de b em que a colisão muda. Grava reduce_pr2c.csv, histogram_pr2c.csv, boundary_pr2c.csv e o estado reducers_pr2c.txt, que pode ser combinado com o de outras execuções. Junto com --output none, serve para ensembles grandes sem nenhum arquivo por trajetória.\n", 100 * REDUTOR_ERRO_RELATIVO);
+        printf("- --shard <k>/<N>: Integra apenas a parte k (de 0 a N-1) dos testes, os de índice i com i %% N = k (intercalados por todo o intervalo de b e pelo grid), na pasta <test_name>/shard_<k>_of_<N>. Cada parte pode rodar num processo ou numa máquina diferente, com os mesmos argumentos; o flyby_merge junta as partes em <test_name>, como uma execução num único processo. Não pode ser usada com --refine ou --validate.\n");
+        printf("- --progress <formato>: Como o progresso do sweep é mostrado: auto (padrão; a barra num terminal e registros JSON, um por linha, quando a saída vai para um arquivo ou um pipe), bar, json ou none. O ETA é ponderado pelo custo estimado das trajetórias.\n");
+        printf("- --progress-interval <s>: Intervalo mínimo entre dois desenhos do progresso, em segundos (padrão: %.2f para a barra e %.0f para o JSON).\n", PROGRESSO_INTERVALO_BARRA, PROGRESSO_INTERVALO_JSON);
+        printf("- --resume: Continua uma execução interrompida (Ctrl-C, SIGTERM ou queda) na mesma pasta, com os mesmos argumentos (apenas --threads, --writers, --simd e as opções do progresso podem mudar). Os testes já salvos são mantidos, e os que ficaram pela metade são refeitos.\n");
+        printf("- --analytic: Calcula todos os testes pela hipérbole kepleriana, sem integração numérica (os arquivos de trajetória não são gerados).\n");
+        printf("- --validate <N>: Junto com --analytic, integra numericamente N testes espalhados pelo intervalo de b (com o integrador escolhido) e mostra o desvio em relação à solução analítica (com o dopri5, termina com erro se os desvios passarem das tolerâncias da validação). Junto com --precision mixed, integra os N testes nas duas precisões (sem arquivos de trajetória) e mostra o desvio da mista em relação à dupla.\n");
         return 1;
     }
     // ................................................................................................................
-    //      Declara as variáveis locais.
-    double d_values[NUMERO_DE_TESTES];                  // [m]          - Distância relativa mínima entre a sonda e
-                                                        //              Marte registrada para um teste.
-    double b_values[NUMERO_DE_TESTES];                  // [m]          - Parâmetro de impacto usado no teste.
-    double var_velocidade[NUMERO_DE_TESTES];            // [m/s]        - Módulo da variação da velocidade relativa de
-                                                        //              entrada e de saída da sonda no processo.
-    double deflection_angle[NUMERO_DE_TESTES];          // [º]          - Ângulo de deflexão entre a sonda e Marte.
-    double times[NUMERO_DE_TESTES];                     // [s]          - Tempo total que cada simulação utilizou, em segundos.
-    int collision[NUMERO_DE_TESTES];                    //              - Indicador de colisão. É 1 caso tenha ocorrido
-                                                        //              - uma colisão da sonda com Marte, e 0 caso contrário.
-
-    int i;                                              //              - Variável para iterações em primeiro nível.
-    int j;                                              //              - Variável para iterações em segundo nível.
-
-    double min_b_factor;                                // [m]          - Fator mínimo para o parâmetro b
-    double max_b_factor;                                // [m]          - Fator máximo para o parâmetro b
-    double b_step;                                      // [m]          - "Passo" entre os valores max e min de b.
-    double progress;                                    //              - Contador de progresso.
-    double elapsed;                                     //              - Tempo decorrido da simulação.
-    double total_time;                                  //              - Tempo estimado total de simulação.
-    double remaining;                                   //              - Tempo restante de simulação.
-    clock_t begin;                                      //              - Momento em que o processo começou.
-    char elapsed_str[50];                               //              - “String” com o tempo atual de processamento.
-    char remaining_str[50];                             //              - "String" com o tempo restante de processamento.
-
-    char filename[200];                                 //              - Nome do arquivo onde os dados globais serão salvos.
-    FILE *fo;                                           //              - Ponteiro para o arquivo onde os dados serão salvos.
-    // ................................................................................................................
-    //      Salva o nome do teste numa variável global. Isso vai ser usado para o nome da pasta dos dados temporais,
+    //      Salva o nome do teste na configuração da execução. Isso vai ser usado para o nome da pasta dos dados temporais,
     //  e também para o nome do arquivo de dados globais =D
-    sprintf(test_name, "%s", argv[1]);
-
-    //      Cálcula o valor de x(0) a partir do fator passado na chamada do código.
-    x_init = strtod(argv[2], NULL);
-    x_init *= -RAIO_MARTE;
-    stop_value = (-1) * x_init;        //  É a mesma coisa que o x_init, mas positivo (e não necessariamente sobre x)
+    //  Com --shard, a pasta é a da parte, dentro da pasta do teste.
+    sprintf(settings.test_name, "%s", args[1]);
+    if (settings.shard.count > 1 && shard_directory(&settings.shard, args[1], settings.test_name, sizeof(settings.test_name)) != 0) {
+        printf("O nome do teste é longo demais: %s\n", args[1]);
+        return 1;
+    }
 
-    //      Pega a velocidade da sonda no infinito, e calcula a velocidade inicial da sonda.
-    v_infinite_in = strtod(argv[3], NULL);
-    v_x_init = sqrt(v_infinite_in * v_infinite_in + 2 * CONSTANTE_GRAVITACIONAL * MASSA_MARTE / fabs(x_init));
+    //      Fator de x(0) e velocidade da sonda no infinito. Com --grid, esses são apenas os valores dos parâmetros que
+    //  não estão no grid.
+    x_init_factor = strtod(args[2], NULL);
+    v_infinity = strtod(args[3], NULL);
 
     //      Calcula o intervalo de valores de parâmetro de impacto que serão utilizados.
-    min_b_factor = strtod(argv[4], NULL);
-    max_b_factor = strtod(argv[5], NULL);
+    min_b_factor = strtod(args[4], NULL);
+    max_b_factor = strtod(args[5], NULL);
 
     if (min_b_factor > max_b_factor) {
-        printf("O fator mínimo (argv[4]: %d) precisa ser menor do que o fator máximo (argv[5]: %d).\n", (int) min_b_factor, (int) max_b_factor);
+        printf("O fator mínimo (<b_min_factor>: %d) precisa ser menor do que o fator máximo (<b_max_factor>: %d).\n", (int) min_b_factor, (int) max_b_factor);
         return 1;
     }
 
     min_b_factor *= RAIO_MARTE;
     max_b_factor *= RAIO_MARTE;
 
-    if (fabs(x_init) < max_b_factor) {
-        printf("A posição inicial não pode ser menor do que o fator de impacto máximo.\n");
+    b_step = (max_b_factor - min_b_factor) / (n_coarse - 1);
+
+    //      Prepara as fatias do grid. Tudo o que depende só delas (x(0), critério de parada, velocidade inicial) é
+    //  calculado aqui uma única vez, em vez de uma vez por teste.
+    settings.slices = malloc(sizeof(grid_slice) * settings.n_slices);
+    if (settings.slices == NULL) {
+        printf("Falha ao alocar memória para %ld fatias do grid.\n", settings.n_slices);
         return 1;
     }
+    for (i = 0; i < settings.n_slices; i++) {
+        slice = &settings.slices[i];
+        slice->parameters[0] = grid_value(&settings.grid, "x_init_factor", i, x_init_factor);
+        slice->parameters[1] = grid_value(&settings.grid, "velocity_infinity", i, v_infinity);
+        flyby_conditions_init(&conditions, slice->parameters[0], slice->parameters[1]);
+        slice->x_init = conditions.x_init;
+        slice->stop_value = conditions.stop_value;      //  É a mesma coisa que o x_init, mas positivo (e não necessariamente sobre x)
+        slice->v_infinite_in = conditions.v_infinite_in;
+        slice->v_x_init = conditions.v_x_init;
 
-    b_step = (max_b_factor - min_b_factor) / (NUMERO_DE_TESTES - 1);
+        if (fabs(slice->x_init) < max_b_factor) {
+            printf("A posição inicial não pode ser menor do que o fator de impacto máximo.\n");
+            return 1;
+        }
+    }
 
     //      Tempo e passo de integração.
-    max_int_time = strtod(argv[6], NULL);
-    dt = strtod(argv[7], NULL);
+    settings.config.max_time = strtod(args[6], NULL);
+    settings.config.dt = strtod(args[7], NULL);
 
-    steps_to_output = (int) (STEPS_PARA_OUTPUT / dt);
 
-    //      Calcula os valores de fator de impacto que serão usados.
-    for (i = 0; i < NUMERO_DE_TESTES; i++) b_values[i] = min_b_factor + b_step * i;
+    //      O sweep não guarda nada por teste: o b vem do índice (veja test_b) e os resultados ficam num anel com as
+    //  posições das threads (veja run_simulations). Só o refinamento (que escolhe os b novos a partir dos resultados)
+    //  guarda os vetores, com o orçamento de trajetórias como tamanho; a validação guarda os seus N testes e a
+    //  retomada, um bit por teste.
+    b_values = NULL;
+    results = NULL;
+    done = NULL;
+    if (settings.refine_budget > 0) {
+        b_values = malloc(sizeof(double) * settings.total_tests);
+        results = malloc(sizeof(simulation_result) * settings.total_tests);
+    }
+    numeric = malloc(sizeof(simulation_result) * (settings.n_validate > 0 ? settings.n_validate : 1));
+    mixed = malloc(sizeof(simulation_result) * (settings.n_validate > 0 ? settings.n_validate : 1));
+    validated = malloc(sizeof(int) * (settings.n_validate > 0 ? settings.n_validate : 1));
+    if (settings.resume) done = calloc(settings.total_tests / 8 + 1, sizeof(unsigned char));
+    state.levels = settings.refine_budget > 0 ? calloc(settings.total_tests, sizeof(int)) : NULL;
+    if ((settings.refine_budget > 0 && (b_values == NULL || results == NULL || state.levels == NULL)) || numeric == NULL || mixed == NULL || validated == NULL ||
+        (settings.resume && done == NULL)) {
+        printf("Falha ao alocar memória para %d testes.\n", settings.total_tests);
+        return 1;
+    }
+
+    //      No refinamento, os n_coarse primeiros valores de b são os da grade uniforme; os outros são escolhidos a cada
+    //  rodada.
+    if (settings.refine_budget > 0) for (i = 0; i < n_coarse; i++) b_values[i] = min_b_factor + b_step * i;
+
+    //      Os redutores cobrem o intervalo de b do sweep e a deflexão de 0 a 180 graus.
+    reducer_names[0] = "d_min";
+    reducer_names[1] = "delta_v";
+    reducer_names[2] = "deflection_angle";
+    if (settings.reducing && reducers_init(&state.reducers, 3, reducer_names, 2, min_b_factor, max_b_factor, 0.0, 180.0) != 0) {
+        printf("Falha ao preparar os redutores (--reduce).\n");
+        return 1;
+    }
     // ................................................................................................................
     //      Imprime um registro básico sobre o que o programa está a fazer.
     printf("Rodando o teste...\n");
     printf("Condições iniciais definidas: \n");
     printf("\t Raio de Marte utilizado: %.4e metros \n", RAIO_MARTE);
     printf("\t Massa de Marte utilizada: %.4e kg \n", MASSA_MARTE);
-    printf("\t Valor de x(0): %.4e metros\n", x_init);
+    printf("\t Valor de x(0): %.4e metros\n", settings.slices[0].x_init);
     printf("\t Valor de y(0) pertencente ao intervalo [%.4e m; %.4e m], com passo igual a %.4e metros\n", min_b_factor, max_b_factor, b_step);
-    printf("\t Valor de vx(0): %.4e metros por segundo\n", v_x_init);
+    printf("\t Valor de vx(0): %.4e metros por segundo\n", settings.slices[0].v_x_init);
     printf("\t Valor de vy(0): %.4e metros por segundo\n", 0.0);
-    printf("\t Tempo máximo de integração: %.4e segundos\n", max_int_time);
-    printf("\t Passo de integração: %.4lf s\n", dt);
+    if (settings.grid.n_axes > 0) {
+        printf("\t Grid com %ld fatias e %d testes (os valores acima são os da primeira fatia):\n", settings.n_slices, settings.total_tests);
+        for (i = 0; i < settings.grid.n_axes; i++) printf("\t\t %s: %d valores de %.4e a %.4e\n", settings.grid.axes[i].name, settings.grid.axes[i].n, settings.grid.axes[i].min, settings.grid.axes[i].max);
+    }
+    printf("\t Tempo máximo de integração: %.4e segundos\n", settings.config.max_time);
+    if (settings.analytic) printf("\t Solução analítica (hipérbole kepleriana)%s\n", settings.n_validate > 0 ? ", com validação numérica:" : "");
+    if (!settings.analytic || settings.n_validate > 0) {
+        printf("\t Passo de integração: %.4lf s\n", settings.config.dt);
+        printf("\t Integrador: %s\n", integrator_name(settings.config.integrator));
+        if (settings.simd != SIMD_DESLIGADO) printf("\t Integração em lote: %s\n", batch_name(settings.simd));
+        if (settings.config.precision == PRECISAO_MISTA) printf("\t Precisão mista: forças em float32, estado em double%s\n", settings.n_validate > 0 ? ", com comparação com a precisão dupla" : "");
+        if (settings.config.cadence != CADENCIA_TEMPO || settings.config.rows > 0) printf("\t Cadência da saída: %s, até %ld linhas por trajetória\n", cadence_name(settings.config.cadence), settings.config.rows > 0 ? settings.config.rows : CADENCIA_LINHAS_PADRAO);
+        if (settings.config.integrator == INTEGRADOR_DOPRI5) printf("\t Tolerâncias do passo adaptativo: rtol = %.2e, atol = %.2e\n", settings.config.tol_rel, settings.config.tol_abs);
+        if (settings.early_exit > 0) printf("\t Saída antecipada: tolerância de %.2e nos elementos osculadores\n", settings.early_exit);
+        if (settings.drift) printf("\t Medida da deriva da energia e do momento angular (colunas drift_energy e drift_momentum)\n");
+        if (settings.profiling) printf("\t Perfil da execução (colunas steps, wall_time, steps_per_s e stop)\n");
+        if (settings.refine_budget > 0) printf("\t Refinamento adaptativo: até %d trajetórias, limiar de %.2e da variação total\n", settings.refine_budget, settings.refine_tol);
+        printf("\t Número de threads: %d\n", settings.n_threads);
+        printf("\t Threads de escrita: %d%s\n", settings.n_writers, settings.n_writers == 0 ? " (escrita na thread que integra)" : "");
+    }
+    if (settings.shard.count > 1) printf("\t Parte %d de %d: %ld dos %d testes (intercalados)\n", settings.shard.index, settings.shard.count, shard_tests(&settings.shard, settings.total_tests), settings.total_tests);
+    if (settings.reducing) printf("\t Redutores de streaming: resumo, histograma de b × deflexão e fronteira da colisão%s\n",
+        settings.output_format == SAIDA_NENHUMA && !settings.analytic ? " (sem arquivos de trajetória)" : "");
     // ................................................................................................................
     //      Cria a pasta onde as coisas serão salvas.
     //  !! Esse trecho do código funciona apenas no MacOS e no Linux. Isso não é aplicável no Windows.
     //  No Windows é necessário substituir essa implementação com o uso da biblioteca 'direct.h'.
-    if (mkdir(test_name, 0755) == 0) printf("Os dados serão salvos na pasta: '%s'\n", test_name);
+    //  Com --resume, as pastas de uma execução interrompida são reaproveitadas. Com --shard, a pasta do teste pode já
+    //  existir (com as outras partes); a da parte é criada dentro dela.
+    if (settings.shard.count > 1 && mkdir(args[1], 0755) != 0 && errno != EEXIST) {
+        perror("Falha ao criar o diretório do teste");
+        return 1;
+    }
+    if (mkdir(settings.test_name, 0755) == 0) printf("Os dados serão salvos na pasta: '%s'\n", settings.test_name);
+    else if (settings.resume && errno == EEXIST) printf("Retomando a execução salva na pasta: '%s'\n", settings.test_name);
     else {
-        perror("Falha ao criar o diretório do teste. Verifique se a pasta já existe, caso isso seja verdade, delete-a ou renomei-a.");
+        perror("Falha ao criar o diretório do teste. Verifique se a pasta já existe, caso isso seja verdade, delete-a, renomei-a ou use --resume para continuar a execução");
         return 1;
     }
 
-    sprintf(filename, "%s/pr2c", test_name);
+    sprintf(filename, "%s/pr2c", settings.test_name);
     if (mkdir(filename, 0755) == 0) printf("Pasta do problema de 2 corpos: '%s'\n", filename);
-    else {
+    else if (!settings.resume || errno != EEXIST) {
         perror("Falha ao criar o diretório para os arquivos do problema de 2 corpos. Verifique se a pasta já existe, caso isso seja verdade, delete-a ou renomei-a.");
         return 1;
     }
-    // ................................................................................................................
-    //      Chama a função responsável pelas simulações numéricas de cada teste.
-    printf("\nRealizando simulações ... \n");
-    begin = clock();
-    for (i = 0; i < NUMERO_DE_TESTES; i++) {
-        progress = (1.0 * i / NUMERO_DE_TESTES) * 100;
-
-        //      Chama a simulação para o parâmetro de impacto b_values[i].
-        simulate(i, b_values[i], &d_values[i], &var_velocidade[i], &deflection_angle[i], &collision[i], &times[i]);
 
-        //      Barrinha de progresso (modo avançado com ETA) =D
-        elapsed = (double) (clock() - begin) / CLOCKS_PER_SEC;
-        total_time = (elapsed / (i > 0 ? i : 1)) * NUMERO_DE_TESTES;
-        remaining = total_time - elapsed;
+    //      A linha de comando fica salva na pasta; a retomada só é aceita com os mesmos argumentos.
+    sprintf(filename, "%s/run_pr2c.txt", settings.test_name);
+    neutral[0] = "--threads";
+    neutral[1] = "--writers";
+    neutral[2] = "--simd";
+    neutral[3] = "--progress";
+    neutral[4] = "--progress-interval";
+    status = journal_config(filename, argc, argv, neutral, 5, settings.resume);
+    if (status == -1) {
+        printf("Os argumentos não são os mesmos da execução salva em '%s' (na retomada, apenas --threads, --writers, --simd e as opções do progresso podem mudar).\n", filename);
+        return 1;
+    }
+    if (status != 0) {
+        printf("Falha ao %s o arquivo de configuração da execução: '%s'.\n", settings.resume ? "ler" : "gravar", filename);
+        return 1;
+    }
 
-        format_time(elapsed, elapsed_str);
-        format_time(remaining, remaining_str);
+    //      A parte é identificada na própria pasta, para o flyby_merge.
+    sprintf(filename, "%s/shard_pr2c.txt", settings.test_name);
+    if (settings.shard.count > 1 && shard_save(filename, &settings.shard, settings.total_tests) != 0) {
+        perror("Falha ao gravar o arquivo da parte da execução (--shard)");
+        return 1;
+    }
 
-        printf("\r");       //  Limpa
-        for (j = 0; j < 220; j++) printf(" ");
-        fflush(stdout);
+    //      No formato binário todas as trajetórias vão para um único arquivo. Na retomada, o arquivo é reaberto sem
+    //  apagar as trajetórias que já estão no índice.
+    if (settings.output_format == SAIDA_BINARIA) {
+        sprintf(filename, "%s/pr2c/trajectories.bin", settings.test_name);
+        settings.store = settings.resume ? store_reopen(filename, settings.total_tests, "t,x,y,v_x,v_y,d") : NULL;
+        if (settings.store == NULL) settings.store = store_open(filename, settings.total_tests, "t,x,y,v_x,v_y,d");
+        if (settings.store == NULL) {
+            perror("Falha ao criar o arquivo binário das trajetórias");
+            return 1;
+        }
+    }
+    // ................................................................................................................
+    //      O arquivo de dados globais é aberto antes das simulações: cada teste é escrito assim que ele e todos os
+    //  anteriores terminam (na ordem dos índices, a mesma da execução serial), então os resultados parciais podem ser
+    //  lidos durante a execução.
+    //  Na retomada, o arquivo funciona como o diário da execução: ele é filtrado (veja journal.h) e as linhas novas são
+    //  acrescentadas no fim.
+    sprintf(filename, "%s/global_pr2c.csv", settings.test_name);
+    if (settings.resume) {
+        n_done = journal_resume(filename, settings.total_tests, settings.analytic || settings.output_format == SAIDA_NENHUMA ? NULL : trajectory_complete, &settings, done);
+        if (n_done < 0 || (settings.reducing && reduce_global(&state.reducers, filename) != 0)) {
+            perror("Falha ao ler o arquivo de dados globais da execução interrompida");
+            return 1;
+        }
+        printf("Testes já concluídos na execução interrompida: %ld de %ld\n", n_done, shard_tests(&settings.shard, settings.total_tests));
+    }
+    fo = fopen(filename, settings.resume ? "a" : "w");
+    if (fo == NULL) {
+        perror("Falha ao criar o arquivo de dados globais");
+        return 1;
+    }
+    printf("Os dados globais serão salvos em: '%s'\n", filename);
 
-        printf("\r[");
-        for (j = 0; j < 100; j++) printf(progress >= j ? "#" : " ");
-        printf("] %.2lf%%, Elapsed: %s, ETA: %s", progress, elapsed_str, remaining_str);
+    //  - Cabeçalho do arquivo CSV (apenas num arquivo vazio).
+    //  No modo adaptativo são adicionadas duas colunas com o número de passos aceitos e rejeitados, com --drift as duas
+    //  colunas da deriva e com --profile as colunas de desempenho de cada trajetória. Com --grid, as colunas da fatia e
+    //  dos parâmetros dela vão no fim; com --refine, a coluna do nível de refinamento.
+    fseek(fo, 0, SEEK_END);
+    if (ftell(fo) == 0) fprintf(fo, "i,b,d_min,delta_v,deflection_angle,collision,t%s%s%s%s%s\n", settings.config.integrator == INTEGRADOR_DOPRI5 && !settings.analytic ? ",steps_accepted,steps_rejected" : "",
+        settings.drift ? ",drift_energy,drift_momentum" : "", settings.profiling ? ",steps,wall_time,steps_per_s,stop" : "", settings.grid.n_axes > 0 ? ",slice,x_init_factor,velocity_infinity" : "",
+        settings.refine_budget > 0 ? ",level" : "");
+    fflush(fo);
+    // ................................................................................................................
+    //      Chama a função responsável pelas simulações numéricas de cada teste. Um SIGINT ou SIGTERM interrompe o sweep
+    //  depois dos testes em andamento, e tudo o que terminou é salvo.
+    sweep_catch_signals();
+    if (settings.profiling) profile_init(&state.profile);
+    interrupted = 0;
+    if (!settings.analytic) {
+        printf("\nRealizando simulações ... \n");
+        if (settings.refine_budget > 0) status = run_refinement(&settings, &state, n_coarse, b_values, results, fo);
+        else status = run_simulations(&settings, &state, (int) shard_tests(&settings.shard, settings.total_tests), NULL, NULL, min_b_factor, b_step, done, NULL, fo);
+        if (status == 1) return 1;
+        interrupted = status == 2;
+    } else {
+        //      No modo analítico cada teste custa apenas algumas funções hiperbólicas, calculadas na hora de escrever
+        //  (a validação recalcula os seus N testes).
+        begin = clock();
+        for (i = settings.shard.index, j = 0; i < settings.total_tests && !sweep_interrupted(); i += settings.shard.count) {
+            if (journal_done(done, i)) continue;
+            analytic_solution(&settings, min_b_factor + b_step * (i % settings.n_impacts), &settings.slices[i / settings.n_impacts], &exact);
+            write_global(&settings, state.levels, fo, i, &exact);
+            if (settings.reducing) reduce_result(&state.reducers, &exact);
+            j++;
+        }
+        interrupted = i < settings.total_tests;
+        printf("\nSolução analítica calculada para %d testes em %.3e segundos.\n\n", j, (double) (clock() - begin) / CLOCKS_PER_SEC);
+    }
+    fclose(fo);
 
-        fflush(stdout);     //  Força a impressão =V
+    //      Os redutores são gravados mesmo numa interrupção: eles têm os mesmos testes do arquivo global, e a retomada
+    //  os reconstrói a partir dele.
+    if (settings.reducing && reducers_write(&state.reducers, settings.test_name, "pr2c") != 0) {
+        perror("Falha ao gravar os resultados dos redutores");
+        return 1;
     }
+    // ................................................................................................................
+    //      Validação da solução analítica: integra alguns testes espalhados pelo intervalo de b e compara. Na precisão
+    //  mista, os mesmos testes são integrados nas duas precisões, sem arquivos de trajetória (assim a comparação também
+    //  vale na retomada, em que os resultados dos testes já concluídos não estão na memória).
+    if (settings.n_validate > 0 && !interrupted) {
+        for (i = 0; i < settings.n_validate; i++) validated[i] = settings.n_validate > 1 ? (int) lround((double) i * (settings.total_tests - 1) / (settings.n_validate - 1)) : 0;
 
-    printf("\r");       //  Limpa
-    for (j = 0; j < 220; j++) printf(" ");
-    fflush(stdout);
+        if (settings.analytic) {
+            printf("Validando a solução analítica com %d testes integrados numericamente ... \n", settings.n_validate);
+            status = run_simulations(&settings, &state, settings.n_validate, validated, NULL, min_b_factor, b_step, NULL, numeric, NULL);
+        } else {
+            printf("Comparando a precisão mista com a dupla em %d testes ... \n", settings.n_validate);
+            settings.output_format = SAIDA_NENHUMA;
+            status = run_simulations(&settings, &state, settings.n_validate, validated, NULL, min_b_factor, b_step, NULL, mixed, NULL);
+            settings.config.precision = PRECISAO_DUPLA;
+            if (status == 0) status = run_simulations(&settings, &state, settings.n_validate, validated, NULL, min_b_factor, b_step, NULL, numeric, NULL);
+        }
+        if (status == 1) return 1;
+        interrupted = status == 2;
+    }
+    //      Desvios da validação (apenas se ela chegou ao fim).
+    if (settings.n_validate > 0 && !interrupted) {
+        printf("%5s %14s %14s %14s %14s %14s %6s\n", "i", "b [m]", "d_min [m]", "|Δd_min| [m]", "|Δdelta_v|", "|Δdefl| [°]", "colisão");
+        for (j = 0; j < 4; j++) deviation[j] = 0.0;
+        mismatches = 0;
+        for (i = 0; i < settings.n_validate; i++) {
+            //  A referência é a solução analítica (ou a precisão dupla); a coluna da colisão mostra referência/comparado.
+            if (settings.analytic) analytic_solution(&settings, min_b_factor + b_step * (validated[i] % settings.n_impacts), &settings.slices[validated[i] / settings.n_impacts], &exact);
+            reference = settings.analytic ? &exact : &numeric[i];
+            compared = settings.analytic ? &numeric[i] : &mixed[i];
 
-    printf("\r[");
-    for (i = 0; i < 100; i++) printf("#");
-    printf("] 100.00%%, Total time: %s", elapsed_str);
-    fflush(stdout);
-    printf("\n\n");
-    // ................................................................................................................
-    //      Salva os dados globais.
-    printf("Salvando os dados globais em: '%s/global.csv'\n", test_name);
+            printf("%5d %14.6e %14.6e %14.6e %14.6e %14.6e %3d/%d\n", validated[i] + 1, reference->b, reference->d_min, fabs(compared->d_min - reference->d_min),
+                fabs(compared->delta_v - reference->delta_v), fabs(compared->deflection_angle - reference->deflection_angle) * RAD_TO_DEG, reference->collision,
+                compared->collision);
 
-    sprintf(filename, "%s/global_pr2c.csv", test_name);
-    fo = fopen(filename, "w");
+            if (compared->collision != reference->collision) mismatches++;
+            //  No Euler o ponto de parada de uma colisão depende do passo (a sonda já está dentro de Marte), então elas
+            //  ficam fora dos desvios máximos; os outros métodos localizam a entrada na superfície dentro do passo.
+            if ((compared->collision || reference->collision) && !(settings.analytic && settings.config.integrator != INTEGRADOR_EULER)) continue;
+            if (fabs(compared->d_min - reference->d_min) > deviation[0]) deviation[0] = fabs(compared->d_min - reference->d_min);
+            if (fabs(compared->delta_v - reference->delta_v) > deviation[1]) deviation[1] = fabs(compared->delta_v - reference->delta_v);
+            if (fabs(compared->deflection_angle - reference->deflection_angle) > deviation[2]) deviation[2] = fabs(compared->deflection_angle - reference->deflection_angle);
+            if (fabs(compared->time_end - reference->time_end) > deviation[3]) deviation[3] = fabs(compared->time_end - reference->time_end);
+        }
+        printf("Maiores desvios (%s, %s): d_min = %.4e m, delta_v = %.4e m/s, deflexão = %.4e graus, t = %.4e s\n",
+            settings.analytic ? "numérico - analítico" : "mista - dupla", settings.analytic && settings.config.integrator != INTEGRADOR_EULER ? "todos os testes" : "testes sem colisão", deviation[0], deviation[1], deviation[2] * RAD_TO_DEG, deviation[3]);
+        printf("Testes em que a colisão não coincide: %d\n\n", mismatches);
 
-    //  - Cabeçalho do arquivo CSV.
-    fprintf(fo, "i,b,d_min,delta_v,deflection_angle,collision,t\n");
-    for (i = 0; i < NUMERO_DE_TESTES; i++) {
-        fprintf(fo, "%d,%.15e,%.15e,%.15e,%.15e,%d,%.15e\n",
-            i + 1, b_values[i], d_values[i], var_velocidade[i], deflection_angle[i] * RAD_TO_DEG, collision[i],times[i]);
+        //  O dopri5 localiza os pontos de parada, então ele deve reproduzir a hipérbole (colisões incluídas) dentro das
+        //  tolerâncias VALIDACAO_*. Fora delas, o programa termina com erro.
+        if (settings.analytic && settings.config.integrator == INTEGRADOR_DOPRI5) {
+            rejected = mismatches > 0 || deviation[0] > VALIDACAO_D_MIN || deviation[1] > VALIDACAO_DELTA_V || deviation[2] * RAD_TO_DEG > VALIDACAO_DEFLEXAO ||
+                deviation[3] > VALIDACAO_TEMPO;
+            printf("Validação do dopri5 (d_min < %.0e m, delta_v < %.0e m/s, deflexão < %.0e graus, t < %.0e s, colisões iguais): %s\n\n", VALIDACAO_D_MIN,
+                VALIDACAO_DELTA_V, VALIDACAO_DEFLEXAO, VALIDACAO_TEMPO, rejected ? "REPROVADA" : "aprovada");
+        }
     }
-
-    fclose(fo);
+    if (settings.profiling) profile_report(&state.profile);
+    if (store_close(settings.store) != 0) {
+        printf("Falha ao escrever o arquivo binário das trajetórias.\n");
+        return 1;
+    }
+    free(b_values);
+    free(results);
+    free(numeric);
+    free(mixed);
+    free(validated);
+    free(settings.slices);
+    free(done);
+    free(state.levels);
     // ................................................................................................................
+    if (interrupted) {
+        if (settings.refine_budget > 0) printf("Execução interrompida: os testes concluídos foram salvos (o refinamento não pode ser retomado com --resume).\n\n");
+        else printf("Execução interrompida: os testes concluídos foram salvos. Para continuar, rode o mesmo comando com --resume.\n\n");
+        return 130;
+    }
+    if (rejected) return 1;
     printf("Simulação concluída =D\n\n");
     // ................................................................................................................
     return 0;
@@ -244,156 +975,739 @@ int main(const int argc, const char *argv[]) {
 // ....................................................................................................................
 //  * Eu separei isso numa função a parte porque fica mais organizado.
 //  - Faz a simulação física do problema para as condições passadas nos argumentos.
+//  const run_settings* settings            → Configuração da execução.
+//  run_state* state                        → Estado da execução (escrita assíncrona e perfil).
 //  const int test                          → Número de identificação do teste.
 //  const double b                          → Parâmetro de impacto.
-//  double* d_min_value                     → Referência: altera a distância mínima encontrada entre a sonda e Marte.
-//  double* delta_v_value                   → Referência: altera a variação de velocidade entre a sonda e Marte na entrada e saída.
-//  double* deflection_angle_value          → Referência: altera o ângulo de deflexão encontrado.
-//
-//  * Os valores passados como "referência" são saídas da função simulate alterados em espaços de memória pré-alocados.
-//  double* time_end                        → Referência: altera o tempo em segundo que levou para finalizar a simulação.
-void simulate(const int test, const double b, double* d_min_value, double* delta_v_value, double* deflection_angle_value, int* collision, double* time_end) {
+//  simulation_result* result               → Referência: recebe os resultados do teste.
+void simulate(const run_settings* settings, run_state* state, const int test, const double b, const grid_slice* slice, simulation_result* result) {
     // ................................................................................................................
     //          Declaração das variáveis locais.
-    int f;                                              //                  - Contador para as saídas.
+    exit_monitor monitor;                               //                  - Elementos osculadores (--early-exit).
+    drift_reference reference;                          //                  - Quantidades conservadas iniciais (--drift).
+    double begin;                                       // [s]              - Início do teste (--profile).
 
-    //      Variáveis de estado.
+    //      Estado inicial (para a deriva; a trajetória é integrada pela libflyby).
     double r[N_DIMS + 1];                               // [m, m]           - Posição da sonda.
     double v[N_DIMS + 1];                               // [m/s, m/s]       - Velocidade da sonda.
-    //  → A aceleração foi incorporada diretamente nas equações de movimento.
-    //      Variáveis de estado temporárias.
-    double r_temp[N_DIMS + 1];                          // [m, m]           - Posição temporária da sonda.
-    double v_temp[N_DIMS + 1];                          // [m/s, m/s]       - Velocidade temporária da sonda.
-
-    //      Vetores de velocidade de entrada e saída.
-    double velocity_in[N_DIMS + 1];                     // [m/s, m/s]       - Vetor de velocidade relativa de entrada. (No infinito)
-    double velocity_out[N_DIMS + 1];                    // [m/s, m/s]       - Vetor de velocidade relativa de saída. (No infinito, cálculado com correção de energia)
-    double velocity_out_direction[N_DIMS + 1];          // [m/s, m/s]       - Vetor unitário de direção do vetor de saída no ponto de parada. Isso define a direção do velocity_out.
-
-    double div;                                         // [mˆ2]            - Fator comum de divisão. É o módulo quadrado do vetor distância.
-    double time;                                        // [s]              - Tempo de intregrassão.
-    double distance;                                    // [m]              - Distância relativa entre a sonda e Marte.
-    char filename[200];                                 //                  - Arquivos onde os dados da simulação serão salvos.
-    FILE *fo;                                           //                  - Ponteiro de acesso para o arquivo.
+
+    //      O laço é o da libflyby (flyby_integrate), com qualquer integrador.
+    flyby_config config;                                //                  - Configuração da trajetória.
+    flyby_result trajectory;                            //                  - Resultados da trajetória.
+    flyby_sink sink;                                    //                  - Destino das linhas e acompanhamento dos passos.
+    simulation_sink context;                            //                  - Dados do sink (veja sink_row).
+
+    trajectory_output out;                              //                  - Saída dos dados da simulação (veja output.h).
+    char directory[200];                                //                  - Pasta dos arquivos CSV.
     // ................................................................................................................
     //          Condições iniciais, aplicadas...
-    r[1] = x_init;
+    r[1] = slice->x_init;
     r[2] = b;
-    v[1] = v_x_init;
+    v[1] = slice->v_x_init;
     v[2] = 0.0;
 
-    velocity_in[1] = v_infinite_in;
-    velocity_in[2] = 0.0;
-
-    distance = sqrt(r[1] * r[1] + r[2] * r[2]);
-
-    *collision = 0;
-    *d_min_value = distance;
+    result->drift_energy = 0.0;
+    result->drift_momentum = 0.0;
+    result->wall_time = 0.0;
+    begin = settings->profiling ? profile_now() : 0.0;
+    monitor.next_check = 0.0;
+    monitor.valid = 0;
+    if (settings->drift) drift_start(&reference, r, v);
     // ................................................................................................................
     //          Prepara para salvar os dados.
-    f = 0;
-    sprintf(filename, "%s/pr2c/data_%03d.csv", test_name, test + 1);
-    fo = fopen(filename, "w");
-    //  Como eu não vou usar GnuPlot, vou adicionar um cabeçalho no arquivo; e meio que o formato acaba virando um CSV.
-    fprintf(fo, "t,x,y,v_x,v_y,d\n");
+    sprintf(directory, "%s/pr2c", settings->test_name);
+    output_open(&out, settings->output_format, directory, test, "t,x,y,v_x,v_y,d", 12, settings->store, state->pipeline, settings->profiling);
     // ................................................................................................................
     //          Processo de simulação numérica.
-    for (time = 0; time < max_int_time; time += dt) { // NOLINT(*-flp30-c)
-        // ............................................................................................................
-        //          Adiciona os dados ao arquivo de saída.
-        if (f <= 0) {
-            f = steps_to_output;
-            fprintf(fo, "%.8e,%.12e,%.12e,%.12e,%.12e,%.12e\n",
-                time, r[1], r[2], v[1], v[2], distance);
-
-            //      Critérios de parada.
-            //  1. Verifica se a sonda colidiu com Marte.
-            if (distance < RAIO_MARTE) {
-                *d_min_value = distance;
-                *collision = 1;
-                break;
-            }
+    //  A trajetória é a da libflyby (flyby.c), com a configuração da execução e os parâmetros da fatia: as linhas vão
+    //  para a saída da trajetória, e cada passo (aceito, no dopri5) para a deriva e a saída antecipada (sink_step).
+    config = settings->config;
+    config.x_init_factor = slice->parameters[0];
+    config.velocity_infinity = slice->parameters[1];
+
+    context.settings = settings;
+    context.out = &out;
+    context.monitor = &monitor;
+    context.reference = &reference;
+    context.slice = slice;
+    context.result = result;
+    sink.row = sink_row;
+    sink.step = settings->drift || settings->early_exit > 0 ? sink_step : NULL;
+    sink.context = &context;
+    flyby_integrate(&config, b, &trajectory, &sink);
+
+    result->b = b;
+    result->d_min = trajectory.d_min;
+    result->delta_v = trajectory.delta_v;
+    result->deflection_angle = trajectory.deflection_angle;
+    result->collision = trajectory.collision;
+    result->time_end = trajectory.time_end;
+    result->steps_accepted = trajectory.steps_accepted;
+    result->steps_rejected = trajectory.steps_rejected;
+    result->steps = trajectory.steps;
+    result->stop = trajectory.stop;
+    // ................................................................................................................
+    //          Fecha o arquivo de dados.
+    output_close(&out);
+
+    if (settings->profiling) {
+        result->wall_time = profile_now() - begin;
+        profile_trajectory(&state->profile, result->wall_time, out.row_seconds, out.file_seconds, out.row_count, result->steps, result->stop);
+    }
+}
+// ....................................................................................................................
+void sink_row(const double* values, void* context) {
+    const simulation_sink* simulation = context;
+
+    output_row(simulation->out, values);
+}
+// ....................................................................................................................
+//      Os vetores da libflyby começam no índice 0; a deriva e a saída antecipada usam os do programa (índice 1).
+int sink_step(double* time, double* r, double* v, const int event, void* context) {
+    const simulation_sink* simulation = context;
+    const run_settings* settings = simulation->settings;
+    double r_step[N_DIMS + 1];                          // [m, m]           - Posição da sonda no fim do passo.
+    double v_step[N_DIMS + 1];                          // [m/s, m/s]       - Velocidade da sonda no fim do passo.
+    int stop;
+
+    r_step[1] = r[0];
+    r_step[2] = r[1];
+    v_step[1] = v[0];
+    v_step[2] = v[1];
+    if (settings->drift) drift_measure(simulation->reference, r_step, v_step, simulation->result);
+    if (event || settings->early_exit <= 0) return 0;
+
+    stop = check_early_exit(settings, simulation->monitor, r_step, v_step, time, simulation->slice);
+    r[0] = r_step[1];
+    r[1] = r_step[2];
+    v[0] = v_step[1];
+    v[1] = v_step[2];
+    return stop;
+}
+// ....................................................................................................................
+//      Integração em lote (SIMD). O laço é o flyby_batch da libflyby, que reproduz o Euler do flyby_integrate para
+//  vários testes ao mesmo tempo; aqui cada lane tem a sua saída, e o sink dela só recebe as linhas (o lote não tem
+//  deriva nem saída antecipada). Os lotes nunca misturam fatias do grid, então a fatia é a do primeiro teste.
+void simulate_batch(const run_settings* settings, run_state* state, const int count, const int* tests, const double* b_values, simulation_result* results) {
+    const grid_slice* slice = &settings->slices[tests[0] / settings->n_impacts];
+    flyby_config config;                                //                  - Configuração das trajetórias do lote.
+    flyby_result trajectory[BATCH_MAX_LANES];           //                  - Resultados de cada lane.
+    flyby_sink sinks[BATCH_MAX_LANES];                  //                  - Destino das linhas de cada lane.
+    simulation_sink context[BATCH_MAX_LANES];           //                  - Dados do sink de cada lane (veja sink_row).
+    trajectory_output out[BATCH_MAX_LANES];             //                  - Saída de cada lane.
+    double begin;                                       // [s]              - Início do lote (--profile).
+    double share;                                       // [s]              - Parte do tempo do lote de cada lane (--profile).
+    char directory[200];                                //                  - Pasta dos arquivos CSV.
+    int l;
+
+    config = settings->config;
+    config.x_init_factor = slice->parameters[0];
+    config.velocity_infinity = slice->parameters[1];
+    begin = settings->profiling ? profile_now() : 0.0;
+
+    sprintf(directory, "%s/pr2c", settings->test_name);
+    for (l = 0; l < count; l++) {
+        output_open(&out[l], settings->output_format, directory, tests[l], "t,x,y,v_x,v_y,d", 12, settings->store, state->pipeline, settings->profiling);
+        context[l].settings = settings;
+        context[l].out = &out[l];
+        context[l].monitor = NULL;
+        context[l].reference = NULL;
+        context[l].slice = slice;
+        context[l].result = &results[l];
+        sinks[l].row = sink_row;
+        sinks[l].step = NULL;
+        sinks[l].context = &context[l];
+    }
+    flyby_batch(&config, settings->simd, count, b_values, trajectory, sinks);
+
+    //      Fecha os arquivos e copia os resultados de cada lane.
+    for (l = 0; l < count; l++) {
+        output_close(&out[l]);
+
+        results[l].b = trajectory[l].b;
+        results[l].d_min = trajectory[l].d_min;
+        results[l].delta_v = trajectory[l].delta_v;
+        results[l].deflection_angle = trajectory[l].deflection_angle;
+        results[l].collision = trajectory[l].collision;
+        results[l].time_end = trajectory[l].time_end;
+        results[l].steps_accepted = 0;
+        results[l].steps_rejected = 0;
+        results[l].drift_energy = 0.0;
+        results[l].drift_momentum = 0.0;
+        results[l].steps = trajectory[l].steps;
+        results[l].wall_time = 0.0;
+        results[l].stop = trajectory[l].stop;
+    }
+
+    //      No perfil, o tempo do lote é dividido igualmente entre as lanes (elas avançam juntas).
+    if (settings->profiling) {
+        share = (profile_now() - begin) / count;
+        for (l = 0; l < count; l++) {
+            results[l].wall_time = share;
+            profile_trajectory(&state->profile, share, out[l].row_seconds, out[l].file_seconds, out[l].row_count, results[l].steps, results[l].stop);
+        }
+    }
+}
+// ....................................................................................................................
+//      Deriva das quantidades conservadas. A energia é comparada com |E(0)| (que é v_inf² / 2, sempre positiva numa
+//  trajetória hiperbólica) e o momento angular com a sua escala (veja drift_reference).
+void drift_start(drift_reference* reference, const double r[], const double v[]) {
+    reference->energy = 0.5 * (v[1] * v[1] + v[2] * v[2]) - CONSTANTE_GRAVITACIONAL * MASSA_MARTE / sqrt(r[1] * r[1] + r[2] * r[2]);
+    reference->momentum = r[1] * v[2] - r[2] * v[1];
+    reference->scale = reference->momentum != 0 ? fabs(reference->momentum) : sqrt((r[1] * r[1] + r[2] * r[2]) * (v[1] * v[1] + v[2] * v[2]));
+}
+
+void drift_measure(const drift_reference* reference, const double r[], const double v[], simulation_result* result) {
+    const double energy = 0.5 * (v[1] * v[1] + v[2] * v[2]) - CONSTANTE_GRAVITACIONAL * MASSA_MARTE / sqrt(r[1] * r[1] + r[2] * r[2]);
+    const double momentum = r[1] * v[2] - r[2] * v[1];
+    double deviation;
 
-            //  2. Verifica se a sonda está suficientemente longe de Marte.
-            //  O critério temporal aqui é apenas para impedir que ele pare no começo da simulação.
-            if (distance >= stop_value && time > 10 * STEPS_PARA_OUTPUT) {
-                break;
+    deviation = fabs(energy - reference->energy) / fabs(reference->energy);
+    if (deviation > result->drift_energy) result->drift_energy = deviation;
+    deviation = fabs(momentum - reference->momentum) / reference->scale;
+    if (deviation > result->drift_momentum) result->drift_momentum = deviation;
+}
+// ....................................................................................................................
+//      Saída antecipada. Os elementos osculadores do problema de 2 corpos só mudam pelo erro do integrador, que cai
+//  rapidamente com a distância; quando a mudança entre duas verificações fica abaixo da tolerância, integrar o resto
+//  do trecho de saída não acrescenta nada além desse erro.
+//      E = v²/2 - μ/r,         e = ((v² - μ/r) r - (r·v) v) / μ.
+int check_early_exit(const run_settings* settings, exit_monitor* monitor, double r[], double v[], double* time, const grid_slice* slice) {
+    const double mu = CONSTANTE_GRAVITACIONAL * MASSA_MARTE;
+    const double distance = sqrt(r[1] * r[1] + r[2] * r[2]);
+    const double radial = r[1] * v[1] + r[2] * v[2];
+    const double v2 = v[1] * v[1] + v[2] * v[2];
+    double energy;                                      // [J/kg]           - Energia específica.
+    double e[N_DIMS + 1];                               //                  - Vetor excentricidade.
+    double change;                                      //                  - Variação do vetor excentricidade.
+    double elapsed;                                     // [s]              - Tempo até o ponto de parada.
+    int converged;
+
+    if (*time < monitor->next_check) return 0;
+    monitor->next_check = *time + INTERVALO_CONVERGENCIA;
+
+    //  Apenas depois do periapsis, e dentro da esfera de parada.
+    if (radial <= 0 || distance >= slice->stop_value) {
+        monitor->valid = 0;
+        return 0;
+    }
+
+    energy = 0.5 * v2 - mu / distance;
+    e[1] = ((v2 - mu / distance) * r[1] - radial * v[1]) / mu;
+    e[2] = ((v2 - mu / distance) * r[2] - radial * v[2]) / mu;
+    change = sqrt((e[1] - monitor->e[1]) * (e[1] - monitor->e[1]) + (e[2] - monitor->e[2]) * (e[2] - monitor->e[2]));
+
+    converged = monitor->valid && fabs(energy - monitor->energy) <= settings->early_exit * fabs(energy) && change <= settings->early_exit * sqrt(e[1] * e[1] + e[2] * e[2]);
+    monitor->energy = energy;
+    monitor->e[1] = e[1];
+    monitor->e[2] = e[2];
+    monitor->valid = 1;
+    if (!converged) return 0;
+
+    //  O critério de parada de emergência continua valendo: se a hipérbole passa de max_int_time, a integração segue.
+    elapsed = kepler_exit(r, v, slice->stop_value);
+    if (elapsed < 0 || *time + elapsed > settings->config.max_time) return 0;
+
+    *time += elapsed;
+    return 1;
+}
+// ....................................................................................................................
+//      Propagação kepleriana até a distância 'radius', pela anomalia hiperbólica F (veja também o analytic_solution):
+//      r(F) = |a| (e cosh F - 1),          t(F) = sqrt(|a|^3 / μ) (e sinh F - F),          r·v = sqrt(μ |a|) e sinh F.
+//  No referencial perifocal (eixo p na direção do periapsis, q a 90° no sentido do movimento):
+//      posição = |a| (e - cosh F, sqrt(e² - 1) sinh F),  velocidade = sqrt(μ |a|) / r (- sinh F, sqrt(e² - 1) cosh F).
+double kepler_exit(double r[], double v[], const double radius) {
+    const double mu = CONSTANTE_GRAVITACIONAL * MASSA_MARTE;
+    const double distance = sqrt(r[1] * r[1] + r[2] * r[2]);
+    const double v2 = v[1] * v[1] + v[2] * v[2];
+    const double radial = r[1] * v[1] + r[2] * v[2];
+    const double energy = 0.5 * v2 - mu / distance;
+    double a;                                           // [m]              - Semi-eixo (em módulo).
+    double e;                                           //                  - Excentricidade.
+    double p[N_DIMS + 1];                               //                  - Direção do periapsis.
+    double q[N_DIMS + 1];                               //                  - Direção perpendicular, no sentido do movimento.
+    double f_init;                                      //                  - Anomalia hiperbólica do estado atual.
+    double f_end;                                       //                  - Anomalia hiperbólica no ponto de parada.
+    double r_end;
+    double x;
+    double y;
+
+    if (energy <= 0 || radius <= distance) return -1.0;
+
+    a = mu / (2 * energy);
+    p[1] = ((v2 - mu / distance) * r[1] - radial * v[1]) / mu;
+    p[2] = ((v2 - mu / distance) * r[2] - radial * v[2]) / mu;
+    e = sqrt(p[1] * p[1] + p[2] * p[2]);
+    if (e <= 1) return -1.0;
+    p[1] /= e;
+    p[2] /= e;
+    q[1] = r[1] * v[2] - r[2] * v[1] >= 0 ? - p[2] : p[2];
+    q[2] = r[1] * v[2] - r[2] * v[1] >= 0 ? p[1] : - p[1];
+
+    f_init = asinh(radial / (e * sqrt(mu * a)));
+    f_end = acosh((radius / a + 1) / e);
+    r_end = a * (e * cosh(f_end) - 1);
+
+    x = a * (e - cosh(f_end));
+    y = a * sqrt(e * e - 1) * sinh(f_end);
+    r[1] = x * p[1] + y * q[1];
+    r[2] = x * p[2] + y * q[2];
+
+    x = - sqrt(mu * a) / r_end * sinh(f_end);
+    y = sqrt(mu * a) / r_end * sqrt(e * e - 1) * cosh(f_end);
+    v[1] = x * p[1] + y * q[1];
+    v[2] = x * p[2] + y * q[2];
+
+    return ((e * sinh(f_end) - f_end) - (e * sinh(f_init) - f_init)) / sqrt(mu / (a * a * a));
+}
+// ....................................................................................................................
+//      No formato binário, a trajetória está completa se já tem entrada no índice; no CSV, se a última linha do arquivo
+//  é o estado final do teste.
+int trajectory_complete(const int test, const double time_end, void* context) {
+    const run_settings* settings = context;
+    char filename[250];
+
+    if (settings->store != NULL) return store_rows(settings->store, test) > 0;
+
+    sprintf(filename, "%s/pr2c/data_%03d.csv", settings->test_name, test + 1);
+    return journal_csv_complete(filename, time_end);
+}
+// ....................................................................................................................
+//      Solução analítica pela hipérbole kepleriana (flyby_hyperbola, veja flyby.c), a partir da fatia do grid.
+void analytic_solution(const run_settings* settings, const double b, const grid_slice* slice, simulation_result* result) {
+    flyby_conditions conditions;
+    flyby_result hyperbola;
+
+    conditions.x_init = slice->x_init;
+    conditions.stop_value = slice->stop_value;
+    conditions.v_infinite_in = slice->v_infinite_in;
+    conditions.v_x_init = slice->v_x_init;
+    flyby_hyperbola(&conditions, settings->config.max_time, b, &hyperbola);
+
+    result->b = b;
+    result->d_min = hyperbola.d_min;
+    result->delta_v = hyperbola.delta_v;
+    result->deflection_angle = hyperbola.deflection_angle;
+    result->collision = hyperbola.collision;
+    result->time_end = hyperbola.time_end;
+    result->steps_accepted = 0;
+    result->steps_rejected = 0;
+}
+// ....................................................................................................................
+//      Estimativa barata do número de avaliações da aceleração de um teste.
+//  A sonda é tratada como se andasse em linha reta com velocidade v_infinite_in; a única física usada é o periapsis
+//  da hipérbole (a partir da energia e do momento angular iniciais) para saber se o teste termina numa colisão.
+//  - Sem colisão, a sonda percorre a corda inteira até sair da esfera de raio stop_value.
+//  - Com colisão, ela percorre apenas o trecho até a superfície de Marte.
+double estimate_cost(const run_settings* settings, const double b, const grid_slice* slice) {
+    const double mu = CONSTANTE_GRAVITACIONAL * MASSA_MARTE;
+    const double x_init = slice->x_init;
+    const double v_x_init = slice->v_x_init;
+    const double v_infinite_in = slice->v_infinite_in;
+    const double stop_value = slice->stop_value;
+    const double h = fabs(b) * v_x_init;                //  Momento angular específico inicial.
+    const double e = sqrt(1 + v_infinite_in * v_infinite_in * h * h / (mu * mu));
+    const double r_p = (h * h / mu) / (1 + e);          //  Raio do periapsis.
+    double length;
+
+    if (r_p < RAIO_MARTE) length = fabs(x_init) - (fabs(b) < RAIO_MARTE ? sqrt(RAIO_MARTE * RAIO_MARTE - b * b) : 0.0);
+    else length = fabs(x_init) + (fabs(b) < stop_value ? sqrt(stop_value * stop_value - b * b) : 0.0);
+
+    return length / v_infinite_in / settings->config.dt * integrator_evaluations(settings->config.integrator);
+}
+// ....................................................................................................................
+//      Roda o sweep numérico sobre os testes da parte (pulando os que já foram feitos) ou sobre uma lista de testes
+//  (os validados, ou os de uma rodada do refinamento).
+int run_simulations(const run_settings* settings, run_state* state, const int n_tests, const int* tests, const double* b_values, const double b_min, const double b_step, const unsigned char* done,
+    simulation_result* results, FILE* global) {
+    int* starts;                                        //  Primeira posição de cada lote (apenas com lotes de uma lista).
+    int positions[BATCH_MAX_LANES];                     //  Posições de um job que ainda precisam ser feitas.
+    sweep_context context;                              //  Ponteiros para os vetores, usados pelas threads.
+    pipeline_stats writers;                             //  Estatísticas da escrita assíncrona.
+    double total_cost;                                  //  Soma dos custos estimados dos jobs (para o ETA).
+    double phase;                                       //  Início da fase atual (--profile).
+    int n_pending;                                      //  Testes que ainda precisam ser feitos.
+    int n_jobs;                                         //  Número de jobs do sweep (testes ou lotes).
+    int status;
+    int i;
+
+    phase = settings->profiling ? profile_now() : 0.0;
+    context.settings = settings;
+    context.state = state;
+    context.n_tests = n_tests;
+    context.tests = tests;
+    context.b_values = b_values;
+    context.b_min = b_min;
+    context.b_step = b_step;
+    context.done = done;
+    context.results = results;
+    context.width = 1;
+    context.starts = NULL;
+    context.batches = 0;
+    context.drift_energy = 0.0;
+    context.drift_momentum = 0.0;
+    context.global = global;
+    context.flushed = time(NULL);
+    starts = NULL;
+    n_jobs = n_tests;
+
+    //      Com lotes (--simd), cada job é um grupo de até 'width' posições consecutivas: os lotes seguem a ordem dos
+    //  testes, então o arquivo global recebe cada lote inteiro na ordem dos índices. Com --grid, um lote nunca passa de
+    //  uma fatia para a outra (o último lote de cada fatia pode ficar incompleto). Nos testes da parte, cada fatia tem
+    //  o mesmo número de lotes (veja job_positions), e nas listas os lotes são montados aqui. O custo do lote é o do
+    //  seu teste mais caro.
+    if (settings->simd != SIMD_DESLIGADO) {
+        context.width = batch_width(settings->simd);
+        if (tests == NULL) {
+            context.batches = ((settings->n_impacts + settings->shard.count - 1) / settings->shard.count + context.width - 1) / context.width;
+            n_jobs = (int) settings->n_slices * context.batches;
+        } else {
+            starts = malloc(sizeof(int) * (n_tests + 1));
+            if (starts == NULL) {
+                printf("\nFalha ao alocar memória para o sweep.\n");
+                return 1;
             }
+            n_jobs = 0;
+            for (i = 0; i < n_tests; i++) {
+                if (i == 0 || i - starts[n_jobs - 1] == context.width || tests[i] / settings->n_impacts != tests[i - 1] / settings->n_impacts) starts[n_jobs++] = i;
+            }
+            starts[n_jobs] = n_tests;
+            context.starts = starts;
+        }
+    }
+    context.n_jobs = n_jobs;
+    context.n_slots = sweep_slots(settings->n_threads);
+    context.slots = malloc(sizeof(simulation_result) * context.n_slots * context.width);
+    if (context.slots == NULL) {
+        free(starts);
+        printf("\nFalha ao alocar memória para o sweep.\n");
+        return 1;
+    }
+
+    //      Escrita assíncrona: cada thread do sweep tem até 'width' trajetórias abertas ao mesmo tempo. Sem arquivos de
+    //  trajetória (a comparação da precisão mista) não há o que escrever.
+    if (settings->n_writers > 0 && settings->output_format != SAIDA_NENHUMA) {
+        state->pipeline = pipeline_start(settings->n_writers, settings->n_threads * context.width);
+        if (state->pipeline == NULL) {
+            free(starts);
+            free(context.slots);
+            printf("\nFalha ao iniciar as threads de escrita.\n");
+            return 1;
         }
+    }
+    total_cost = 0.0;
+    n_pending = 0;
+    for (i = 0; i < n_jobs; i++) {
+        total_cost += job_cost(i, &context);
+        n_pending += job_positions(&context, i, positions);
+    }
+    progress_begin(&context.progress, settings->progress_format, settings->progress_interval, n_jobs, n_pending, total_cost);
+    if (settings->profiling) {
+        profile_add(&state->profile, PERFIL_PREPARACAO, profile_now() - phase, 1);
+        phase = profile_now();
+    }
 
-        f--;
-        // ............................................................................................................
-        //          Realiza a integração numérica, conforme Eqs~(14-17).
-        div = r[1] * r[1] + r[2] * r[2];
-        r_temp[1] = r[1] + v[1] * dt;
-        r_temp[2] = r[2] + v[2] * dt;
-        v_temp[1] = v[1] - (CONSTANTE_GRAVITACIONAL * MASSA_MARTE * r[1] / (div * sqrt(div))) * dt;
-        v_temp[2] = v[2] - (CONSTANTE_GRAVITACIONAL * MASSA_MARTE * r[2] / (div * sqrt(div))) * dt;
-
-        //          Atualiza os estados.
-        r[1] = r_temp[1];
-        r[2] = r_temp[2];
-        v[1] = v_temp[1];
-        v[2] = v_temp[2];
-        // ............................................................................................................
-        //          Calcula a distância entre Marte e a sonda.
-        distance = sqrt(div);
-        if (distance < *d_min_value) *d_min_value = distance;
-        // ............................................................................................................
+    //      Os testes são distribuídos entre as threads (sweep.c), os mais longos primeiro. Cada trajetória é
+    //  independente e escreve apenas no seu arquivo e na sua posição do anel, e o arquivo global recebe os testes na
+    //  ordem dos índices, então o resultado é o mesmo da execução serial.
+    status = n_pending > 0 ? sweep_run(n_jobs, settings->n_threads, job_cost, run_test, report_progress, write_result, &context) : 0;
+    free(starts);
+    free(context.slots);
+    if (settings->profiling) {
+        profile_sweep(&state->profile, profile_now() - phase, settings->n_threads);
+        phase = profile_now();
     }
-    // ................................................................................................................
-    //          Fecha o arquivo de dados.
-    fclose(fo);
-    // ................................................................................................................
-    //          Calcula o ângulo de deflexão e a variação da velocidade relativa.
-    //  → Começamos com a velocidade de saída no infinito.
-    //  A velocidade atualmente armazenada em 'v' ainda apresenta um erro devido ao campo potenical de Marte; então,
-    //  a gente vai corrigir esse valor para o infinito, descontando a parcela associada a energia potencial gravitacional
-    //  com base na posição 'r' em que 'v' foi obtida.
-    //  O primeiro passo aqui é pegar a direção de 'v':
-    div = sqrt(v[1] * v[1] + v[2] * v[2]);
-    velocity_out_direction[1] = v[1] / div;
-    velocity_out_direction[2] = v[2] / div;
-    //  Na sequência, a gente calcula o módulo corrigido da velocidade no infinito.
-    div = sqrt(div * div - 2 * CONSTANTE_GRAVITACIONAL * MASSA_MARTE / sqrt(r[1] * r[1] + r[2] * r[2]));    // 'div' dentro da expressão é o módulo da velocidade.
-    velocity_out[1] = div * velocity_out_direction[1];
-    velocity_out[2] = div * velocity_out_direction[2];
-
-    //  → Como temos os vetores de entrada e saída no infinito, calculamos a variação dos módulos...
-    *delta_v_value = sqrt(velocity_out[1] * velocity_out[1] + velocity_out[2] * velocity_out[2]) - sqrt(velocity_in[1] * velocity_in[1] + velocity_in[2] * velocity_in[2]);
-
-    //  → E agora, calculamos o ângulo de deflexão...
-    *deflection_angle_value = (velocity_in[1] * velocity_out[1] + velocity_in[2] * velocity_out[2]) /
-        (sqrt(velocity_in[1] * velocity_in[1] + velocity_in[2] * velocity_in[2]) *
-            sqrt(velocity_out[1] * velocity_out[1] + velocity_out[2] * velocity_out[2]));
-
-    if (*deflection_angle_value > 1) *deflection_angle_value = 1.0;
-    if (*deflection_angle_value < -1) *deflection_angle_value = -1.0;
-
-    *deflection_angle_value = acos(*deflection_angle_value);
-
-    //  → Por fim, seta o tempo total usado para a integração.
-    *time_end = time;
+
+    //      Espera as últimas linhas serem escritas.
+    pipeline_stop(state->pipeline, &writers);
+    state->pipeline = NULL;
+    if (settings->profiling) profile_add(&state->profile, PERFIL_FINALIZACAO, profile_now() - phase, 1);
+    if (status < 0) {
+        printf("\nFalha ao iniciar as threads da simulação.\n");
+        return 1;
+    }
+    if (global != NULL) fflush(global);
+
+    progress_end(&context.progress, status == 1);
+    printf("\n\n");
+    if (settings->n_writers > 0 && settings->output_format != SAIDA_NENHUMA) report_writers(&writers);
+    if (settings->drift && status == 0) report_drift(context.drift_energy, context.drift_momentum);
+
+    return status == 1 ? 2 : 0;
+}
+// ....................................................................................................................
+//      Refinamento adaptativo: cada rodada é um sweep comum sobre os testes novos, então as threads, os lotes e a
+//  escrita das trajetórias funcionam como no sweep uniforme.
+int run_refinement(const run_settings* settings, run_state* state, const int n_coarse, double* b_values, simulation_result* results, FILE* global) {
+    refine_sample* samples;                             //  Amostras calculadas até agora (reordenadas pelo refine_select).
+    int* tests;                                         //  Índice de cada teste (tests[i] = i).
+    int n;                                              //  Testes já calculados (incluindo os da rodada atual).
+    int found;                                          //  Testes da rodada atual.
+    int round;
+    int status;
+    int i;
+
+    samples = malloc(sizeof(refine_sample) * settings->refine_budget);
+    tests = malloc(sizeof(int) * settings->refine_budget);
+    if (samples == NULL || tests == NULL) {
+        free(samples);
+        free(tests);
+        printf("\nFalha ao alocar memória para o refinamento.\n");
+        return 1;
+    }
+    for (i = 0; i < settings->refine_budget; i++) tests[i] = i;
+
+    n = n_coarse;
+    found = n_coarse;
+    round = 0;
+    while (1) {
+        status = run_simulations(settings, state, found, &tests[n - found], b_values, 0.0, 0.0, NULL, &results[n - found], global);
+        if (status != 0) break;
+        if (n == settings->refine_budget) {
+            printf("Orçamento do refinamento esgotado: %d trajetórias em %d rodadas.\n\n", n, round + 1);
+            break;
+        }
+
+        for (i = 0; i < n; i++) {
+            samples[i].b = results[i].b;
+            samples[i].values[0] = results[i].deflection_angle;
+            samples[i].values[1] = results[i].delta_v;
+            samples[i].collision = results[i].collision;
+            samples[i].level = state->levels[i];
+        }
+        found = refine_select(samples, n, settings->refine_tol, settings->refine_budget - n, &b_values[n], &state->levels[n]);
+        if (found < 0) {
+            printf("Falha ao alocar memória para o refinamento.\n");
+            status = 1;
+            break;
+        }
+        if (found == 0) {
+            printf("Nenhum intervalo passa do limiar: refinamento concluído com %d trajetórias em %d rodadas.\n\n", n, round + 1);
+            break;
+        }
+        n += found;
+        round++;
+        printf("Rodada %d do refinamento: %d trajetórias novas, até o nível %d (total: %d de %d) ... \n", round, found, state->levels[n - 1], n, settings->refine_budget);
+    }
+    free(samples);
+    free(tests);
+
+    return status;
+}
+// ....................................................................................................................
+//      Custo estimado de um job do sweep, para que as trajetórias mais longas sejam iniciadas primeiro. O de um lote é
+//  o do seu teste mais caro; os testes que já foram feitos (--resume) não custam nada.
+double job_cost(const int test, void* context) {
+    const sweep_context* sweep = context;
+    const run_settings* settings = sweep->settings;
+    int positions[BATCH_MAX_LANES];
+    double cost;
+    double lane;
+    int index;
+    int count;
+    int j;
+
+    cost = 0.0;
+    count = job_positions(sweep, test, positions);
+    for (j = 0; j < count; j++) {
+        index = sweep_test(sweep, positions[j]);
+        lane = estimate_cost(settings, test_b(sweep, index), &settings->slices[index / settings->n_impacts]);
+        if (lane > cost) cost = lane;
+    }
+    return cost;
+}
+// ....................................................................................................................
+//      Executa um job do sweep (chamada pelas threads do sweep.c). Os resultados vão para as posições do job no anel.
+void run_test(const int test, void* context) {
+    sweep_context* sweep = context;
+    const run_settings* settings = sweep->settings;
+    simulation_result* results = &sweep->slots[(test % sweep->n_slots) * sweep->width];
+    int positions[BATCH_MAX_LANES];
+    int tests[BATCH_MAX_LANES];
+    double b_values[BATCH_MAX_LANES];
+    int count;
+    int j;
+
+    progress_job_start(&sweep->progress);
+    count = job_positions(sweep, test, positions);
+    if (count == 0) {
+        progress_job_end(&sweep->progress, 0.0, 0);
+        return;
+    }
+
+    //  Com lotes, o job cobre até 'width' posições da mesma fatia.
+    for (j = 0; j < count; j++) {
+        tests[j] = sweep_test(sweep, positions[j]);
+        b_values[j] = test_b(sweep, tests[j]);
+    }
+    if (sweep->width > 1) simulate_batch(settings, sweep->state, count, tests, b_values, results);
+    else simulate(settings, sweep->state, tests[0], b_values[0], &settings->slices[tests[0] / settings->n_impacts], results);
+    progress_job_end(&sweep->progress, job_cost(test, context), count);
 }
 // ....................................................................................................................
-//      ** Função para mostrar o tempo no ETA em segundos, minutos, etc.
-//  Pode ignorar isso aqui; não dei muita atenção em manter organizado também...
-void format_time(double seconds, char *buffer) {
-    const int sec = (int) seconds;
-    if (sec < 60) {
-        sprintf(buffer, "%d segundos", sec);
-    } else if (sec < 3600) {
-        const int m = sec / 60;
-        const int s = sec % 60;
-        sprintf(buffer, "%d minutos e %d segundos", m, s);
-    } else if (sec < 86400) {
-        const int h = sec / 3600;
-        const int m = sec % 3600;
-        sprintf(buffer, "%d horas e %d minutos", h, m);
+//      Atualiza o progresso (progress.c), que só desenha alguma coisa algumas vezes por segundo. É chamada após cada
+//  job; o sweep.c garante que nunca rode em paralelo.
+void report_progress(const int test, const int done, void* context) {
+    sweep_context* sweep = context;
+    const run_settings* settings = sweep->settings;
+    run_state* state = sweep->state;
+    double phase;                                       //  Início da fase atual (--profile).
+    int drawn;
+
+    (void) test;
+    (void) done;
+
+    phase = settings->profiling ? profile_now() : 0.0;
+    drawn = progress_report(&sweep->progress, state->pipeline != NULL ? pipeline_depth(state->pipeline) : -1);
+    if (settings->profiling) profile_add(&state->profile, PERFIL_PROGRESSO, profile_now() - phase, drawn);
+}
+// ....................................................................................................................
+//      Escreve no arquivo global o(s) teste(s) de um job concluído e libera as suas posições do anel: os resultados vão
+//  para os redutores, para a deriva máxima e, no refinamento e na validação, para o vetor 'results'. O sweep.c chama
+//  esta função na ordem dos jobs (cada prefixo contíguo assim que ele termina), e os lotes seguem a ordem dos testes,
+//  então o arquivo é o mesmo com qualquer número de threads.
+void write_result(const int test, void* context) {
+    sweep_context* sweep = context;
+    const run_settings* settings = sweep->settings;
+    run_state* state = sweep->state;
+    const simulation_result* results = &sweep->slots[(test % sweep->n_slots) * sweep->width];
+    int positions[BATCH_MAX_LANES];
+    double phase;                                       //  Início da fase atual (--profile).
+    int count;
+    int j;
+
+    count = job_positions(sweep, test, positions);
+    for (j = 0; j < count; j++) {
+        //  As colisões ficam fora da deriva (veja report_drift).
+        if (settings->drift && !results[j].collision) {
+            if (results[j].drift_energy > sweep->drift_energy) sweep->drift_energy = results[j].drift_energy;
+            if (results[j].drift_momentum > sweep->drift_momentum) sweep->drift_momentum = results[j].drift_momentum;
+        }
+        if (sweep->results != NULL) sweep->results[positions[j]] = results[j];
+    }
+    if (sweep->global == NULL || count == 0) return;
+
+    //      O arquivo é descarregado no disco no máximo uma vez por segundo, para que os resultados parciais possam ser
+    //  lidos sem pagar um fflush por teste.
+    phase = settings->profiling ? profile_now() : 0.0;
+    for (j = 0; j < count; j++) {
+        write_global(settings, state->levels, sweep->global, sweep_test(sweep, positions[j]), &results[j]);
+        if (settings->reducing) reduce_result(&state->reducers, &results[j]);
+    }
+    if (time(NULL) != sweep->flushed) {
+        fflush(sweep->global);
+        sweep->flushed = time(NULL);
+    }
+    if (settings->profiling) profile_add(&state->profile, PERFIL_GLOBAL, profile_now() - phase, count);
+}
+// ....................................................................................................................
+int sweep_test(const void* context, const int position) {
+    const sweep_context* sweep = context;
+    const run_settings* settings = sweep->settings;
+
+    return sweep->tests != NULL ? sweep->tests[position] : settings->shard.index + position * settings->shard.count;
+}
+// ....................................................................................................................
+double test_b(const void* context, const int test) {
+    const sweep_context* sweep = context;
+    const run_settings* settings = sweep->settings;
+
+    if (sweep->b_values != NULL) return sweep->b_values[test];
+    return sweep->b_min + sweep->b_step * (test % settings->n_impacts);
+}
+// ....................................................................................................................
+//      Posições de um job. Nos lotes dos testes da parte, a fatia s começa na primeira posição com teste maior ou igual
+//  a s × n_impacts, e o job 'batches × s + c' cobre as posições c × width, ..., (c + 1) × width - 1 dela (alguns lotes
+//  do fim de uma fatia podem ficar vazios, quando a parte tem menos testes nela).
+int job_positions(const void* context, const int job, int* positions) {
+    const sweep_context* sweep = context;
+    const run_settings* settings = sweep->settings;
+    long start;                                         //  Primeira posição da fatia (e depois a do job).
+    long end;                                           //  Fim das posições do job.
+    int count;
+    long k;
+
+    if (sweep->width == 1) {
+        start = job;
+        end = job + 1;
+    } else if (sweep->starts != NULL) {
+        start = sweep->starts[job];
+        end = sweep->starts[job + 1];
     } else {
-        const int d = sec / 86400;
-        const int h = sec % 86400;
-        sprintf(buffer, "%d dias e %d minutos", d, h);
+        start = (long) (job / sweep->batches) * settings->n_impacts;
+        end = start + settings->n_impacts;
+        start = start > settings->shard.index ? (start - settings->shard.index + settings->shard.count - 1) / settings->shard.count : 0;
+        end = end > settings->shard.index ? (end - settings->shard.index + settings->shard.count - 1) / settings->shard.count : 0;
+        start += (long) (job % sweep->batches) * sweep->width;
+        if (end > sweep->n_tests) end = sweep->n_tests;
+        if (end > start + sweep->width) end = start + sweep->width;
     }
+
+    count = 0;
+    for (k = start; k < end; k++) if (!journal_done(sweep->done, sweep_test(sweep, (int) k))) positions[count++] = (int) k;
+    return count;
+}
+// ....................................................................................................................
+//      Linha do arquivo de dados globais.
+void write_global(const run_settings* settings, const int* levels, FILE* fo, const int test, const simulation_result* result) {
+    const grid_slice* slice = &settings->slices[test / settings->n_impacts];
+
+    fprintf(fo, "%d,%.15e,%.15e,%.15e,%.15e,%d,%.15e",
+        test + 1, result->b, result->d_min, result->delta_v, result->deflection_angle * RAD_TO_DEG, result->collision, result->time_end);
+    if (settings->config.integrator == INTEGRADOR_DOPRI5 && !settings->analytic) fprintf(fo, ",%ld,%ld", result->steps_accepted, result->steps_rejected);
+    if (settings->drift) fprintf(fo, ",%.15e,%.15e", result->drift_energy, result->drift_momentum);
+    if (settings->profiling) fprintf(fo, ",%lld,%.6e,%.6e,%s", result->steps, result->wall_time, result->wall_time > 0 ? (double) result->steps / result->wall_time : 0.0,
+        profile_stop_name(result->stop));
+    if (settings->grid.n_axes > 0) fprintf(fo, ",%d,%.15e,%.15e", test / settings->n_impacts, slice->parameters[0], slice->parameters[1]);
+    if (settings->refine_budget > 0) fprintf(fo, ",%d", levels[test]);
+    fprintf(fo, "\n");
+}
+// ....................................................................................................................
+void reduce_result(reducer_set* reducers, const simulation_result* result) {
+    double values[3];
+
+    values[0] = result->d_min;
+    values[1] = result->collision ? NAN : result->delta_v;
+    values[2] = result->collision ? NAN : result->deflection_angle * RAD_TO_DEG;
+    reducers_add(reducers, result->b, result->collision, values);
+}
+// ....................................................................................................................
+//      O journal_resume já deixou no arquivo apenas as linhas válidas, uma por teste. Os valores lidos são os do
+//  write_global (com 16 algarismos), então o estado dos redutores é o que eles teriam se esses testes tivessem acabado
+//  agora, a menos do arredondamento do último algarismo.
+int reduce_global(reducer_set* reducers, const char* path) {
+    char line[1024];
+    double values[3];
+    double b;
+    int collision;
+    FILE* fi;
+
+    fi = fopen(path, "r");
+    if (fi == NULL) return errno == ENOENT ? 0 : 1;
+    while (fgets(line, sizeof(line), fi) != NULL) {
+        if (sscanf(line, "%*d,%lf,%lf,%lf,%lf,%d", &b, &values[0], &values[1], &values[2], &collision) != 5) continue;
+        if (collision) values[1] = values[2] = NAN;
+        reducers_add(reducers, b, collision, values);
+    }
+    fclose(fi);
+    return 0;
+}
+// ....................................................................................................................
+//      Resumo da deriva. As colisões ficam de fora: elas param dentro de Marte, perto da singularidade do potencial, e o
+//  desvio delas não diz nada sobre o passo.
+void report_drift(const double energy, const double momentum) {
+    printf("Maior deriva relativa nos testes sem colisão: energia = %.4e, momento angular = %.4e\n\n", energy, momentum);
 }
-// ....................................................................................................................
\ No newline at end of file
+// ....................................................................................................................
+//      Estatísticas da escrita assíncrona.
+void report_writers(const pipeline_stats* stats) {
+    const double elapsed = stats->elapsed_seconds > 0 ? stats->elapsed_seconds : 1e-9;
+
+    printf("Escrita assíncrona: %ld trajetórias, %lld linhas e %.2f MB em %d thread(s) de escrita; %.3e linhas/s e %.2f MB/s ao longo da simulação.\n",
+        stats->trajectories, stats->rows, stats->bytes / 1e6, stats->writers, stats->rows / elapsed, stats->bytes / 1e6 / elapsed);
+    printf("\t Fila: %ld buffers enviados, profundidade média de %.2f e máxima de %d (pool de %d buffers com %d linhas).\n",
+        stats->buffers, stats->mean_depth, stats->max_depth, stats->pool, PIPELINE_LINHAS_POR_BUFFER);
+    printf("\t Escrita ocupada por %.3f s de %.3f s; a integração esperou por um buffer livre %ld vezes (%.3f s).\n\n",
+        stats->busy_seconds, elapsed, stats->waits, stats->wait_seconds);
+}
+// ....................................................................................................................
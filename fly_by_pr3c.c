@@ -7,26 +7,40 @@
 // ReSharper disable CppJoinDeclarationAndAssignment
 // ....................................................................................................................
 //      Bibliotecas:
+#include <errno.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <time.h>
+
+#include "cadence.h"
+#include "flyby3.h"
+#include "grid.h"
+#include "integrators.h"
+#include "journal.h"
+#include "nbody.h"
+#include "output.h"
+#include "philox.h"
+#include "profile.h"
+#include "progress.h"
+#include "reducers.h"
+#include "refine.h"
+#include "roots.h"
+#include "shard.h"
+#include "sweep.h"
 // ....................................................................................................................
 //      Constantes da simulação:
 //  → Definições gerais.
-#define N_DIMS 2                                        //  O número de dimensões do problema não deve ser alterado!!
-                                                        //  Como o problema do Fly-By foi desenvolvido em cima do plano
-                                                        //  de coordenadas polares, mudar esse valor não vai resultar
-                                                        //  em alterações na simulação; porém, caso isso seja menor do
-                                                        //  que 2, é provável que ocorra um erro na execução.
 
-#define NUMERO_DE_TESTES 240                            //  Número de testes balísticos que serão realizados na simulação
+#define NUMERO_DE_TESTES 240                            //  Número padrão de testes balísticos da simulação (opção --tests)
 
 #define STEPS_PARA_OUTPUT 180                           //  Valor base para definir a cada quantos steps de integração
-                                                        //  ocorrerá a exportação de dados e checagem dos critérios de parada.
+                                                        //  ocorrerá a exportação de dados (na cadência por tempo, o padrão).
                                                         //  Pense que para dt = 1 segundo isso é feito a cada STEPS_PARA_OUTPUT segundos.
+                                                        //  Os critérios de parada são verificados a cada passo.
 
 //  → Constantes e massas.
 #define CONSTANTE_GRAVITACIONAL 6.6743e-11              //  Constante gravitacional de Newton no sistema internacional.
@@ -37,49 +51,516 @@
 #define DISTANCIA_MARTE_SOL 2.2794e11                   //  Distância radial entre Marte e o Sol. (Em metros)
 #define RAIO_MARTE 3.3895E6                             //  Raio do planeta Marte. (Em metros)
 
+//  → Modo de busca (opção --target).
+#define ALVO_NENHUM 0                                   //  Sweep normal sobre os valores de b.
+#define ALVO_DEFLEXAO 1                                 //  Procura o b com o ângulo de deflexão pedido (em graus).
+#define ALVO_DV_HELIO 2                                 //  Procura o b com a variação de velocidade heliocêntrica pedida.
+#define ALVO_MAX_AVALIACOES 60                          //  Trajetórias integradas, no máximo, numa busca.
+#define ALVO_TOLERANCIA 1e-9                            //  Tolerância da busca em b, relativa ao intervalo [b_min, b_max].
+#define ALVO_SALTO 1e-6                                 //  Resíduo final, relativo à variação entre os extremos, acima
+                                                        //  do qual a solução é tratada como um salto da função.
+
+//  → Monte Carlo (opção --monte-carlo): erros de injeção sorteados em cada amostra, e os seus desvios padrão padrão
+//  (opção --dispersion).
+#define MC_B 0                                          //  Erro no parâmetro de impacto. (Em metros)
+#define MC_VELOCIDADE 1                                 //  Erro no módulo da velocidade de entrada. (Em metros por segundo)
+#define MC_DIRECAO 2                                    //  Erro na direção da velocidade de entrada. (Em graus)
+#define MC_FASE_MARTE 3                                 //  Erro no ângulo inicial de Marte. (Em graus)
+#define MC_ERROS 4                                      //  Número de erros sorteados.
+#define MC_SIGMA_B 1.0e3
+#define MC_SIGMA_VELOCIDADE 0.1
+#define MC_SIGMA_DIRECAO 1.0e-3
+#define MC_SIGMA_FASE_MARTE 1.0e-6                      //  Cerca de 4 km ao longo da órbita de Marte.
+#define MC_SEMENTE 1                                    //  Semente padrão (opção --seed).
+
 //  → Definições matemáticas
 #define DEG_TO_RAD 0.0174532925                         //  Relação para converter graus para radianos.
 #define RAD_TO_DEG 57.2957795                           //  Relação para converter radianos para graus.
 // ....................................................................................................................
+//      Resultados de um teste. É preenchida pela função simulate.
+typedef struct {
+    double b;                                       // [m]      - Parâmetro de impacto usado no teste.
+    double d_min;                                   // [m]      - Distância mínima encontrada entre a sonda e Marte.
+    double delta_v;                                 // [m/s]    - Variação de velocidade heliocêntrica da sonda.
+    double delta_v_rel;                             // [m/s]    - Variação de velocidade relativa da sonda.
+    double deflection_angle;                        // [rad]    - Ângulo de deflexão encontrado.
+    int collision;                                  //          - Indicador de colisão. É 0 caso não tenha ocorrido colisão; e 1 caso contrário.
+    double time_end;                                // [s]      - Tempo que levou para finalizar a simulação.
+    long steps_accepted;                            //          - Passos aceitos pelo integrador adaptativo (dopri5).
+    long steps_rejected;                            //          - Passos rejeitados pelo integrador adaptativo (dopri5).
+    double drift_jacobi;                            //          - Maior desvio da integral de Jacobi (--drift), em
+                                                    //            unidades de v_inf² / 2.
+    long long steps;                                //          - Passos de integração (no dopri5, aceitos e rejeitados).
+    double wall_time;                               // [s]      - Tempo de parede da trajetória.
+    int stop;                                       //          - Motivo do fim da trajetória (PARADA_*, veja profile.h).
+} simulation_result;
+
+//      Fatia do grid (--grid, veja grid.h): os parâmetros que não são o b, e as condições iniciais que dependem apenas
+//  deles. É calculada uma única vez por fatia no main, e lida (sem alterações) por todos os testes da fatia.
+typedef struct {
+    flyby3_conditions conditions;                   //          - Condições iniciais da fatia (veja flyby3.h); no Monte
+                                                    //            Carlo, com os erros de injeção da amostra.
+    double parameters[3];                           //          - r_factor, mars_init_angle e velocity_infinity como foram
+                                                    //            fornecidos (colunas do arquivo global com --grid).
+    double b;                                       // [m]      - Parâmetro de impacto da amostra (apenas com --monte-carlo).
+    double errors[MC_ERROS];                        //          - Erros de injeção da amostra (--monte-carlo; MC_*).
+} grid_slice;
+
+//      Configuração da execução. É preenchida pelo main a partir da linha de comando e lida (sem alterações) por todas
+//  as threads; a trajetória em si é a 'config' da libflyby (flyby3.h), com as condições iniciais de cada fatia.
+typedef struct {
+    char test_name[100];                            //          - Nome da pasta onde os dados temporais serão salvos.
+    grid_spec grid;                                 //          - Parâmetros variados com --grid (veja grid.h).
+    grid_slice* slices;                             //          - Fatias do grid (uma só sem --grid).
+    long n_slices;                                  //          - Número de fatias.
+    int n_impacts;                                  //          - Valores do parâmetro de impacto por fatia (--tests).
+    int total_tests;                                //          - Número de testes do sweep (fatias × valores de b).
+    int n_threads;                                  //          - Número de threads usadas no sweep.
+    flyby3_config config;                           //          - Tempo máximo, passo, integrador, formulação (--engine),
+                                                    //            tolerâncias do dopri5, cadência (--cadence, --rows) e
+                                                    //            deriva (--drift).
+    nbody_table bodies;                             //          - Corpos do motor de N corpos (--engine nbody; Marte com
+                                                    //            ângulo inicial 0). É a tabela da 'config'.
+    int output_format;                              //          - Formato dos arquivos de trajetória (SAIDA_*, veja output.h).
+    trajectory_store* store;                        //          - Arquivo binário das trajetórias (apenas com --output binary).
+    int n_writers;                                  //          - Threads de escrita assíncrona (--writers; 0 escreve na própria thread).
+    int resume;                                     //          - 1 para retomar uma execução interrompida (--resume, veja journal.h).
+    int target;                                     //          - Quantidade buscada com --target (ALVO_*).
+    double target_value;                            //          - Valor pedido para ela (graus ou m/s).
+    int refine_budget;                              //          - Orçamento de trajetórias do refinamento (--refine; 0 desliga).
+    double refine_tol;                              //          - Limiar do refinamento (--refine-tol, veja refine.h).
+    int profiling;                                  //          - 1 para medir o tempo de cada fase da execução (--profile).
+    int progress_format;                            //          - Formato do progresso (--progress, PROGRESSO_*).
+    double progress_interval;                       //          - Intervalo entre dois desenhos do progresso (0 usa o padrão).
+    int monte_carlo;                                //          - Amostras do Monte Carlo (--monte-carlo; 0 para o sweep normal).
+    double mc_sigma[MC_ERROS];                      //          - Desvio padrão de cada erro de injeção (--dispersion).
+    uint64_t mc_seed;                               //          - Semente do Philox (--seed).
+    int mc_trajectories;                            //          - 1 para escrever os arquivos de trajetória das amostras.
+    int reducing;                                   //          - 1 para resumir os resultados com os redutores (--reduce).
+    shard_spec shard;                               //          - Parte da execução integrada por este processo (--shard).
+} run_settings;
+
+//      Estado compartilhado da execução, que muda durante o sweep: a escrita assíncrona (de cada sweep), o perfil (que
+//  tem a sua trava), os redutores e os níveis do refinamento (escritos apenas pelo write_result e pelo main).
+typedef struct {
+    output_pipeline* pipeline;                      //          - Escrita assíncrona das trajetórias (NULL com --writers 0).
+    int* levels;                                    //          - Nível de refinamento de cada teste (apenas com --refine).
+    profile_counters profile;                       //          - Tempo de cada fase (veja profile.h).
+    reducer_set reducers;                           //          - Redutores de streaming dos resultados (veja reducers.h).
+} run_state;
+// ....................................................................................................................
 //      Funções auxiliares (aqui temos um "mini-header" dentro do arquivo *.c)
 //  - Faz a simulação física do problema para as condições passadas nos argumentos.
+//  const run_settings* settings            → Configuração da execução.
+//  run_state* state                        → Estado da execução (escrita assíncrona e perfil).
 //  const int test                          → Número de identificação do teste.
 //  const double b                          → Parâmetro de impacto.
-//  double* d_min_value                     → Referência: altera a distância mínima encontrada entre a sonda e Marte.
-//  double* delta_v_value                   → Referência: altera a variação de velocidade heliocêntrica da sonda.
-//  double* delta_v_value_rel               → Referência: altera a variação de velocidade relativa da sonda.
-//  double* deflection_angle_value          → Referência: altera o ângulo de deflexão encontrado.
-//  int* collision                          → Referência: altera o indicador de colisão. É 0 caso não tenha ocorrido colisão; e 1 caso contrário.
-//  double* time_end                        → Referência: altera o tempo em segundo que levou para finalizar a simulação.
+//  const grid_slice* slice                 → Fatia do grid do teste (velocidade, ângulo de Marte e raio de influência).
+//  simulation_result* result               → Referência: recebe os resultados do teste (veja a estrutura acima).
+void simulate(const run_settings* settings, run_state* state, int test, double b, const grid_slice* slice, simulation_result* result);
+
+//  - Destino das linhas da libflyby (flyby3_sink, veja flyby3.h; context é a saída da trajetória): adiciona a linha
+//  (t, posições de Marte e da sonda, velocidades de Marte e da sonda, d) à saída.
+void sink_row(const double* values, void* context);
+
+//  - Estima, de forma barata, o número de passos de integração de um teste. É usada apenas para ordenar os testes
+//  no sweep com várias threads (os mais caros começam primeiro).
+//  const run_settings* settings            → Configuração da execução (passo e integrador).
+//  const double b                          → Parâmetro de impacto.
+//  const grid_slice* slice                 → Fatia do grid do teste.
+double estimate_cost(const run_settings* settings, double b, const grid_slice* slice);
+
+//  - Integra os testes listados em 'tests' (ou os testes desta parte da execução) usando o sweep com várias threads
+//  (sweep.h) e mostra a barra de progresso. Os resultados ficam num anel de sweep_slots(n_threads) posições, então a
+//  memória não depende do número de testes. Retorna 0 em caso de sucesso, 2 se a execução foi interrompida
+//  (SIGINT/SIGTERM) antes de todos os testes e 1 em caso de erro.
+//  const run_settings* settings            → Configuração da execução.
+//  run_state* state                        → Estado da execução.
+//  int n_tests                             → Número de testes (de posições em 'tests', ou da parte, com 'tests' NULL).
+//  const int* tests                        → Índice de cada teste (NULL para shard.index + k × shard.count).
+//  const double* b_values                  → Parâmetro de impacto de todos os testes (NULL para calculá-lo pelo índice,
+//                                            com b_min e b_step; veja test_b).
+//  double b_min, double b_step             → Grade de b, usada quando b_values é NULL.
+//  const unsigned char* done               → Testes já concluídos, que são pulados (--resume, veja journal_done; pode
+//                                            ser NULL).
+//  simulation_result* results              → Recebe o resultado de cada teste, na posição do seu índice (pode ser NULL;
+//                                            apenas o --refine precisa de todos os resultados).
+//  FILE* global                            → Arquivo de dados globais, que recebe os testes na ordem dos índices, assim
+//                                            que todos os anteriores terminam.
+int run_simulations(const run_settings* settings, run_state* state, int n_tests, const int* tests, const double* b_values, double b_min, double b_step, const unsigned char* done,
+    simulation_result* results, FILE* global);
+
+//  - Refinamento adaptativo (--refine, veja refine.h): integra a grade inicial e, em rodadas, os pontos médios dos
+//  intervalos marcados pelo refine_select, até o orçamento acabar ou nada mais precisar ser refinado. Os testes novos
+//  ocupam as posições n_coarse, n_coarse + 1, ... dos vetores. Retorna o mesmo que o run_simulations.
+//  const run_settings* settings            → Configuração da execução.
+//  run_state* state                        → Estado da execução (recebe os níveis do refinamento).
+//  int n_coarse                            → Testes da grade inicial (--tests).
+//  double* b_values                        → Parâmetro de impacto de cada teste (recebe os valores das rodadas).
+//  simulation_result* results              → Recebe o resultado de cada teste.
+//  FILE* global                            → Arquivo de dados globais.
+int run_refinement(const run_settings* settings, run_state* state, int n_coarse, double* b_values, simulation_result* results, FILE* global);
+
+//  - Funções chamadas pelo sweep (sweep.h): estima o custo de um teste, executa o teste, atualiza a barra de progresso
+//  (na ordem em que os testes terminam) e escreve o teste no arquivo global (na ordem dos índices).
+double job_cost(int job, void* context);
+void run_test(int job, void* context);
+void report_progress(int job, int done, void* context);
+void write_result(int job, void* context);
+
+//  - Índice do teste de um job do sweep, e o parâmetro de impacto de um teste (de b_values, da amostra do Monte Carlo
+//  ou da grade b_min + b_step × (test % n_impacts)).
+int sweep_test(const void* context, int job);
+double test_b(const void* context, int test);
+
+//  - Escreve uma linha do arquivo de dados globais.
+//  const run_settings* settings            → Configuração da execução (colunas do arquivo).
+//  const int* levels                       → Nível de refinamento de cada teste (apenas com --refine).
+//  int test                                → Índice do teste (começa em 0).
+//  double b                                → Parâmetro de impacto do teste.
+//  const simulation_result* result         → Resultados do teste.
 //
-//  * Os valores passados como "referência" são saídas da função simulate alterados em espaços de memória pré-alocados.
-void simulate(int test, double b, double* d_min_value, double* delta_v_value, double* delta_v_value_rel, double* deflection_angle_value, int* collision, double* time_end);
+//  * Com --profile, a linha ganha os passos, o tempo de parede, os passos por segundo e o motivo do fim do teste; com
+//  --grid, ela termina com a fatia e os valores dos parâmetros dela; com --refine, com o nível de refinamento.
+void write_global(const run_settings* settings, const int* levels, FILE* fo, int test, double b, const simulation_result* result);
 
-//  - Isso aqui é só uma função extra para converter o tempo de ETA de segundos para um formato "melhor"
-//  Pode ignorar =D
-void format_time(double seconds, char *buffer);
-// ....................................................................................................................
-//      Alocação global de memória:
-char test_name[100];                                //  Nome da pasta onde os dados temporais serão salvos.
+//  - Verificação do --resume (veja journal.h; context é o run_settings): retorna 1 se o arquivo de trajetória do teste está completo.
+int trajectory_complete(int test, double time_end, void* context);
+
+//  - Acrescenta um teste aos redutores (--reduce, veja reducers.h): d_min, Δv, Δv relativo e deflexão (as três últimas
+//  apenas sem colisão).
+void reduce_result(reducer_set* reducers, double b, const simulation_result* result);
+
+//  - Na retomada, passa pelos redutores os testes que já estão no arquivo global. Retorna 0 em caso de sucesso.
+int reduce_global(reducer_set* reducers, const char* path);
+
+//  - Modo de busca (--target): procura pelo método de Brent (roots.h) o b entre b_min e b_max em que a deflexão, ou a
+//  variação de velocidade heliocêntrica, atinge o valor pedido. Cada avaliação é um teste, com o seu arquivo de
+//  trajetória e a sua linha no arquivo global.
+//  const run_settings* settings            → Configuração da execução.
+//  run_state* state                        → Estado da execução.
+//  FILE* global                            → Arquivo de dados globais.
+//  double b_min, double b_max              → Intervalo da busca (precisa conter uma mudança de sinal do resíduo).
+//  double* b_values                        → Recebe o b de cada avaliação (ALVO_MAX_AVALIACOES posições).
+//  simulation_result* results              → Recebe o resultado de cada avaliação (idem).
+//
+//  * Retorna 0 em caso de sucesso.
+int run_target(const run_settings* settings, run_state* state, FILE* global, double b_min, double b_max, double* b_values, simulation_result* results);
 
-double mars_angle_init;                             //  Posição angular inicial de Marte.
-double r_factor;                                    //  Fator que multiplica R_Marte para definir a esfera de influência do planeta.
-double v_sonda_init;                                //  Módulo da velocidade inicial da sonda.
-double max_int_time;                                //  Tempo total de simulação (critério de parada de emergência)
-double dt;                                          //  Timestep de integração.
-double stop_value;                                  //  Fator de parada da simulação. (em relação a órbitas de Marte)
+//  - Integra a trajetória de parâmetro de impacto b e retorna a quantidade buscada menos o valor pedido (NaN quando
+//  ela não está definida, como o Δv de uma colisão). É a função passada para o brent_solve.
+double target_residual(double b, void* context);
 
-int steps_to_output;                                //  Passos de integração para a exportação.
+//  - Lê um desvio padrão do Monte Carlo no formato nome=valor (--dispersion) para a sua posição de 'sigma'. Retorna 0,
+//  ou -1 se for inválido.
+int dispersion_parse(double sigma[], const char* text);
+
+//  - Sorteia os erros de injeção da amostra 'sample' do Monte Carlo (philox.h) e os aplica à fatia, que chega com as
+//  condições nominais. Retorna o parâmetro de impacto da amostra.
+//  const run_settings* settings            → Configuração da execução (semente e desvios padrão).
+//  grid_slice* slice                       → Fatia da amostra.
+//  int sample                              → Índice da amostra (o contador do Philox).
+//  double b                                → Parâmetro de impacto nominal.
+double monte_carlo_sample(const run_settings* settings, grid_slice* slice, int sample, double b);
+
+//  - Lê as amostras do arquivo global (inclusive as de uma execução retomada), imprime a probabilidade de colisão e as
+//  distribuições de d_min, Δv e deflexão, e as grava em montecarlo_pr3c.csv. Retorna 0 em caso de sucesso.
+int report_monte_carlo(const run_settings* settings);
+
+//  - Quantil p de um vetor ordenado, com interpolação linear.
+double quantile(const double* sorted, int n, double p);
+
+//  - Ordena números (qsort).
+int compare_doubles(const void* a, const void* b);
+
+//  - Imprime as estatísticas da escrita assíncrona (--writers): profundidade da fila, espera por buffers e vazão.
+void report_writers(const pipeline_stats* stats);
+
+//  - Imprime a maior deriva da integral de Jacobi entre os testes do sweep sem colisão (--drift), acumulada pelo
+//  write_result.
+void report_drift(double jacobi);
+// ....................................................................................................................
+//      Dados do sweep. Cada teste escreve apenas na sua posição do anel de resultados (job % n_slots, que o sweep.c só
+//  reaproveita depois do write_result), então não é preciso nenhuma trava. O arquivo global, o vetor 'results' e a
+//  deriva só são escritos pelo write_result, que o sweep.c nunca roda em paralelo.
+typedef struct {
+    const run_settings* settings;                   //  Configuração da execução.
+    run_state* state;                               //  Estado compartilhado da execução.
+    int n_tests;                                    //  Número de jobs do sweep.
+    const int* tests;                               //  Índice de cada teste do sweep (NULL para os testes da parte).
+    const double* b_values;                         //  Parâmetro de impacto de todos os testes (NULL: calculado pelo índice).
+    double b_min;                                   //  Grade de b, usada quando b_values é NULL.
+    double b_step;
+    const unsigned char* done;                      //  Testes já concluídos (--resume; NULL sem retomada).
+    simulation_result* slots;                       //  Anel com os resultados dos testes em aberto.
+    int n_slots;                                    //  Posições do anel (sweep_slots).
+    simulation_result* results;                     //  Resultados de todos os testes, pelo índice (ou NULL).
+    double drift;                                   //  Maior deriva entre os testes sem colisão (--drift).
+    FILE* global;                                   //  Arquivo de dados globais.
+    time_t flushed;                                 //  Última vez em que o arquivo global foi descarregado no disco.
+    progress_state progress;                        //  Progresso do sweep (barra de progresso, veja progress.h).
+} sweep_context;
+
+//      Dados da busca (--target), repassados para o target_residual.
+typedef struct {
+    const run_settings* settings;                   //  Configuração da execução.
+    run_state* state;                               //  Estado compartilhado da execução.
+    FILE* global;                                   //  Arquivo de dados globais.
+    double* b_values;                               //  Parâmetro de impacto de cada avaliação.
+    simulation_result* results;                     //  Resultados de cada avaliação.
+    double* residuals;                              //  Resíduo de cada avaliação.
+    int n;                                          //  Avaliações feitas até agora.
+} target_context;
 // ....................................................................................................................
 //      Função de entrada do programa:
-//  Compilação: gcc fly_by.c -lm -o fly_by
+//  Compilação: gcc fly_by_pr3c.c sweep.c integrators.c -lm -lpthread -o fly_by_pr3c
 //  Permissão: chmod +x fly_by
-//  Execução: ./fly_by [test_name] [x_init_factor] [mars_init_angle] [velocity_infinity] [b_min_factor] [b_max_factor] [max_time] [dt]
+//  Execução: ./fly_by [test_name] [x_init_factor] [mars_init_angle] [velocity_infinity] [b_min_factor] [b_max_factor] [max_time] [dt] [opções]
 int main(const int argc, const char *argv[]) {
+    // ................................................................................................................
+    //      Declara as variáveis locais.
+    run_settings settings;                              //              - Configuração da execução (linha de comando).
+    run_state state;                                    //              - Estado compartilhado da execução.
+    double* b_values;                                   // [m]          - Parâmetro de impacto de cada teste (só com
+                                                        //              --refine e --target; no sweep ele vem do índice).
+    simulation_result* results;                         //              - Resultados de cada teste (distância mínima,
+                                                        //              variações de velocidade, deflexão, colisão, tempo).
+    int status;                                         //              - Retorno do sweep.
+
+    double min_b_factor;                                // [m]          - Fator mínimo para o parâmetro b
+    double max_b_factor;                                // [m]          - Fator máximo para o parâmetro b
+    double b_step;                                      // [m]          - "Passo" entre os valores max e min de b.
+    int n_coarse;                                       //              - Valores de b da grade uniforme (--tests).
+    double r_factor;                                    //              - Fator do raio de influência (argumento posicional).
+    double mars_angle;                                  // [graus]      - Ângulo inicial de Marte (argumento posicional).
+    double v_infinity;                                  // [m/s]        - Velocidade no infinito (argumento posicional).
+    grid_slice* slice;                                  //              - Fatia do grid sendo preparada.
+    const char* grid_names[3];                          //              - Parâmetros que podem ser variados com --grid.
+    const char* reducer_names[4];                       //              - Quantidades dos redutores (--reduce).
+    double b_low;                                       // [m]          - Intervalo de b dos redutores.
+    double b_high;
+    const char* invalid;                                //              - Parâmetro do --grid desconhecido.
+
+    unsigned char* done;                                //              - Um bit por teste já concluído (apenas com --resume).
+    long n_done;                                        //              - Testes recuperados do arquivo global.
+    const char* neutral[4];                             //              - Opções que podem mudar na retomada.
+    char* end;                                          //              - Fim do número lido em --target.
+    const char* bodies_path;                            //              - Arquivo com os corpos adicionais (--bodies).
+
+    const char* args[9];                                //              - Argumentos posicionais (args[0] é o programa).
+    int n_args;                                         //              - Número de argumentos posicionais encontrados.
+
+    int i;                                              //              - Variável para iterações em primeiro nível.
+
+    char filename[200];                                 //              - Nome do arquivo onde os dados globais serão salvos.
+    FILE *fo;                                           //              - Ponteiro para o arquivo onde os dados serão salvos.
+    // ................................................................................................................
+    //      Separa os argumentos posicionais das opções (que começam com "--"). As opções podem aparecer em qualquer
+    //  posição da linha de comando.
+    args[0] = argv[0];
+    n_args = 0;
+    settings.n_impacts = NUMERO_DE_TESTES;
+    settings.grid.n_axes = 0;
+    settings.n_threads = 1;
+    //  A trajetória começa com os padrões da libflyby (Euler na formulação polar, cadência por tempo e as tolerâncias
+    //  do dopri5); o tempo máximo e o passo vêm dos argumentos posicionais, e as condições iniciais, de cada fatia.
+    settings.config = flyby3_default_config(0.0, 0.0);
+    bodies_path = NULL;
+    settings.output_format = SAIDA_CSV;
+    settings.store = NULL;
+    settings.n_writers = 1;
+    state.pipeline = NULL;
+    settings.resume = 0;
+    settings.target = ALVO_NENHUM;
+    settings.target_value = 0.0;
+    settings.profiling = 0;
+    settings.progress_format = PROGRESSO_AUTO;
+    settings.progress_interval = 0.0;
+    settings.refine_budget = 0;
+    settings.refine_tol = REFINAMENTO_LIMIAR;
+    settings.monte_carlo = 0;
+    settings.mc_sigma[MC_B] = MC_SIGMA_B;
+    settings.mc_sigma[MC_VELOCIDADE] = MC_SIGMA_VELOCIDADE;
+    settings.mc_sigma[MC_DIRECAO] = MC_SIGMA_DIRECAO;
+    settings.mc_sigma[MC_FASE_MARTE] = MC_SIGMA_FASE_MARTE;
+    settings.mc_seed = MC_SEMENTE;
+    settings.mc_trajectories = 0;
+    settings.reducing = 0;
+    settings.shard.index = 0;
+    settings.shard.count = 1;
+    state.levels = NULL;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--tests") == 0 && i + 1 < argc) {
+            settings.n_impacts = (int) strtol(argv[++i], NULL, 10);
+            if (settings.n_impacts < 2) {
+                printf("O número de testes (--tests) precisa ser maior ou igual a 2.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--grid") == 0 && i + 1 < argc) {
+            status = grid_add(&settings.grid, argv[++i]);
+            if (status != 0) {
+                if (status == -1) printf("Intervalo inválido (--grid): %s. Use nome=min:max:n, por exemplo velocity_infinity=2000:3000:11.\n", argv[i]);
+                else printf("Parâmetro repetido ou grid com mais de %d parâmetros (--grid): %s.\n", GRID_MAX_EIXOS, argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            settings.n_threads = (int) strtol(argv[++i], NULL, 10);
+            if (settings.n_threads < 1) {
+                printf("O número de threads (--threads) precisa ser maior ou igual a 1.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--integrator") == 0 && i + 1 < argc) {
+            settings.config.integrator = integrator_parse(argv[++i]);
+            if (settings.config.integrator < 0) {
+                printf("Integrador desconhecido (--integrator): %s. Use euler, leapfrog, rk4, yoshida ou dopri5.\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "polar") == 0) settings.config.engine = FORMULACAO_POLAR;
+            else if (strcmp(argv[i], "cartesian") == 0) settings.config.engine = FORMULACAO_CARTESIANA;
+            else if (strcmp(argv[i], "nbody") == 0) settings.config.engine = FORMULACAO_NBODY;
+            else {
+                printf("Formulação desconhecida (--engine): %s. Use polar, cartesian ou nbody.\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--bodies") == 0 && i + 1 < argc) {
+            bodies_path = argv[++i];
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            settings.output_format = output_parse(argv[++i]);
+            if (settings.output_format < 0) {
+                printf("Formato desconhecido (--output): %s. Use csv, binary ou none.\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--writers") == 0 && i + 1 < argc) {
+            settings.n_writers = (int) strtol(argv[++i], NULL, 10);
+            if (settings.n_writers < 0) {
+                printf("O número de threads de escrita (--writers) não pode ser negativo.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--cadence") == 0 && i + 1 < argc) {
+            settings.config.cadence = cadence_parse(argv[++i]);
+            if (settings.config.cadence < 0) {
+                printf("Cadência desconhecida (--cadence): %s. Use time, arc ou distance.\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--rows") == 0 && i + 1 < argc) {
+            settings.config.rows = strtol(argv[++i], NULL, 10);
+            if (settings.config.rows < 2) {
+                printf("O orçamento de linhas (--rows) precisa ser maior ou igual a 2.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--drift") == 0) {
+            settings.config.drift = 1;
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            settings.profiling = 1;
+        } else if (strcmp(argv[i], "--progress") == 0 && i + 1 < argc) {
+            settings.progress_format = progress_mode(argv[++i]);
+            if (settings.progress_format < 0) {
+                printf("Formato de progresso desconhecido (--progress): %s. Use auto, bar, json ou none.\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--progress-interval") == 0 && i + 1 < argc) {
+            settings.progress_interval = strtod(argv[++i], NULL);
+            if (!(settings.progress_interval > 0)) {
+                printf("O intervalo do progresso (--progress-interval) precisa ser positivo.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--resume") == 0) {
+            settings.resume = 1;
+        } else if (strcmp(argv[i], "--target") == 0 && i + 1 < argc) {
+            i++;
+            if (strncmp(argv[i], "deflection=", 11) == 0) settings.target = ALVO_DEFLEXAO;
+            else if (strncmp(argv[i], "dv_helio=", 9) == 0) settings.target = ALVO_DV_HELIO;
+            else settings.target = ALVO_NENHUM;
+            if (settings.target != ALVO_NENHUM) settings.target_value = strtod(strchr(argv[i], '=') + 1, &end);
+            if (settings.target == ALVO_NENHUM || end == strchr(argv[i], '=') + 1 || *end != '\0') {
+                printf("Busca inválida (--target): %s. Use deflection=<graus> ou dv_helio=<m/s>.\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--refine") == 0 && i + 1 < argc) {
+            settings.refine_budget = (int) strtol(argv[++i], NULL, 10);
+            if (settings.refine_budget < 2) {
+                printf("O orçamento de trajetórias (--refine) precisa ser maior ou igual a 2.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--refine-tol") == 0 && i + 1 < argc) {
+            settings.refine_tol = strtod(argv[++i], NULL);
+            if (!(settings.refine_tol > 0)) {
+                printf("O limiar do refinamento (--refine-tol) precisa ser positivo.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--monte-carlo") == 0 && i + 1 < argc) {
+            settings.monte_carlo = (int) strtol(argv[++i], NULL, 10);
+            if (settings.monte_carlo < 2) {
+                printf("O número de amostras (--monte-carlo) precisa ser maior ou igual a 2.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--dispersion") == 0 && i + 1 < argc) {
+            if (dispersion_parse(settings.mc_sigma, argv[++i]) != 0) {
+                printf("Dispersão inválida (--dispersion): %s. Use b=<m>, velocity=<m/s>, direction=<graus> ou mars_angle=<graus>, com valores não negativos.\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            settings.mc_seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--mc-trajectories") == 0) {
+            settings.mc_trajectories = 1;
+        } else if (strcmp(argv[i], "--reduce") == 0) {
+            settings.reducing = 1;
+        } else if (strcmp(argv[i], "--shard") == 0 && i + 1 < argc) {
+            if (shard_parse(argv[++i], &settings.shard) != 0) {
+                printf("Parte inválida (--shard): %s. Use k/N, com 0 <= k < N (por exemplo 0/4, 1/4, 2/4 e 3/4).\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--rtol") == 0 && i + 1 < argc) {
+            settings.config.tol_rel = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--atol") == 0 && i + 1 < argc) {
+            settings.config.tol_abs = strtod(argv[++i], NULL);
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            printf("Opção desconhecida (ou sem valor): %s\n", argv[i]);
+            return 1;
+        } else {
+            if (n_args < 8) args[n_args + 1] = argv[i];
+            n_args++;
+        }
+    }
+    if (settings.config.tol_rel < 0 || settings.config.tol_abs < 0 || settings.config.tol_rel + settings.config.tol_abs <= 0) {
+        printf("As tolerâncias --rtol e --atol não podem ser negativas, e pelo menos uma delas precisa ser positiva.\n");
+        return 1;
+    }
+    if (bodies_path != NULL && settings.config.engine != FORMULACAO_NBODY) {
+        printf("A tabela de corpos (--bodies) só é usada com --engine nbody.\n");
+        return 1;
+    }
+    if (settings.config.engine == FORMULACAO_NBODY && settings.config.integrator == INTEGRADOR_DOPRI5) {
+        printf("O motor de N corpos (--engine nbody) funciona com os integradores de passo fixo (euler, leapfrog, rk4 e yoshida).\n");
+        return 1;
+    }
+    if (settings.target != ALVO_NENHUM && (settings.grid.n_axes > 0 || settings.resume)) {
+        printf("O modo de busca (--target) não pode ser usado junto com --grid ou --resume.\n");
+        return 1;
+    }
+    if (settings.refine_budget > 0 && (settings.grid.n_axes > 0 || settings.resume || settings.target != ALVO_NENHUM)) {
+        printf("O refinamento adaptativo (--refine) não pode ser usado junto com --grid, --resume ou --target.\n");
+        return 1;
+    }
+    if (settings.monte_carlo > 0 && (settings.grid.n_axes > 0 || settings.target != ALVO_NENHUM || settings.refine_budget > 0)) {
+        printf("O Monte Carlo (--monte-carlo) não pode ser usado junto com --grid, --target ou --refine.\n");
+        return 1;
+    }
+    if (settings.shard.count > 1 && (settings.target != ALVO_NENHUM || settings.refine_budget > 0)) {
+        printf("A execução em partes (--shard) não pode ser usada junto com --target ou --refine (os testes de uma rodada dependem dos anteriores).\n");
+        return 1;
+    }
+    if (settings.refine_budget > 0 && settings.refine_budget < settings.n_impacts) {
+        printf("O orçamento de trajetórias (--refine) precisa ser maior ou igual ao número de testes (--tests: %d).\n", settings.n_impacts);
+        return 1;
+    }
     // ................................................................................................................
     //      Verifica o número de argumentos do input.
-    if (argc != 9) {
-        printf("Use: %s <test_name> <x_init_factor> <velocity_infinity> <b_min_factor> <b_max_factor> <max_time> <dt>\n",
+    if (n_args != 8) {
+        printf("Use: %s <test_name> <r_factor> <mars_init_angle> <velocity_infinity> <b_min_factor> <b_max_factor> <max_time> <dt> [opções]\n",
             argv[0]);
         printf("- <test_name>: Nome do teste, e da pasta onde a saída será salva.\n");
         printf("- <r_factor>: Fator multiplicando R_Marte que define o raio de influência do planeta. No trabalho usamos um valor igual a 50.\n");
@@ -88,79 +569,166 @@ int main(const int argc, const char *argv[]) {
         printf("- <b_min_factor>: Fator mínimo usado na definição do intervalo de valores para o parâmetro de impacto. No trabalho usamos um valor igual a -10\n");
         printf("- <b_max_factor>: Fator máximo usado na definição do intervalo de valores para o parâmetro de impacto. No trabalho usamos um valor igual a 10.\n");
         printf("- <max_time>: Critério de parada de emergência. É o tempo máximo que pode ser gasto com a integração antes dela ser abortada, sem segundos. No trabalho foi utilizado 10e10 segundos.\n");
-        printf("- <dt>: Passo temporal utilizado na integração, em segundos. Não deve ser muito grande já que é usado o método de Euler. No trabalho foi utilizado 0,001 s.\n");
+        printf("- <dt>: Passo temporal utilizado na integração, em segundos. Com o método de Euler (padrão) não deve ser muito grande. No trabalho foi utilizado 0,001 s.\n");
+        printf("Opções:\n");
+        printf("- --tests <N>: Número de valores do parâmetro de impacto, igualmente espaçados entre os dois fatores (padrão: %d).\n", NUMERO_DE_TESTES);
+        printf("- --grid <nome>=<min>:<max>:<n>: Troca o argumento posicional <nome> (r_factor, mars_init_angle ou velocity_infinity) por n valores igualmente espaçados. Pode ser repetida; o sweep cobre o produto cartesiano de todos os intervalos e de b.\n");
+        printf("- --threads <N>: Número de threads usadas para simular as trajetórias em paralelo (padrão: 1). O resultado é idêntico ao da execução serial.\n");
+        printf("- --integrator <método>: Método de integração: euler (padrão, 1ª ordem), leapfrog (velocity-Verlet, 2ª ordem), rk4 (Runge-Kutta clássico) ou yoshida (Forest-Ruth, 4ª ordem) ou dopri5 (Dormand-Prince 5(4) com passo adaptativo; nesse caso <dt> é só o passo inicial). Os métodos de ordem alta permitem um dt muito maior.\n");
+        printf("- --engine <formulação>: Estado integrado pelo euler e pelo rk4: polar (padrão, Eqs. 34-38 do relatório) ou cartesian (posição e velocidade cartesianas heliocêntricas; no euler o passo usa só multiplicações, somas e uma raiz por corpo). O leapfrog e o yoshida sempre usam o estado cartesiano. Com nbody, todos os integradores de passo fixo usam o motor de N corpos (nbody.c), com o Sol parado, Marte na órbita circular e os corpos de --bodies; só com o Sol e Marte, o resultado é o do cartesian a menos do arredondamento das rotações de Marte.\n");
+        printf("- --bodies <arquivo>: Corpos adicionais do --engine nbody, um por linha: <nome> fixed <massa> <raio> <x> <y>, <nome> circular <massa> <raio> <centro> <raio da órbita> <ângulo inicial em graus> ou <nome> integrated <massa> <raio> <x> <y> <v_x> <v_y> (unidades SI; o centro é sol, marte ou um corpo anterior do arquivo; '#' começa um comentário). Uma colisão com um corpo de raio positivo termina a trajetória com collision = 1.\n");
+        printf("- --output <formato>: Formato dos arquivos de trajetória: csv (padrão, um arquivo data_NNN.csv por teste), binary (um único arquivo pr3c/trajectories.bin, com colunas float64 que podem ser lidas por mmap; veja output.h) ou none (nenhum arquivo de trajetória, apenas o arquivo global).\n");
+        printf("- --writers <N>: Threads que formatam e gravam os arquivos de trajetória enquanto a integração continua (padrão: 1). Com 0 as linhas são escritas pela própria thread que integra, como antes.\n");
+        printf("- --cadence <política>: Quando as linhas dos arquivos de trajetória são exportadas: time (padrão, a cada %d segundos), arc (pelo ângulo que a trajetória relativa a Marte faz, concentrando as linhas no periapsis) ou distance (uniformes no logaritmo da distância a Marte). Os critérios de parada são verificados a cada passo em todos os casos.\n", STEPS_PARA_OUTPUT);
+        printf("- --rows <N>: Orçamento de linhas por trajetória (padrão: %d com arc e distance; sem limite com time). O estado final é sempre a última linha.\n", CADENCIA_LINHAS_PADRAO);
+        printf("- --target <quantidade>=<valor>: Em vez do sweep, procura o b entre os dois fatores em que deflection (o ângulo de deflexão, em graus) ou dv_helio (a variação de velocidade heliocêntrica, em m/s) atinge o valor pedido, pelo método de Brent. Os valores nos dois extremos precisam ficar em lados opostos do valor pedido. Cada trajetória integrada na busca é salva como um teste; --tests é ignorada.\n");
+        printf("- --refine <N>: Refinamento adaptativo de b: começa com a grade de --tests valores e, em rodadas, divide ao meio os intervalos em que a colisão muda ou a deflexão/Δv heliocêntrico variam mais que o limiar, até N trajetórias no total. O arquivo global ganha a coluna 'level' (0 na grade inicial).\n");
+        printf("- --refine-tol <fração>: Limiar do --refine, em fração da variação total da deflexão e do Δv, aplicado à diferença e à curvatura entre amostras vizinhas (padrão: %.2f).\n", REFINAMENTO_LIMIAR);
+        printf("- --drift: Mede, a cada passo, o desvio da integral de Jacobi (a energia no referencial que gira com Marte, constante com o Sol fixo e a órbita circular de Marte) em relação ao valor inicial, em unidades de v_inf²/2, e escreve o maior na coluna drift_jacobi do arquivo global. Serve para escolher o maior dt com erro aceitável.\n");
+        printf("- --profile: Mede o tempo de parede de cada fase (integração, linhas e arquivos de trajetória, arquivo global, barra de progresso) e imprime uma tabela no fim. O arquivo global ganha as colunas steps, wall_time, steps_per_s e stop (collision, soi ou max_time).\n");
+        printf("- --reduce: Resume os resultados com redutores de streaming, de memória fixa: média, desvio padrão e quantis aproximados (erro relativo de %.0f%%) de d_min, Δv, Δv relativo e deflexão, probabilidade de colisão, histograma 2-D de b × deflexão e os intervalos de b em que a colisão muda. Grava reduce_pr3c.csv, histogram_pr3c.csv, boundary_pr3c.csv e o estado reducers_pr3c.txt, que pode ser combinado com o de outras execuções. Junto com --output none, serve para ensembles grandes sem nenhum arquivo por trajetória.\n", 100 * REDUTOR_ERRO_RELATIVO);
+        printf("- --shard <k>/<N>: Integra apenas a parte k (de 0 a N-1) dos testes, os de índice i com i %% N = k (intercalados por todo o intervalo de b e pelo grid), na pasta <test_name>/shard_<k>_of_<N>. Cada parte pode rodar num processo ou numa máquina diferente, com os mesmos argumentos; o flyby_merge junta as partes em <test_name>, como uma execução num único processo. Não pode ser usada com --target ou --refine.\n");
+        printf("- --progress <formato>: Como o progresso do sweep é mostrado: auto (padrão; a barra num terminal e registros JSON, um por linha, quando a saída vai para um arquivo ou um pipe), bar, json ou none. O ETA é ponderado pelo custo estimado das trajetórias.\n");
+        printf("- --progress-interval <s>: Intervalo mínimo entre dois desenhos do progresso, em segundos (padrão: %.2f para a barra e %.0f para o JSON).\n", PROGRESSO_INTERVALO_BARRA, PROGRESSO_INTERVALO_JSON);
+        printf("- --resume: Continua uma execução interrompida (Ctrl-C, SIGTERM ou queda) na mesma pasta, com os mesmos argumentos (apenas --threads, --writers e as opções do progresso podem mudar). Os testes já salvos são mantidos, e os que ficaram pela metade são refeitos.\n");
+        printf("- --monte-carlo <N>: Em vez do sweep, integra N amostras com erros de injeção sorteados em torno do b nominal (o centro do intervalo entre os dois fatores; use o mesmo valor nos dois para um b exato): no parâmetro de impacto, no módulo e na direção da velocidade de entrada e no ângulo inicial de Marte (a sonda continua apontada para a posição nominal). Os sorteios usam um gerador baseado em contador (Philox), então cada amostra é a mesma com qualquer número de threads. O arquivo global ganha as colunas dos erros, e no fim são impressas a probabilidade de colisão e as distribuições de d_min, Δv e deflexão (também em montecarlo_pr3c.csv). --tests é ignorada.\n");
+        printf("- --dispersion <erro>=<σ>: Desvio padrão de um erro do Monte Carlo: b (m, padrão %.0e), velocity (m/s, padrão %.1f), direction (graus, padrão %.0e) ou mars_angle (graus, padrão %.0e). Pode ser repetida; 0 desliga o erro.\n",
+            MC_SIGMA_B, MC_SIGMA_VELOCIDADE, MC_SIGMA_DIRECAO, MC_SIGMA_FASE_MARTE);
+        printf("- --seed <S>: Semente do Monte Carlo (padrão: %d).\n", MC_SEMENTE);
+        printf("- --mc-trajectories: Escreve os arquivos de trajetória das amostras do Monte Carlo, no formato de --output (sem essa opção, apenas o arquivo global é escrito).\n");
+        printf("- --rtol <valor>, --atol <valor>: Tolerâncias relativa e absoluta (em metros e metros por segundo) do dopri5 (padrão: 1e-10 e 1e-6). O dopri5 integra o estado relativo a Marte, então as tolerâncias valem para ele.\n");
         return 1;
     }
     // ................................................................................................................
-    //      Declara as variáveis locais.
-    double d_values[NUMERO_DE_TESTES];                  // [m]          - Distância relativa mínima entre a sonda e
-                                                        //              Marte registrada para um teste.
-    double b_values[NUMERO_DE_TESTES];                  // [m]          - Parâmetro de impacto usado no teste.
-    double var_velocidade_rel[NUMERO_DE_TESTES];        // [m/s]        - Variação do módulo da velocidade relativa de
-                                                        //              entrada e de saída da sonda no processo.
-    double var_velocidade_helio[NUMERO_DE_TESTES];      // [m/s]        - Variação do módulo da velocidade heliocêntrica da sonda.
-    double deflection_angle[NUMERO_DE_TESTES];          // [º]          - Ângulo de deflexão entre a sonda e Marte.
-    double times[NUMERO_DE_TESTES];                     // [s]          - Tempo total que cada simulação utilizou, em segundos.
-    int collision[NUMERO_DE_TESTES];                    //              - Indicador de colisão. É 1 caso tenha ocorrido
-                                                        //              - uma colisão da sonda com Marte, e 0 caso contrário.
-
-    int i;                                              //              - Variável para iterações em primeiro nível.
-    int j;                                              //              - Variável para iterações em segundo nível.
-
-    double min_b_factor;                                // [m]          - Fator mínimo para o parâmetro b
-    double max_b_factor;                                // [m]          - Fator máximo para o parâmetro b
-    double b_step;                                      // [m]          - "Passo" entre os valores max e min de b.
-    double progress;                                    //              - Contador de progresso.
-    double elapsed;                                     //              - Tempo decorrido da simulação.
-    double total_time;                                  //              - Tempo estimado total de simulação.
-    double remaining;                                   //              - Tempo restante de simulação.
-    clock_t begin;                                      //              - Momento em que o processo começou.
-    char elapsed_str[50];                               //              - “String” com o tempo atual de processamento.
-    char remaining_str[50];                             //              - "String" com o tempo restante de processamento.
-
-    char filename[200];                                 //              - Nome do arquivo onde os dados globais serão salvos.
-    FILE *fo;                                           //              - Ponteiro para o arquivo onde os dados serão salvos.
-    // ................................................................................................................
-    //      Salva o nome do teste numa variável global. Isso vai ser usado para o nome da pasta dos dados temporais,
+    //      Salva o nome do teste na configuração da execução. Isso vai ser usado para o nome da pasta dos dados temporais,
     //  e também para o nome do arquivo de dados globais =D
-    sprintf(test_name, "%s", argv[1]);
-
-    //      Cálcula o valor de x(0) a partir do fator passado na chamada do código.
-    r_factor = strtod(argv[2], NULL);
-    r_factor *= RAIO_MARTE;
-    stop_value = r_factor;
+    //  Com --shard, a pasta é a da parte, dentro da pasta do teste.
+    sprintf(settings.test_name, "%s", args[1]);
+    if (settings.shard.count > 1 && shard_directory(&settings.shard, args[1], settings.test_name, sizeof(settings.test_name)) != 0) {
+        printf("O nome do teste é longo demais: %s\n", args[1]);
+        return 1;
+    }
 
-    //      Pega a inclinação inicial de Marte (em radianos)
-    mars_angle_init = strtod(argv[3], NULL);
-    mars_angle_init *= DEG_TO_RAD;
+    //      Fator do raio de influência, inclinação inicial de Marte (em graus) e velocidade da sonda no infinito. Com
+    //  --grid, esses são apenas os valores dos parâmetros que não estão no grid.
+    r_factor = strtod(args[2], NULL);
+    mars_angle = strtod(args[3], NULL);
+    v_infinity = strtod(args[4], NULL);
 
-    //      Pega a velocidade da sonda no infinito, e calcula a velocidade inicial da sonda.
-    v_sonda_init = strtod(argv[4], NULL);
-    v_sonda_init = sqrt(v_sonda_init * v_sonda_init + 2 * CONSTANTE_GRAVITACIONAL * MASSA_MARTE / fabs(r_factor));
+    grid_names[0] = "r_factor";
+    grid_names[1] = "mars_init_angle";
+    grid_names[2] = "velocity_infinity";
+    invalid = grid_check(&settings.grid, grid_names, 3);
+    if (invalid != NULL) {
+        printf("O parâmetro %s não pode ser variado com --grid. Use r_factor, mars_init_angle ou velocity_infinity.\n", invalid);
+        return 1;
+    }
+    settings.n_slices = grid_slices(&settings.grid);
+    if ((double) settings.n_slices * settings.n_impacts > 2147483647.0) {
+        printf("O grid tem testes demais (%ld fatias × %d valores de b).\n", settings.n_slices, settings.n_impacts);
+        return 1;
+    }
+    if (settings.monte_carlo > 0) {                                              //  Uma fatia por amostra, com um único b.
+        settings.n_slices = settings.monte_carlo;
+        settings.n_impacts = 1;
+        if (!settings.mc_trajectories) settings.output_format = SAIDA_NENHUMA;
+    }
+    n_coarse = settings.n_impacts;
+    if (settings.target != ALVO_NENHUM) settings.n_impacts = ALVO_MAX_AVALIACOES;         //  Uma posição por avaliação da busca.
+    if (settings.refine_budget > 0) settings.n_impacts = settings.refine_budget;                   //  Uma posição por trajetória do orçamento.
+    settings.total_tests = (int) settings.n_slices * settings.n_impacts;
 
     //      Calcula o intervalo de valores de parâmetro de impacto que serão utilizados.
-    min_b_factor = strtod(argv[5], NULL);
-    max_b_factor = strtod(argv[6], NULL);
+    min_b_factor = strtod(args[5], NULL);
+    max_b_factor = strtod(args[6], NULL);
 
     min_b_factor *= RAIO_MARTE;
     max_b_factor *= RAIO_MARTE;
 
-    if (fabs(r_factor) < max_b_factor) {
-        printf("O raio de influência da esfera não pode ser menor do que o fator de impacto máximo.\n");
+    b_step = settings.monte_carlo > 0 ? 0.0 : (max_b_factor - min_b_factor) / ((settings.refine_budget > 0 ? n_coarse : settings.n_impacts) - 1);
+
+    //      Prepara as fatias do grid. Tudo o que depende só delas (velocidade inicial, estado inicial de Marte) é
+    //  calculado aqui uma única vez, em vez de uma vez por teste (veja flyby3_conditions_init).
+    settings.slices = malloc(sizeof(grid_slice) * settings.n_slices);
+    if (settings.slices == NULL) {
+        printf("Falha ao alocar memória para %ld fatias do grid.\n", settings.n_slices);
         return 1;
     }
+    for (i = 0; i < settings.n_slices; i++) {
+        slice = &settings.slices[i];
+        slice->parameters[0] = grid_value(&settings.grid, "r_factor", i, r_factor);
+        slice->parameters[1] = grid_value(&settings.grid, "mars_init_angle", i, mars_angle);
+        slice->parameters[2] = grid_value(&settings.grid, "velocity_infinity", i, v_infinity);
+        flyby3_conditions_init(&slice->conditions, slice->parameters[0], slice->parameters[1], slice->parameters[2]);
 
-    b_step = (max_b_factor - min_b_factor) / (NUMERO_DE_TESTES - 1);
+        if (fabs(slice->conditions.r_factor) < max_b_factor) {
+            printf("O raio de influência da esfera não pode ser menor do que o fator de impacto máximo.\n");
+            return 1;
+        }
+    }
 
     //      Tempo e passo de integração.
-    max_int_time = strtod(argv[7], NULL);
-    dt = strtod(argv[8], NULL);
+    settings.config.max_time = strtod(args[7], NULL);
+    settings.config.dt = strtod(args[8], NULL);
+
+    //      Tabela de corpos do --engine nbody: o Sol parado na origem e Marte na órbita circular (o ângulo inicial de
+    //  cada fatia é colocado pelo flyby3_integrate), seguidos dos corpos do arquivo. O Sol fica longe demais das
+    //  trajetórias para uma colisão, e a colisão com Marte é verificada pelo próprio laço, então os dois entram sem raio.
+    settings.config.reference_body = flyby3_bodies(&settings.bodies);
+    settings.config.bodies = &settings.bodies;
+    if (bodies_path != NULL) {
+        status = nbody_load(&settings.bodies, bodies_path);
+        if (status != 0) {
+            if (status < 0) printf("Não foi possível abrir a tabela de corpos (--bodies): %s\n", bodies_path);
+            else printf("Linha %d inválida na tabela de corpos (--bodies): %s. Veja o formato em --bodies (nomes repetidos, centros desconhecidos ou mais de %d corpos e %d corpos integrados não são aceitos).\n",
+                status, bodies_path, NBODY_MAX_CORPOS, NBODY_MAX_PONTOS - 1);
+            return 1;
+        }
+    }
 
-    steps_to_output = (int) (STEPS_PARA_OUTPUT / dt);
+    //      O sweep não guarda nada por teste: o b vem do índice (veja test_b) e os resultados ficam num anel com as
+    //  posições das threads (veja run_simulations). Só o refinamento (que escolhe os b novos a partir dos resultados) e
+    //  a busca guardam os vetores, com o orçamento de trajetórias como tamanho, e a retomada guarda um bit por teste.
+    b_values = NULL;
+    results = NULL;
+    done = NULL;
+    if (settings.refine_budget > 0 || settings.target != ALVO_NENHUM) {
+        b_values = malloc(sizeof(double) * settings.total_tests);
+        results = malloc(sizeof(simulation_result) * settings.total_tests);
+    }
+    if (settings.resume) done = calloc(settings.total_tests / 8 + 1, sizeof(unsigned char));
+    state.levels = settings.refine_budget > 0 ? calloc(settings.total_tests, sizeof(int)) : NULL;
+    if (((settings.refine_budget > 0 || settings.target != ALVO_NENHUM) && (b_values == NULL || results == NULL)) || (settings.resume && done == NULL) ||
+        (settings.refine_budget > 0 && state.levels == NULL)) {
+        printf("Falha ao alocar memória para %d testes.\n", settings.total_tests);
+        return 1;
+    }
 
-    //      Calcula os valores de fator de impacto que serão usados.
-    for (i = 0; i < NUMERO_DE_TESTES; i++) b_values[i] = min_b_factor + b_step * i;
+    //      No refinamento, os n_coarse primeiros valores de b são os da grade uniforme; os outros são escolhidos a cada
+    //  rodada.
+    if (settings.refine_budget > 0) for (i = 0; i < n_coarse; i++) b_values[i] = min_b_factor + b_step * i;
 
+    //      No Monte Carlo, cada amostra (uma fatia) recebe os seus erros de injeção em torno do b nominal.
+    if (settings.monte_carlo > 0) for (i = 0; i < settings.total_tests; i++) settings.slices[i].b = monte_carlo_sample(&settings, &settings.slices[i], i, 0.5 * (min_b_factor + max_b_factor));
+
+    //      Os redutores cobrem o intervalo de b dos testes (no Monte Carlo, o das amostras) e a deflexão de 0 a 180 graus.
+    reducer_names[0] = "d_min";
+    reducer_names[1] = "delta_v";
+    reducer_names[2] = "delta_v_rel";
+    reducer_names[3] = "deflection_angle";
+    b_low = min_b_factor;
+    b_high = max_b_factor;
+    if (settings.monte_carlo > 0) {
+        b_low = b_high = settings.slices[0].b;
+        for (i = 1; i < settings.total_tests; i++) {
+            if (settings.slices[i].b < b_low) b_low = settings.slices[i].b;
+            if (settings.slices[i].b > b_high) b_high = settings.slices[i].b;
+        }
+    }
+    if (settings.reducing && reducers_init(&state.reducers, 4, reducer_names, 3, b_low, b_high, 0.0, 180.0) != 0) {
+        printf("Falha ao preparar os redutores (--reduce).\n");
+        return 1;
+    }
     // ................................................................................................................
     //      Imprime um registro básico sobre o que o programa está a fazer.
     printf("Rodando o teste...\n");
@@ -169,298 +737,865 @@ int main(const int argc, const char *argv[]) {
     printf("\t Raio de Marte utilizado: %.4e metros \n", RAIO_MARTE);
     printf("\t Massa de Marte utilizada: %.4e kg \n", MASSA_MARTE);
     printf("\t Raio da órbita de Marte utilizada: %.4e metros\n", DISTANCIA_MARTE_SOL);
-    printf("\t Valor raio de influência da esfera é de: %.4e metros\n", r_factor);
-    printf("\t Valor do parâmetro de impacto pertencente ao intervalo [%.4e m; %.4e m], com passo igual a %.4e metros\n", min_b_factor, max_b_factor, b_step);
-    printf("\t Valor do módulo da velocidade inicial da sonda: %.4e metros por segundo\n", v_sonda_init);
-    printf("\t Tempo máximo de integração: %.4e segundos\n", max_int_time);
-    printf("\t Passo de integração: %.4lf s\n", dt);
+    printf("\t Valor raio de influência da esfera é de: %.4e metros\n", settings.slices[0].conditions.r_factor);
+    if (settings.target != ALVO_NENHUM) printf("\t Busca do parâmetro de impacto no intervalo [%.4e m; %.4e m] com %s = %.6e %s\n", min_b_factor, max_b_factor,
+        settings.target == ALVO_DEFLEXAO ? "deflexão" : "Δv heliocêntrico", settings.target_value, settings.target == ALVO_DEFLEXAO ? "graus" : "m/s");
+    else if (settings.monte_carlo > 0) printf("\t Monte Carlo: %d amostras em torno de b = %.4e m (semente %llu), com σ_b = %.2e m, σ_v = %.2e m/s, σ_direção = %.2e graus e σ_Marte = %.2e graus\n",
+        settings.monte_carlo, 0.5 * (min_b_factor + max_b_factor), (unsigned long long) settings.mc_seed, settings.mc_sigma[MC_B], settings.mc_sigma[MC_VELOCIDADE], settings.mc_sigma[MC_DIRECAO], settings.mc_sigma[MC_FASE_MARTE]);
+    else printf("\t Valor do parâmetro de impacto pertencente ao intervalo [%.4e m; %.4e m], com passo igual a %.4e metros\n", min_b_factor, max_b_factor, b_step);
+    printf("\t Valor do módulo da velocidade inicial da sonda: %.4e metros por segundo\n", settings.slices[0].conditions.v_sonda_init);
+    if (settings.grid.n_axes > 0) {
+        printf("\t Grid com %ld fatias e %d testes (os valores acima são os da primeira fatia):\n", settings.n_slices, settings.total_tests);
+        for (i = 0; i < settings.grid.n_axes; i++) printf("\t\t %s: %d valores de %.4e a %.4e\n", settings.grid.axes[i].name, settings.grid.axes[i].n, settings.grid.axes[i].min, settings.grid.axes[i].max);
+    }
+    printf("\t Tempo máximo de integração: %.4e segundos\n", settings.config.max_time);
+    printf("\t Passo de integração: %.4lf s\n", settings.config.dt);
+    printf("\t Integrador: %s\n", integrator_name(settings.config.integrator));
+    if (settings.config.engine == FORMULACAO_NBODY) printf("\t Formulação: N corpos (%d corpos, %d integrados)\n", settings.bodies.n, settings.bodies.n_integrated);
+    else if (settings.config.integrator == INTEGRADOR_EULER || settings.config.integrator == INTEGRADOR_RK4) printf("\t Formulação: %s\n", settings.config.engine == FORMULACAO_POLAR ? "polar" : "cartesiana");
+    if (settings.config.integrator == INTEGRADOR_DOPRI5) printf("\t Tolerâncias do passo adaptativo: rtol = %.2e, atol = %.2e\n", settings.config.tol_rel, settings.config.tol_abs);
+    if (settings.config.cadence != CADENCIA_TEMPO || settings.config.rows > 0) printf("\t Cadência da saída: %s, até %ld linhas por trajetória\n", cadence_name(settings.config.cadence), settings.config.rows > 0 ? settings.config.rows : CADENCIA_LINHAS_PADRAO);
+    if (settings.config.drift) printf("\t Medida da deriva da integral de Jacobi (coluna drift_jacobi)\n");
+    if (settings.profiling) printf("\t Perfil da execução (colunas steps, wall_time, steps_per_s e stop)\n");
+    printf("\t Número de threads: %d\n", settings.n_threads);
+    printf("\t Threads de escrita: %d%s\n", settings.n_writers, settings.n_writers == 0 ? " (escrita na thread que integra)" : "");
+    if (settings.reducing) printf("\t Redutores de streaming: resumo, histograma de b × deflexão e fronteira da colisão%s\n",
+        settings.output_format == SAIDA_NENHUMA ? " (sem arquivos de trajetória)" : "");
+    if (settings.refine_budget > 0) printf("\t Refinamento adaptativo: até %d trajetórias, limiar de %.2e da variação total\n", settings.refine_budget, settings.refine_tol);
+    if (settings.shard.count > 1) printf("\t Parte %d de %d: %ld dos %d testes (intercalados)\n", settings.shard.index, settings.shard.count, shard_tests(&settings.shard, settings.total_tests), settings.total_tests);
     // ................................................................................................................
     //      Cria a pasta onde as coisas serão salvas.
     //  !! Esse trecho do código funciona apenas no MacOS e no Linux. Isso não é aplicável no Windows.
     //  No Windows é necessário substituir essa implementação com o uso da biblioteca 'direct.h'.
-    sprintf(filename, "%s/pr3c", test_name);
+    //  Com --resume, a pasta de uma execução interrompida é reaproveitada. A pasta de uma parte (--shard) pode já existir,
+    //  com a parte do fly_by_pr2c.
+    if (settings.shard.count > 1 && mkdir(settings.test_name, 0755) != 0 && errno != EEXIST) {
+        perror("Falha ao criar o diretório da parte da execução (--shard). Verifique se a pasta do teste existe");
+        return 1;
+    }
+    sprintf(filename, "%s/pr3c", settings.test_name);
     if (mkdir(filename, 0755) == 0) printf("Pasta do problema de 3 corpos: '%s'\n", filename);
+    else if (settings.resume && errno == EEXIST) printf("Retomando a execução salva na pasta: '%s'\n", filename);
     else {
-        perror("Falha ao criar o diretório para os arquivos do problema de 3 corpos. Verifique se a pasta já existe, caso isso seja verdade, delete-a ou renomei-a.");
+        perror("Falha ao criar o diretório para os arquivos do problema de 3 corpos. Verifique se a pasta já existe, caso isso seja verdade, delete-a, renomei-a ou use --resume para continuar a execução");
         return 1;
     }
-    // ................................................................................................................
-    //      Chama a função responsável pelas simulações numéricas de cada teste.
-    printf("\nRealizando simulações ... \n");
-    begin = clock();
-    for (i = 0; i < NUMERO_DE_TESTES; i++) {
-        progress = (1.0 * i / NUMERO_DE_TESTES) * 100;
-
-        //      Chama a simulação para o parâmetro de impacto b_values[i].
-        simulate(i, b_values[i], &d_values[i], &var_velocidade_helio[i], &var_velocidade_rel[i], &deflection_angle[i], &collision[i], &times[i]);
-
-        //      Barrinha de progresso (modo avançado com ETA) =D
-        elapsed = (double) (clock() - begin) / CLOCKS_PER_SEC;
-        total_time = (elapsed / (i > 0 ? i : 1)) * NUMERO_DE_TESTES;
-        remaining = total_time - elapsed;
-
-        format_time(elapsed, elapsed_str);
-        format_time(remaining, remaining_str);
-
-        printf("\r");       //  Limpa
-        for (j = 0; j < 220; j++) printf(" ");
-        fflush(stdout);
 
-        printf("\r[");
-        for (j = 0; j < 100; j++) printf(progress >= j ? "#" : " ");
-        printf("] %.2lf%%, Elapsed: %s, ETA: %s", progress, elapsed_str, remaining_str);
-
-        fflush(stdout);     //  Força a impressão =V
+    //      A linha de comando fica salva na pasta; a retomada só é aceita com os mesmos argumentos.
+    sprintf(filename, "%s/run_pr3c.txt", settings.test_name);
+    neutral[0] = "--threads";
+    neutral[1] = "--writers";
+    neutral[2] = "--progress";
+    neutral[3] = "--progress-interval";
+    status = journal_config(filename, argc, argv, neutral, 4, settings.resume);
+    if (status == -1) {
+        printf("Os argumentos não são os mesmos da execução salva em '%s' (na retomada, apenas --threads, --writers e as opções do progresso podem mudar).\n", filename);
+        return 1;
+    }
+    if (status != 0) {
+        printf("Falha ao %s o arquivo de configuração da execução: '%s'.\n", settings.resume ? "ler" : "gravar", filename);
+        return 1;
     }
 
-    printf("\r");       //  Limpa
-    for (j = 0; j < 220; j++) printf(" ");
-    fflush(stdout);
+    //      A parte é identificada na própria pasta, para o flyby_merge.
+    sprintf(filename, "%s/shard_pr3c.txt", settings.test_name);
+    if (settings.shard.count > 1 && shard_save(filename, &settings.shard, settings.total_tests) != 0) {
+        perror("Falha ao gravar o arquivo da parte da execução (--shard)");
+        return 1;
+    }
 
-    printf("\r[");
-    for (i = 0; i < 100; i++) printf("#");
-    printf("] 100.00%%, Total time: %s", elapsed_str);
-    fflush(stdout);
-    printf("\n\n");
+    //      No formato binário todas as trajetórias vão para um único arquivo. Na retomada, o arquivo é reaberto sem
+    //  apagar as trajetórias que já estão no índice.
+    if (settings.output_format == SAIDA_BINARIA) {
+        sprintf(filename, "%s/pr3c/trajectories.bin", settings.test_name);
+        settings.store = settings.resume ? store_reopen(filename, settings.total_tests, "t,x_mars,y_mars,x_ship,y_ship,v_x_mars,v_y_mars,v_x_ship,v_y_ship,d") : NULL;
+        if (settings.store == NULL) settings.store = store_open(filename, settings.total_tests, "t,x_mars,y_mars,x_ship,y_ship,v_x_mars,v_y_mars,v_x_ship,v_y_ship,d");
+        if (settings.store == NULL) {
+            perror("Falha ao criar o arquivo binário das trajetórias");
+            return 1;
+        }
+    }
     // ................................................................................................................
-    //      Salva os dados globais.
-    printf("Salvando os dados globais em: '%s/global.csv'\n", test_name);
+    //      O arquivo de dados globais é aberto antes das simulações: cada teste é escrito assim que ele e todos os
+    //  anteriores terminam (na ordem dos índices, a mesma da execução serial), então os resultados parciais podem ser
+    //  lidos durante a execução.
+    //  Na retomada, o arquivo funciona como o diário da execução: ele é filtrado (veja journal.h) e as linhas novas são
+    //  acrescentadas no fim.
+    sprintf(filename, "%s/global_pr3c.csv", settings.test_name);
+    if (settings.resume) {
+        n_done = journal_resume(filename, settings.total_tests, settings.output_format == SAIDA_NENHUMA ? NULL : trajectory_complete, &settings, done);
+        if (n_done < 0 || (settings.reducing && reduce_global(&state.reducers, filename) != 0)) {
+            perror("Falha ao ler o arquivo de dados globais da execução interrompida");
+            return 1;
+        }
+        printf("Testes já concluídos na execução interrompida: %ld de %ld\n", n_done, shard_tests(&settings.shard, settings.total_tests));
+    }
+    fo = fopen(filename, settings.resume ? "a" : "w");
+    if (fo == NULL) {
+        perror("Falha ao criar o arquivo de dados globais");
+        return 1;
+    }
+    printf("Os dados globais serão salvos em: '%s'\n", filename);
 
-    sprintf(filename, "%s/global_pr3c.csv", test_name);
-    fo = fopen(filename, "w");
+    //  - Cabeçalho do arquivo CSV (apenas num arquivo vazio).
+    //  No modo adaptativo são adicionadas duas colunas com o número de passos aceitos e rejeitados, com --drift a coluna
+    //  da deriva e com --profile as colunas de desempenho de cada trajetória. Com --grid, as colunas da fatia e dos
+    //  parâmetros dela vão no fim; com --refine, a coluna do nível de refinamento; com --monte-carlo, os erros sorteados.
+    fseek(fo, 0, SEEK_END);
+    if (ftell(fo) == 0) fprintf(fo, "i,b,d_min,delta_v,delta_v_rel,deflection_angle,collision,t%s%s%s%s%s%s\n", settings.config.integrator == INTEGRADOR_DOPRI5 ? ",steps_accepted,steps_rejected" : "",
+        settings.config.drift ? ",drift_jacobi" : "", settings.profiling ? ",steps,wall_time,steps_per_s,stop" : "", settings.grid.n_axes > 0 ? ",slice,r_factor,mars_init_angle,velocity_infinity" : "",
+        settings.refine_budget > 0 ? ",level" : "", settings.monte_carlo > 0 ? ",b_error,velocity_error,direction_error,mars_angle_error" : "");
+    fflush(fo);
 
-    //  - Cabeçalho do arquivo CSV.
-    fprintf(fo, "i,b,d_min,delta_v,delta_v_rel,deflection_angle,collision,t\n");
-    for (i = 0; i < NUMERO_DE_TESTES; i++) {
-        fprintf(fo, "%d,%.15e,%.15e,%.15e,%.15e,%.15e,%d,%.15e\n",
-            i + 1, b_values[i], d_values[i], var_velocidade_helio[i], var_velocidade_rel[i], deflection_angle[i] * RAD_TO_DEG, collision[i],times[i]);
+    //      Modo de busca: as trajetórias são integradas uma a uma, no lugar do sweep.
+    if (settings.profiling) profile_init(&state.profile);
+    if (settings.target != ALVO_NENHUM) {
+        status = run_target(&settings, &state, fo, min_b_factor, max_b_factor, b_values, results);
+        if (settings.profiling) profile_report(&state.profile);
+        if (settings.reducing && reducers_write(&state.reducers, settings.test_name, "pr3c") != 0) {
+            perror("Falha ao gravar os resultados dos redutores");
+            status = 1;
+        }
+        if (store_close(settings.store) != 0) {
+            printf("Falha ao escrever o arquivo binário das trajetórias.\n");
+            status = 1;
+        }
+        fclose(fo);
+        free(b_values);
+        free(results);
+        free(settings.slices);
+        free(done);
+        return status;
     }
+    // ................................................................................................................
+    //      Chama a função responsável pelas simulações numéricas de cada teste. Um SIGINT ou SIGTERM interrompe o sweep
+    //  depois dos testes em andamento, e tudo o que terminou é salvo.
+    printf("\nRealizando simulações ... \n");
+    sweep_catch_signals();
+    if (settings.refine_budget > 0) status = run_refinement(&settings, &state, n_coarse, b_values, results, fo);
+    else status = run_simulations(&settings, &state, (int) shard_tests(&settings.shard, settings.total_tests), NULL, NULL, min_b_factor, b_step, done, NULL, fo);
+    if (status == 1) return 1;
+    if (settings.profiling) profile_report(&state.profile);
 
+    //      Os redutores são gravados mesmo numa interrupção: eles têm os mesmos testes do arquivo global, e a retomada
+    //  os reconstrói a partir dele.
+    if (settings.reducing && reducers_write(&state.reducers, settings.test_name, "pr3c") != 0) {
+        perror("Falha ao gravar os resultados dos redutores");
+        return 1;
+    }
+    if (store_close(settings.store) != 0) {
+        printf("Falha ao escrever o arquivo binário das trajetórias.\n");
+        return 1;
+    }
     fclose(fo);
+    free(b_values);
+    free(results);
+    free(settings.slices);
+    free(done);
+    free(state.levels);
     // ................................................................................................................
+    if (status == 2) {
+        if (settings.refine_budget > 0) printf("Execução interrompida: os testes concluídos foram salvos (o refinamento não pode ser retomado com --resume).\n\n");
+        else printf("Execução interrompida: os testes concluídos foram salvos. Para continuar, rode o mesmo comando com --resume.\n\n");
+        return 130;
+    }
+    if (settings.monte_carlo > 0 && report_monte_carlo(&settings) != 0) return 1;
     printf("Simulação concluída =D\n\n");
     // ................................................................................................................
     return 0;
 }
 // ....................................................................................................................
 //  - Faz a simulação física do problema para as condições passadas nos argumentos.
+//  const run_settings* settings            → Configuração da execução.
+//  run_state* state                        → Estado da execução (escrita assíncrona e perfil).
 //  const int test                          → Número de identificação do teste.
 //  const double b                          → Parâmetro de impacto.
-//  double* d_min_value                     → Referência: altera a distância mínima encontrada entre a sonda e Marte.
-//  double* delta_v_value                   → Referência: altera a variação de velocidade heliocêntrica da sonda.
-//  double* delta_v_value_rel               → Referência: altera a variação de velocidade relativa da sonda.
-//  double* deflection_angle_value          → Referência: altera o ângulo de deflexão encontrado.
-//  int* collision                          → Referência: altera o indicador de colisão. É 0 caso não tenha ocorrido colisão; e 1 caso contrário.
-//  double* time_end                        → Referência: altera o tempo em segundo que levou para finalizar a simulação.
-//
-//  * Os valores passados como "referência" são saídas da função simulate alterados em espaços de memória pré-alocados.
-void simulate(int test, double b, double* d_min_value, double* delta_v_value, double* delta_v_value_rel, double* deflection_angle_value, int* collision, double* time_end) {
+//  simulation_result* result               → Referência: recebe os resultados do teste.
+void simulate(const run_settings* settings, run_state* state, const int test, const double b, const grid_slice* slice, simulation_result* result) {
     // ................................................................................................................
     //          Declaração das variáveis locais.
-    int f;                                              //                  - Contador para as saídas.
-
-    //      Variáveis de estado (coordenadas polares)
-    double mars_coord_polar[N_DIMS + 1];                // [m, rad]         - Posição em coordenadas polares de Marte.
-    double mars_velocity_polar[N_DIMS + 1];             // [m/s, rad/s]     - Velocidade em coordenadas polares de Marte.
-    double ship_coord_polar[N_DIMS + 1];                // [m, rad]         - Posição em coordenadas polares da sonda.
-    double ship_velocity_polar[N_DIMS + 1];             // [m/s, rad/s]     - Velocidade em coordenadas polares da sonda.
-
-    //      Variáveis de estado (coordenadas cartesianas)
-    double mars_coord_cartesian[N_DIMS + 1];            // [m, m]           - Posição em coordenadas cartesianas de Marte.
-    double mars_velocity_cartesian[N_DIMS + 1];         // [m/s, m/s]       - Velocidade em coordenadas cartesianas de Marte.
-    double ship_coord_cartesian[N_DIMS + 1];            // [m, m]           - Posição em coordenadas cartesianas da sonda.
-    double ship_velocity_cartesian[N_DIMS + 1];         // [m/s, m/s]       - Velocidade em coordenadas cartesianas da sonda.
-
-    //  Também preciso de variáveis temporárias para armazenar as atualizações de estado...
-    double mars_coord_polar_updated[N_DIMS + 1];        // [m, rad]         - Posição temporária atualizada pelo integrador de Marte.
-    double ship_coord_polar_updated[N_DIMS + 1];        // [m, rad]         - Posição temporária atualizada pelo integrador da sonda.
-    double ship_velocity_polar_updated[N_DIMS + 1];     // [m/s, rad/s]     - Velocidade temporária atualizada pelo integrador da sonda.
-
-    //      Vetores de velocidade de entrada e saída.
-    double velocity_in[N_DIMS + 1];                     // [m/s, m/s]       - Vetor de velocidade de entrada. (referencial do Sol)
-    double velocity_out[N_DIMS + 1];                    // [m/s, m/s]       - Vetor de velocidade de saída. (referecial do Sol)
-    double velocity_in_rel[N_DIMS + 1];                 // [m/s, m/s]       - Vetor de velocidade de entrada. (referencial de Marte)
-    double velocity_out_rel[N_DIMS + 1];                // [m/s, m/s]       - Vetor de velocidade de saída. (referecial de Marte)
-    double velocity_out_direction[N_DIMS + 1];          // [m/s, m/s]       - Vetor unitário de direção do vetor de saída no ponto de parada. Isso define a direção do velocity_out.
-
-    double div;                                         // [mˆ2]            - Fator comum de divisão. É o módulo quadrado do vetor distância.
-    double time;                                        // [s]              - Tempo de intregrassão.
-    double distance;                                    // [m]              - Distância relativa entre a sonda e Marte.
-    char filename[200];                                 //                  - Arquivos onde os dados da simulação serão salvos.
-    FILE *fo;                                           //                  - Ponteiro de acesso para o arquivo.
-    // ................................................................................................................
-    //          Condições iniciais, aplicadas...
-    //  1. Começando por marte, o raio da órbita do planeta é tabelado; e o ângulo foi fornecido.
-    mars_coord_polar[1] = DISTANCIA_MARTE_SOL;
-    mars_coord_polar[2] = mars_angle_init;
-    mars_velocity_polar[1] = 0.0;
-    mars_velocity_polar[2] = sqrt(CONSTANTE_GRAVITACIONAL * MASSA_SOL / (DISTANCIA_MARTE_SOL * DISTANCIA_MARTE_SOL * DISTANCIA_MARTE_SOL));
-
-    //  2. Converte as coordenadas de marte para os valores cartesianos.
-    mars_coord_cartesian[1] = mars_coord_polar[1] * cos(mars_coord_polar[2]);
-    mars_coord_cartesian[2] = mars_coord_polar[1] * sin(mars_coord_polar[2]);
-    mars_velocity_cartesian[1] = - mars_coord_polar[1] * mars_velocity_polar[2] * sin(mars_coord_polar[2]);
-    mars_velocity_cartesian[2] = mars_coord_polar[1] * mars_velocity_polar[2] * cos(mars_coord_polar[2]);
-
-    //  3. Calcula a posição cartesiana inicial da sonda.
-    ship_coord_cartesian[1] = mars_coord_cartesian[1] + sqrt(r_factor * r_factor - b * b) * sin(mars_coord_polar[2]) - b * cos(mars_coord_polar[2]);
-    ship_coord_cartesian[2] = mars_coord_cartesian[2] - sqrt(r_factor * r_factor - b * b) * cos(mars_coord_polar[2]) - b * sin(mars_coord_polar[2]);
-
-    //  4. Converte os valores de posição para coordendas polares.
-    ship_coord_polar[1] = sqrt(ship_coord_cartesian[1] * ship_coord_cartesian[1] + ship_coord_cartesian[2] * ship_coord_cartesian[2]);
-    ship_coord_polar[2] = atan2(ship_coord_cartesian[2], ship_coord_cartesian[1]);
-
-    //  5. Calcula a velocidade relativa de entrada; e aproveita para calcular o valor da velocidade heliocêntrica.
-    velocity_in_rel[1] = - v_sonda_init * sin(mars_coord_polar[2]);
-    velocity_in_rel[2] = v_sonda_init * cos(mars_coord_polar[2]);
-
-    ship_velocity_cartesian[1] = velocity_in_rel[1] + mars_velocity_cartesian[1];
-    ship_velocity_cartesian[2] = velocity_in_rel[2] + mars_velocity_cartesian[2];
-
-    velocity_in[1] = ship_velocity_cartesian[1];
-    velocity_in[2] = ship_velocity_cartesian[2];
-
-    //  6. Converte as velocidades cartesianas para polar.
-    ship_velocity_polar[1] = (ship_coord_cartesian[1] * ship_velocity_cartesian[1] + ship_coord_cartesian[2] * ship_velocity_cartesian[2]) / ship_coord_polar[1];
-    ship_velocity_polar[2] = (ship_coord_cartesian[1] * ship_velocity_cartesian[2] - ship_coord_cartesian[1] * ship_velocity_cartesian[1]) / (ship_coord_polar[1] * ship_coord_polar[1]);
-
-    //  7. Distância entre a sonda e Marte.
-    distance = sqrt((ship_coord_cartesian[1] - mars_coord_cartesian[1]) * (ship_coord_cartesian[1] - mars_coord_cartesian[1]) + (ship_coord_cartesian[2] - mars_coord_cartesian[2]) * (ship_coord_cartesian[2] - mars_coord_cartesian[2]));
-
-    //  8. Configurações adicionais...
-    *collision = 0;
-    *d_min_value = distance;
+    flyby3_result trajectory;                           //                  - Resultados da trajetória (veja flyby3.h).
+    flyby3_sink sink;                                   //                  - Destino das linhas (veja sink_row).
+    double begin;                                       // [s]              - Início do teste (--profile).
+    trajectory_output out;                              //                  - Saída dos dados da simulação (veja output.h).
+    char directory[200];                                //                  - Pasta dos arquivos CSV.
     // ................................................................................................................
     //          Prepara para salvar os dados.
-    f = 0;
-    sprintf(filename, "%s/pr3c/data_%03d.csv", test_name, test + 1);
-    fo = fopen(filename, "w");
-    //  Como eu não vou usar GnuPlot, vou adicionar um cabeçalho no arquivo; e meio que o formato acaba virando um CSV.
-    fprintf(fo, "t,x_mars,y_mars,x_ship,y_ship,v_x_mars,v_y_mars,v_x_ship,v_y_ship,d\n");
+    result->wall_time = 0.0;
+    begin = settings->profiling ? profile_now() : 0.0;
+    sprintf(directory, "%s/pr3c", settings->test_name);
+    output_open(&out, settings->output_format, directory, test, "t,x_mars,y_mars,x_ship,y_ship,v_x_mars,v_y_mars,v_x_ship,v_y_ship,d", 15, settings->store,
+        state->pipeline, settings->profiling);
     // ................................................................................................................
     //          Processo de simulação numérica.
-    for (time = 0; time < max_int_time; time += dt) { // NOLINT(*-flp30-c)
-        // ............................................................................................................
-        //          Adiciona os dados ao arquivo de saída.
-        if (f <= 0) {
-            f = steps_to_output;
-            fprintf(fo, "%.8e,%.15e,%.15e,%.15e,%.15e,%.15e,%.15e,%.15e,%.15e,%.15e\n",
-                time, mars_coord_cartesian[1], mars_coord_cartesian[2], ship_coord_cartesian[1], ship_coord_cartesian[2], mars_velocity_cartesian[1], mars_velocity_cartesian[2], ship_velocity_cartesian[1], ship_velocity_cartesian[2], distance);
-
-            //      Critérios de parada.
-            //  1. Verifica se a sonda colidiu com Marte.
-            if (distance < RAIO_MARTE) {
-                *d_min_value = distance;
-                *collision = 1;
-                break;
-            }
+    //  A trajetória é a da libflyby (flyby3.c), com a configuração da execução e as condições iniciais da fatia (no
+    //  Monte Carlo, com os erros de injeção da amostra); as linhas vão para a saída da trajetória.
+    sink.row = sink_row;
+    sink.context = &out;
+    flyby3_integrate(&settings->config, &slice->conditions, b, &trajectory, &sink);
 
-            //  2. Verifica se a sonda está suficientemente longe de Marte.
-            //  O critério temporal aqui é apenas para impedir que ele pare no começo da simulação.
-            if (distance >= stop_value && time > 10 * STEPS_PARA_OUTPUT) {
-                break;
-            }
+    result->b = b;
+    result->d_min = trajectory.d_min;
+    result->delta_v = trajectory.delta_v;
+    result->delta_v_rel = trajectory.delta_v_rel;
+    result->deflection_angle = trajectory.deflection_angle;
+    result->collision = trajectory.collision;
+    result->time_end = trajectory.time_end;
+    result->steps_accepted = (long) trajectory.steps_accepted;
+    result->steps_rejected = (long) trajectory.steps_rejected;
+    result->drift_jacobi = trajectory.drift_jacobi;
+    result->steps = trajectory.steps;
+    result->stop = trajectory.stop;
+    // ................................................................................................................
+    //          Fecha o arquivo de dados.
+    output_close(&out);
+
+    if (settings->profiling) {
+        result->wall_time = profile_now() - begin;
+        profile_trajectory(&state->profile, result->wall_time, out.row_seconds, out.file_seconds, out.row_count, result->steps, result->stop);
+    }
+}
+// ....................................................................................................................
+void sink_row(const double* values, void* context) {
+    output_row(context, values);
+}
+// ....................................................................................................................
+//      Estimativa barata do número de avaliações da aceleração de um teste.
+//  No referencial de Marte, a sonda é tratada como se andasse em linha reta com a velocidade inicial; a única física
+//  usada é o periapsis da hipérbole relativa a Marte (o Sol é ignorado) para saber se o teste termina numa colisão.
+//  - Sem colisão, a sonda atravessa a esfera de influência inteira (raio r_factor).
+//  - Com colisão, ela percorre apenas o trecho até a superfície de Marte.
+double estimate_cost(const run_settings* settings, const double b, const grid_slice* slice) {
+    const double mu = CONSTANTE_GRAVITACIONAL * MASSA_MARTE;
+    const double r_factor = slice->conditions.r_factor;
+    const double v_sonda_init = slice->conditions.v_sonda_init;
+    const double v_inf2 = v_sonda_init * v_sonda_init - 2 * mu / r_factor;
+    const double h = fabs(b) * v_sonda_init;            //  Momento angular específico inicial (relativo a Marte).
+    const double e = sqrt(1 + v_inf2 * h * h / (mu * mu));
+    const double r_p = (h * h / mu) / (1 + e);          //  Raio do periapsis.
+    const double half_chord = fabs(b) < r_factor ? sqrt(r_factor * r_factor - b * b) : 0.0;
+    double length;
+
+    if (r_p < RAIO_MARTE) length = half_chord - (fabs(b) < RAIO_MARTE ? sqrt(RAIO_MARTE * RAIO_MARTE - b * b) : 0.0);
+    else length = 2 * half_chord;
+
+    return length / v_sonda_init / settings->config.dt * integrator_evaluations(settings->config.integrator);
+}
+// ....................................................................................................................
+//      Roda o sweep numérico sobre os testes da parte (pulando os que já foram feitos) ou sobre uma lista de testes
+//  (os de uma rodada do refinamento).
+int run_simulations(const run_settings* settings, run_state* state, const int n_tests, const int* tests, const double* b_values, const double b_min, const double b_step, const unsigned char* done,
+    simulation_result* results, FILE* global) {
+    sweep_context context;                              //  Ponteiros para os vetores, usados pelas threads.
+    pipeline_stats writers;                             //  Estatísticas da escrita assíncrona.
+    double total_cost;                                  //  Soma dos custos estimados dos testes (para o ETA).
+    double phase;                                       //  Início da fase atual (--profile).
+    int n_pending;                                      //  Testes que ainda precisam ser feitos.
+    int status;
+    int i;
+
+    phase = settings->profiling ? profile_now() : 0.0;
+    context.settings = settings;
+    context.state = state;
+    context.n_tests = n_tests;
+    context.tests = tests;
+    context.b_values = b_values;
+    context.b_min = b_min;
+    context.b_step = b_step;
+    context.done = done;
+    context.n_slots = sweep_slots(settings->n_threads);
+    context.slots = malloc(sizeof(simulation_result) * context.n_slots);
+    context.results = results;
+    context.drift = 0.0;
+    context.global = global;
+    context.flushed = time(NULL);
+    if (context.slots == NULL) {
+        printf("\nFalha ao alocar memória para o sweep.\n");
+        return 1;
+    }
+
+    //      Escrita assíncrona: cada thread do sweep tem uma trajetória aberta por vez.
+    if (settings->n_writers > 0) {
+        state->pipeline = pipeline_start(settings->n_writers, settings->n_threads);
+        if (state->pipeline == NULL) {
+            free(context.slots);
+            printf("\nFalha ao iniciar as threads de escrita.\n");
+            return 1;
         }
+    }
+    total_cost = 0.0;
+    n_pending = 0;
+    for (i = 0; i < n_tests; i++) {
+        if (journal_done(done, sweep_test(&context, i))) continue;
+        total_cost += job_cost(i, &context);
+        n_pending++;
+    }
+    progress_begin(&context.progress, settings->progress_format, settings->progress_interval, n_tests, n_pending, total_cost);
+    if (settings->profiling) {
+        profile_add(&state->profile, PERFIL_PREPARACAO, profile_now() - phase, 1);
+        phase = profile_now();
+    }
 
-        f--;
-        // ............................................................................................................
-        //          Realiza a integração numérica, conforme Eqs~(34-38).
-        div = ship_coord_polar[1] * ship_coord_polar[1] + mars_coord_polar[1] * mars_coord_polar[1] - 2 * ship_coord_polar[1] * mars_coord_polar[1] * cos(ship_coord_polar[2] - mars_coord_polar[2]);
-
-        mars_coord_polar_updated[2] = mars_coord_polar[2] + mars_velocity_polar[2] * dt;
-        ship_coord_polar_updated[1] = ship_coord_polar[1] + ship_velocity_polar[1] * dt;
-        ship_coord_polar_updated[2] = ship_coord_polar[2] + ship_velocity_polar[2] * dt;
-        ship_velocity_polar_updated[1] = ship_velocity_polar[1] + (ship_coord_polar[1] * ship_velocity_polar[2] * ship_velocity_polar[2] -
-            CONSTANTE_GRAVITACIONAL * MASSA_SOL / (ship_coord_polar[1] * ship_coord_polar[1]) -
-            CONSTANTE_GRAVITACIONAL * MASSA_MARTE * (ship_coord_polar[1] - mars_coord_polar[1] * cos(ship_coord_polar[2] - mars_coord_polar[2])) /
-            (div * sqrt(div))) * dt;
-        ship_velocity_polar_updated[2] = ship_velocity_polar[2] +
-            (- CONSTANTE_GRAVITACIONAL * MASSA_MARTE * mars_coord_polar[1] * sin(ship_coord_polar[2] - mars_coord_polar[2]) /
-                (ship_coord_polar[1] * div * sqrt(div)) - 2 * ship_velocity_polar[1] * ship_velocity_polar[2] / ship_coord_polar[1]) * dt;
-
-        //  - Aplica as atualizações de posição e velocidade.
-        mars_coord_polar[2] = mars_coord_polar_updated[2];
-        ship_coord_polar[1] = ship_coord_polar_updated[1];
-        ship_coord_polar[2] = ship_coord_polar_updated[2];
-        ship_velocity_polar[1] = ship_velocity_polar_updated[1];
-        ship_velocity_polar[2] = ship_velocity_polar_updated[2];
-        // ............................................................................................................
-        //          Atualiza os dados de coordenadas cartesianas, etc.
-        //      Converte as coordenadas cartesianas iniciais.
-        //  - Posição de Marte (x e y, em ordem)
-        mars_coord_cartesian[1] = mars_coord_polar[1] * cos(mars_coord_polar[2]);
-        mars_coord_cartesian[2] = mars_coord_polar[1] * sin(mars_coord_polar[2]);
-        //  - Posição da sonda (x e y, em ordem)
-        ship_coord_cartesian[1] = ship_coord_polar[1] * cos(ship_coord_polar[2]);
-        ship_coord_cartesian[2] = ship_coord_polar[1] * sin(ship_coord_polar[2]);
-        //  - Velocidade de Marte (x e y, em ordem)
-        mars_velocity_cartesian[1] = mars_velocity_polar[1] * cos(mars_coord_polar[2]) - mars_coord_polar[1] * mars_velocity_polar[2] * sin(mars_coord_polar[2]);
-        mars_velocity_cartesian[2] = mars_velocity_polar[1] * sin(mars_coord_polar[2]) + mars_coord_polar[1] * mars_velocity_polar[2] * cos(mars_coord_polar[2]);
-        //  - Velocidade da sonda (x e y, em ordem)
-        ship_velocity_cartesian[1] = ship_velocity_polar[1] * cos(ship_coord_polar[2]) - ship_coord_polar[1] * ship_velocity_polar[2] * sin(ship_coord_polar[2]);
-        ship_velocity_cartesian[2] = ship_velocity_polar[1] * sin(ship_coord_polar[2]) + ship_coord_polar[1] * ship_velocity_polar[2] * cos(ship_coord_polar[2]);
-        // ............................................................................................................
-        //          Calcula a distância entre Marte e a sonda.
-        distance = sqrt(div);
-        if (distance < *d_min_value) *d_min_value = distance;
-        // ............................................................................................................
+    //      Os testes são distribuídos entre as threads (sweep.c), os mais longos primeiro. Cada trajetória é
+    //  independente e escreve apenas no seu arquivo e na sua posição do anel, e o arquivo global recebe os testes na
+    //  ordem dos índices, então o resultado é o mesmo da execução serial.
+    status = n_pending > 0 ? sweep_run(n_tests, settings->n_threads, job_cost, run_test, report_progress, write_result, &context) : 0;
+    free(context.slots);
+    if (settings->profiling) {
+        profile_sweep(&state->profile, profile_now() - phase, settings->n_threads);
+        phase = profile_now();
     }
-    // ................................................................................................................
-    //          Fecha o arquivo de dados.
-    fclose(fo);
-    // ................................................................................................................
-    //          Calcula o ângulo de deflexão e a variação da velocidade.
-    //  →   Vamos começar calculando a variação do módulo da velocidade heliocêntrica. Para isso vamos pegar a
-    //  velocidade heliocêntrica de saída:
-    velocity_out[1] = ship_velocity_cartesian[1];
-    velocity_out[2] = ship_velocity_cartesian[2];
-    //  Agora comparamos os módulos...
-    *delta_v_value = sqrt(velocity_out[1] * velocity_out[1] + velocity_out[2] * velocity_out[2]) - sqrt(velocity_in[1] * velocity_in[1] + velocity_in[2] * velocity_in[2]);
-
-    //  →   Na sequência, calculamos a variação da velocidade relativa; é a mesma coisa, mas a gente precisa descontar a velocidade
-    //  de marte...
-    velocity_out_rel[1] = ship_velocity_cartesian[1] - mars_velocity_cartesian[1];
-    velocity_out_rel[2] = ship_velocity_cartesian[2] - mars_velocity_cartesian[2];
-
-    *delta_v_value_rel = sqrt(velocity_out_rel[1] * velocity_out_rel[1] + velocity_out_rel[2] * velocity_out_rel[2]) - sqrt(velocity_in_rel[1] * velocity_in_rel[1] + velocity_in_rel[2] * velocity_in_rel[2]);
-
-    //  →   Vamos agora pegar a direção do vetor velocidade... (aqui vou usar cálculo repetido, mas é para deixar mais claro oq estou tentando fazer)
-    div = sqrt(velocity_out_rel[1] * velocity_out_rel[1] + velocity_out_rel[2] * velocity_out_rel[2]);
-    velocity_out_direction[1] = velocity_out[1] / div;
-    velocity_out_direction[2] = velocity_out[2] / div;
-
-    //  → E agora, calculamos o ângulo de deflexão...
-    *deflection_angle_value = (velocity_in_rel[1] * velocity_out_rel[1] + velocity_in_rel[2] * velocity_out_rel[2]) /
-        (sqrt(velocity_in_rel[1] * velocity_in_rel[1] + velocity_in_rel[2] * velocity_in_rel[2]) *
-            sqrt(velocity_out_rel[1] * velocity_out_rel[1] + velocity_out_rel[2] * velocity_out_rel[2]));
-
-    if (*deflection_angle_value > 1) *deflection_angle_value = 1.0;
-    if (*deflection_angle_value < -1) *deflection_angle_value = -1.0;
-
-    *deflection_angle_value = acos(*deflection_angle_value);
-
-    //  → Por fim, seta o tempo total usado para a integração.
-    *time_end = time;
+
+    //      Espera as últimas linhas serem escritas.
+    pipeline_stop(state->pipeline, &writers);
+    state->pipeline = NULL;
+    if (settings->profiling) profile_add(&state->profile, PERFIL_FINALIZACAO, profile_now() - phase, 1);
+    if (status < 0) {
+        printf("\nFalha ao iniciar as threads da simulação.\n");
+        return 1;
+    }
+    fflush(global);
+
+    progress_end(&context.progress, status == 1);
+    printf("\n\n");
+    if (settings->n_writers > 0) report_writers(&writers);
+    if (settings->config.drift && status == 0) report_drift(context.drift);
+
+    return status == 1 ? 2 : 0;
+}
+// ....................................................................................................................
+//      Refinamento adaptativo: cada rodada é um sweep comum sobre os testes novos, então as threads e a escrita das
+//  trajetórias funcionam como no sweep uniforme.
+int run_refinement(const run_settings* settings, run_state* state, const int n_coarse, double* b_values, simulation_result* results, FILE* global) {
+    refine_sample* samples;                             //  Amostras calculadas até agora (reordenadas pelo refine_select).
+    int* tests;                                         //  Índice de cada teste (tests[i] = i).
+    int n;                                              //  Testes já calculados (incluindo os da rodada atual).
+    int found;                                          //  Testes da rodada atual.
+    int round;
+    int status;
+    int i;
+
+    samples = malloc(sizeof(refine_sample) * settings->refine_budget);
+    tests = malloc(sizeof(int) * settings->refine_budget);
+    if (samples == NULL || tests == NULL) {
+        free(samples);
+        free(tests);
+        printf("\nFalha ao alocar memória para o refinamento.\n");
+        return 1;
+    }
+    for (i = 0; i < settings->refine_budget; i++) tests[i] = i;
+
+    n = n_coarse;
+    found = n_coarse;
+    round = 0;
+    while (1) {
+        status = run_simulations(settings, state, found, &tests[n - found], b_values, 0.0, 0.0, NULL, results, global);
+        if (status != 0) break;
+        if (n == settings->refine_budget) {
+            printf("Orçamento do refinamento esgotado: %d trajetórias em %d rodadas.\n\n", n, round + 1);
+            break;
+        }
+
+        for (i = 0; i < n; i++) {
+            samples[i].b = b_values[i];
+            samples[i].values[0] = results[i].deflection_angle;
+            samples[i].values[1] = results[i].delta_v;
+            samples[i].collision = results[i].collision;
+            samples[i].level = state->levels[i];
+        }
+        found = refine_select(samples, n, settings->refine_tol, settings->refine_budget - n, &b_values[n], &state->levels[n]);
+        if (found < 0) {
+            printf("Falha ao alocar memória para o refinamento.\n");
+            status = 1;
+            break;
+        }
+        if (found == 0) {
+            printf("Nenhum intervalo passa do limiar: refinamento concluído com %d trajetórias em %d rodadas.\n\n", n, round + 1);
+            break;
+        }
+        n += found;
+        round++;
+        printf("Rodada %d do refinamento: %d trajetórias novas, até o nível %d (total: %d de %d) ... \n", round, found, state->levels[n - 1], n, settings->refine_budget);
+    }
+    free(samples);
+    free(tests);
+
+    return status;
+}
+// ....................................................................................................................
+//      Custo estimado de um teste do sweep, para que as trajetórias mais longas sejam iniciadas primeiro. Os testes
+//  que já foram feitos (--resume) não custam nada.
+double job_cost(const int job, void* context) {
+    const sweep_context* sweep = context;
+    const run_settings* settings = sweep->settings;
+    const int test = sweep_test(sweep, job);
+
+    if (journal_done(sweep->done, test)) return 0.0;
+    return estimate_cost(settings, test_b(sweep, test), &settings->slices[test / settings->n_impacts]);
+}
+// ....................................................................................................................
+//      Executa um teste do sweep (chamada pelas threads do sweep.c).
+void run_test(const int job, void* context) {
+    sweep_context* sweep = context;
+    const run_settings* settings = sweep->settings;
+    const int test = sweep_test(sweep, job);
+
+    progress_job_start(&sweep->progress);
+    if (journal_done(sweep->done, test)) {
+        progress_job_end(&sweep->progress, 0.0, 0);
+        return;
+    }
+    simulate(settings, sweep->state, test, test_b(sweep, test), &settings->slices[test / settings->n_impacts], &sweep->slots[job % sweep->n_slots]);
+    progress_job_end(&sweep->progress, job_cost(job, context), 1);
+}
+// ....................................................................................................................
+//      Atualiza o progresso (progress.c), que só desenha alguma coisa algumas vezes por segundo. É chamada após cada
+//  teste; o sweep.c garante que nunca rode em paralelo.
+void report_progress(const int job, const int done, void* context) {
+    sweep_context* sweep = context;
+    const run_settings* settings = sweep->settings;
+    run_state* state = sweep->state;
+    double phase;                                       //  Início da fase atual (--profile).
+    int drawn;
+
+    (void) job;
+    (void) done;
+
+    phase = settings->profiling ? profile_now() : 0.0;
+    drawn = progress_report(&sweep->progress, state->pipeline != NULL ? pipeline_depth(state->pipeline) : -1);
+    if (settings->profiling) profile_add(&state->profile, PERFIL_PROGRESSO, profile_now() - phase, drawn);
+}
+// ....................................................................................................................
+//      Escreve no arquivo global um teste concluído e libera a sua posição do anel: o resultado vai para os redutores,
+//  para a deriva máxima e, no refinamento, para o vetor de todos os resultados. O sweep.c chama esta função na ordem
+//  dos índices (cada prefixo contíguo assim que ele termina), então o arquivo é o mesmo com qualquer número de threads.
+void write_result(const int job, void* context) {
+    sweep_context* sweep = context;
+    const run_settings* settings = sweep->settings;
+    run_state* state = sweep->state;
+    const int test = sweep_test(sweep, job);
+    const double b = test_b(sweep, test);
+    const simulation_result* result = &sweep->slots[job % sweep->n_slots];
+    double phase;                                       //  Início da fase atual (--profile).
+
+    if (journal_done(sweep->done, test)) return;
+
+    //      O arquivo é descarregado no disco no máximo uma vez por segundo, para que os resultados parciais possam ser
+    //  lidos sem pagar um fflush por teste.
+    phase = settings->profiling ? profile_now() : 0.0;
+    write_global(settings, state->levels, sweep->global, test, b, result);
+    if (settings->reducing) reduce_result(&state->reducers, b, result);
+    if (time(NULL) != sweep->flushed) {
+        fflush(sweep->global);
+        sweep->flushed = time(NULL);
+    }
+    if (settings->profiling) profile_add(&state->profile, PERFIL_GLOBAL, profile_now() - phase, 1);
+
+    //  As colisões ficam fora da deriva (veja report_drift).
+    if (settings->config.drift && !result->collision && result->drift_jacobi > sweep->drift) sweep->drift = result->drift_jacobi;
+    if (sweep->results != NULL) sweep->results[test] = *result;
+}
+// ....................................................................................................................
+int sweep_test(const void* context, const int job) {
+    const sweep_context* sweep = context;
+    const run_settings* settings = sweep->settings;
+
+    return sweep->tests != NULL ? sweep->tests[job] : settings->shard.index + job * settings->shard.count;
+}
+// ....................................................................................................................
+double test_b(const void* context, const int test) {
+    const sweep_context* sweep = context;
+    const run_settings* settings = sweep->settings;
+
+    if (sweep->b_values != NULL) return sweep->b_values[test];
+    if (settings->monte_carlo > 0) return settings->slices[test].b;
+    return sweep->b_min + sweep->b_step * (test % settings->n_impacts);
+}
+// ....................................................................................................................
+//      Linha do arquivo de dados globais.
+void write_global(const run_settings* settings, const int* levels, FILE* fo, const int test, const double b, const simulation_result* result) {
+    fprintf(fo, "%d,%.15e,%.15e,%.15e,%.15e,%.15e,%d,%.15e",
+        test + 1, b, result->d_min, result->delta_v, result->delta_v_rel, result->deflection_angle * RAD_TO_DEG, result->collision, result->time_end);
+    if (settings->config.integrator == INTEGRADOR_DOPRI5) fprintf(fo, ",%ld,%ld", result->steps_accepted, result->steps_rejected);
+    if (settings->config.drift) fprintf(fo, ",%.15e", result->drift_jacobi);
+    if (settings->profiling) fprintf(fo, ",%lld,%.6e,%.6e,%s", result->steps, result->wall_time, result->wall_time > 0 ? (double) result->steps / result->wall_time : 0.0,
+        profile_stop_name(result->stop));
+    if (settings->grid.n_axes > 0) fprintf(fo, ",%d,%.15e,%.15e,%.15e", test / settings->n_impacts, settings->slices[test / settings->n_impacts].parameters[0],
+        settings->slices[test / settings->n_impacts].parameters[1], settings->slices[test / settings->n_impacts].parameters[2]);
+    if (settings->refine_budget > 0) fprintf(fo, ",%d", levels[test]);
+    if (settings->monte_carlo > 0) fprintf(fo, ",%.15e,%.15e,%.15e,%.15e", settings->slices[test].errors[MC_B], settings->slices[test].errors[MC_VELOCIDADE], settings->slices[test].errors[MC_DIRECAO],
+        settings->slices[test].errors[MC_FASE_MARTE]);
+    fprintf(fo, "\n");
+}
+// ....................................................................................................................
+void reduce_result(reducer_set* reducers, const double b, const simulation_result* result) {
+    double values[4];
+
+    values[0] = result->d_min;
+    values[1] = result->collision ? NAN : result->delta_v;
+    values[2] = result->collision ? NAN : result->delta_v_rel;
+    values[3] = result->collision ? NAN : result->deflection_angle * RAD_TO_DEG;
+    reducers_add(reducers, b, result->collision, values);
+}
+// ....................................................................................................................
+//      O journal_resume já deixou no arquivo apenas as linhas válidas, uma por teste. Os valores lidos são os do
+//  write_global (com 16 algarismos), então o estado dos redutores é o que eles teriam se esses testes tivessem acabado
+//  agora, a menos do arredondamento do último algarismo.
+int reduce_global(reducer_set* reducers, const char* path) {
+    char line[1024];
+    double values[4];
+    double b;
+    int collision;
+    FILE* fi;
+
+    fi = fopen(path, "r");
+    if (fi == NULL) return errno == ENOENT ? 0 : 1;
+    while (fgets(line, sizeof(line), fi) != NULL) {
+        if (sscanf(line, "%*d,%lf,%lf,%lf,%lf,%lf,%d", &b, &values[0], &values[1], &values[2], &values[3], &collision) != 6) continue;
+        if (collision) values[1] = values[2] = values[3] = NAN;
+        reducers_add(reducers, b, collision, values);
+    }
+    fclose(fi);
+    return 0;
+}
+// ....................................................................................................................
+//      No formato binário, a trajetória está completa se já tem entrada no índice; no CSV, se a última linha do arquivo
+//  é o estado final do teste.
+int trajectory_complete(const int test, const double time_end, void* context) {
+    const run_settings* settings = context;
+    char filename[250];
+
+    if (settings->store != NULL) return store_rows(settings->store, test) > 0;
+
+    sprintf(filename, "%s/pr3c/data_%03d.csv", settings->test_name, test + 1);
+    return journal_csv_complete(filename, time_end);
 }
 // ....................................................................................................................
-//      ** Função para mostrar o tempo no ETA em segundos, minutos, etc.
-//  Pode ignorar isso aqui; não dei muita atenção em manter organizado também...
-void format_time(double seconds, char *buffer) {
-    const int sec = (int) seconds;
-    if (sec < 60) {
-        sprintf(buffer, "%d segundos", sec);
-    } else if (sec < 3600) {
-        const int m = sec / 60;
-        const int s = sec % 60;
-        sprintf(buffer, "%d minutos e %d segundos", m, s);
-    } else if (sec < 86400) {
-        const int h = sec / 3600;
-        const int m = sec % 3600;
-        sprintf(buffer, "%d horas e %d minutos", h, m);
-    } else {
-        const int d = sec / 86400;
-        const int h = sec % 86400;
-        sprintf(buffer, "%d dias e %d minutos", d, h);
+//      Busca do b (--target). A deflexão é uma função contínua de b fora da região de colisão e cresce quando a sonda
+//  passa mais perto de Marte; uma colisão conta como deflexão de 180°, para que a busca caminhe para longe dela. Se o
+//  valor pedido for maior que o da trajetória rasante, a busca termina na fronteira da colisão, e isso é avisado.
+int run_target(const run_settings* settings, run_state* state, FILE* global, const double b_min, const double b_max, double* b_values, simulation_result* results) {
+    target_context context;
+    pipeline_stats writers;
+    double residuals[ALVO_MAX_AVALIACOES];
+    simulation_result* best;
+    const double tol = ALVO_TOLERANCIA * fabs(b_max - b_min);
+    double f_min;
+    double f_max;
+    double root;
+    double residual;
+    double phase;                                       //  Início da fase atual (--profile).
+    int evaluations;
+    int boundary;
+    int status;
+    int i;
+
+    context.settings = settings;
+    context.state = state;
+    context.global = global;
+    context.b_values = b_values;
+    context.results = results;
+    context.residuals = residuals;
+    context.n = 0;
+
+    if (settings->n_writers > 0) {
+        state->pipeline = pipeline_start(settings->n_writers, 1);
+        if (state->pipeline == NULL) {
+            printf("\nFalha ao iniciar as threads de escrita.\n");
+            return 1;
+        }
+    }
+
+    printf("\nBuscando o parâmetro de impacto ... \n");
+    printf("%5s %16s %14s %16s %16s\n", "i", "b [m]", "b [R_Marte]", settings->target == ALVO_DEFLEXAO ? "deflexão [°]" : "Δv [m/s]", "resíduo");
+    phase = settings->profiling ? profile_now() : 0.0;
+    f_min = target_residual(b_min, &context);
+    f_max = target_residual(b_max, &context);
+    status = brent_solve(target_residual, &context, b_min, b_max, f_min, f_max, tol, ALVO_MAX_AVALIACOES - 2, &root, &evaluations);
+    if (settings->profiling) {
+        profile_sweep(&state->profile, profile_now() - phase, 1);
+        phase = profile_now();
+    }
+
+    pipeline_stop(state->pipeline, &writers);
+    state->pipeline = NULL;
+    if (settings->profiling) profile_add(&state->profile, PERFIL_FINALIZACAO, profile_now() - phase, 1);
+    fflush(global);
+    printf("\n");
+    if (settings->n_writers > 0) report_writers(&writers);
+
+    if (status == RAIZ_SEM_INTERVALO) {
+        printf("Os valores em b_min e b_max estão do mesmo lado do valor pedido. Ajuste o intervalo para que ele contenha a solução (e apenas uma).\n");
+        return 1;
+    }
+    if (status == RAIZ_INDEFINIDA) {
+        printf("A busca passou por uma colisão, onde o Δv não está definido. Ajuste o intervalo para ficar de um só lado de Marte, fora da região de colisão.\n");
+        return 1;
+    }
+    if (status == RAIZ_SEM_CONVERGENCIA) {
+        printf("A busca não convergiu em %d trajetórias (a última aproximação é b = %.10e m).\n", context.n, root);
+        return 1;
+    }
+
+    //      Resultado: a melhor aproximação é sempre um ponto avaliado.
+    best = NULL;
+    residual = 0.0;
+    boundary = 0;
+    for (i = 0; i < context.n; i++) {
+        if (b_values[i] == root) {
+            best = &results[i];
+            residual = residuals[i];
+        }
+        if (results[i].collision && fabs(b_values[i] - root) <= 4 * tol) boundary = 1;
+    }
+    if (best == NULL || best->collision || boundary) {
+        printf("O valor pedido não é atingido: a busca terminou na fronteira da região de colisão (b = %.10e m).\n", root);
+        return 1;
+    }
+
+    printf("Solução encontrada com %d trajetórias integradas:\n", context.n);
+    printf("\t b = %.10e m (%.10f R_Marte)\n", root, root / RAIO_MARTE);
+    printf("\t Ângulo de deflexão: %.10f graus\n", best->deflection_angle * RAD_TO_DEG);
+    printf("\t Variação de velocidade heliocêntrica: %.10e m/s\n", best->delta_v);
+    printf("\t Distância mínima: %.6e m\n", best->d_min);
+    printf("\t Resíduo: %.6e %s\n\n", residual, settings->target == ALVO_DEFLEXAO ? "graus" : "m/s");
+
+    //  Um resíduo grande no fim quer dizer que b convergiu para um salto da função, e não para uma raiz.
+    if (fabs(residual) > ALVO_SALTO * fabs(f_max - f_min)) {
+        printf("Atenção: a quantidade varia aos saltos perto desta solução (o teste termina no primeiro passo fora da esfera de influência, e esse passo muda com b). Use um integrador de passo fixo com um dt menor para uma solução mais precisa.\n\n");
+    }
+    printf("Busca concluída =D\n\n");
+    return 0;
+}
+// ....................................................................................................................
+//      Uma avaliação da busca: um teste novo, com o seu arquivo de trajetória e a sua linha no arquivo global.
+double target_residual(const double b, void* context) {
+    target_context* search = context;
+    const run_settings* settings = search->settings;
+    run_state* state = search->state;
+    const int test = search->n++;
+    simulation_result* result = &search->results[test];
+    double value;
+    double phase;                                       //  Início da fase atual (--profile).
+
+    search->b_values[test] = b;
+    simulate(settings, state, test, b, &settings->slices[0], result);
+    phase = settings->profiling ? profile_now() : 0.0;
+    write_global(settings, state->levels, search->global, test, b, result);
+    if (settings->reducing) reduce_result(&state->reducers, b, result);
+    if (settings->profiling) {
+        profile_add(&state->profile, PERFIL_GLOBAL, profile_now() - phase, 1);
+        phase = profile_now();
+    }
+
+    if (settings->target == ALVO_DEFLEXAO) value = result->collision ? 180.0 : result->deflection_angle * RAD_TO_DEG;
+    else value = result->collision ? NAN : result->delta_v;
+
+    search->residuals[test] = value - settings->target_value;
+    printf("%5d %16.8e %14.8f %16.8e %16.8e%s\n", test + 1, b, b / RAIO_MARTE, value, value - settings->target_value, result->collision ? " (colisão)" : "");
+    fflush(stdout);
+    if (settings->profiling) profile_add(&state->profile, PERFIL_PROGRESSO, profile_now() - phase, 1);
+    return value - settings->target_value;
+}
+// ....................................................................................................................
+//      Resumo da deriva. As colisões ficam de fora: elas param dentro de Marte, perto da singularidade do potencial, e o
+//  desvio delas não diz nada sobre o passo.
+void report_drift(const double jacobi) {
+    printf("Maior deriva da integral de Jacobi nos testes sem colisão: %.4e (em unidades de v_inf²/2)\n\n", jacobi);
+}
+// ....................................................................................................................
+//      Estatísticas da escrita assíncrona.
+void report_writers(const pipeline_stats* stats) {
+    const double elapsed = stats->elapsed_seconds > 0 ? stats->elapsed_seconds : 1e-9;
+
+    printf("Escrita assíncrona: %ld trajetórias, %lld linhas e %.2f MB em %d thread(s) de escrita; %.3e linhas/s e %.2f MB/s ao longo da simulação.\n",
+        stats->trajectories, stats->rows, stats->bytes / 1e6, stats->writers, stats->rows / elapsed, stats->bytes / 1e6 / elapsed);
+    printf("\t Fila: %ld buffers enviados, profundidade média de %.2f e máxima de %d (pool de %d buffers com %d linhas).\n",
+        stats->buffers, stats->mean_depth, stats->max_depth, stats->pool, PIPELINE_LINHAS_POR_BUFFER);
+    printf("\t Escrita ocupada por %.3f s de %.3f s; a integração esperou por um buffer livre %ld vezes (%.3f s).\n\n",
+        stats->busy_seconds, elapsed, stats->waits, stats->wait_seconds);
+}
+// ....................................................................................................................
+//      Desvios padrão do Monte Carlo: os nomes são os das colunas do arquivo global, sem o sufixo "_error".
+int dispersion_parse(double sigma[], const char* text) {
+    const char* names[MC_ERROS] = {"b", "velocity", "direction", "mars_angle"};
+    const char* value = strchr(text, '=');
+    char* end;
+    double deviation;
+    int k;
+
+    if (value == NULL) return -1;
+    deviation = strtod(value + 1, &end);
+    if (end == value + 1 || *end != '\0' || !(deviation >= 0)) return -1;
+
+    for (k = 0; k < MC_ERROS; k++) {
+        if (strlen(names[k]) == (size_t) (value - text) && strncmp(text, names[k], value - text) == 0) {
+            sigma[k] = deviation;
+            return 0;
+        }
+    }
+    return -1;
+}
+// ....................................................................................................................
+//      Erros de injeção de uma amostra. A sonda é apontada para a posição nominal de Marte (cos_angle e sin_angle
+//  continuam os nominais) com a velocidade heliocêntrica nominal mais o erro da manobra, mas Marte está, de fato, no
+//  ângulo sorteado. O simulate calcula o estado relativo nominal, então a diferença entre Marte nominal e Marte sorteado
+//  entra nos erros de posição e de velocidade relativas, e o estado heliocêntrico da sonda não depende do erro de Marte.
+double monte_carlo_sample(const run_settings* settings, grid_slice* slice, const int sample, const double b) {
+    flyby3_conditions* conditions = &slice->conditions;
+    double z[MC_ERROS];                                 //  Normais padrão da amostra (dois blocos do Philox).
+    double nominal_coord[2];                            // [m]      - Posição nominal de Marte.
+    double nominal_velocity[2];                         // [m/s]    - Velocidade nominal de Marte.
+    double speed;                                       // [m/s]    - Módulo da velocidade relativa sorteada.
+    double direction;                                   // [rad]    - Direção da velocidade relativa sorteada.
+    int k;
+
+    philox_normal(settings->mc_seed, (uint64_t) sample, 0, &z[0]);
+    philox_normal(settings->mc_seed, (uint64_t) sample, 1, &z[2]);
+    for (k = 0; k < MC_ERROS; k++) slice->errors[k] = settings->mc_sigma[k] * z[k];
+
+    nominal_coord[0] = conditions->mars_coord[0];
+    nominal_coord[1] = conditions->mars_coord[1];
+    nominal_velocity[0] = conditions->mars_velocity[0];
+    nominal_velocity[1] = conditions->mars_velocity[1];
+    conditions->mars_angle_init += slice->errors[MC_FASE_MARTE] * DEG_TO_RAD;
+    flyby3_mars_state(conditions, 0.0, conditions->mars_coord, conditions->mars_velocity);
+
+    speed = conditions->v_sonda_init + slice->errors[MC_VELOCIDADE];
+    direction = (slice->parameters[1] + slice->errors[MC_DIRECAO]) * DEG_TO_RAD;
+    conditions->position_error[0] = nominal_coord[0] - conditions->mars_coord[0];
+    conditions->position_error[1] = nominal_coord[1] - conditions->mars_coord[1];
+    conditions->velocity_error[0] = (- speed * sin(direction) + conditions->v_sonda_init * conditions->sin_angle) + (nominal_velocity[0] - conditions->mars_velocity[0]);
+    conditions->velocity_error[1] = (speed * cos(direction) - conditions->v_sonda_init * conditions->cos_angle) + (nominal_velocity[1] - conditions->mars_velocity[1]);
+    conditions->perturbed = 1;
+
+    return b + slice->errors[MC_B];
+}
+// ....................................................................................................................
+//      Estatísticas do Monte Carlo. As amostras vêm do arquivo global, que na retomada também tem as da execução
+//  interrompida (as linhas novas vêm depois das antigas), então elas são colocadas na ordem das amostras antes das
+//  somas (o resultado é o mesmo com qualquer número de threads e com retomadas). O Δv e a deflexão só existem nas
+//  amostras sem colisão; a colisão entra como a média de um indicador (a probabilidade), com o erro padrão binomial e
+//  o intervalo de 95% de Wilson.
+int report_monte_carlo(const run_settings* settings) {
+    const char* names[5] = {"collision", "d_min", "delta_v", "delta_v_rel", "deflection_angle"};
+    double* values[5];                                  //  Valores de cada quantidade (ordenados antes dos quantis).
+    int counts[5];                                      //  Número de valores de cada quantidade.
+    double* rows;                                       //  Quantidades de cada amostra, na ordem das amostras.
+    unsigned char* present;                             //  1 para as amostras encontradas no arquivo global.
+    double row[5];
+    int sample;
+    double mean;
+    double variance;
+    double p;
+    double error;
+    double center;
+    double half;
+    char filename[200];
+    char line[1024];
+    int collision;
+    int n;
+    int k;
+    int j;
+    FILE* fi;
+    FILE* fo;
+
+    rows = malloc(sizeof(double) * 5 * settings->monte_carlo);
+    present = calloc(settings->monte_carlo, sizeof(unsigned char));
+    for (k = 0; k < 5; k++) {
+        values[k] = malloc(sizeof(double) * settings->monte_carlo);
+        counts[k] = 0;
+    }
+    if (rows == NULL || present == NULL || values[0] == NULL || values[1] == NULL || values[2] == NULL || values[3] == NULL || values[4] == NULL) {
+        for (k = 0; k < 5; k++) free(values[k]);
+        free(rows);
+        free(present);
+        printf("Falha ao alocar memória para as estatísticas do Monte Carlo.\n");
+        return 1;
+    }
+
+    sprintf(filename, "%s/global_pr3c.csv", settings->test_name);
+    fi = fopen(filename, "r");
+    if (fi == NULL || fgets(line, sizeof(line), fi) == NULL) {
+        if (fi != NULL) fclose(fi);
+        for (k = 0; k < 5; k++) free(values[k]);
+        free(rows);
+        free(present);
+        perror("Falha ao ler o arquivo de dados globais");
+        return 1;
+    }
+    while (fgets(line, sizeof(line), fi) != NULL) {
+        if (sscanf(line, "%d,%*f,%lf,%lf,%lf,%lf,%d", &sample, &row[1], &row[2], &row[3], &row[4], &collision) != 6) continue;
+        if (sample < 1 || sample > settings->monte_carlo) continue;
+        row[0] = collision;
+        for (k = 0; k < 5; k++) rows[5 * (sample - 1) + k] = row[k];
+        present[sample - 1] = 1;
+    }
+    fclose(fi);
+
+    n = 0;
+    for (j = 0; j < settings->monte_carlo; j++) {
+        if (!present[j]) continue;
+        for (k = 0; k < 5; k++) if (k < 2 || rows[5 * j] == 0) values[k][counts[k]++] = rows[5 * j + k];
+        n++;
+    }
+    free(rows);
+    free(present);
+
+    sprintf(filename, "%s/montecarlo_pr3c.csv", settings->test_name);
+    fo = fopen(filename, "w");
+    if (fo == NULL) {
+        for (k = 0; k < 5; k++) free(values[k]);
+        perror("Falha ao criar o arquivo de estatísticas do Monte Carlo");
+        return 1;
     }
+    fprintf(fo, "quantity,n,mean,std,min,p05,p50,p95,max\n");
+
+    p = 0.0;
+    for (j = 0; j < counts[0]; j++) p += values[0][j];
+    p = n > 0 ? p / n : 0.0;
+    error = n > 0 ? sqrt(p * (1 - p) / n) : 0.0;
+    center = n > 0 ? (p + 1.96 * 1.96 / (2.0 * n)) / (1 + 1.96 * 1.96 / n) : 0.0;
+    half = n > 0 ? 1.96 / (1 + 1.96 * 1.96 / n) * sqrt(p * (1 - p) / n + 1.96 * 1.96 / (4.0 * n * n)) : 0.0;
+    printf("\nMonte Carlo com %d amostras:\n", n);
+    printf("\t Probabilidade de colisão: %.6f ± %.6f (intervalo de 95%%: [%.6f; %.6f])\n", p, error, center - half, center + half);
+
+    for (k = 0; k < 5; k++) {
+        mean = 0.0;
+        for (j = 0; j < counts[k]; j++) mean += values[k][j];
+        mean = counts[k] > 0 ? mean / counts[k] : 0.0;
+        variance = 0.0;
+        for (j = 0; j < counts[k]; j++) variance += (values[k][j] - mean) * (values[k][j] - mean);
+        variance = counts[k] > 1 ? variance / (counts[k] - 1) : 0.0;
+        qsort(values[k], counts[k], sizeof(double), compare_doubles);
+
+        fprintf(fo, "%s,%d,%.15e,%.15e,%.15e,%.15e,%.15e,%.15e,%.15e\n", names[k], counts[k], mean, sqrt(variance),
+            counts[k] > 0 ? values[k][0] : 0.0, quantile(values[k], counts[k], 0.05), quantile(values[k], counts[k], 0.5),
+            quantile(values[k], counts[k], 0.95), counts[k] > 0 ? values[k][counts[k] - 1] : 0.0);
+        if (k > 0) printf("\t %s (%d amostras): média %.6e, desvio padrão %.6e, p05 %.6e, mediana %.6e, p95 %.6e\n", names[k], counts[k], mean,
+            sqrt(variance), quantile(values[k], counts[k], 0.05), quantile(values[k], counts[k], 0.5), quantile(values[k], counts[k], 0.95));
+    }
+    fclose(fo);
+    printf("\t (d_min em metros, Δv em m/s e deflexão em graus; o Δv e a deflexão são das amostras sem colisão)\n");
+    printf("As estatísticas foram salvas em: '%s'\n\n", filename);
+
+    for (k = 0; k < 5; k++) free(values[k]);
+    return 0;
+}
+// ....................................................................................................................
+double quantile(const double* sorted, const int n, const double p) {
+    const double position = p * (n - 1);
+    const int below = (int) floor(position);
+
+    if (n <= 0) return 0.0;
+    if (below >= n - 1) return sorted[n - 1];
+    return sorted[below] + (position - below) * (sorted[below + 1] - sorted[below]);
 }
-// ....................................................................................................................
\ No newline at end of file
+// ....................................................................................................................
+int compare_doubles(const void* a, const void* b) {
+    const double x = *(const double*) a;
+    const double y = *(const double*) b;
+
+    return (x > y) - (x < y);
+}
+// ....................................................................................................................
@@ -0,0 +1,800 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Comentários para desabilitar algumas funções de análise do CLion:
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ....................................................................................................................
+//      Bibliotecas:
+#include <math.h>
+#include <stdlib.h>
+
+#include "flyby.h"
+#include "sweep.h"
+// ....................................................................................................................
+//      Constantes (as mesmas do fly_by_pr2c).
+#define CONSTANTE_GRAVITACIONAL 6.6743e-11              //  Constante gravitacional de Newton no sistema internacional.
+#define MASSA_MARTE 6.4171e23                           //  Massa de Marte. (Em quilogramas)
+#define RAIO_MARTE 3.3895E6                             //  Raio do planeta Marte. (Em metros)
+
+#define STEPS_PARA_OUTPUT 180                           //  Segundos entre duas linhas no padrão do programa. O critério de
+                                                        //  parada por distância só vale depois de 10 * STEPS_PARA_OUTPUT
+                                                        //  segundos (para não parar no começo da simulação).
+// ....................................................................................................................
+//      Funções auxiliares (aqui temos um "mini-header" dentro do arquivo *.c)
+//  - Entrega a linha (t, x, y, v_x, v_y, d) ao destino das linhas, se houver um.
+static void emit_row(const flyby_sink* sink, double time, const double* r, const double* v, double distance);
+
+//  - Integração com passo adaptativo (Dormand-Prince 5(4)). Avança r e v (que chegam com o estado inicial) até um
+//  critério de parada, entrega as linhas na cadência escolhida por meio da saída densa e preenche d_min, o indicador de
+//  colisão, o motivo do fim e o número de passos. Retorna o tempo final da integração e soma as linhas em *n_rows.
+static double integrate_adaptive(const flyby_config* config, const flyby_conditions* conditions, output_cadence* cadence, double* r, double* v,
+    flyby_result* result, const flyby_sink* sink, long* n_rows);
+
+//  - Eventos de um passo aceito do dopri5 (colisão e saída da esfera de parada), localizados na saída densa. Retorna a
+//  posição do evento dentro do passo (theta), ou 1 se não houver evento.
+//  const dopri5_workspace* workspace       → Estágios do passo aceito (antes do dopri5_accept).
+//  const double* r, const double* v        → Estado no começo do passo.
+//  double* r_new, double* v_new            → Estado no fim do passo; recebem o estado no ponto do evento.
+//  double time_end                         → Tempo no fim do passo.
+//  double stop_value                       → Distância do critério de parada.
+//  int* event                              → Recebe o evento (PARADA_COLISAO, PARADA_DISTANCIA ou PARADA_TEMPO se nenhum).
+static double adaptive_event(const dopri5_workspace* workspace, const double* r, const double* v, double* r_new, double* v_new, double time_end,
+    double stop_value, int* event);
+
+//  - Destino das linhas do flyby_trajectory: guarda a linha no vetor de quem chama, se ela couber (context é um
+//  flyby_rows).
+static void store_row(const double* values, void* context);
+
+//  - Funções chamadas pelo sweep (sweep.h): estima o custo de uma trajetória e a integra sem guardar as linhas.
+static double sweep_cost(int job, void* context);
+static void sweep_job(int job, void* context);
+// ....................................................................................................................
+//      Dados do flyby_sweep.
+typedef struct {
+    const flyby_config* config;                         //  Configuração comum.
+    const double* b_values;                             //  Parâmetro de impacto de cada trajetória.
+    flyby_result* results;                              //  Resultados de cada trajetória.
+} flyby_sweep_context;
+
+//      Vetor de linhas do flyby_trajectory.
+typedef struct {
+    double* rows;                                       //  Linhas, coluna por coluna (pode ser NULL).
+    long capacity;                                      //  Número de linhas que cabem em 'rows'.
+    long n_rows;                                        //  Linhas recebidas até agora.
+} flyby_rows;
+// ....................................................................................................................
+flyby_config flyby_default_config(const double x_init_factor, const double velocity_infinity, const double max_time, const double dt) {
+    flyby_config config;
+
+    config.x_init_factor = x_init_factor;
+    config.velocity_infinity = velocity_infinity;
+    config.max_time = max_time;
+    config.dt = dt;
+    config.rows = 0;
+    config.integrator = INTEGRADOR_EULER;
+    config.precision = PRECISAO_DUPLA;
+    config.cadence = CADENCIA_TEMPO;
+    config.output_interval = STEPS_PARA_OUTPUT;
+    config.tol_rel = 1e-10;
+    config.tol_abs = 1e-6;
+    return config;
+}
+// ....................................................................................................................
+int flyby_check(const flyby_config* config) {
+    if (config == NULL) return FLYBY_ERRO_CONFIG;
+    if (!(config->x_init_factor > 0) || !(config->velocity_infinity > 0) || !(config->max_time > 0) || !(config->dt > 0)) return FLYBY_ERRO_CONFIG;
+    if (config->integrator < INTEGRADOR_EULER || config->integrator > INTEGRADOR_DOPRI5) return FLYBY_ERRO_CONFIG;
+    if (config->tol_rel < 0 || config->tol_abs < 0 || !(config->tol_rel + config->tol_abs > 0)) return FLYBY_ERRO_CONFIG;
+    if (config->precision != PRECISAO_DUPLA && (config->precision != PRECISAO_MISTA || config->integrator != INTEGRADOR_EULER)) return FLYBY_ERRO_CONFIG;
+    if (config->cadence < CADENCIA_TEMPO || config->cadence > CADENCIA_DISTANCIA || config->rows < 0 || config->output_interval < 0) return FLYBY_ERRO_CONFIG;
+    return 0;
+}
+// ....................................................................................................................
+void flyby_conditions_init(flyby_conditions* conditions, const double x_init_factor, const double velocity_infinity) {
+    conditions->x_init = x_init_factor * -RAIO_MARTE;
+    conditions->stop_value = (-1) * conditions->x_init;
+    conditions->v_infinite_in = velocity_infinity;
+    conditions->v_x_init = sqrt(velocity_infinity * velocity_infinity + 2 * CONSTANTE_GRAVITACIONAL * MASSA_MARTE / fabs(conditions->x_init));
+}
+// ....................................................................................................................
+//      Mesmo laço do simulate do fly_by_pr2c, sem os arquivos: as linhas vão para 'rows' e os critérios de parada são
+//  verificados a cada passo. O estado final é sempre a última linha.
+long flyby_trajectory(const flyby_config* config, const double b, flyby_result* result, double* rows, const long capacity) {
+    flyby_rows store;
+    flyby_sink sink;
+
+    store.rows = rows;
+    store.capacity = capacity;
+    store.n_rows = 0;
+    sink.row = store_row;
+    sink.step = NULL;
+    sink.context = &store;
+    return flyby_integrate(config, b, result, &sink);
+}
+// ....................................................................................................................
+long flyby_integrate(const flyby_config* config, const double b, flyby_result* result, const flyby_sink* sink) {
+    const double mu = CONSTANTE_GRAVITACIONAL * MASSA_MARTE;
+    const double dt = config != NULL ? config->dt : 0.0;
+    flyby_conditions conditions;                        //                  - Condições iniciais.
+    output_cadence cadence;                             //                  - Cadência das linhas (veja cadence.h).
+    double r[2];                                        // [m, m]           - Posição da sonda.
+    double v[2];                                        // [m/s, m/s]       - Velocidade da sonda.
+    double a[2];                                        // [m/s², m/s²]     - Aceleração da sonda (apenas para o leapfrog).
+    double r_temp[2];                                   // [m, m]           - Posição temporária da sonda.
+    double v_temp[2];                                   // [m/s, m/s]       - Velocidade temporária da sonda.
+    double div;                                         // [mˆ2]            - Módulo quadrado do vetor distância.
+    double factor;                                      // [1/s²]           - μ / |r|^3 em float32 (precisão mista).
+    float f_div;                                        // [mˆ2]            - div em float32 (idem).
+    float f_root;                                       // [m]              - |r| em float32 (idem).
+    double radial;                                      // [m²/s]           - Produto r·v antes do passo (detecta o periapsis).
+    double crossing;                                    //                  - Posição da entrada em Marte dentro do passo (-1 se não houver).
+    double time;                                        // [s]              - Tempo de integração.
+    double exit_time;                                   // [s]              - Tempo do estado depois do passo (sink->step).
+    double distance;                                    // [m]              - Distância entre a sonda e Marte.
+    long n_rows;                                        //                  - Linhas da trajetória.
+    int steps_to_output;                                //                  - Passos entre duas linhas (cadência por tempo).
+    int exported;                                       //                  - 1 se o estado atual já foi exportado.
+    int early;                                          //                  - 1 se quem chama encerrou a trajetória (sink->step).
+
+    if (flyby_check(config) != 0 || result == NULL) return FLYBY_ERRO_CONFIG;
+    flyby_conditions_init(&conditions, config->x_init_factor, config->velocity_infinity);
+    // ................................................................................................................
+    //          Condições iniciais.
+    r[0] = conditions.x_init;
+    r[1] = b;
+    v[0] = conditions.v_x_init;
+    v[1] = 0.0;
+
+    distance = sqrt(r[0] * r[0] + r[1] * r[1]);
+
+    result->b = b;
+    result->collision = 0;
+    result->d_min = distance;
+    result->steps = 0;
+    result->steps_accepted = 0;
+    result->steps_rejected = 0;
+    result->stop = PARADA_TEMPO;
+    n_rows = 0;
+
+    //  O Dormand-Prince escolhe o próprio passo, então ele tem um laço separado (integrate_adaptive), com as linhas
+    //  tiradas da saída densa a cada output_interval segundos.
+    if (config->integrator == INTEGRADOR_DOPRI5) {
+        cadence_init(&cadence, config->cadence, config->rows, config->output_interval, 0.0, mu, conditions.stop_value, RAIO_MARTE, r, v);
+        time = integrate_adaptive(config, &conditions, &cadence, r, v, result, sink, &n_rows);
+        flyby_exit(r, v, conditions.v_infinite_in, &result->delta_v, &result->deflection_angle);
+        result->time_end = time;
+        return n_rows;
+    }
+
+    if (config->integrator == INTEGRADOR_LEAPFROG) flyby_acceleration(0.0, r, v, a, NULL);
+    steps_to_output = (int) (config->output_interval / dt);
+    cadence_init(&cadence, config->cadence, config->rows, (steps_to_output > 1 ? steps_to_output : 1) * dt, 0.5 * dt, mu,
+        conditions.stop_value, RAIO_MARTE, r, v);
+    exported = 0;
+    crossing = -1.0;
+    // ................................................................................................................
+    for (time = 0; time < config->max_time; time += dt) { // NOLINT(*-flp30-c)
+        exported = cadence_due(&cadence);
+        if (exported) {
+            emit_row(sink, time, r, v, distance);
+            n_rows++;
+        }
+
+        //  Critérios de parada: colisão e distância (depois de 10 * STEPS_PARA_OUTPUT segundos).
+        if (distance < RAIO_MARTE) {
+            result->d_min = distance;
+            result->collision = 1;
+            result->stop = PARADA_COLISAO;
+            break;
+        }
+        if (distance >= conditions.stop_value && time > 10 * STEPS_PARA_OUTPUT) {
+            result->stop = PARADA_DISTANCIA;
+            break;
+        }
+
+        cadence_advance(&cadence, cadence_measure(&cadence, r, v, dt));
+        exported = 0;
+        result->steps++;
+        // ............................................................................................................
+        if (config->integrator == INTEGRADOR_EULER) {
+            div = r[0] * r[0] + r[1] * r[1];
+            r_temp[0] = r[0] + v[0] * dt;
+            r_temp[1] = r[1] + v[1] * dt;
+            if (config->precision == PRECISAO_MISTA) {
+                f_div = (float) div;
+                f_root = sqrtf(f_div);
+                factor = (double) ((float) mu / (f_div * f_root));
+                v_temp[0] = v[0] - (factor * r[0]) * dt;
+                v_temp[1] = v[1] - (factor * r[1]) * dt;
+            } else {
+                v_temp[0] = v[0] - (CONSTANTE_GRAVITACIONAL * MASSA_MARTE * r[0] / (div * sqrt(div))) * dt;
+                v_temp[1] = v[1] - (CONSTANTE_GRAVITACIONAL * MASSA_MARTE * r[1] / (div * sqrt(div))) * dt;
+            }
+
+            r[0] = r_temp[0];
+            r[1] = r_temp[1];
+            v[0] = v_temp[0];
+            v[1] = v_temp[1];
+
+            distance = config->precision == PRECISAO_MISTA ? (double) f_root : sqrt(div);
+        } else {
+            radial = r[0] * v[0] + r[1] * v[1];
+            r_temp[0] = r[0];
+            r_temp[1] = r[1];
+            v_temp[0] = v[0];
+            v_temp[1] = v[1];
+            switch (config->integrator) {
+                case INTEGRADOR_LEAPFROG: leapfrog_step(2, time, r, v, a, dt, flyby_acceleration, NULL); break;
+                case INTEGRADOR_RK4: rk4_step(2, time, r, v, dt, flyby_acceleration, NULL); break;
+                default: yoshida_step(2, time, r, v, dt, flyby_acceleration, NULL); break;
+            }
+            crossing = flyby_collision(dt, r_temp, v_temp, r, v);
+            distance = sqrt(r[0] * r[0] + r[1] * r[1]);
+
+            //  Periapsis entre dois passos: o da cônica osculadora.
+            if (crossing < 0 && radial < 0 && r[0] * v[0] + r[1] * v[1] >= 0) {
+                div = flyby_periapsis(r, v);
+                if (div < result->d_min) result->d_min = div;
+            }
+        }
+        if (distance < result->d_min) result->d_min = distance;
+
+        //  Acompanhamento de quem chama, com o estado do fim do passo (a deriva e o --early-exit do fly_by_pr2c).
+        exit_time = time + dt;
+        early = sink != NULL && sink->step != NULL && sink->step(&exit_time, r, v, crossing >= 0, sink->context);
+
+        //  Colisão dentro do passo: a trajetória termina na superfície (flyby_collision).
+        if (crossing >= 0) {
+            time += crossing * dt;
+            result->d_min = distance;
+            result->collision = 1;
+            result->stop = PARADA_COLISAO;
+            break;
+        }
+
+        //  Saída antecipada pedida por quem chama: o estado já é o do ponto de parada.
+        if (early) {
+            time = exit_time;
+            distance = sqrt(r[0] * r[0] + r[1] * r[1]);
+            result->stop = PARADA_ANTECIPADA;
+            break;
+        }
+    }
+
+    if (!exported) {
+        emit_row(sink, time, r, v, distance);
+        n_rows++;
+    }
+    // ................................................................................................................
+    flyby_exit(r, v, conditions.v_infinite_in, &result->delta_v, &result->deflection_angle);
+    result->time_end = time;
+    return n_rows;
+}
+// ....................................................................................................................
+//      Integração com passo adaptativo (Dormand-Prince 5(4)).
+//  O passo cresce longe de Marte, onde a força é pequena, e diminui perto do periapsis. Os critérios de parada são
+//  verificados a cada passo aceito (com o ponto do evento localizado dentro do passo, veja adaptive_event), e as
+//  amostras seguem a cadência escolhida graças à saída densa (interpolação dentro do passo). A medida da cadência
+//  cresce linearmente dentro do passo.
+static double integrate_adaptive(const flyby_config* config, const flyby_conditions* conditions, output_cadence* cadence, double* r, double* v,
+    flyby_result* result, const flyby_sink* sink, long* n_rows) {
+    dopri5_workspace workspace;                         //                  - Estágios do Dormand-Prince.
+    double r_new[2];                                    // [m, m]           - Posição proposta pelo passo.
+    double v_new[2];                                    // [m/s, m/s]       - Velocidade proposta pelo passo.
+    double r_out[2];                                    // [m, m]           - Posição interpolada para a saída.
+    double v_out[2];                                    // [m/s, m/s]       - Velocidade interpolada para a saída.
+    double time;                                        // [s]              - Tempo de integração.
+    double exit_time;                                   // [s]              - Tempo do estado depois do passo (sink->step).
+    double h;                                           // [s]              - Passo atual.
+    double err;                                         //                  - Erro local normalizado (aceita se <= 1).
+    double ds;                                          //                  - Medida da cadência acumulada no passo.
+    double fraction;                                    //                  - Posição de uma amostra dentro do passo.
+    double last_output;                                 // [s]              - Tempo da última amostra.
+    double radial;                                      // [m²/s]           - Produto r·v antes do passo.
+    double distance;                                    // [m]              - Distância entre a sonda e Marte.
+    double theta;                                       //                  - Posição do evento dentro do passo (1 sem evento).
+    int event;                                          //                  - Evento do passo (PARADA_*, ou PARADA_TEMPO sem evento).
+    int after_reject;                                   //                  - 1 se o passo anterior foi rejeitado.
+    int early;                                          //                  - 1 se quem chama encerrou a trajetória (sink->step).
+
+    dopri5_init(&workspace, 2);
+    distance = sqrt(r[0] * r[0] + r[1] * r[1]);
+    time = 0.0;
+    h = config->dt;
+    last_output = -1.0;
+    after_reject = 0;
+
+    while (time < config->max_time) {
+        if (time + h > config->max_time) h = config->max_time - time;
+        err = dopri5_step(&workspace, time, r, v, h, flyby_acceleration, NULL, config->tol_rel, config->tol_abs, r_new, v_new);
+
+        //  Passo rejeitado: tenta de novo com um passo menor (um erro NaN também é rejeitado).
+        result->steps++;
+        if (!(err <= 1.0)) {
+            result->steps_rejected++;
+            h = isnan(err) ? 0.2 * h : dopri5_next_step(h, err, 1);
+            after_reject = 1;
+            continue;
+        }
+
+        //      Critérios de parada (os mesmos do passo fixo). A colisão e a saída da esfera de parada são localizadas na
+        //  saída densa (adaptive_event), e o passo termina no ponto do evento.
+        theta = adaptive_event(&workspace, r, v, r_new, v_new, time + h, conditions->stop_value, &event);
+
+        //  Entrega as amostras que caem dentro deste passo (apenas até o evento).
+        ds = cadence_measure(cadence, r, v, h);
+        while (cadence_next(cadence, ds, &fraction) && fraction <= theta) {
+            dopri5_dense(&workspace, fraction, r_out, v_out);
+            last_output = time + fraction * h;
+            emit_row(sink, last_output, r_out, v_out, sqrt(r_out[0] * r_out[0] + r_out[1] * r_out[1]));
+            (*n_rows)++;
+        }
+        cadence_advance(cadence, ds);
+
+        //  Aceita o passo.
+        dopri5_accept(&workspace);
+        result->steps_accepted++;
+
+        radial = r[0] * v[0] + r[1] * v[1];
+        time += event != PARADA_TEMPO ? theta * h : h;
+        r[0] = r_new[0];
+        r[1] = r_new[1];
+        v[0] = v_new[0];
+        v[1] = v_new[1];
+        distance = sqrt(r[0] * r[0] + r[1] * r[1]);
+
+        h = dopri5_next_step(h, err, after_reject);
+        after_reject = 0;
+
+        //  Periapsis pela cônica osculadora (veja o laço de passo fixo).
+        if (radial < 0 && r[0] * v[0] + r[1] * v[1] >= 0) {
+            err = flyby_periapsis(r, v);
+            if (err < result->d_min) result->d_min = err;
+        }
+        if (distance < result->d_min) result->d_min = distance;
+
+        //  Acompanhamento de quem chama (a deriva e o --early-exit do fly_by_pr2c).
+        exit_time = time;
+        early = sink != NULL && sink->step != NULL && sink->step(&exit_time, r, v, event != PARADA_TEMPO, sink->context);
+
+        //  1. Colisão com Marte: a distância mínima é a da superfície, onde a trajetória termina.
+        if (event == PARADA_COLISAO) {
+            result->d_min = distance;
+            result->collision = 1;
+        }
+
+        //  2. Saída da esfera de raio stop_value.
+        if (event != PARADA_TEMPO) {
+            result->stop = event;
+            break;
+        }
+
+        //  3. Saída antecipada pedida por quem chama: o estado já é o do ponto de parada.
+        if (early) {
+            time = exit_time;
+            distance = sqrt(r[0] * r[0] + r[1] * r[1]);
+            result->stop = PARADA_ANTECIPADA;
+            break;
+        }
+    }
+
+    //  Entrega também o estado final, caso ele não coincida com uma amostra.
+    if (last_output < time) {
+        emit_row(sink, time, r, v, distance);
+        (*n_rows)++;
+    }
+    return time;
+}
+// ....................................................................................................................
+//      Eventos de um passo aceito. Sem a localização, a trajetória terminaria no fim do passo, que com o passo adaptativo
+//  pode estar milhares de quilômetros depois da superfície ou da esfera de parada (o tempo final, a deflexão e o d_min
+//  dependeriam do passo). Aqui o ponto do evento é encontrado por bisseção em |r(theta)| (dopri5_event):
+//  - Colisão: o fim do passo está dentro de Marte, ou as duas pontas estão fora mas o periapsis do passo (onde r·v troca
+//  de sinal) está dentro (colisão rasante). O evento é a entrada na superfície.
+//  - Parada: o fim do passo está fora da esfera de raio stop_value (com o mesmo critério temporal do passo fixo). O evento
+//  é a saída da esfera; se o começo do passo também estava fora, a trajetória termina no fim do passo.
+static double adaptive_event(const dopri5_workspace* workspace, const double* r, const double* v, double* r_new, double* v_new, const double time_end,
+    double stop_value, int* event) {
+    const double distance = sqrt(r[0] * r[0] + r[1] * r[1]);
+    const double distance_new = sqrt(r_new[0] * r_new[0] + r_new[1] * r_new[1]);
+    double surface = RAIO_MARTE;                        // [m]              - Raio do evento de colisão.
+    double r_event[2];                                  // [m, m]           - Posição no periapsis do passo.
+    double v_event[2];                                  // [m/s, m/s]       - Velocidade no periapsis do passo.
+    double theta;
+
+    *event = PARADA_TEMPO;
+    if (distance_new < RAIO_MARTE) {
+        *event = PARADA_COLISAO;
+        return dopri5_event(workspace, 0.0, 1.0, event_radius, &surface, r_new, v_new);
+    }
+    if (r[0] * v[0] + r[1] * v[1] < 0 && r_new[0] * v_new[0] + r_new[1] * v_new[1] >= 0 && flyby_periapsis(r_new, v_new) < RAIO_MARTE) {
+        theta = dopri5_event(workspace, 0.0, 1.0, event_radial, NULL, r_event, v_event);
+        if (sqrt(r_event[0] * r_event[0] + r_event[1] * r_event[1]) < RAIO_MARTE) {
+            *event = PARADA_COLISAO;
+            return dopri5_event(workspace, 0.0, theta, event_radius, &surface, r_new, v_new);
+        }
+    }
+    if (distance_new >= stop_value && time_end > 10 * STEPS_PARA_OUTPUT) {
+        *event = PARADA_DISTANCIA;
+        if (distance < stop_value) return dopri5_event(workspace, 0.0, 1.0, event_radius, &stop_value, r_new, v_new);
+    }
+    return 1.0;
+}
+// ....................................................................................................................
+//      Integração em lote (SIMD), o laço de Euler do flyby_integrate para várias trajetórias ao mesmo tempo: todas
+//  começam em t = 0 com o mesmo dt, então o tempo é o mesmo para todas as lanes. batch_euler_run avança o lote inteiro
+//  até o próximo evento de alguma lane (linha devida, colisão ou parada); aqui cada lane com evento entrega a sua linha
+//  e é desativada (mascarada) ao colidir ou sair da esfera de raio stop_value.
+int flyby_batch(const flyby_config* config, const int isa, const int count, const double* b_values, flyby_result* results, const flyby_sink* sinks) {
+    const double mu = CONSTANTE_GRAVITACIONAL * MASSA_MARTE;
+    flyby_conditions conditions;                        //                  - Condições iniciais (as mesmas para todas as lanes).
+    batch_params params;                                //                  - Parâmetros comuns do lote.
+    batch_lanes lanes;                                  //                  - Estado do lote.
+    output_cadence cadence[BATCH_MAX_LANES];            //                  - Cadência das linhas de cada lane.
+    int exported[BATCH_MAX_LANES];                      //                  - 1 se o estado atual da lane já foi entregue.
+    double r[2];                                        // [m, m]           - Posição de uma lane.
+    double v[2];                                        // [m/s, m/s]       - Velocidade de uma lane.
+    double end_time[BATCH_MAX_LANES];                   // [s]              - Tempo em que cada lane parou.
+    double time;                                        // [s]              - Tempo de integração (o mesmo para o lote todo).
+    int steps_to_output;                                //                  - Passos entre duas linhas (cadência por tempo).
+    int n_active;
+    int l;
+
+    if (flyby_check(config) != 0 || config->integrator != INTEGRADOR_EULER || isa < SIMD_ESCALAR || isa > SIMD_AVX512) return FLYBY_ERRO_CONFIG;
+    if (count < 1 || count > batch_width(isa) || b_values == NULL || results == NULL) return FLYBY_ERRO_CONFIG;
+    flyby_conditions_init(&conditions, config->x_init_factor, config->velocity_infinity);
+    // ................................................................................................................
+    //          Condições iniciais (as mesmas do flyby_integrate). As lanes que sobram no último lote ficam desativadas.
+    params.mu = mu;
+    params.dt = config->dt;
+    params.max_time = config->max_time;
+    params.r_collision = RAIO_MARTE;
+    params.r_stop = conditions.stop_value;
+    params.stop_gate = 10 * STEPS_PARA_OUTPUT;
+    params.cadence = config->cadence;
+    params.precision = config->precision;
+    steps_to_output = (int) (config->output_interval / config->dt);
+
+    for (l = 0; l < BATCH_MAX_LANES; l++) {
+        const double b = b_values[l < count ? l : 0];
+
+        lanes.x[l] = conditions.x_init;
+        lanes.y[l] = b;
+        lanes.vx[l] = conditions.v_x_init;
+        lanes.vy[l] = 0.0;
+        lanes.distance[l] = sqrt(lanes.x[l] * lanes.x[l] + lanes.y[l] * lanes.y[l]);
+        lanes.d_min[l] = lanes.distance[l];
+        lanes.progress[l] = 0.0;
+        lanes.limit[l] = 0.0;
+        lanes.active[l] = l < count;
+        end_time[l] = 0.0;
+        exported[l] = 0;
+        if (l >= count) continue;
+
+        results[l].b = b;
+        results[l].collision = 0;
+        results[l].steps_accepted = 0;
+        results[l].steps_rejected = 0;
+        results[l].stop = PARADA_TEMPO;
+
+        r[0] = lanes.x[l];
+        r[1] = lanes.y[l];
+        v[0] = lanes.vx[l];
+        v[1] = lanes.vy[l];
+        cadence_init(&cadence[l], config->cadence, config->rows, (steps_to_output > 1 ? steps_to_output : 1) * config->dt, 0.5 * config->dt, mu,
+            conditions.stop_value, RAIO_MARTE, r, v);
+        lanes.limit[l] = cadence_limit(&cadence[l]);
+    }
+    // ................................................................................................................
+    time = 0;
+    while (1) {
+        batch_euler_run(isa, &lanes, &params, &time);
+        if (time >= config->max_time) break;
+
+        //      Eventos de cada lane ativa: linha e critérios de parada, na mesma ordem do flyby_integrate.
+        n_active = 0;
+        for (l = 0; l < count; l++) {
+            if (!lanes.active[l]) continue;
+            r[0] = lanes.x[l];
+            r[1] = lanes.y[l];
+            v[0] = lanes.vx[l];
+            v[1] = lanes.vy[l];
+
+            cadence[l].progress = lanes.progress[l];
+            exported[l] = cadence_due(&cadence[l]);
+            if (exported[l]) emit_row(sinks != NULL ? &sinks[l] : NULL, time, r, v, lanes.distance[l]);
+            lanes.limit[l] = cadence_limit(&cadence[l]);
+
+            if (lanes.distance[l] < RAIO_MARTE) {
+                lanes.d_min[l] = lanes.distance[l];
+                results[l].collision = 1;
+                results[l].stop = PARADA_COLISAO;
+                lanes.active[l] = 0;
+            } else if (lanes.distance[l] >= conditions.stop_value && time > 10 * STEPS_PARA_OUTPUT) {
+                results[l].stop = PARADA_DISTANCIA;
+                lanes.active[l] = 0;
+            }
+
+            if (lanes.active[l]) {
+                exported[l] = 0;
+                n_active++;
+            }
+            else end_time[l] = time;
+        }
+        if (n_active == 0) break;
+    }
+    // ................................................................................................................
+    //          Resultados de cada lane. O estado final é sempre a última linha.
+    for (l = 0; l < count; l++) {
+        if (lanes.active[l]) end_time[l] = time;
+
+        r[0] = lanes.x[l];
+        r[1] = lanes.y[l];
+        v[0] = lanes.vx[l];
+        v[1] = lanes.vy[l];
+        if (!exported[l]) emit_row(sinks != NULL ? &sinks[l] : NULL, end_time[l], r, v, lanes.distance[l]);
+
+        results[l].d_min = lanes.d_min[l];
+        results[l].steps = llround(end_time[l] / config->dt);
+        flyby_exit(r, v, conditions.v_infinite_in, &results[l].delta_v, &results[l].deflection_angle);
+        results[l].time_end = end_time[l];
+    }
+    return 0;
+}
+// ....................................................................................................................
+static void emit_row(const flyby_sink* sink, const double time, const double* r, const double* v, const double distance) {
+    double values[FLYBY_COLUNAS];
+
+    if (sink == NULL || sink->row == NULL) return;
+    values[0] = time;
+    values[1] = r[0];
+    values[2] = r[1];
+    values[3] = v[0];
+    values[4] = v[1];
+    values[5] = distance;
+    sink->row(values, sink->context);
+}
+// ....................................................................................................................
+static void store_row(const double* values, void* context) {
+    flyby_rows* store = context;
+    int column;
+
+    if (store->rows != NULL && store->n_rows < store->capacity) {
+        for (column = 0; column < FLYBY_COLUNAS; column++) store->rows[column * store->capacity + store->n_rows] = values[column];
+    }
+    store->n_rows++;
+}
+// ....................................................................................................................
+int flyby_analytic(const flyby_config* config, const double b, flyby_result* result) {
+    flyby_conditions conditions;
+
+    if (flyby_check(config) != 0 || result == NULL) return FLYBY_ERRO_CONFIG;
+    flyby_conditions_init(&conditions, config->x_init_factor, config->velocity_infinity);
+    flyby_hyperbola(&conditions, config->max_time, b, result);
+    return 0;
+}
+// ....................................................................................................................
+int flyby_sweep(const flyby_config* config, const int n, const double* b_values, flyby_result* results, const int n_threads) {
+    flyby_sweep_context context;
+    int status;
+
+    if (flyby_check(config) != 0 || n < 0 || (n > 0 && (b_values == NULL || results == NULL))) return FLYBY_ERRO_CONFIG;
+    if (n == 0) return 0;
+
+    context.config = config;
+    context.b_values = b_values;
+    context.results = results;
+    status = sweep_run(n, n_threads > 0 ? n_threads : 1, sweep_cost, sweep_job, NULL, NULL, &context);
+
+    return status < 0 ? FLYBY_ERRO_MEMORIA : status;
+}
+// ....................................................................................................................
+static double sweep_cost(const int job, void* context) {
+    const flyby_sweep_context* sweep = context;
+
+    return flyby_estimate_steps(sweep->config, sweep->b_values[job]);
+}
+// ....................................................................................................................
+static void sweep_job(const int job, void* context) {
+    const flyby_sweep_context* sweep = context;
+
+    flyby_integrate(sweep->config, sweep->b_values[job], &sweep->results[job], NULL);
+}
+// ....................................................................................................................
+//      Estimativa barata (a mesma do estimate_cost do pr2c, em passos): a sonda anda em linha reta com velocidade
+//  v_infinite_in, até a superfície de Marte quando o periapsis da hipérbole fica abaixo dela, ou até sair da esfera
+//  de raio stop_value caso contrário.
+double flyby_estimate_steps(const flyby_config* config, const double b) {
+    const double mu = CONSTANTE_GRAVITACIONAL * MASSA_MARTE;
+    flyby_conditions conditions;
+    double h;
+    double e;
+    double r_p;
+    double length;
+
+    if (flyby_check(config) != 0) return 0.0;
+    flyby_conditions_init(&conditions, config->x_init_factor, config->velocity_infinity);
+    h = fabs(b) * conditions.v_x_init;
+    e = sqrt(1 + conditions.v_infinite_in * conditions.v_infinite_in * h * h / (mu * mu));
+    r_p = (h * h / mu) / (1 + e);
+
+    if (r_p < RAIO_MARTE) length = fabs(conditions.x_init) - (fabs(b) < RAIO_MARTE ? sqrt(RAIO_MARTE * RAIO_MARTE - b * b) : 0.0);
+    else length = fabs(conditions.x_init) + (fabs(b) < conditions.stop_value ? sqrt(conditions.stop_value * conditions.stop_value - b * b) : 0.0);
+
+    return fmin(length / conditions.v_infinite_in, config->max_time) / config->dt;
+}
+// ....................................................................................................................
+void flyby_acceleration(const double t, const double* x, const double* v, double* a, void* context) {
+    const double div = x[0] * x[0] + x[1] * x[1];
+    const double factor = CONSTANTE_GRAVITACIONAL * MASSA_MARTE / (div * sqrt(div));
+
+    (void) t;
+    (void) v;
+    (void) context;
+
+    a[0] = - factor * x[0];
+    a[1] = - factor * x[1];
+}
+// ....................................................................................................................
+//      Raio do periapsis da cônica osculadora: r_p = p / (1 + e), com p = h²/μ e e² = 1 + 2 E h²/μ².
+double flyby_periapsis(const double* r, const double* v) {
+    const double mu = CONSTANTE_GRAVITACIONAL * MASSA_MARTE;
+    const double h = r[0] * v[1] - r[1] * v[0];         //  Momento angular específico.
+    const double energy = 0.5 * (v[0] * v[0] + v[1] * v[1]) - mu / sqrt(r[0] * r[0] + r[1] * r[1]);
+    const double e2 = 1 + 2 * energy * h * h / (mu * mu);
+
+    return (h * h / mu) / (1 + sqrt(e2 > 0 ? e2 : 0.0));
+}
+// ....................................................................................................................
+//      Colisão dentro de um passo. Sem a interpolação, a colisão seria a primeira amostra dentro de Marte: o d_min e o
+//  tempo final dependeriam do passo (com dt = 60 s, a sonda anda até ~300 km dentro da superfície). A colisão rasante
+//  (as duas pontas fora de Marte, mas o periapsis do passo, onde r·v troca de sinal, dentro) também conta; nela a
+//  entrada fica antes do periapsis.
+double flyby_collision(const double dt, const double* r0, const double* v0, double* r, double* v) {
+    double surface = RAIO_MARTE;                        // [m]              - Raio do evento de colisão.
+    double r1[2];                                       // [m, m]           - Posição no fim do passo.
+    double v1[2];                                       // [m/s, m/s]       - Velocidade no fim do passo.
+    double a0[2];                                       // [m/s², m/s²]     - Aceleração no começo do passo.
+    double a1[2];                                       // [m/s², m/s²]     - Aceleração no fim do passo.
+    double r_event[2];                                  // [m, m]           - Posição interpolada.
+    double v_event[2];                                  // [m/s, m/s]       - Velocidade interpolada.
+    hermite_step step;                                  //                  - Passo para a interpolação de Hermite.
+    double theta;
+
+    //  A maioria dos passos não chega perto de Marte: as acelerações só são calculadas quando há colisão.
+    if (sqrt(r[0] * r[0] + r[1] * r[1]) >= RAIO_MARTE &&
+        !(r0[0] * v0[0] + r0[1] * v0[1] < 0 && r[0] * v[0] + r[1] * v[1] >= 0 && flyby_periapsis(r, v) < RAIO_MARTE)) return -1.0;
+
+    r1[0] = r[0];
+    r1[1] = r[1];
+    v1[0] = v[0];
+    v1[1] = v[1];
+    flyby_acceleration(0.0, r0, v0, a0, NULL);
+    flyby_acceleration(0.0, r1, v1, a1, NULL);
+    step.n = 2;
+    step.h = dt;
+    step.x0 = r0;
+    step.v0 = v0;
+    step.a0 = a0;
+    step.x1 = r1;
+    step.v1 = v1;
+    step.a1 = a1;
+
+    theta = 1.0;
+    if (sqrt(r[0] * r[0] + r[1] * r[1]) >= RAIO_MARTE) {
+        theta = hermite_event(&step, 0.0, 1.0, event_radial, NULL, r_event, v_event);
+        if (sqrt(r_event[0] * r_event[0] + r_event[1] * r_event[1]) >= RAIO_MARTE) return -1.0;
+    }
+
+    return hermite_event(&step, 0.0, theta, event_radius, &surface, r, v);
+}
+// ....................................................................................................................
+//      Resultados no ponto de parada.
+//  A velocidade em 'v' ainda sente o campo de Marte; o módulo é corrigido para o infinito descontando a energia
+//  potencial em 'r', mantendo a direção de 'v'. A variação de velocidade é a diferença dos módulos de entrada e saída,
+//  e o ângulo de deflexão é o ângulo entre as duas velocidades (a de entrada é (v_infinite_in, 0)).
+void flyby_exit(const double* r, const double* v, const double v_infinite_in, double* delta_v, double* deflection_angle) {
+    double velocity_in[2];                              // [m/s, m/s]       - Velocidade de entrada (no infinito).
+    double velocity_out[2];                             // [m/s, m/s]       - Velocidade de saída (no infinito, com correção de energia).
+    double velocity_out_direction[2];                   //                  - Direção de 'v' no ponto de parada.
+    double div;                                         //                  - Variável auxiliar.
+    double cosine;
+
+    velocity_in[0] = v_infinite_in;
+    velocity_in[1] = 0.0;
+
+    div = sqrt(v[0] * v[0] + v[1] * v[1]);
+    velocity_out_direction[0] = v[0] / div;
+    velocity_out_direction[1] = v[1] / div;
+    div = sqrt(div * div - 2 * CONSTANTE_GRAVITACIONAL * MASSA_MARTE / sqrt(r[0] * r[0] + r[1] * r[1]));    // 'div' dentro da expressão é o módulo da velocidade.
+    velocity_out[0] = div * velocity_out_direction[0];
+    velocity_out[1] = div * velocity_out_direction[1];
+
+    *delta_v = sqrt(velocity_out[0] * velocity_out[0] + velocity_out[1] * velocity_out[1]) - sqrt(velocity_in[0] * velocity_in[0] + velocity_in[1] * velocity_in[1]);
+
+    cosine = (velocity_in[0] * velocity_out[0] + velocity_in[1] * velocity_out[1]) /
+        (sqrt(velocity_in[0] * velocity_in[0] + velocity_in[1] * velocity_in[1]) *
+            sqrt(velocity_out[0] * velocity_out[0] + velocity_out[1] * velocity_out[1]));
+
+    if (cosine > 1) cosine = 1.0;
+    if (cosine < -1) cosine = -1.0;
+
+    *deflection_angle = acos(cosine);
+}
+// ....................................................................................................................
+//      Solução analítica pela hipérbole kepleriana.
+//  A órbita relativa a Marte é descrita pela anomalia hiperbólica F (F < 0 antes do periapsis e F > 0 depois):
+//      r(F) = |a| (e cosh F - 1),          t(F) = sqrt(|a|^3 / μ) (e sinh F - F),
+//  e a velocidade no referencial perifocal é paralela a (- sinh F, sqrt(e² - 1) cosh F). Os elementos (|a|, e) saem
+//  da energia e do momento angular do estado inicial da integração (x_init, b) com velocidade (v_x_init, 0), então o
+//  resultado corresponde ao mesmo problema que é integrado, e não ao da hipérbole com a sonda vindo do infinito.
+//  - Sem colisão, a trajetória termina ao voltar para a distância stop_value (como no critério de parada numérico).
+//  - Com colisão (periapsis abaixo de RAIO_MARTE), ela termina ao atingir a superfície, e d_min = RAIO_MARTE.
+//  O ângulo de deflexão é o ângulo entre as velocidades inicial e final, e delta_v usa a mesma correção de energia
+//  da integração (para a solução exata ela é nula, a menos de arredondamento).
+void flyby_hyperbola(const flyby_conditions* conditions, const double max_time, const double b, flyby_result* result) {
+    const double mu = CONSTANTE_GRAVITACIONAL * MASSA_MARTE;
+    const double x_init = conditions->x_init;
+    const double v_x_init = conditions->v_x_init;
+    const double r_init = sqrt(x_init * x_init + b * b);
+    const double h = fabs(b) * v_x_init;                //  Momento angular específico.
+    const double energy = 0.5 * v_x_init * v_x_init - mu / r_init;
+    const double a = mu / (2 * energy);                 //  Semi-eixo (em módulo).
+    const double e = sqrt(1 + 2 * energy * h * h / (mu * mu));
+    const double r_p = (h * h / mu) / (1 + e);          //  Raio do periapsis.
+    const double n = sqrt(mu / (a * a * a));            //  "Movimento médio" hiperbólico.
+    const double f_init = - acosh((r_init / a + 1) / e);
+    double f_end;                                       //  Anomalia hiperbólica no ponto de parada.
+    double r_end;                                       //  Distância no ponto de parada.
+    double delta;                                       //  Correção de Newton na equação de Kepler.
+    double dot;
+    int k;
+
+    result->b = b;
+    result->steps = 0;
+    result->steps_accepted = 0;
+    result->steps_rejected = 0;
+    result->collision = r_p < RAIO_MARTE;
+    result->stop = result->collision ? PARADA_COLISAO : PARADA_DISTANCIA;
+
+    //      Ponto de parada: superfície de Marte antes do periapsis, ou stop_value depois dele.
+    r_end = result->collision ? RAIO_MARTE : conditions->stop_value;
+    f_end = acosh((r_end / a + 1) / e);
+    if (result->collision) f_end = - f_end;
+    result->time_end = ((e * sinh(f_end) - f_end) - (e * sinh(f_init) - f_init)) / n;
+
+    //      Critério de parada de emergência: resolve a equação de Kepler hiperbólica (Newton) em t = max_time.
+    if (result->time_end > max_time) {
+        const double m = e * sinh(f_init) - f_init + n * max_time;
+        f_end = f_init;
+        for (k = 0; k < 100; k++) {
+            delta = (e * sinh(f_end) - f_end - m) / (e * cosh(f_end) - 1);
+            f_end -= delta;
+            if (fabs(delta) < 1e-15 * (1 + fabs(f_end))) break;
+        }
+        r_end = a * (e * cosh(f_end) - 1);
+        result->collision = 0;
+        result->time_end = max_time;
+        result->stop = PARADA_TEMPO;
+    }
+
+    //      Distância mínima: o periapsis, caso ele tenha sido atravessado; senão, o ponto de parada.
+    result->d_min = f_end >= 0 && !result->collision ? r_p : r_end;
+
+    //      Velocidade de saída corrigida para o infinito (módulo) e ângulo entre as direções de entrada e saída.
+    result->delta_v = sqrt(2 * energy) - conditions->v_infinite_in;
+    if (h > 0) {
+        const double q = sqrt(e * e - 1);
+        dot = (sinh(f_init) * sinh(f_end) + q * q * cosh(f_init) * cosh(f_end)) /
+            (sqrt(sinh(f_init) * sinh(f_init) + q * q * cosh(f_init) * cosh(f_init)) * sqrt(sinh(f_end) * sinh(f_end) + q * q * cosh(f_end) * cosh(f_end)));
+        if (dot > 1) dot = 1.0;
+        if (dot < -1) dot = -1.0;
+        result->deflection_angle = acos(dot);
+    } else {
+        //  Trajetória radial (b = 0): a sonda vai direto para Marte e a direção não muda.
+        result->deflection_angle = 0.0;
+    }
+}
+// ....................................................................................................................
@@ -0,0 +1,171 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      libflyby: o problema de 2 corpos (sonda e Marte) como uma biblioteca reentrante, com uma API em C.
+//
+//  Toda a configuração vem de uma estrutura (flyby_config) e todo o estado fica na pilha da chamada, então várias
+//  threads (ou várias configurações) podem usar a biblioteca ao mesmo tempo. Os resultados vão para estruturas do
+//  chamador e as trajetórias para um vetor do chamador, sem nenhum arquivo: o graphics.jl (ccall) passa uma matriz do próprio Julia,
+//  que recebe os valores diretamente, sem cópia e sem passar por texto.
+//
+//  O fly_by_pr2c é só a linha de comando e os arquivos em volta desta biblioteca: as trajetórias dele (Euler, com as
+//  duas precisões, leapfrog, RK4, Yoshida e o Dormand-Prince) são o flyby_integrate, que entrega as linhas aos arquivos
+//  e cada passo à deriva e à saída antecipada do programa (flyby_sink), os lotes SIMD são o flyby_batch e a solução
+//  analítica é a flyby_hyperbola. Então uma trajetória calculada pela biblioteca é idêntica à do arquivo data_%03d.csv
+//  com a mesma configuração. O problema de 3 corpos do fly_by_pr3c fica no flyby3.h, com a mesma organização.
+//
+//  Os vetores aqui começam no índice 0: posição (x, y) e velocidade (v_x, v_y) relativas a Marte.
+// ....................................................................................................................
+#ifndef FLY_BY_FLYBY_H
+#define FLY_BY_FLYBY_H
+// ....................................................................................................................
+#include "batch.h"
+#include "cadence.h"
+#include "integrators.h"
+#include "profile.h"
+// ....................................................................................................................
+//      Colunas de uma linha da trajetória: t, x, y, v_x, v_y e d (as mesmas dos arquivos data_%03d.csv).
+#define FLYBY_COLUNAS 6
+
+//      Códigos de retorno.
+#define FLYBY_ERRO_CONFIG (-1)                          //  Configuração inválida (veja flyby_check).
+#define FLYBY_ERRO_MEMORIA (-2)                         //  Falha ao alocar memória ou criar as threads.
+// ....................................................................................................................
+//  - Configuração de uma simulação. Os campos têm tamanho fixo no Linux de 64 bits e vêm em ordem decrescente de
+//  alinhamento, então a mesma estrutura pode ser declarada em outra linguagem (veja o graphics.jl).
+typedef struct {
+    double x_init_factor;                               // [R_M]    - Posição inicial em raios de Marte (x(0) = - x_init_factor R_M).
+    double velocity_infinity;                           // [m/s]    - Velocidade da sonda no infinito.
+    double max_time;                                    // [s]      - Tempo máximo de integração (critério de parada de emergência).
+    double dt;                                          // [s]      - Passo de integração.
+    double output_interval;                             // [s]      - Tempo entre duas linhas na cadência por tempo
+                                                        //            (arredondado para baixo a um número inteiro de
+                                                        //            passos, pelo menos um, exceto no dopri5).
+    double tol_rel;                                     //          - Tolerância relativa do dopri5.
+    double tol_abs;                                     // [m, m/s] - Tolerância absoluta do dopri5.
+    long rows;                                          //          - Orçamento de linhas por trajetória (0 para o padrão da cadência).
+    int integrator;                                     //          - INTEGRADOR_* (integrators.h); com o dopri5, dt é o passo inicial.
+    int precision;                                      //          - PRECISAO_DUPLA ou PRECISAO_MISTA (apenas com o Euler, batch.h).
+    int cadence;                                        //          - Cadência das linhas (CADENCIA_*, cadence.h).
+} flyby_config;
+
+//  - Condições iniciais que dependem apenas de x_init_factor e velocity_infinity (uma fatia do grid no pr2c).
+typedef struct {
+    double x_init;                                      // [m]      - Valor inicial no eixo x.
+    double stop_value;                                  // [m]      - Distância do critério de parada (|x_init|).
+    double v_infinite_in;                               // [m/s]    - Velocidade da sonda no infinito.
+    double v_x_init;                                    // [m/s]    - Velocidade inicial da sonda (apenas no eixo x).
+} flyby_conditions;
+
+//  - Resultados de uma trajetória (sem "padding", como o flyby_config).
+typedef struct {
+    double b;                                           // [m]      - Parâmetro de impacto.
+    double d_min;                                       // [m]      - Distância mínima entre a sonda e Marte.
+    double delta_v;                                     // [m/s]    - Variação de velocidade entre a entrada e a saída.
+    double deflection_angle;                            // [rad]    - Ângulo de deflexão.
+    double time_end;                                    // [s]      - Tempo em que a trajetória terminou.
+    long long steps;                                    //          - Passos de integração (0 na solução analítica; no dopri5,
+                                                        //            aceitos e rejeitados).
+    long long steps_accepted;                           //          - Passos aceitos pelo dopri5 (0 nos outros métodos).
+    long long steps_rejected;                           //          - Passos rejeitados pelo dopri5 (idem).
+    int collision;                                      //          - 1 se a sonda colidiu com Marte.
+    int stop;                                           //          - Motivo do fim da trajetória (PARADA_*, profile.h).
+} flyby_result;
+
+//  - Destino das linhas de uma trajetória e acompanhamento dos passos (flyby_integrate). Os campos podem ser NULL.
+typedef struct {
+    //  → Recebe uma linha: t, x, y, v_x, v_y e d (FLYBY_COLUNAS valores).
+    void (*row)(const double* values, void* context);
+    //  → Chamada depois de cada passo (no dopri5, de cada passo aceito), com o estado do fim dele. Com 'event', o passo
+    //  terminou num evento (na superfície de Marte ou, no dopri5, na saída da esfera de parada) e a trajetória acaba
+    //  ali. Sem ele, pode encerrar a trajetória antes dos critérios de parada (PARADA_ANTECIPADA): retorna 1 depois de
+    //  levar r, v e *time (que chega com o tempo do fim do passo) ao ponto de parada.
+    int (*step)(double* time, double* r, double* v, int event, void* context);
+    void* context;                                      //  Último argumento das duas funções.
+} flyby_sink;
+// ....................................................................................................................
+//  - Configuração com os valores padrão do fly_by_pr2c (Euler, precisão dupla, uma linha a cada 180 s, rtol = 1e-10 e
+//  atol = 1e-6).
+//  double x_init_factor, double velocity_infinity, double max_time, double dt → Argumentos posicionais do programa.
+flyby_config flyby_default_config(double x_init_factor, double velocity_infinity, double max_time, double dt);
+
+//  - Verifica uma configuração. Retorna 0 se ela é válida e FLYBY_ERRO_CONFIG caso contrário.
+int flyby_check(const flyby_config* config);
+
+//  - Condições iniciais: x(0) = - x_init_factor R_M e a velocidade inicial com a energia de velocity_infinity.
+void flyby_conditions_init(flyby_conditions* conditions, double x_init_factor, double velocity_infinity);
+
+//  - Integra uma trajetória do parâmetro de impacto b.
+//  const flyby_config* config              → Configuração da simulação.
+//  double b                                → Parâmetro de impacto.
+//  flyby_result* result                    → Recebe os resultados da trajetória.
+//  double* rows                            → Recebe as linhas da trajetória, coluna por coluna: o valor da coluna c na
+//                                            linha i fica em rows[c * capacity + i] (uma matriz capacity × FLYBY_COLUNAS
+//                                            do Julia, ou do Fortran). Pode ser NULL.
+//  long capacity                           → Número de linhas que cabem em 'rows'.
+//
+//  * Retorna o número de linhas da trajetória (apenas as 'capacity' primeiras são escritas; com um valor maior, a
+//  chamada pode ser repetida com um vetor maior) ou FLYBY_ERRO_CONFIG.
+long flyby_trajectory(const flyby_config* config, double b, flyby_result* result, double* rows, long capacity);
+
+//  - Integra uma trajetória do parâmetro de impacto b, entregando as linhas e os passos ao 'sink' (pode ser NULL). É o
+//  laço do flyby_trajectory e do simulate do fly_by_pr2c.
+//
+//  * Retorna o número de linhas da trajetória ou FLYBY_ERRO_CONFIG.
+long flyby_integrate(const flyby_config* config, double b, flyby_result* result, const flyby_sink* sink);
+
+//  - Integra um lote de até BATCH_MAX_LANES trajetórias de Euler ao mesmo tempo, com o conjunto de instruções 'isa'
+//  (batch.h). Os resultados e as linhas de cada trajetória são idênticos aos do flyby_integrate.
+//  const flyby_config* config              → Configuração comum (apenas o Euler).
+//  int isa                                 → Conjunto de instruções (SIMD_*, já resolvido pelo batch_select).
+//  int count                               → Número de trajetórias (de 1 a batch_width(isa)).
+//  const double* b_values                  → Parâmetro de impacto de cada trajetória.
+//  flyby_result* results                   → Recebe os resultados de cada trajetória.
+//  const flyby_sink* sinks                 → Destino das linhas de cada trajetória (o 'step' não é chamado). Pode
+//                                            ser NULL.
+//
+//  * Retorna 0, ou FLYBY_ERRO_CONFIG.
+int flyby_batch(const flyby_config* config, int isa, int count, const double* b_values, flyby_result* results, const flyby_sink* sinks);
+
+//  - Solução analítica (hipérbole kepleriana) de uma trajetória, com os mesmos resultados que a integração mede.
+//  Retorna 0, ou FLYBY_ERRO_CONFIG.
+int flyby_analytic(const flyby_config* config, double b, flyby_result* result);
+
+//  - Integra várias trajetórias (apenas os resultados) com o sweep de várias threads (sweep.h).
+//  const flyby_config* config              → Configuração da simulação (a mesma para todas).
+//  int n                                   → Número de trajetórias.
+//  const double* b_values                  → Parâmetro de impacto de cada trajetória.
+//  flyby_result* results                   → Recebe os resultados de cada trajetória.
+//  int n_threads                           → Número de threads (1 roda tudo na chamadora).
+//
+//  * Retorna 0 em caso de sucesso, 1 se o sweep foi interrompido (sweep_catch_signals), FLYBY_ERRO_CONFIG ou
+//  FLYBY_ERRO_MEMORIA.
+int flyby_sweep(const flyby_config* config, int n, const double* b_values, flyby_result* results, int n_threads);
+
+//  - Estimativa barata do número de passos de uma trajetória (linha reta com a velocidade no infinito). Serve para
+//  ordenar o sweep e para escolher o tamanho inicial do vetor de linhas.
+double flyby_estimate_steps(const flyby_config* config, double b);
+
+//  - Física do problema, também usada pelo fly_by_pr2c.
+//  → Aceleração gravitacional de Marte, no formato dos integradores (integrators.h).
+void flyby_acceleration(double t, const double* x, const double* v, double* a, void* context);
+
+//  → Raio do periapsis da cônica osculadora do estado (r, v).
+double flyby_periapsis(const double* r, const double* v);
+
+//  → Colisão dentro de um passo de tamanho dt dos métodos de ordem alta: a entrada na superfície de Marte é localizada
+//  na interpolação de Hermite do passo (hermite_event, com os estados e as acelerações nas duas pontas). r0/v0 é o
+//  estado no começo do passo e r/v o do fim, que recebe o estado na superfície se houver colisão. Retorna a posição da
+//  entrada dentro do passo (theta), ou -1 se o passo não entrou em Marte.
+double flyby_collision(double dt, const double* r0, const double* v0, double* r, double* v);
+
+//  → Variação de velocidade e ângulo de deflexão a partir do estado no ponto de parada (a velocidade é corrigida para
+//  o infinito descontando o potencial de Marte em r).
+void flyby_exit(const double* r, const double* v, double v_infinite_in, double* delta_v, double* deflection_angle);
+
+//  → Solução analítica a partir das condições iniciais (usada pelo flyby_analytic e pelo --analytic do pr2c).
+void flyby_hyperbola(const flyby_conditions* conditions, double max_time, double b, flyby_result* result);
+// ....................................................................................................................
+#endif
@@ -0,0 +1,890 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Comentários para desabilitar algumas funções de análise do CLion:
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ....................................................................................................................
+//      Bibliotecas:
+#include <math.h>
+#include <stdlib.h>
+
+#include "flyby3.h"
+#include "polar.h"
+// ....................................................................................................................
+//      Constantes (as mesmas do fly_by_pr3c).
+#define N_DIMS 2                                        //  Dimensões do problema. Os vetores internos começam no índice 1,
+                                                        //  como no polar.c.
+#define CONSTANTE_GRAVITACIONAL 6.6743e-11              //  Constante gravitacional de Newton no sistema internacional.
+#define MASSA_SOL 1.9885e30                             //  Massa do Sol. (Em quilogramas)
+#define MASSA_MARTE 6.4171e23                           //  Massa de Marte. (Em quilogramas)
+#define DISTANCIA_MARTE_SOL 2.2794e11                   //  Distância radial entre Marte e o Sol. (Em metros)
+#define RAIO_MARTE 3.3895E6                             //  Raio do planeta Marte. (Em metros)
+#define DEG_TO_RAD 0.0174532925                         //  Relação para converter graus para radianos.
+
+#define STEPS_PARA_OUTPUT 180                           //  Segundos entre duas linhas no padrão do programa. O critério de
+                                                        //  parada por distância só vale depois de 10 * STEPS_PARA_OUTPUT
+                                                        //  segundos (para não parar no começo da simulação).
+// ....................................................................................................................
+//      Funções auxiliares (aqui temos um "mini-header" dentro do arquivo *.c)
+//  - Integração com passo adaptativo (Dormand-Prince 5(4)). Recebe os estados cartesianos heliocêntricos iniciais da
+//  sonda e de Marte e os devolve no fim da integração; entrega as linhas na cadência escolhida por meio da saída densa
+//  e preenche d_min, o indicador de colisão, o motivo do fim e o número de passos aceitos/rejeitados. Retorna o tempo
+//  final da integração e soma as linhas em *n_rows.
+static double integrate_adaptive(const flyby3_config* config, const flyby3_conditions* conditions, double ship_coord[], double ship_velocity[],
+    double mars_coord[], double mars_velocity[], output_cadence* cadence, flyby3_result* result, const flyby3_sink* sink, long* n_rows);
+
+//  - Colisão dentro de um passo dos métodos de ordem alta de passo fixo. A entrada na superfície de Marte é localizada
+//  na interpolação de Hermite do estado relativo a Marte (hermite_event, com os estados e as acelerações nas duas
+//  pontas). Retorna a posição dela dentro do passo (theta), ou -1 se o passo não entrou em Marte.
+//  const flyby3_conditions* conditions     → Condições iniciais (órbita de Marte).
+//  double dt                               → Passo de integração.
+//  double time                             → Tempo no começo do passo.
+//  const double r0[], const double v0[]    → Estado relativo a Marte no começo do passo.
+//  double r[], double v[]                  → Estado relativo no fim do passo; recebem o da superfície se houver colisão.
+static double step_collision(const flyby3_conditions* conditions, double dt, double time, const double r0[], const double v0[], double r[], double v[]);
+
+//  - Eventos de um passo aceito do dopri5 (colisão e saída da esfera de parada), localizados na saída densa. Retorna a
+//  posição do evento dentro do passo (theta), ou 1 se não houver evento.
+//  const dopri5_workspace* workspace       → Estágios do passo aceito (antes do dopri5_accept).
+//  const double r[], const double v[]      → Estado relativo a Marte no começo do passo.
+//  double r_new[], double v_new[]          → Estado relativo a Marte no fim do passo; recebem o estado no ponto do evento.
+//  double time_end                         → Tempo no fim do passo.
+//  const flyby3_conditions* conditions     → Condições iniciais (distância de parada).
+//  int* event                              → Recebe o evento (PARADA_COLISAO, PARADA_DISTANCIA ou PARADA_TEMPO se nenhum).
+static double adaptive_event(const dopri5_workspace* workspace, const double r[], const double v[], double r_new[], double v_new[], double time_end,
+    const flyby3_conditions* conditions, int* event);
+
+//  - Entrega a linha (t, posições de Marte e da sonda, velocidades de Marte e da sonda, d) ao destino das linhas, se
+//  houver um.
+static void emit_row(const flyby3_sink* sink, double time, const double mars_coord[], const double ship_coord[], const double mars_velocity[],
+    const double ship_velocity[], double distance);
+
+//  - Acelerações da sonda no formato usado pelos integradores de ordem alta (integrators.h). Marte segue a sua órbita
+//  circular prescrita, com ângulo mars_angle_init + ω t; o 'context' são as condições iniciais (flyby3_conditions).
+//  → acceleration_polar: x = (r, θ) e v = (dr/dt, dθ/dt) heliocêntricos, conforme Eqs~(34-38).
+//  → acceleration_cartesian: x = (x, y) e v = (v_x, v_y) heliocêntricos.
+static void acceleration_polar(double t, const double* x, const double* v, double* a, void* context);
+static void acceleration_cartesian(double t, const double* x, const double* v, double* a, void* context);
+//  → acceleration_relative: x = (x, y) e v = (v_x, v_y) relativos a Marte (usada pelo dopri5).
+static void acceleration_relative(double t, const double* x, const double* v, double* a, void* context);
+
+//  - Integral de Jacobi da sonda: E - ω h, com E a energia específica heliocêntrica (incluindo o potencial de Marte) e
+//  h o momento angular heliocêntrico. Com o Sol fixo e Marte numa órbita circular prescrita, ela é constante (é a
+//  energia no referencial que gira com Marte); a energia e o momento angular sozinhos não são.
+static double jacobi_integral(const double ship_coord[], const double ship_velocity[], const double mars_coord[]);
+
+//  - Deriva da integral de Jacobi: atualiza o maior desvio em relação ao valor inicial 'jacobi_start'.
+static void drift_measure(double jacobi_start, const flyby3_conditions* conditions, const double ship_coord[], const double ship_velocity[],
+    const double mars_coord[], flyby3_result* result);
+
+//  - Raio do periapsis da cônica osculadora definida pela posição e velocidade relativas a Marte.
+static double periapsis_radius(const double r[], const double v[]);
+// ....................................................................................................................
+flyby3_config flyby3_default_config(const double max_time, const double dt) {
+    flyby3_config config;
+
+    config.max_time = max_time;
+    config.dt = dt;
+    config.output_interval = STEPS_PARA_OUTPUT;
+    config.tol_rel = 1e-10;
+    config.tol_abs = 1e-6;
+    config.bodies = NULL;
+    config.rows = 0;
+    config.integrator = INTEGRADOR_EULER;
+    config.engine = FORMULACAO_POLAR;
+    config.reference_body = 0;
+    config.cadence = CADENCIA_TEMPO;
+    config.drift = 0;
+    return config;
+}
+// ....................................................................................................................
+int flyby3_check(const flyby3_config* config) {
+    if (config == NULL) return FLYBY_ERRO_CONFIG;
+    if (!(config->max_time > 0) || !(config->dt > 0)) return FLYBY_ERRO_CONFIG;
+    if (config->integrator < INTEGRADOR_EULER || config->integrator > INTEGRADOR_DOPRI5) return FLYBY_ERRO_CONFIG;
+    if (config->tol_rel < 0 || config->tol_abs < 0 || !(config->tol_rel + config->tol_abs > 0)) return FLYBY_ERRO_CONFIG;
+    if (config->engine < FORMULACAO_POLAR || config->engine > FORMULACAO_NBODY) return FLYBY_ERRO_CONFIG;
+    if (config->engine == FORMULACAO_NBODY && (config->bodies == NULL || config->integrator == INTEGRADOR_DOPRI5 ||
+        config->reference_body < 0 || config->reference_body >= config->bodies->n)) return FLYBY_ERRO_CONFIG;
+    if (config->cadence < CADENCIA_TEMPO || config->cadence > CADENCIA_DISTANCIA || config->rows < 0 || config->output_interval < 0) return FLYBY_ERRO_CONFIG;
+    return 0;
+}
+// ....................................................................................................................
+void flyby3_conditions_init(flyby3_conditions* conditions, const double r_factor, const double mars_init_angle, const double velocity_infinity) {
+    conditions->r_factor = r_factor * RAIO_MARTE;
+    conditions->stop_value = conditions->r_factor;
+    conditions->mars_angle_init = mars_init_angle * DEG_TO_RAD;
+    conditions->v_infinity = velocity_infinity;
+    conditions->v_sonda_init = sqrt(conditions->v_infinity * conditions->v_infinity + 2 * CONSTANTE_GRAVITACIONAL * MASSA_MARTE / fabs(conditions->r_factor));
+
+    conditions->cos_angle = cos(conditions->mars_angle_init);
+    conditions->sin_angle = sin(conditions->mars_angle_init);
+    flyby3_mars_state(conditions, 0.0, conditions->mars_coord, conditions->mars_velocity);
+
+    conditions->position_error[0] = conditions->position_error[1] = 0.0;
+    conditions->velocity_error[0] = conditions->velocity_error[1] = 0.0;
+    conditions->perturbed = 0;
+}
+// ....................................................................................................................
+int flyby3_bodies(nbody_table* table) {
+    nbody_init(table);
+    nbody_add_fixed(table, "sol", CONSTANTE_GRAVITACIONAL * MASSA_SOL, 0.0, 0.0, 0.0);
+    return nbody_add_circular(table, "marte", CONSTANTE_GRAVITACIONAL * MASSA_MARTE, 0.0, 0, DISTANCIA_MARTE_SOL, 0.0);
+}
+// ....................................................................................................................
+//      O laço do simulate do fly_by_pr3c, sem os arquivos: as linhas vão para o 'sink' e os critérios de parada são
+//  verificados a cada passo.
+long flyby3_integrate(const flyby3_config* config, const flyby3_conditions* conditions, const double b, flyby3_result* result, const flyby3_sink* sink) {
+    // ................................................................................................................
+    //          Declaração das variáveis locais.
+    output_cadence cadence;                             //                  - Cadência das saídas (veja cadence.h).
+    int exported;                                       //                  - 1 se o estado atual já foi exportado.
+    long n_rows;                                        //                  - Linhas da trajetória.
+    int steps_to_output;                                //                  - Passos entre duas linhas (cadência por tempo).
+    double dt;                                          // [s]              - Passo de integração.
+    int integrator;                                     //                  - Método de integração (INTEGRADOR_*).
+    int engine;                                         //                  - Formulação do estado integrado (FORMULACAO_*).
+
+    //      Variáveis de estado (coordenadas polares)
+    double mars_coord_polar[N_DIMS + 1];                // [m, rad]         - Posição em coordenadas polares de Marte.
+    double mars_velocity_polar[N_DIMS + 1];             // [m/s, rad/s]     - Velocidade em coordenadas polares de Marte.
+    double ship_coord_polar[N_DIMS + 1];                // [m, rad]         - Posição em coordenadas polares da sonda.
+    double ship_velocity_polar[N_DIMS + 1];             // [m/s, rad/s]     - Velocidade em coordenadas polares da sonda.
+
+    //      Variáveis de estado (coordenadas cartesianas)
+    double mars_coord_cartesian[N_DIMS + 1];            // [m, m]           - Posição em coordenadas cartesianas de Marte.
+    double mars_velocity_cartesian[N_DIMS + 1];         // [m/s, m/s]       - Velocidade em coordenadas cartesianas de Marte.
+    double ship_coord_cartesian[N_DIMS + 1];            // [m, m]           - Posição em coordenadas cartesianas da sonda.
+    double ship_velocity_cartesian[N_DIMS + 1];         // [m/s, m/s]       - Velocidade em coordenadas cartesianas da sonda.
+
+    //  Também preciso de variáveis temporárias para armazenar as atualizações de estado...
+    double ship_acceleration[N_DIMS + 1];               // [m/s², m/s²]     - Aceleração cartesiana da sonda (apenas para o leapfrog).
+
+    //      Estado relativo a Marte (detecção do periapsis nos métodos de ordem alta).
+    double relative_coord[N_DIMS + 1];                  // [m, m]           - Posição da sonda relativa a Marte.
+    double relative_velocity[N_DIMS + 1];               // [m/s, m/s]       - Velocidade da sonda relativa a Marte.
+    double radial = 0.0;                                // [m²/s]           - Produto r·v relativo antes do passo.
+    double start_coord[N_DIMS + 1];                     // [m, m]           - Posição relativa no começo do passo.
+    double start_velocity[N_DIMS + 1];                  // [m/s, m/s]       - Velocidade relativa no começo do passo.
+    double crossing;                                    //                  - Posição da entrada em Marte dentro do passo (-1 se não houver).
+    int polar;                                          //                  - Indica se o estado integrado é o polar (Euler e
+                                                        //                  RK4 com FORMULACAO_POLAR) ou o cartesiano.
+    int cartesian_euler;                                //                  - Euler cartesiano (laço sem trigonometria).
+
+    //      Euler cartesiano: Marte avança por uma rotação fixa de ω dt, sem cos/sin a cada passo.
+    double mars_rotation_cos;                           //                  - cos(ω dt).
+    double mars_rotation_sin;                           //                  - sin(ω dt).
+    double mars_temp;                                   // [m]              - Temporária da rotação.
+    double sun_factor;                                  // [1/s²]           - G M_sol / |r|^3.
+    double mars_factor;                                 // [1/s²]           - G M_marte / |r - r_m|^3.
+    double ship_acceleration_x;                         // [m/s²]           - Aceleração cartesiana da sonda (x).
+    double ship_acceleration_y;                         // [m/s²]           - Aceleração cartesiana da sonda (y).
+
+    //      Motor de N corpos (FORMULACAO_NBODY): a sonda é o ponto 0 e os corpos integrados vêm depois (veja nbody.h).
+    //  O estado de Marte é sempre o do corpo de referência da tabela, lido com os ângulos das forças (nbody_body_state).
+    int nbody;                                          //                  - Indica se o motor de N corpos está em uso.
+    nbody_table table;                                  //                  - Tabela de corpos, com o ângulo inicial de Marte das condições.
+    nbody_run run;                                      //                  - Integração (context do nbody_acceleration).
+    int rotating;                                       //                  - Indica se Marte avança pela rotação de ω dt.
+    int tracking;                                       //                  - 1 se o estado de Marte é lido da tabela a cada
+                                                        //                  passo (e não só nas saídas).
+    double points_coord[INTEGRATOR_MAX_DIMS];           // [m]              - Posição dos pontos (x e y intercalados).
+    double points_velocity[INTEGRATOR_MAX_DIMS];        // [m/s]            - Velocidade dos pontos.
+    double points_acceleration[INTEGRATOR_MAX_DIMS];    // [m/s²]           - Aceleração dos pontos (apenas para o leapfrog).
+    int n_dims;                                         //                  - Tamanho do estado dos pontos.
+
+    //      Vetores de velocidade de entrada e saída.
+    double velocity_in[N_DIMS + 1];                     // [m/s, m/s]       - Vetor de velocidade de entrada. (referencial do Sol)
+    double velocity_out[N_DIMS + 1];                    // [m/s, m/s]       - Vetor de velocidade de saída. (referecial do Sol)
+    double velocity_in_rel[N_DIMS + 1];                 // [m/s, m/s]       - Vetor de velocidade de entrada. (referencial de Marte)
+    double velocity_out_rel[N_DIMS + 1];                // [m/s, m/s]       - Vetor de velocidade de saída. (referecial de Marte)
+
+    double div = 0.0;                                   // [mˆ2]            - Fator comum de divisão. É o módulo quadrado do vetor distância.
+    double time;                                        // [s]              - Tempo de intregrassão.
+    double distance;                                    // [m]              - Distância relativa entre a sonda e Marte.
+    double jacobi_start;                                // [J/kg]           - Integral de Jacobi inicial (config->drift).
+
+    if (flyby3_check(config) != 0 || conditions == NULL || result == NULL) return FLYBY_ERRO_CONFIG;
+    dt = config->dt;
+    integrator = config->integrator;
+    engine = config->engine;
+    polar = engine == FORMULACAO_POLAR && (integrator == INTEGRADOR_EULER || integrator == INTEGRADOR_RK4);
+    cartesian_euler = engine == FORMULACAO_CARTESIANA && integrator == INTEGRADOR_EULER;
+    nbody = engine == FORMULACAO_NBODY;
+    rotating = cartesian_euler;
+    n_rows = 0;
+    // ................................................................................................................
+    //          Condições iniciais, aplicadas...
+    //  1. Começando por marte, o raio da órbita do planeta é tabelado; e o ângulo foi fornecido.
+    mars_coord_polar[1] = DISTANCIA_MARTE_SOL;
+    mars_coord_polar[2] = conditions->mars_angle_init;
+    mars_velocity_polar[1] = 0.0;
+    mars_velocity_polar[2] = sqrt(CONSTANTE_GRAVITACIONAL * MASSA_SOL / (DISTANCIA_MARTE_SOL * DISTANCIA_MARTE_SOL * DISTANCIA_MARTE_SOL));
+
+    //  2. As coordenadas cartesianas de Marte só dependem das condições, então já foram calculadas (veja
+    //  flyby3_conditions_init). No motor de N corpos, elas vêm da tabela, que ganha o ângulo inicial de Marte das
+    //  condições (os corpos integrados vão para o estado, depois da sonda).
+    if (nbody) {
+        table = *config->bodies;
+        table.phase[config->reference_body] = conditions->mars_angle_init;
+        nbody_run_init(&run, &table, 1, config->reference_body);
+        nbody_start(&run, points_coord, points_velocity);
+        nbody_body_state(&run, config->reference_body, 0.0, points_coord, points_velocity, &mars_coord_cartesian[1], &mars_velocity_cartesian[1]);
+    } else {
+        mars_coord_cartesian[1] = conditions->mars_coord[0];
+        mars_coord_cartesian[2] = conditions->mars_coord[1];
+        mars_velocity_cartesian[1] = conditions->mars_velocity[0];
+        mars_velocity_cartesian[2] = conditions->mars_velocity[1];
+    }
+
+    //  3. Calcula a posição cartesiana inicial da sonda (com o erro de injeção, se houver).
+    ship_coord_cartesian[1] = mars_coord_cartesian[1] + sqrt(conditions->r_factor * conditions->r_factor - b * b) * conditions->sin_angle - b * conditions->cos_angle;
+    ship_coord_cartesian[2] = mars_coord_cartesian[2] - sqrt(conditions->r_factor * conditions->r_factor - b * b) * conditions->cos_angle - b * conditions->sin_angle;
+    if (conditions->perturbed) {
+        ship_coord_cartesian[1] += conditions->position_error[0];
+        ship_coord_cartesian[2] += conditions->position_error[1];
+    }
+
+    //  4. Converte os valores de posição para coordendas polares.
+    ship_coord_polar[1] = sqrt(ship_coord_cartesian[1] * ship_coord_cartesian[1] + ship_coord_cartesian[2] * ship_coord_cartesian[2]);
+    ship_coord_polar[2] = atan2(ship_coord_cartesian[2], ship_coord_cartesian[1]);
+
+    //  5. Calcula a velocidade relativa de entrada (idem); e aproveita para calcular o valor da velocidade heliocêntrica.
+    velocity_in_rel[1] = - conditions->v_sonda_init * conditions->sin_angle;
+    velocity_in_rel[2] = conditions->v_sonda_init * conditions->cos_angle;
+    if (conditions->perturbed) {
+        velocity_in_rel[1] += conditions->velocity_error[0];
+        velocity_in_rel[2] += conditions->velocity_error[1];
+    }
+
+    ship_velocity_cartesian[1] = velocity_in_rel[1] + mars_velocity_cartesian[1];
+    ship_velocity_cartesian[2] = velocity_in_rel[2] + mars_velocity_cartesian[2];
+
+    velocity_in[1] = ship_velocity_cartesian[1];
+    velocity_in[2] = ship_velocity_cartesian[2];
+
+    //  6. Converte as velocidades cartesianas para polar.
+    ship_velocity_polar[1] = (ship_coord_cartesian[1] * ship_velocity_cartesian[1] + ship_coord_cartesian[2] * ship_velocity_cartesian[2]) / ship_coord_polar[1];
+    ship_velocity_polar[2] = (ship_coord_cartesian[1] * ship_velocity_cartesian[2] - ship_coord_cartesian[2] * ship_velocity_cartesian[1]) / (ship_coord_polar[1] * ship_coord_polar[1]);
+
+    //  7. Distância entre a sonda e Marte.
+    distance = sqrt((ship_coord_cartesian[1] - mars_coord_cartesian[1]) * (ship_coord_cartesian[1] - mars_coord_cartesian[1]) + (ship_coord_cartesian[2] - mars_coord_cartesian[2]) * (ship_coord_cartesian[2] - mars_coord_cartesian[2]));
+
+    //  8. Configurações adicionais...
+    result->b = b;
+    result->collision = 0;
+    result->d_min = distance;
+    result->steps_accepted = 0;
+    result->steps_rejected = 0;
+    result->drift_jacobi = 0.0;
+    result->steps = 0;
+    result->stop = PARADA_TEMPO;
+    jacobi_start = config->drift ? jacobi_integral(ship_coord_cartesian, ship_velocity_cartesian, mars_coord_cartesian) : 0.0;
+
+    //  9. Rotação de Marte em um passo (no Euler cartesiano).
+    mars_rotation_cos = cos(mars_velocity_polar[2] * dt);
+    mars_rotation_sin = sin(mars_velocity_polar[2] * dt);
+
+    //  10. No motor de N corpos, o estado começa com a sonda.
+    n_dims = N_DIMS;
+    if (nbody) {
+        points_coord[0] = ship_coord_cartesian[1];
+        points_coord[1] = ship_coord_cartesian[2];
+        points_velocity[0] = ship_velocity_cartesian[1];
+        points_velocity[1] = ship_velocity_cartesian[2];
+        n_dims = 2 * nbody_points(&run);
+    }
+
+    //  11. O leapfrog reaproveita a aceleração do fim do passo anterior.
+    if (integrator == INTEGRADOR_LEAPFROG) {
+        if (nbody) nbody_acceleration(0.0, points_coord, points_velocity, points_acceleration, &run);
+        else acceleration_cartesian(0.0, &ship_coord_cartesian[1], &ship_velocity_cartesian[1], &ship_acceleration[1], (void*) conditions);
+    }
+    // ................................................................................................................
+    //      A cadência usa o estado relativo a Marte. Na cadência por tempo, com passo fixo, é uma saída a cada
+    //  output_interval / dt passos (pelo menos a cada passo), como no original.
+    relative_coord[1] = ship_coord_cartesian[1] - mars_coord_cartesian[1];
+    relative_coord[2] = ship_coord_cartesian[2] - mars_coord_cartesian[2];
+    if (integrator == INTEGRADOR_DOPRI5) {
+        cadence_init(&cadence, config->cadence, config->rows, config->output_interval, 0.0, CONSTANTE_GRAVITACIONAL * MASSA_MARTE, conditions->stop_value,
+            RAIO_MARTE, &relative_coord[1], &velocity_in_rel[1]);
+    } else {
+        steps_to_output = (int) (config->output_interval / dt);
+        cadence_init(&cadence, config->cadence, config->rows, (steps_to_output > 1 ? steps_to_output : 1) * dt, 0.5 * dt, CONSTANTE_GRAVITACIONAL * MASSA_MARTE,
+            conditions->stop_value, RAIO_MARTE, &relative_coord[1], &velocity_in_rel[1]);
+    }
+    //      No Euler de N corpos, a distância a Marte vem das forças: sem a deriva e com a cadência por tempo, o estado
+    //  de Marte só é lido da tabela nas saídas.
+    tracking = !nbody || integrator != INTEGRADOR_EULER || config->drift || cadence.policy != CADENCIA_TEMPO;
+    // ................................................................................................................
+    //          Processo de simulação numérica.
+    //  O Dormand-Prince escolhe o próprio passo, então ele tem um laço separado (integrate_adaptive).
+    if (integrator == INTEGRADOR_DOPRI5) {
+        time = integrate_adaptive(config, conditions, ship_coord_cartesian, ship_velocity_cartesian, mars_coord_cartesian, mars_velocity_cartesian, &cadence,
+            result, sink, &n_rows);
+    } else {
+        exported = 0;
+        crossing = -1.0;
+
+        for (time = 0; time < config->max_time; time += dt) { // NOLINT(*-flp30-c)
+            // ........................................................................................................
+            //          Entrega a linha ao destino, conforme a cadência.
+            exported = cadence_due(&cadence);
+            if (exported) {
+                //  No motor de N corpos, o estado de Marte da saída é o da tabela. Quando Marte avança por rotações
+                //  (Euler cartesiano), a sua posição é ressincronizada com o ângulo exato em cada saída, para que o
+                //  arredondamento das rotações não se acumule.
+                if (nbody) {
+                    nbody_body_state(&run, config->reference_body, time, points_coord, points_velocity, &mars_coord_cartesian[1], &mars_velocity_cartesian[1]);
+                } else if (rotating) {
+                    mars_coord_polar[2] = conditions->mars_angle_init + mars_velocity_polar[2] * time;
+                    mars_coord_cartesian[1] = mars_coord_polar[1] * cos(mars_coord_polar[2]);
+                    mars_coord_cartesian[2] = mars_coord_polar[1] * sin(mars_coord_polar[2]);
+                    mars_velocity_cartesian[1] = - mars_coord_polar[1] * mars_velocity_polar[2] * sin(mars_coord_polar[2]);
+                    mars_velocity_cartesian[2] = mars_coord_polar[1] * mars_velocity_polar[2] * cos(mars_coord_polar[2]);
+                }
+                emit_row(sink, time, mars_coord_cartesian, ship_coord_cartesian, mars_velocity_cartesian, ship_velocity_cartesian, distance);
+                n_rows++;
+            }
+            // ........................................................................................................
+            //          Critérios de parada, verificados a cada passo.
+            //  1. Verifica se a sonda colidiu com Marte.
+            if (distance < RAIO_MARTE) {
+                result->d_min = distance;
+                result->collision = 1;
+                result->stop = PARADA_COLISAO;
+                break;
+            }
+            //  No motor de N corpos, também com os outros corpos que têm raio.
+            if (nbody && nbody_collision(&run, time, points_coord, 0) >= 0) {
+                result->collision = 1;
+                result->stop = PARADA_COLISAO;
+                break;
+            }
+
+            //  2. Verifica se a sonda está suficientemente longe de Marte.
+            //  O critério temporal aqui é apenas para impedir que ele pare no começo da simulação.
+            if (distance >= conditions->stop_value && time > 10 * STEPS_PARA_OUTPUT) {
+                result->stop = PARADA_DISTANCIA;
+                break;
+            }
+
+            //      Medida da cadência no começo do passo.
+            if (cadence.policy != CADENCIA_TEMPO) {
+                relative_coord[1] = ship_coord_cartesian[1] - mars_coord_cartesian[1];
+                relative_coord[2] = ship_coord_cartesian[2] - mars_coord_cartesian[2];
+                relative_velocity[1] = ship_velocity_cartesian[1] - mars_velocity_cartesian[1];
+                relative_velocity[2] = ship_velocity_cartesian[2] - mars_velocity_cartesian[2];
+            }
+            cadence_advance(&cadence, cadence_measure(&cadence, &relative_coord[1], &relative_velocity[1], dt));
+            exported = 0;
+            result->steps++;
+
+            //      Estado relativo no começo do passo, para localizar uma colisão dentro dele (métodos de ordem alta).
+            if (integrator != INTEGRADOR_EULER) {
+                start_coord[1] = ship_coord_cartesian[1] - mars_coord_cartesian[1];
+                start_coord[2] = ship_coord_cartesian[2] - mars_coord_cartesian[2];
+                start_velocity[1] = ship_velocity_cartesian[1] - mars_velocity_cartesian[1];
+                start_velocity[2] = ship_velocity_cartesian[2] - mars_velocity_cartesian[2];
+            }
+            // ........................................................................................................
+            if (nbody) {
+                //          Motor de N corpos (nbody.c): a sonda e os corpos integrados avançam juntos; os corpos fixos e os das
+                //  órbitas prescritas são posicionados em cada avaliação da aceleração (por rotações, veja nbody_run).
+                //  O Euler devolve a distância a Marte do começo do passo, como os outros dois Euler.
+                radial = (ship_coord_cartesian[1] - mars_coord_cartesian[1]) * (ship_velocity_cartesian[1] - mars_velocity_cartesian[1]) +
+                    (ship_coord_cartesian[2] - mars_coord_cartesian[2]) * (ship_velocity_cartesian[2] - mars_velocity_cartesian[2]);
+
+                switch (integrator) {
+                    case INTEGRADOR_EULER: nbody_euler_step(&run, time, dt, points_coord, points_velocity, &distance); break;
+                    case INTEGRADOR_RK4: rk4_step(n_dims, time, points_coord, points_velocity, dt, nbody_acceleration, &run); break;
+                    case INTEGRADOR_LEAPFROG: leapfrog_step(n_dims, time, points_coord, points_velocity, points_acceleration, dt, nbody_acceleration, &run); break;
+                    default: yoshida_step(n_dims, time, points_coord, points_velocity, dt, nbody_acceleration, &run); break;
+                }
+                ship_coord_cartesian[1] = points_coord[0];
+                ship_coord_cartesian[2] = points_coord[1];
+                ship_velocity_cartesian[1] = points_velocity[0];
+                ship_velocity_cartesian[2] = points_velocity[1];
+            } else if (cartesian_euler) {
+                //          Euler nas coordenadas cartesianas heliocêntricas: a = - G M_sol r / |r|^3 - G M_marte (r - r_m) / |r - r_m|^3.
+                //  Apenas uma raiz por corpo, e nenhuma função trigonométrica.
+                relative_coord[1] = ship_coord_cartesian[1] - mars_coord_cartesian[1];
+                relative_coord[2] = ship_coord_cartesian[2] - mars_coord_cartesian[2];
+                div = ship_coord_cartesian[1] * ship_coord_cartesian[1] + ship_coord_cartesian[2] * ship_coord_cartesian[2];
+                sun_factor = CONSTANTE_GRAVITACIONAL * MASSA_SOL / (div * sqrt(div));
+                div = relative_coord[1] * relative_coord[1] + relative_coord[2] * relative_coord[2];
+                distance = sqrt(div);
+                mars_factor = CONSTANTE_GRAVITACIONAL * MASSA_MARTE / (div * distance);
+
+                ship_acceleration_x = - sun_factor * ship_coord_cartesian[1] - mars_factor * relative_coord[1];
+                ship_acceleration_y = - sun_factor * ship_coord_cartesian[2] - mars_factor * relative_coord[2];
+
+                //  - Aplica as atualizações de posição e velocidade.
+                ship_coord_cartesian[1] += ship_velocity_cartesian[1] * dt;
+                ship_coord_cartesian[2] += ship_velocity_cartesian[2] * dt;
+                ship_velocity_cartesian[1] += ship_acceleration_x * dt;
+                ship_velocity_cartesian[2] += ship_acceleration_y * dt;
+            } else if (integrator == INTEGRADOR_EULER) {
+                //          Realiza a integração numérica, conforme Eqs~(34-38) (polar.c).
+                div = polar_euler_step(ship_coord_polar, ship_velocity_polar, mars_coord_polar, mars_velocity_polar, dt);
+            } else {
+                //          Métodos de ordem alta (integrators.c). O RK4 integra o mesmo estado do Euler (engine); já os métodos
+                //  simpléticos precisam de um Hamiltoniano separável, o que não acontece nas coordenadas (r, θ), então eles
+                //  integram a posição e a velocidade cartesianas heliocêntricas da sonda.
+                radial = (ship_coord_cartesian[1] - mars_coord_cartesian[1]) * (ship_velocity_cartesian[1] - mars_velocity_cartesian[1]) +
+                    (ship_coord_cartesian[2] - mars_coord_cartesian[2]) * (ship_velocity_cartesian[2] - mars_velocity_cartesian[2]);
+
+                switch (integrator) {
+                    case INTEGRADOR_RK4:
+                        if (polar) rk4_step(N_DIMS, time, &ship_coord_polar[1], &ship_velocity_polar[1], dt, acceleration_polar, (void*) conditions);
+                        else rk4_step(N_DIMS, time, &ship_coord_cartesian[1], &ship_velocity_cartesian[1], dt, acceleration_cartesian, (void*) conditions);
+                        break;
+                    case INTEGRADOR_LEAPFROG: leapfrog_step(N_DIMS, time, &ship_coord_cartesian[1], &ship_velocity_cartesian[1], &ship_acceleration[1], dt, acceleration_cartesian, (void*) conditions); break;
+                    default: yoshida_step(N_DIMS, time, &ship_coord_cartesian[1], &ship_velocity_cartesian[1], dt, acceleration_cartesian, (void*) conditions); break;
+                }
+
+                //  - Marte segue a órbita circular prescrita (a mesma usada dentro das funções de aceleração).
+                mars_coord_polar[2] = conditions->mars_angle_init + mars_velocity_polar[2] * (time + dt);
+            }
+            // ........................................................................................................
+            //          Atualiza os dados de coordenadas cartesianas, etc.
+            //      Converte as coordenadas cartesianas iniciais.
+            //  - Posição de Marte (x e y, em ordem). No motor de N corpos, é a do corpo de referência da tabela no fim
+            //  do passo; no Euler cartesiano, Marte gira ω dt na órbita circular, sem cos/sin.
+            if (nbody) {
+                if (tracking) nbody_body_state(&run, config->reference_body, time + dt, points_coord, points_velocity, &mars_coord_cartesian[1], &mars_velocity_cartesian[1]);
+            } else if (rotating) {
+                mars_temp = mars_rotation_cos * mars_coord_cartesian[1] - mars_rotation_sin * mars_coord_cartesian[2];
+                mars_coord_cartesian[2] = mars_rotation_sin * mars_coord_cartesian[1] + mars_rotation_cos * mars_coord_cartesian[2];
+                mars_coord_cartesian[1] = mars_temp;
+                mars_velocity_cartesian[1] = - mars_velocity_polar[2] * mars_coord_cartesian[2];
+                mars_velocity_cartesian[2] = mars_velocity_polar[2] * mars_coord_cartesian[1];
+            } else {
+                polar_to_cartesian(mars_coord_polar, mars_velocity_polar, mars_coord_cartesian, mars_velocity_cartesian);
+            }
+            //  - Posição e velocidade da sonda (polar.c).
+            if (polar) polar_to_cartesian(ship_coord_polar, ship_velocity_polar, ship_coord_cartesian, ship_velocity_cartesian);
+            // ........................................................................................................
+            //          Calcula a distância entre Marte e a sonda.
+            //  No Euler é a distância do começo do passo (no Euler cartesiano e no de N corpos ela já foi calculada junto
+            //  com a força).
+            if (integrator == INTEGRADOR_EULER) {
+                if (!cartesian_euler && !nbody) distance = sqrt(div);
+            } else {
+                relative_coord[1] = ship_coord_cartesian[1] - mars_coord_cartesian[1];
+                relative_coord[2] = ship_coord_cartesian[2] - mars_coord_cartesian[2];
+                relative_velocity[1] = ship_velocity_cartesian[1] - mars_velocity_cartesian[1];
+                relative_velocity[2] = ship_velocity_cartesian[2] - mars_velocity_cartesian[2];
+
+                //  Colisão dentro do passo: o estado passa a ser o da entrada na superfície (veja step_collision).
+                crossing = step_collision(conditions, dt, time, start_coord, start_velocity, relative_coord, relative_velocity);
+                if (crossing >= 0) {
+                    if (nbody) nbody_body_state(&run, config->reference_body, time + crossing * dt, points_coord, points_velocity, &mars_coord_cartesian[1], &mars_velocity_cartesian[1]);
+                    else flyby3_mars_state(conditions, time + crossing * dt, &mars_coord_cartesian[1], &mars_velocity_cartesian[1]);
+                    ship_coord_cartesian[1] = mars_coord_cartesian[1] + relative_coord[1];
+                    ship_coord_cartesian[2] = mars_coord_cartesian[2] + relative_coord[2];
+                    ship_velocity_cartesian[1] = mars_velocity_cartesian[1] + relative_velocity[1];
+                    ship_velocity_cartesian[2] = mars_velocity_cartesian[2] + relative_velocity[2];
+                }
+                distance = sqrt(relative_coord[1] * relative_coord[1] + relative_coord[2] * relative_coord[2]);
+
+                //  Com passos grandes o periapsis cai entre dois passos. Quando r·v relativo troca de sinal, usamos o
+                //  periapsis da cônica osculadora relativa a Marte (a perturbação do Sol durante a passagem é desprezível).
+                if (crossing < 0 && radial < 0 && relative_coord[1] * relative_velocity[1] + relative_coord[2] * relative_velocity[2] >= 0) {
+                    div = periapsis_radius(relative_coord, relative_velocity);
+                    if (div < result->d_min) result->d_min = div;
+                }
+            }
+            if (distance < result->d_min) result->d_min = distance;
+            if (config->drift) drift_measure(jacobi_start, conditions, ship_coord_cartesian, ship_velocity_cartesian, mars_coord_cartesian, result);
+            // ........................................................................................................
+            //          Colisão dentro do passo (métodos de ordem alta): o estado já é o da entrada na superfície, e a
+            //  trajetória termina ali, com a distância mínima igual à da superfície.
+            if (crossing >= 0) {
+                time += crossing * dt;
+                result->d_min = distance;
+                result->collision = 1;
+                result->stop = PARADA_COLISAO;
+                break;
+            }
+        }
+
+        //  O estado final é sempre a última linha (com Marte lido da tabela no motor de N corpos, ou ressincronizado,
+        //  se ele avança por rotações no Euler cartesiano).
+        if (!exported) {
+            if (nbody) {
+                nbody_body_state(&run, config->reference_body, time, points_coord, points_velocity, &mars_coord_cartesian[1], &mars_velocity_cartesian[1]);
+            } else if (rotating) {
+                mars_coord_polar[2] = conditions->mars_angle_init + mars_velocity_polar[2] * time;
+                mars_coord_cartesian[1] = mars_coord_polar[1] * cos(mars_coord_polar[2]);
+                mars_coord_cartesian[2] = mars_coord_polar[1] * sin(mars_coord_polar[2]);
+                mars_velocity_cartesian[1] = - mars_coord_polar[1] * mars_velocity_polar[2] * sin(mars_coord_polar[2]);
+                mars_velocity_cartesian[2] = mars_coord_polar[1] * mars_velocity_polar[2] * cos(mars_coord_polar[2]);
+            }
+            emit_row(sink, time, mars_coord_cartesian, ship_coord_cartesian, mars_velocity_cartesian, ship_velocity_cartesian, distance);
+            n_rows++;
+        }
+    }
+    // ................................................................................................................
+    //          Calcula o ângulo de deflexão e a variação da velocidade.
+    //  →   Vamos começar calculando a variação do módulo da velocidade heliocêntrica. Para isso vamos pegar a
+    //  velocidade heliocêntrica de saída:
+    velocity_out[1] = ship_velocity_cartesian[1];
+    velocity_out[2] = ship_velocity_cartesian[2];
+    //  Agora comparamos os módulos...
+    result->delta_v = sqrt(velocity_out[1] * velocity_out[1] + velocity_out[2] * velocity_out[2]) - sqrt(velocity_in[1] * velocity_in[1] + velocity_in[2] * velocity_in[2]);
+
+    //  →   Na sequência, calculamos a variação da velocidade relativa; é a mesma coisa, mas a gente precisa descontar a velocidade
+    //  de marte...
+    velocity_out_rel[1] = ship_velocity_cartesian[1] - mars_velocity_cartesian[1];
+    velocity_out_rel[2] = ship_velocity_cartesian[2] - mars_velocity_cartesian[2];
+
+    result->delta_v_rel = sqrt(velocity_out_rel[1] * velocity_out_rel[1] + velocity_out_rel[2] * velocity_out_rel[2]) - sqrt(velocity_in_rel[1] * velocity_in_rel[1] + velocity_in_rel[2] * velocity_in_rel[2]);
+
+    //  → E agora, calculamos o ângulo de deflexão...
+    result->deflection_angle = (velocity_in_rel[1] * velocity_out_rel[1] + velocity_in_rel[2] * velocity_out_rel[2]) /
+        (sqrt(velocity_in_rel[1] * velocity_in_rel[1] + velocity_in_rel[2] * velocity_in_rel[2]) *
+            sqrt(velocity_out_rel[1] * velocity_out_rel[1] + velocity_out_rel[2] * velocity_out_rel[2]));
+
+    if (result->deflection_angle > 1) result->deflection_angle = 1.0;
+    if (result->deflection_angle < -1) result->deflection_angle = -1.0;
+
+    result->deflection_angle = acos(result->deflection_angle);
+
+    //  → Por fim, seta o tempo total usado para a integração.
+    result->time_end = time;
+    return n_rows;
+}
+// ....................................................................................................................
+//      Integração com passo adaptativo (Dormand-Prince 5(4)).
+//  O estado integrado é a posição e a velocidade da sonda relativas a Marte. No referencial heliocêntrico a posição
+//  vale ~2e11 m, e uma tolerância relativa de 1e-10 já permitiria erros de dezenas de metros por passo; relativo a
+//  Marte, o erro é medido na mesma escala da distância mínima que queremos medir. Como no flyby.c, os critérios de
+//  parada são verificados a cada passo aceito (com o ponto do evento localizado dentro do passo, veja adaptive_event) e
+//  as amostras são tiradas da saída densa.
+static double integrate_adaptive(const flyby3_config* config, const flyby3_conditions* conditions, double ship_coord[], double ship_velocity[],
+    double mars_coord[], double mars_velocity[], output_cadence* cadence, flyby3_result* result, const flyby3_sink* sink, long* n_rows) {
+    dopri5_workspace workspace;                         //                  - Estágios do Dormand-Prince.
+    double r[N_DIMS + 1];                               // [m, m]           - Posição da sonda relativa a Marte.
+    double v[N_DIMS + 1];                               // [m/s, m/s]       - Velocidade da sonda relativa a Marte.
+    double r_new[N_DIMS + 1];                           // [m, m]           - Posição proposta pelo passo.
+    double v_new[N_DIMS + 1];                           // [m/s, m/s]       - Velocidade proposta pelo passo.
+    double r_out[N_DIMS + 1];                           // [m, m]           - Posição interpolada para a saída.
+    double v_out[N_DIMS + 1];                           // [m/s, m/s]       - Velocidade interpolada para a saída.
+    double time;                                        // [s]              - Tempo de integração.
+    double h;                                           // [s]              - Passo atual.
+    double err;                                         //                  - Erro local normalizado (aceita se <= 1).
+    double ds;                                          //                  - Medida da cadência acumulada no passo.
+    double fraction;                                    //                  - Posição de uma amostra dentro do passo.
+    double last_output;                                 // [s]              - Tempo da última amostra.
+    double radial;                                      // [m²/s]           - Produto r·v antes do passo.
+    double distance;                                    // [m]              - Distância entre a sonda e Marte.
+    double theta;                                       //                  - Posição do evento dentro do passo (1 sem evento).
+    int event;                                          //                  - Evento do passo (PARADA_*, ou PARADA_TEMPO sem evento).
+    int after_reject;                                   //                  - 1 se o passo anterior foi rejeitado.
+    double jacobi_start;                                // [J/kg]           - Integral de Jacobi inicial (config->drift).
+    double ship_now[N_DIMS + 1];                        // [m, m]           - Posição heliocêntrica depois do passo (deriva).
+    double velocity_now[N_DIMS + 1];                    // [m/s, m/s]       - Velocidade heliocêntrica depois do passo (idem).
+
+    jacobi_start = config->drift ? jacobi_integral(ship_coord, ship_velocity, mars_coord) : 0.0;
+    r[1] = ship_coord[1] - mars_coord[1];
+    r[2] = ship_coord[2] - mars_coord[2];
+    v[1] = ship_velocity[1] - mars_velocity[1];
+    v[2] = ship_velocity[2] - mars_velocity[2];
+    distance = sqrt(r[1] * r[1] + r[2] * r[2]);
+
+    dopri5_init(&workspace, N_DIMS);
+    time = 0.0;
+    h = config->dt;
+    last_output = -1.0;
+    after_reject = 0;
+
+    while (time < config->max_time) {
+        if (time + h > config->max_time) h = config->max_time - time;
+        err = dopri5_step(&workspace, time, &r[1], &v[1], h, acceleration_relative, (void*) conditions, config->tol_rel, config->tol_abs, &r_new[1], &v_new[1]);
+
+        //  Passo rejeitado: tenta de novo com um passo menor (um erro NaN também é rejeitado).
+        result->steps++;
+        if (!(err <= 1.0)) {
+            result->steps_rejected++;
+            h = isnan(err) ? 0.2 * h : dopri5_next_step(h, err, 1);
+            after_reject = 1;
+            continue;
+        }
+
+        //      Critérios de parada (os mesmos do passo fixo). A colisão e a saída da esfera de parada são localizadas na
+        //  saída densa (adaptive_event), e o passo termina no ponto do evento.
+        theta = adaptive_event(&workspace, r, v, r_new, v_new, time + h, conditions, &event);
+
+        //  Entrega as amostras que caem dentro deste passo (apenas até o evento, já no referencial heliocêntrico).
+        ds = cadence_measure(cadence, &r[1], &v[1], h);
+        while (cadence_next(cadence, ds, &fraction) && fraction <= theta) {
+            dopri5_dense(&workspace, fraction, &r_out[1], &v_out[1]);
+            last_output = time + fraction * h;
+            flyby3_mars_state(conditions, last_output, &mars_coord[1], &mars_velocity[1]);
+            distance = sqrt(r_out[1] * r_out[1] + r_out[2] * r_out[2]);
+            r_out[1] += mars_coord[1];
+            r_out[2] += mars_coord[2];
+            v_out[1] += mars_velocity[1];
+            v_out[2] += mars_velocity[2];
+            emit_row(sink, last_output, mars_coord, r_out, mars_velocity, v_out, distance);
+            (*n_rows)++;
+        }
+        cadence_advance(cadence, ds);
+
+        //  Aceita o passo.
+        dopri5_accept(&workspace);
+        result->steps_accepted++;
+
+        radial = r[1] * v[1] + r[2] * v[2];
+        time += event != PARADA_TEMPO ? theta * h : h;
+        r[1] = r_new[1];
+        r[2] = r_new[2];
+        v[1] = v_new[1];
+        v[2] = v_new[2];
+        distance = sqrt(r[1] * r[1] + r[2] * r[2]);
+
+        h = dopri5_next_step(h, err, after_reject);
+        after_reject = 0;
+
+        //  Periapsis pela cônica osculadora (veja o laço de passo fixo no flyby3_integrate).
+        if (radial < 0 && r[1] * v[1] + r[2] * v[2] >= 0) {
+            err = periapsis_radius(r, v);
+            if (err < result->d_min) result->d_min = err;
+        }
+        if (distance < result->d_min) result->d_min = distance;
+
+        //  A integral de Jacobi é medida no referencial heliocêntrico.
+        if (config->drift) {
+            flyby3_mars_state(conditions, time, &mars_coord[1], &mars_velocity[1]);
+            ship_now[1] = r[1] + mars_coord[1];
+            ship_now[2] = r[2] + mars_coord[2];
+            velocity_now[1] = v[1] + mars_velocity[1];
+            velocity_now[2] = v[2] + mars_velocity[2];
+            drift_measure(jacobi_start, conditions, ship_now, velocity_now, mars_coord, result);
+        }
+
+        //  1. Colisão com Marte: a distância mínima é a da superfície, onde a trajetória termina.
+        if (event == PARADA_COLISAO) {
+            result->d_min = distance;
+            result->collision = 1;
+        }
+
+        //  2. Saída da esfera de raio stop_value.
+        if (event != PARADA_TEMPO) {
+            result->stop = event;
+            break;
+        }
+    }
+    // ................................................................................................................
+    //      Volta para o referencial heliocêntrico, que é o usado no cálculo da deflexão e das variações de velocidade.
+    flyby3_mars_state(conditions, time, &mars_coord[1], &mars_velocity[1]);
+    ship_coord[1] = mars_coord[1] + r[1];
+    ship_coord[2] = mars_coord[2] + r[2];
+    ship_velocity[1] = mars_velocity[1] + v[1];
+    ship_velocity[2] = mars_velocity[2] + v[2];
+
+    //  Entrega também o estado final, caso ele não coincida com uma amostra.
+    if (last_output < time) {
+        emit_row(sink, time, mars_coord, ship_coord, mars_velocity, ship_velocity, distance);
+        (*n_rows)++;
+    }
+
+    return time;
+}
+// ....................................................................................................................
+//      Colisão dentro de um passo de tamanho dt, como no flyby_collision (flyby.c): sem a interpolação, a colisão seria
+//  a primeira amostra dentro de Marte, e o d_min e o tempo final dependeriam do passo. As acelerações das pontas são
+//  as relativas a Marte do acceleration_relative (no motor de N corpos, os outros corpos da tabela ficam de fora delas,
+//  o que só afeta o interpolante, não o passo).
+static double step_collision(const flyby3_conditions* conditions, const double dt, const double time, const double r0[], const double v0[], double r[],
+    double v[]) {
+    double surface = RAIO_MARTE;                        // [m]              - Raio do evento de colisão.
+    double r1[N_DIMS + 1];                              // [m, m]           - Posição no fim do passo.
+    double v1[N_DIMS + 1];                              // [m/s, m/s]       - Velocidade no fim do passo.
+    double a0[N_DIMS + 1];                              // [m/s², m/s²]     - Aceleração no começo do passo.
+    double a1[N_DIMS + 1];                              // [m/s², m/s²]     - Aceleração no fim do passo.
+    double r_event[N_DIMS + 1];                         // [m, m]           - Posição interpolada.
+    double v_event[N_DIMS + 1];                         // [m/s, m/s]       - Velocidade interpolada.
+    hermite_step step;                                  //                  - Passo para a interpolação de Hermite.
+    double theta;
+
+    //  A maioria dos passos não chega perto de Marte: as acelerações só são calculadas quando há colisão.
+    if (sqrt(r[1] * r[1] + r[2] * r[2]) >= RAIO_MARTE &&
+        !(r0[1] * v0[1] + r0[2] * v0[2] < 0 && r[1] * v[1] + r[2] * v[2] >= 0 && periapsis_radius(r, v) < RAIO_MARTE)) return -1.0;
+
+    r1[1] = r[1];
+    r1[2] = r[2];
+    v1[1] = v[1];
+    v1[2] = v[2];
+    acceleration_relative(time, &r0[1], &v0[1], &a0[1], (void*) conditions);
+    acceleration_relative(time + dt, &r1[1], &v1[1], &a1[1], (void*) conditions);
+    step.n = N_DIMS;
+    step.h = dt;
+    step.x0 = &r0[1];
+    step.v0 = &v0[1];
+    step.a0 = &a0[1];
+    step.x1 = &r1[1];
+    step.v1 = &v1[1];
+    step.a1 = &a1[1];
+
+    //  Na colisão rasante, a entrada fica antes do periapsis do passo.
+    theta = 1.0;
+    if (sqrt(r[1] * r[1] + r[2] * r[2]) >= RAIO_MARTE) {
+        theta = hermite_event(&step, 0.0, 1.0, event_radial, NULL, &r_event[1], &v_event[1]);
+        if (sqrt(r_event[1] * r_event[1] + r_event[2] * r_event[2]) >= RAIO_MARTE) return -1.0;
+    }
+
+    theta = hermite_event(&step, 0.0, theta, event_radius, &surface, &r[1], &v[1]);
+    return theta;
+}
+// ....................................................................................................................
+//      Eventos de um passo aceito, como no adaptive_event do flyby.c: sem a localização, a trajetória terminaria no fim
+//  do passo, que pode estar milhares de quilômetros depois da superfície ou da esfera de parada. O ponto do evento é
+//  encontrado por bisseção em |r(theta)| relativo a Marte (dopri5_event):
+//  - Colisão: o fim do passo está dentro de Marte, ou as duas pontas estão fora mas o periapsis do passo (onde r·v troca
+//  de sinal) está dentro (colisão rasante). O evento é a entrada na superfície.
+//  - Parada: o fim do passo está fora da esfera de raio stop_value (com o mesmo critério temporal do passo fixo). O evento
+//  é a saída da esfera; se o começo do passo também estava fora, a trajetória termina no fim do passo, como antes.
+static double adaptive_event(const dopri5_workspace* workspace, const double r[], const double v[], double r_new[], double v_new[], const double time_end,
+    const flyby3_conditions* conditions, int* event) {
+    const double distance = sqrt(r[1] * r[1] + r[2] * r[2]);
+    const double distance_new = sqrt(r_new[1] * r_new[1] + r_new[2] * r_new[2]);
+    double surface = RAIO_MARTE;                        // [m]              - Raio do evento de colisão.
+    double stop_value = conditions->stop_value;         // [m]              - Raio do evento de parada.
+    double r_event[N_DIMS + 1];                         // [m, m]           - Posição no periapsis do passo.
+    double v_event[N_DIMS + 1];                         // [m/s, m/s]       - Velocidade no periapsis do passo.
+    double theta;
+
+    *event = PARADA_TEMPO;
+    if (distance_new < RAIO_MARTE) {
+        *event = PARADA_COLISAO;
+        return dopri5_event(workspace, 0.0, 1.0, event_radius, &surface, &r_new[1], &v_new[1]);
+    }
+    if (r[1] * v[1] + r[2] * v[2] < 0 && r_new[1] * v_new[1] + r_new[2] * v_new[2] >= 0 && periapsis_radius(r_new, v_new) < RAIO_MARTE) {
+        theta = dopri5_event(workspace, 0.0, 1.0, event_radial, NULL, &r_event[1], &v_event[1]);
+        if (sqrt(r_event[1] * r_event[1] + r_event[2] * r_event[2]) < RAIO_MARTE) {
+            *event = PARADA_COLISAO;
+            return dopri5_event(workspace, 0.0, theta, event_radius, &surface, &r_new[1], &v_new[1]);
+        }
+    }
+    if (distance_new >= conditions->stop_value && time_end > 10 * STEPS_PARA_OUTPUT) {
+        *event = PARADA_DISTANCIA;
+        if (distance < conditions->stop_value) return dopri5_event(workspace, 0.0, 1.0, event_radius, &stop_value, &r_new[1], &v_new[1]);
+    }
+    return 1.0;
+}
+// ....................................................................................................................
+static void emit_row(const flyby3_sink* sink, const double time, const double mars_coord[], const double ship_coord[], const double mars_velocity[],
+    const double ship_velocity[], const double distance) {
+    double row[FLYBY3_COLUNAS];
+
+    if (sink == NULL || sink->row == NULL) return;
+    row[0] = time;
+    row[1] = mars_coord[1];
+    row[2] = mars_coord[2];
+    row[3] = ship_coord[1];
+    row[4] = ship_coord[2];
+    row[5] = mars_velocity[1];
+    row[6] = mars_velocity[2];
+    row[7] = ship_velocity[1];
+    row[8] = ship_velocity[2];
+    row[9] = distance;
+    sink->row(row, sink->context);
+}
+// ....................................................................................................................
+//      Aceleração em coordenadas polares heliocêntricas, conforme Eqs~(34-38).
+static void acceleration_polar(const double t, const double* x, const double* v, double* a, void* context) {
+    const flyby3_conditions* conditions = context;
+    const double mars_omega = sqrt(CONSTANTE_GRAVITACIONAL * MASSA_SOL / (DISTANCIA_MARTE_SOL * DISTANCIA_MARTE_SOL * DISTANCIA_MARTE_SOL));
+    const double delta = x[1] - (conditions->mars_angle_init + mars_omega * t);
+    const double cos_delta = cos(delta);
+    const double div = x[0] * x[0] + DISTANCIA_MARTE_SOL * DISTANCIA_MARTE_SOL - 2 * x[0] * DISTANCIA_MARTE_SOL * cos_delta;
+
+    a[0] = x[0] * v[1] * v[1] - CONSTANTE_GRAVITACIONAL * MASSA_SOL / (x[0] * x[0]) -
+        CONSTANTE_GRAVITACIONAL * MASSA_MARTE * (x[0] - DISTANCIA_MARTE_SOL * cos_delta) / (div * sqrt(div));
+    a[1] = - CONSTANTE_GRAVITACIONAL * MASSA_MARTE * DISTANCIA_MARTE_SOL * sin(delta) / (x[0] * div * sqrt(div)) -
+        2 * v[0] * v[1] / x[0];
+}
+// ....................................................................................................................
+//      Aceleração em coordenadas cartesianas heliocêntricas: a = - G M_sol r / |r|^3 - G M_marte (r - r_m) / |r - r_m|^3.
+static void acceleration_cartesian(const double t, const double* x, const double* v, double* a, void* context) {
+    const flyby3_conditions* conditions = context;
+    const double mars_omega = sqrt(CONSTANTE_GRAVITACIONAL * MASSA_SOL / (DISTANCIA_MARTE_SOL * DISTANCIA_MARTE_SOL * DISTANCIA_MARTE_SOL));
+    const double mars_angle = conditions->mars_angle_init + mars_omega * t;
+    const double dx = x[0] - DISTANCIA_MARTE_SOL * cos(mars_angle);
+    const double dy = x[1] - DISTANCIA_MARTE_SOL * sin(mars_angle);
+    const double div_sun = x[0] * x[0] + x[1] * x[1];
+    const double div_mars = dx * dx + dy * dy;
+    const double factor_sun = CONSTANTE_GRAVITACIONAL * MASSA_SOL / (div_sun * sqrt(div_sun));
+    const double factor_mars = CONSTANTE_GRAVITACIONAL * MASSA_MARTE / (div_mars * sqrt(div_mars));
+
+    (void) v;
+
+    a[0] = - factor_sun * x[0] - factor_mars * dx;
+    a[1] = - factor_sun * x[1] - factor_mars * dy;
+}
+// ....................................................................................................................
+//      Aceleração relativa a Marte: a atração do Sol entra como termo de maré (a diferença entre a atração do Sol sobre
+//  a sonda e sobre Marte), a = - G M_sol (r_m + x) / |r_m + x|^3 + G M_sol r_m / |r_m|^3 - G M_marte x / |x|^3.
+static void acceleration_relative(const double t, const double* x, const double* v, double* a, void* context) {
+    const flyby3_conditions* conditions = context;
+    const double mars_omega = sqrt(CONSTANTE_GRAVITACIONAL * MASSA_SOL / (DISTANCIA_MARTE_SOL * DISTANCIA_MARTE_SOL * DISTANCIA_MARTE_SOL));
+    const double mars_angle = conditions->mars_angle_init + mars_omega * t;
+    const double mars_x = DISTANCIA_MARTE_SOL * cos(mars_angle);
+    const double mars_y = DISTANCIA_MARTE_SOL * sin(mars_angle);
+    const double sx = mars_x + x[0];
+    const double sy = mars_y + x[1];
+    const double div_sun = sx * sx + sy * sy;
+    const double div_mars = x[0] * x[0] + x[1] * x[1];
+    const double factor_sun = CONSTANTE_GRAVITACIONAL * MASSA_SOL / (div_sun * sqrt(div_sun));
+    const double factor_mars = CONSTANTE_GRAVITACIONAL * MASSA_MARTE / (div_mars * sqrt(div_mars));
+
+    (void) v;
+
+    //  Para a órbita circular, G M_sol / |r_m|^3 = ω².
+    a[0] = - factor_sun * sx + mars_omega * mars_omega * mars_x - factor_mars * x[0];
+    a[1] = - factor_sun * sy + mars_omega * mars_omega * mars_y - factor_mars * x[1];
+}
+// ....................................................................................................................
+void flyby3_mars_state(const flyby3_conditions* conditions, const double t, double* coord, double* velocity) {
+    const double mars_omega = sqrt(CONSTANTE_GRAVITACIONAL * MASSA_SOL / (DISTANCIA_MARTE_SOL * DISTANCIA_MARTE_SOL * DISTANCIA_MARTE_SOL));
+    const double mars_angle = conditions->mars_angle_init + mars_omega * t;
+
+    coord[0] = DISTANCIA_MARTE_SOL * cos(mars_angle);
+    coord[1] = DISTANCIA_MARTE_SOL * sin(mars_angle);
+    velocity[0] = - DISTANCIA_MARTE_SOL * mars_omega * sin(mars_angle);
+    velocity[1] = DISTANCIA_MARTE_SOL * mars_omega * cos(mars_angle);
+}
+// ....................................................................................................................
+//      Integral de Jacobi. A velocidade angular de Marte é a mesma do flyby3_mars_state.
+static double jacobi_integral(const double ship_coord[], const double ship_velocity[], const double mars_coord[]) {
+    const double mars_omega = sqrt(CONSTANTE_GRAVITACIONAL * MASSA_SOL / (DISTANCIA_MARTE_SOL * DISTANCIA_MARTE_SOL * DISTANCIA_MARTE_SOL));
+    const double sun_distance = sqrt(ship_coord[1] * ship_coord[1] + ship_coord[2] * ship_coord[2]);
+    const double mars_distance = sqrt((ship_coord[1] - mars_coord[1]) * (ship_coord[1] - mars_coord[1]) + (ship_coord[2] - mars_coord[2]) * (ship_coord[2] - mars_coord[2]));
+
+    return 0.5 * (ship_velocity[1] * ship_velocity[1] + ship_velocity[2] * ship_velocity[2]) - CONSTANTE_GRAVITACIONAL * MASSA_SOL / sun_distance -
+        CONSTANTE_GRAVITACIONAL * MASSA_MARTE / mars_distance - mars_omega * (ship_coord[1] * ship_velocity[2] - ship_coord[2] * ship_velocity[1]);
+}
+// ....................................................................................................................
+//      O desvio é medido em unidades de v_inf² / 2 (a energia relativa a Marte, a escala do sobrevoo): a integral em si
+//  vale ~1e8 J/kg, dominada pelo Sol, e um desvio relativo a ela esconderia o erro da passagem por Marte.
+static void drift_measure(const double jacobi_start, const flyby3_conditions* conditions, const double ship_coord[], const double ship_velocity[],
+    const double mars_coord[], flyby3_result* result) {
+    const double deviation = fabs(jacobi_integral(ship_coord, ship_velocity, mars_coord) - jacobi_start) / (0.5 * conditions->v_infinity * conditions->v_infinity);
+
+    if (deviation > result->drift_jacobi) result->drift_jacobi = deviation;
+}
+// ....................................................................................................................
+//      Raio do periapsis da cônica osculadora relativa a Marte: r_p = p / (1 + e), com p = h²/μ e e² = 1 + 2 E h²/μ².
+static double periapsis_radius(const double r[], const double v[]) {
+    const double mu = CONSTANTE_GRAVITACIONAL * MASSA_MARTE;
+    const double h = r[1] * v[2] - r[2] * v[1];         //  Momento angular específico.
+    const double energy = 0.5 * (v[1] * v[1] + v[2] * v[2]) - mu / sqrt(r[1] * r[1] + r[2] * r[2]);
+    const double e2 = 1 + 2 * energy * h * h / (mu * mu);
+
+    return (h * h / mu) / (1 + sqrt(e2 > 0 ? e2 : 0.0));
+}
+// ....................................................................................................................
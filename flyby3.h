@@ -0,0 +1,128 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      libflyby, problema de 3 corpos: a sonda passando por Marte, com o Sol parado e Marte na órbita circular.
+//
+//  É a mesma ideia do flyby.h para o fly_by_pr3c: toda a configuração vem de uma estrutura (flyby3_config), as
+//  condições iniciais de outra (flyby3_conditions, uma fatia do grid ou uma amostra do Monte Carlo no programa) e todo
+//  o estado fica na pilha da chamada. O fly_by_pr3c é só a linha de comando e os arquivos em volta destas funções: as
+//  trajetórias dele, com as três formulações (polar, cartesiana e o motor de N corpos, nbody.h) e todos os
+//  integradores, são o flyby3_integrate, que entrega as linhas aos arquivos pelo flyby3_sink.
+//
+//  Os vetores aqui começam no índice 0: posição (x, y) e velocidade (v_x, v_y) cartesianas heliocêntricas.
+// ....................................................................................................................
+#ifndef FLY_BY_FLYBY3_H
+#define FLY_BY_FLYBY3_H
+// ....................................................................................................................
+#include "flyby.h"
+#include "nbody.h"
+// ....................................................................................................................
+//      Colunas de uma linha da trajetória: t, x_mars, y_mars, x_ship, y_ship, v_x_mars, v_y_mars, v_x_ship, v_y_ship
+//  e d (as mesmas dos arquivos data_%03d.csv do fly_by_pr3c).
+#define FLYBY3_COLUNAS 10
+
+//      Formulação do estado integrado (opção --engine do fly_by_pr3c).
+#define FORMULACAO_POLAR 0                              //  Coordenadas polares heliocêntricas, conforme Eqs~(34-38).
+#define FORMULACAO_CARTESIANA 1                         //  Coordenadas cartesianas heliocêntricas (sem trigonometria
+                                                        //  por passo no método de Euler).
+#define FORMULACAO_NBODY 2                              //  Motor de N corpos (nbody.h), com o Sol, Marte e os corpos da
+                                                        //  tabela.
+// ....................................................................................................................
+//  - Configuração de uma simulação (a mesma para todas as trajetórias de uma execução).
+typedef struct {
+    double max_time;                                    // [s]      - Tempo máximo de integração (critério de parada de emergência).
+    double dt;                                          // [s]      - Passo de integração (no dopri5, o passo inicial).
+    double output_interval;                             // [s]      - Tempo entre duas linhas na cadência por tempo
+                                                        //            (arredondado para baixo a um número inteiro de
+                                                        //            passos, pelo menos um, exceto no dopri5).
+    double tol_rel;                                     //          - Tolerância relativa do dopri5.
+    double tol_abs;                                     // [m, m/s] - Tolerância absoluta do dopri5 (no estado relativo a Marte).
+    const nbody_table* bodies;                          //          - Tabela de corpos do motor de N corpos (apenas com
+                                                        //            FORMULACAO_NBODY; veja flyby3_bodies).
+    long rows;                                          //          - Orçamento de linhas por trajetória (0 para o padrão da cadência).
+    int integrator;                                     //          - INTEGRADOR_* (integrators.h).
+    int engine;                                         //          - FORMULACAO_* (o leapfrog e o yoshida sempre integram o
+                                                        //            estado cartesiano, fora do motor de N corpos).
+    int reference_body;                                 //          - Marte na tabela 'bodies'.
+    int cadence;                                        //          - Cadência das linhas (CADENCIA_*, cadence.h).
+    int drift;                                          //          - 1 para medir a deriva da integral de Jacobi a cada passo.
+} flyby3_config;
+
+//  - Condições iniciais que não dependem do parâmetro de impacto (uma fatia do grid no pr3c).
+typedef struct {
+    double v_infinity;                                  // [m/s]    - Velocidade da sonda no infinito.
+    double mars_angle_init;                             // [rad]    - Posição angular inicial de Marte.
+    double r_factor;                                    // [m]      - Raio da esfera de influência do planeta.
+    double stop_value;                                  // [m]      - Distância do critério de parada (igual ao r_factor).
+    double v_sonda_init;                                // [m/s]    - Módulo da velocidade inicial da sonda.
+    double cos_angle;                                   //          - cos do ângulo da direção de entrada (o nominal de Marte).
+    double sin_angle;                                   //          - sin do ângulo (idem).
+    double mars_coord[2];                               // [m]      - Posição inicial de Marte.
+    double mars_velocity[2];                            // [m/s]    - Velocidade inicial de Marte.
+    double position_error[2];                           // [m]      - Erro da posição inicial da sonda relativa a Marte.
+    double velocity_error[2];                           // [m/s]    - Erro da velocidade inicial relativa a Marte.
+    int perturbed;                                      //          - 1 para somar os dois erros acima ao estado inicial.
+} flyby3_conditions;
+
+//  - Resultados de uma trajetória.
+typedef struct {
+    double b;                                           // [m]      - Parâmetro de impacto.
+    double d_min;                                       // [m]      - Distância mínima entre a sonda e Marte.
+    double delta_v;                                     // [m/s]    - Variação da velocidade heliocêntrica.
+    double delta_v_rel;                                 // [m/s]    - Variação da velocidade relativa a Marte.
+    double deflection_angle;                            // [rad]    - Ângulo de deflexão.
+    double time_end;                                    // [s]      - Tempo em que a trajetória terminou.
+    double drift_jacobi;                                //          - Maior desvio da integral de Jacobi, em unidades de
+                                                        //            v_inf² / 2 (0 sem config->drift).
+    long long steps;                                    //          - Passos de integração (no dopri5, aceitos e rejeitados).
+    long long steps_accepted;                           //          - Passos aceitos pelo dopri5 (0 nos outros métodos).
+    long long steps_rejected;                           //          - Passos rejeitados pelo dopri5 (idem).
+    int collision;                                      //          - 1 se a sonda colidiu com Marte (ou com um corpo da tabela).
+    int stop;                                           //          - Motivo do fim da trajetória (PARADA_*, profile.h).
+} flyby3_result;
+
+//  - Destino das linhas de uma trajetória (flyby3_integrate). O 'row' pode ser NULL.
+typedef struct {
+    //  → Recebe uma linha (FLYBY3_COLUNAS valores).
+    void (*row)(const double* values, void* context);
+    void* context;                                      //  Último argumento do 'row'.
+} flyby3_sink;
+// ....................................................................................................................
+//  - Configuração com os valores padrão do fly_by_pr3c (Euler na formulação polar, uma linha a cada 180 s, rtol = 1e-10
+//  e atol = 1e-6, sem tabela de corpos).
+//  double max_time, double dt              → Argumentos posicionais do programa.
+flyby3_config flyby3_default_config(double max_time, double dt);
+
+//  - Verifica uma configuração. Retorna 0 se ela é válida e FLYBY_ERRO_CONFIG (flyby.h) caso contrário; o motor de N
+//  corpos precisa da tabela e de um integrador de passo fixo.
+int flyby3_check(const flyby3_config* config);
+
+//  - Condições iniciais nominais: Marte no ângulo inicial, e a sonda na esfera de influência com a energia de
+//  velocity_infinity, apontada para Marte (sem os erros de injeção).
+//  double r_factor                         → Raio da esfera de influência, em raios de Marte.
+//  double mars_init_angle                  → Ângulo inicial de Marte, em graus.
+//  double velocity_infinity                → Velocidade da sonda no infinito.
+void flyby3_conditions_init(flyby3_conditions* conditions, double r_factor, double mars_init_angle, double velocity_infinity);
+
+//  - Tabela do motor de N corpos com o Sol parado na origem e Marte na órbita circular (com ângulo inicial 0: o da
+//  fatia é colocado pelo flyby3_integrate). Os dois entram sem raio, e a colisão com Marte é verificada pelo laço.
+//  Outros corpos podem ser acrescentados depois (nbody_load). Retorna a posição de Marte na tabela.
+int flyby3_bodies(nbody_table* table);
+
+//  - Integra uma trajetória do parâmetro de impacto b.
+//  const flyby3_config* config             → Configuração da simulação.
+//  const flyby3_conditions* conditions     → Condições iniciais (fatia do grid).
+//  double b                                → Parâmetro de impacto.
+//  flyby3_result* result                   → Recebe os resultados da trajetória.
+//  const flyby3_sink* sink                 → Destino das linhas (pode ser NULL). O estado final é sempre a última linha.
+//
+//  * Retorna o número de linhas da trajetória ou FLYBY_ERRO_CONFIG.
+long flyby3_integrate(const flyby3_config* config, const flyby3_conditions* conditions, double b, flyby3_result* result, const flyby3_sink* sink);
+
+//  - Posição e velocidade cartesianas de Marte no instante t (órbita circular prescrita, a partir do ângulo inicial das
+//  condições).
+void flyby3_mars_state(const flyby3_conditions* conditions, double t, double* coord, double* velocity);
+// ....................................................................................................................
+#endif
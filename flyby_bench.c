@@ -0,0 +1,877 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Comentários para desabilitar algumas funções de análise do CLion:
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ....................................................................................................................
+//      Micro-benchmarks dos núcleos de integração e da saída (alvo flyby_bench do CMake).
+//
+//  Cada caso roda algumas vezes para aquecer (caches, frequência do processador, páginas do sistema de arquivos) e
+//  depois é medido várias vezes; o tempo reportado é a mediana das amostras, com o mínimo e o máximo ao lado. Os
+//  casos são:
+//  - pr2c_euler: trajetórias completas do flyby_integrate (flyby.c), o laço de passo fixo do pr2c, com o Euler.
+//  - pr2c_batch: o mesmo passo no lote SIMD (batch.c), com o melhor conjunto de instruções do processador.
+//  - pr2c_euler_mixed, pr2c_batch_mixed: os mesmos dois casos na precisão mista (--precision mixed do pr2c).
+//  - pr3c_polar: o passo de Euler polar do pr3c (polar.c), Eqs~(34-38), com a conversão para cartesianas.
+//  - pr3c_nbody: o passo de Euler do motor de N corpos (nbody.c), com o Sol, Marte, Fobos e Deimos.
+//  - leapfrog, rk4, yoshida, dopri5: um passo de cada integrador de integrators.c com o flyby_acceleration.
+//  - output_csv, output_binary: linhas (t, x, y, v_x, v_y, d) escritas pela saída de output.c, sem escrita assíncrona.
+//  - pr2c_end_to_end, pr3c_end_to_end: os executáveis completos, com duas trajetórias sem colisão.
+//
+//  Os resultados são impressos numa tabela e gravados em JSON (um caso por linha), para comparar commits (--compare).
+//  Com --validate, em vez de medir, o programa confere que o motor de N corpos com um corpo só (Marte parado na origem)
+//  reproduz o Euler do pr2c (flyby_trajectory) a menos do arredondamento.
+// ....................................................................................................................
+//      Bibliotecas:
+#include <dirent.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "batch.h"
+#include "cadence.h"
+#include "flyby.h"
+#include "integrators.h"
+#include "nbody.h"
+#include "output.h"
+#include "polar.h"
+// ....................................................................................................................
+//      Constantes (as mesmas dos dois programas).
+#define N_DIMS 2                                        //  Dimensões do problema.
+#define CONSTANTE_GRAVITACIONAL 6.6743e-11              //  Constante gravitacional de Newton no sistema internacional.
+#define MASSA_SOL 1.9885e30                             //  Massa do Sol. (Em quilogramas)
+#define MASSA_MARTE 6.4171e23                           //  Massa de Marte. (Em quilogramas)
+#define DISTANCIA_MARTE_SOL 2.2794e11                   //  Distância radial entre Marte e o Sol. (Em metros)
+#define RAIO_MARTE 3.3895E6                             //  Raio do planeta Marte. (Em metros)
+#define DEG_TO_RAD 0.0174532925                         //  Relação para converter graus para radianos.
+#define STEPS_PARA_OUTPUT 180                           //  O critério de parada por distância vale depois de 10 vezes isso.
+
+//      Luas de Marte do caso pr3c_nbody: massa (kg), raio (m) e raio da órbita (m).
+#define MASSA_FOBOS 1.0659e16
+#define RAIO_FOBOS 11267.0
+#define ORBITA_FOBOS 9.376e6
+#define MASSA_DEIMOS 1.4762e15
+#define RAIO_DEIMOS 6200.0
+#define ORBITA_DEIMOS 2.3463e7
+
+//      Condições dos casos: as do trabalho (x_init_factor = 50, v_inf = 2600 m/s, ângulo de Marte de -0.01°), com b
+//  entre 5 e 6 raios de Marte (trajetórias sem colisão).
+#define BENCH_X_FATOR 50.0
+#define BENCH_V_INFINITO 2600.0
+#define BENCH_ANGULO_MARTE (-0.01)
+#define BENCH_B_FATOR 5.0
+
+#define AMOSTRAS_PADRAO 7                               //  Amostras medidas de cada caso (--samples).
+#define AQUECIMENTO_PADRAO 2                            //  Execuções descartadas antes das amostras (--warmup).
+#define PASSOS_PADRAO 2000000                           //  Passos por amostra nos núcleos de integração (--steps).
+#define LINHAS_PADRAO 200000                            //  Linhas por amostra nos casos de saída (--rows).
+#define DT_PADRAO 0.5                                   //  Passo de integração dos casos (--dt).
+#define MAX_AMOSTRAS 1000                               //  Número máximo de amostras por caso.
+
+//      Validação do motor de N corpos (--validate): trajetórias com b = 0.5, 1.5, ..., raios de Marte (as primeiras
+//  colidem) e o maior desvio relativo aceito na distância mínima, na variação de velocidade e na deflexão.
+#define VALIDACAO_TESTES 8
+#define VALIDACAO_TOLERANCIA 1e-9
+
+//      Executáveis usados nos casos completos (o CMake passa o caminho dos alvos).
+#ifndef FLYBY_PR2C
+#define FLYBY_PR2C "./fly_by_pr2c"
+#endif
+#ifndef FLYBY_PR3C
+#define FLYBY_PR3C "./fly_by_pr3c"
+#endif
+// ....................................................................................................................
+//      Medida de uma execução de um caso.
+typedef struct {
+    double seconds;                                 //  Tempo da parte medida (sem preparação e limpeza).
+    long long units;                                //  Unidades de trabalho feitas (passos, linhas...).
+    long long bytes;                                //  Bytes escritos (0 nos núcleos de integração).
+} bench_measure;
+
+//      Um caso do benchmark.
+typedef struct {
+    const char* name;                               //  Nome do caso (também no JSON).
+    const char* unit;                               //  Unidade de trabalho (step, lane-step, row).
+    int (*run)(bench_measure* measure);             //  Executa uma vez; retorna 0 em caso de sucesso.
+} bench_case;
+
+//      Resultado de um caso.
+typedef struct {
+    const bench_case* bench;
+    int samples;                                    //  Número de amostras.
+    double median;                                  //  Mediana do tempo das amostras, em segundos.
+    double min;                                     //  Menor tempo.
+    double max;                                     //  Maior tempo.
+    long long units;                                //  Unidades de trabalho por amostra.
+    long long bytes;                                //  Bytes por amostra.
+} bench_result;
+// ....................................................................................................................
+//      Funções auxiliares (aqui temos um "mini-header" dentro do arquivo *.c)
+//  - Relógio monotônico, em segundos.
+double now(void);
+
+//  - Casos do benchmark (veja a lista no começo do arquivo).
+int bench_pr2c_euler(bench_measure* measure);
+int bench_pr2c_batch(bench_measure* measure);
+int bench_pr2c_euler_mixed(bench_measure* measure);
+int bench_pr2c_batch_mixed(bench_measure* measure);
+int bench_pr3c_polar(bench_measure* measure);
+int bench_pr3c_nbody(bench_measure* measure);
+int bench_leapfrog(bench_measure* measure);
+int bench_rk4(bench_measure* measure);
+int bench_yoshida(bench_measure* measure);
+int bench_dopri5(bench_measure* measure);
+int bench_output_csv(bench_measure* measure);
+int bench_output_binary(bench_measure* measure);
+int bench_pr2c_end_to_end(bench_measure* measure);
+int bench_pr3c_end_to_end(bench_measure* measure);
+
+//  - Euler do pr2c, nas trajetórias do flyby_integrate ou no lote, numa precisão (PRECISAO_*, veja batch.h).
+int bench_euler(int precision, bench_measure* measure);
+int bench_batch(int precision, bench_measure* measure);
+
+//  - Passos de um integrador de integrators.c (INTEGRADOR_*) com a aceleração do pr2c.
+int bench_integrator(int method, bench_measure* measure);
+
+//  - Escreve 'rows' linhas com a saída de output.c no formato pedido (SAIDA_*).
+int bench_output(int format, bench_measure* measure);
+
+//  - Roda um dos executáveis (com a saída padrão descartada) e mede o tempo até ele terminar.
+//  const char* const* args                 → Argumentos (args[0] é o executável; termina com NULL).
+//  const char* global                      → Arquivo de dados globais gerado (a soma da coluna 't' dá os passos).
+//  const char* directory                   → Pasta dos arquivos de trajetória (para os bytes escritos).
+int bench_program(const char* const* args, const char* global, const char* directory, bench_measure* measure);
+
+//  - Validação do motor de N corpos contra o pr2c (--validate). Retorna 0 se todas as trajetórias concordam.
+int validate_nbody(void);
+
+//  - Desvio relativo entre um valor e a referência (absoluto quando a referência é zero).
+double relative_deviation(double value, double reference);
+
+//  - Estado inicial do pr2c (flyby_conditions_init): posição e velocidade relativas a Marte.
+void initial_state(double r[], double v[]);
+
+//  - Apaga uma pasta e tudo o que está dentro dela.
+int remove_tree(const char* path);
+
+//  - Soma o tamanho dos arquivos de uma pasta.
+long long directory_bytes(const char* path);
+
+//  - Compara os resultados com os de um JSON gravado antes (--compare).
+void compare_results(const char* path, const bench_result* results, int n_results);
+
+//  - Ordena os tempos das amostras.
+int compare_doubles(const void* a, const void* b);
+// ....................................................................................................................
+//      Alocação global de memória:
+long n_steps;                                       //  Passos por amostra nos núcleos de integração.
+long n_rows;                                        //  Linhas por amostra nos casos de saída.
+double dt;                                          //  Passo de integração.
+int simd;                                           //  Conjunto de instruções do caso pr2c_batch.
+char work_directory[200];                           //  Pasta temporária dos arquivos escritos pelos casos.
+volatile double sink;                               //  Recebe o estado final dos laços, para que o compilador não os
+                                                    //  descarte.
+
+const bench_case cases[] = {
+    {"pr2c_euler", "step", bench_pr2c_euler},
+    {"pr2c_batch", "lane-step", bench_pr2c_batch},
+    {"pr2c_euler_mixed", "step", bench_pr2c_euler_mixed},
+    {"pr2c_batch_mixed", "lane-step", bench_pr2c_batch_mixed},
+    {"pr3c_polar", "step", bench_pr3c_polar},
+    {"pr3c_nbody", "step", bench_pr3c_nbody},
+    {"leapfrog", "step", bench_leapfrog},
+    {"rk4", "step", bench_rk4},
+    {"yoshida", "step", bench_yoshida},
+    {"dopri5", "step", bench_dopri5},
+    {"output_csv", "row", bench_output_csv},
+    {"output_binary", "row", bench_output_binary},
+    {"pr2c_end_to_end", "step", bench_pr2c_end_to_end},
+    {"pr3c_end_to_end", "step", bench_pr3c_end_to_end},
+};
+// ....................................................................................................................
+//      Função de entrada do programa:
+//  Compilação: cmake --build build --target flyby_bench (ou veja o README)
+//  Execução: ./flyby_bench [opções]
+int main(const int argc, const char *argv[]) {
+    const int n_cases = (int) (sizeof(cases) / sizeof(cases[0]));
+    bench_result results[sizeof(cases) / sizeof(cases[0])];
+    bench_measure measure;
+    double seconds[MAX_AMOSTRAS];
+    const char* output;                                 //  Arquivo JSON dos resultados.
+    const char* label;                                  //  Rótulo gravado no JSON (por exemplo, o commit).
+    const char* only;                                   //  Roda apenas os casos cujo nome começa com isso.
+    const char* baseline;                               //  JSON de uma execução anterior (--compare).
+    int samples;
+    int warmup;
+    int validate;                                       //  1 para apenas validar o motor de N corpos (--validate).
+    int n_results;
+    int i;
+    int j;
+    FILE* fo;
+
+    samples = AMOSTRAS_PADRAO;
+    warmup = AQUECIMENTO_PADRAO;
+    n_steps = PASSOS_PADRAO;
+    n_rows = LINHAS_PADRAO;
+    dt = DT_PADRAO;
+    output = "flyby_bench.json";
+    label = "";
+    only = NULL;
+    baseline = NULL;
+    validate = 0;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc) samples = (int) strtol(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) warmup = (int) strtol(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--steps") == 0 && i + 1 < argc) n_steps = strtol(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--rows") == 0 && i + 1 < argc) n_rows = strtol(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--dt") == 0 && i + 1 < argc) dt = strtod(argv[++i], NULL);
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) output = argv[++i];
+        else if (strcmp(argv[i], "--label") == 0 && i + 1 < argc) label = argv[++i];
+        else if (strcmp(argv[i], "--only") == 0 && i + 1 < argc) only = argv[++i];
+        else if (strcmp(argv[i], "--compare") == 0 && i + 1 < argc) baseline = argv[++i];
+        else if (strcmp(argv[i], "--validate") == 0) validate = 1;
+        else {
+            printf("Use: %s [opções]\n", argv[0]);
+            printf("- --samples <N>: Amostras medidas de cada caso (padrão: %d). O tempo reportado é a mediana.\n", AMOSTRAS_PADRAO);
+            printf("- --warmup <N>: Execuções descartadas antes das amostras (padrão: %d).\n", AQUECIMENTO_PADRAO);
+            printf("- --steps <N>: Passos por amostra nos núcleos de integração (padrão: %d).\n", PASSOS_PADRAO);
+            printf("- --rows <N>: Linhas por amostra nos casos de saída (padrão: %d).\n", LINHAS_PADRAO);
+            printf("- --dt <valor>: Passo de integração, em segundos (padrão: %.1f).\n", DT_PADRAO);
+            printf("- --output <arquivo>: Arquivo JSON dos resultados (padrão: flyby_bench.json).\n");
+            printf("- --label <texto>: Rótulo gravado no JSON, por exemplo o commit medido.\n");
+            printf("- --only <prefixo>: Roda apenas os casos cujo nome começa com o prefixo (por exemplo, pr2c ou output).\n");
+            printf("- --compare <arquivo>: Compara com o JSON de uma execução anterior e mostra a variação de cada caso.\n");
+            printf("- --validate: Não mede nada; confere que o motor de N corpos com um corpo só (Marte parado) reproduz o Euler do pr2c a menos do arredondamento (usa o --dt).\n");
+            return 1;
+        }
+    }
+    if (samples < 1 || samples > MAX_AMOSTRAS || warmup < 0 || n_steps < 1 || n_rows < 1 || !(dt > 0)) {
+        printf("Valores inválidos: --samples precisa estar entre 1 e %d, --warmup não pode ser negativo, e --steps, --rows e --dt precisam ser positivos.\n",
+            MAX_AMOSTRAS);
+        return 1;
+    }
+    if (validate) return validate_nbody();
+    simd = batch_select(SIMD_AUTO);
+
+    sprintf(work_directory, "/tmp/flyby_bench.XXXXXX");
+    if (mkdtemp(work_directory) == NULL) {
+        perror("Falha ao criar a pasta temporária do benchmark");
+        return 1;
+    }
+
+    printf("%-18s %10s %8s %14s %14s %14s %12s\n", "caso", "unidade", "amostras", "ns/unidade", "mín ns/unid.", "unidades/s", "MB/s");
+    n_results = 0;
+    for (i = 0; i < n_cases; i++) {
+        if (only != NULL && strncmp(cases[i].name, only, strlen(only)) != 0) continue;
+
+        for (j = 0; j < warmup + samples; j++) {
+            if (cases[i].run(&measure) != 0) {
+                printf("Falha ao executar o caso %s.\n", cases[i].name);
+                remove_tree(work_directory);
+                return 1;
+            }
+            if (j >= warmup) seconds[j - warmup] = measure.seconds;
+        }
+        qsort(seconds, samples, sizeof(double), compare_doubles);
+
+        results[n_results].bench = &cases[i];
+        results[n_results].samples = samples;
+        results[n_results].median = samples % 2 == 1 ? seconds[samples / 2] : 0.5 * (seconds[samples / 2 - 1] + seconds[samples / 2]);
+        results[n_results].min = seconds[0];
+        results[n_results].max = seconds[samples - 1];
+        results[n_results].units = measure.units;
+        results[n_results].bytes = measure.bytes;
+
+        printf("%-18s %10s %8d %14.3f %14.3f %14.4e %12.2f\n", cases[i].name, cases[i].unit, samples, 1e9 * results[n_results].median / (double) measure.units,
+            1e9 * results[n_results].min / (double) measure.units, (double) measure.units / results[n_results].median,
+            (double) measure.bytes / results[n_results].median / 1e6);
+        fflush(stdout);
+        n_results++;
+    }
+    remove_tree(work_directory);
+    // ................................................................................................................
+    //      Resultados em JSON, um caso por linha (o --compare lê esse formato).
+    fo = fopen(output, "w");
+    if (fo == NULL) {
+        perror("Falha ao criar o arquivo de resultados");
+        return 1;
+    }
+    fprintf(fo, "{\n  \"label\": \"%s\",\n  \"timestamp\": %ld,\n  \"dt\": %.6e,\n  \"simd\": \"%s\",\n  \"warmup\": %d,\n  \"results\": [\n", label, (long) time(NULL), dt,
+        batch_name(simd), warmup);
+    for (i = 0; i < n_results; i++) {
+        fprintf(fo, "    {\"name\": \"%s\", \"unit\": \"%s\", \"samples\": %d, \"units\": %lld, \"bytes\": %lld, \"median_s\": %.9e, \"min_s\": %.9e, "
+            "\"max_s\": %.9e, \"ns_per_unit\": %.9e, \"units_per_s\": %.9e, \"bytes_per_s\": %.9e}%s\n", results[i].bench->name, results[i].bench->unit,
+            results[i].samples, results[i].units, results[i].bytes, results[i].median, results[i].min, results[i].max,
+            1e9 * results[i].median / (double) results[i].units, (double) results[i].units / results[i].median, (double) results[i].bytes / results[i].median,
+            i + 1 < n_results ? "," : "");
+    }
+    fprintf(fo, "  ]\n}\n");
+    fclose(fo);
+    printf("\nResultados salvos em: '%s'\n", output);
+
+    if (baseline != NULL) compare_results(baseline, results, n_results);
+    return 0;
+}
+// ....................................................................................................................
+double now(void) {
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double) t.tv_sec + 1e-9 * (double) t.tv_nsec;
+}
+// ....................................................................................................................
+int bench_pr2c_euler(bench_measure* measure) { return bench_euler(PRECISAO_DUPLA, measure); }
+int bench_pr2c_batch(bench_measure* measure) { return bench_batch(PRECISAO_DUPLA, measure); }
+int bench_pr2c_euler_mixed(bench_measure* measure) { return bench_euler(PRECISAO_MISTA, measure); }
+int bench_pr2c_batch_mixed(bench_measure* measure) { return bench_batch(PRECISAO_MISTA, measure); }
+// ....................................................................................................................
+//      Euler do pr2c: trajetórias inteiras do flyby_integrate (o laço do simulate, com a cadência e os critérios de
+//  parada, sem linhas), repetidas até somar pelo menos n_steps passos.
+int bench_euler(const int precision, bench_measure* measure) {
+    flyby_config config = flyby_default_config(BENCH_X_FATOR, BENCH_V_INFINITO, 1e10, dt);
+    flyby_result result;
+    long long steps;
+    double d_min;
+    double begin;
+
+    config.precision = precision;
+    if (flyby_check(&config) != 0) return -1;
+    steps = 0;
+    d_min = HUGE_VAL;
+
+    begin = now();
+    while (steps < n_steps) {
+        if (flyby_integrate(&config, BENCH_B_FATOR * RAIO_MARTE, &result, NULL) < 0) return -1;
+        steps += result.steps;
+        if (result.d_min < d_min) d_min = result.d_min;
+    }
+    measure->seconds = now() - begin;
+
+    sink = result.delta_v + d_min;
+    measure->units = steps;
+    measure->bytes = 0;
+    return 0;
+}
+// ....................................................................................................................
+//      Lote SIMD do pr2c: todas as lanes ativas, sem eventos (a parada e a cadência ficam fora de alcance).
+int bench_batch(const int precision, bench_measure* measure) {
+    batch_lanes lanes;
+    batch_params params;
+    double r[N_DIMS + 1];
+    double v[N_DIMS + 1];
+    double time;
+    double begin;
+    const int width = batch_width(simd);
+    int l;
+
+    initial_state(r, v);
+    params.mu = CONSTANTE_GRAVITACIONAL * MASSA_MARTE;
+    params.dt = dt;
+    params.max_time = (double) n_steps * dt;
+    params.r_collision = RAIO_MARTE;
+    params.r_stop = HUGE_VAL;
+    params.stop_gate = 0.0;
+    params.cadence = CADENCIA_TEMPO;
+    params.precision = precision;
+    for (l = 0; l < BATCH_MAX_LANES; l++) {
+        lanes.x[l] = r[1];
+        lanes.y[l] = r[2] + 0.1 * l * RAIO_MARTE;
+        lanes.vx[l] = v[1];
+        lanes.vy[l] = v[2];
+        lanes.distance[l] = sqrt(lanes.x[l] * lanes.x[l] + lanes.y[l] * lanes.y[l]);
+        lanes.d_min[l] = lanes.distance[l];
+        lanes.progress[l] = 0.0;
+        lanes.limit[l] = HUGE_VAL;
+        lanes.active[l] = l < width;
+    }
+    time = 0.0;
+
+    begin = now();
+    batch_euler_run(simd, &lanes, &params, &time);
+    measure->seconds = now() - begin;
+
+    sink = lanes.x[0] + lanes.d_min[width - 1];
+    measure->units = (long long) llround(time / dt) * width;
+    measure->bytes = 0;
+    return 0;
+}
+// ....................................................................................................................
+//      Passo de Euler polar do pr3c (polar_euler_step) e a conversão do estado para cartesianas feita depois de cada
+//  passo (polar_to_cartesian de Marte e da sonda), como no laço do simulate.
+int bench_pr3c_polar(bench_measure* measure) {
+    double mars_coord_polar[N_DIMS + 1];
+    double mars_velocity_polar[N_DIMS + 1];
+    double ship_coord_polar[N_DIMS + 1];
+    double ship_velocity_polar[N_DIMS + 1];
+    double mars_coord_cartesian[N_DIMS + 1];
+    double mars_velocity_cartesian[N_DIMS + 1];
+    double ship_coord_cartesian[N_DIMS + 1];
+    double ship_velocity_cartesian[N_DIMS + 1];
+    const double r_factor = BENCH_X_FATOR * RAIO_MARTE;
+    const double b = BENCH_B_FATOR * RAIO_MARTE;
+    const double angle = BENCH_ANGULO_MARTE * DEG_TO_RAD;
+    const double v_init = sqrt(BENCH_V_INFINITO * BENCH_V_INFINITO + 2 * CONSTANTE_GRAVITACIONAL * MASSA_MARTE / r_factor);
+    double div;
+    double distance;
+    double d_min;
+    double begin;
+    long i;
+
+    //      Condições iniciais (as do simulate do pr3c).
+    mars_coord_polar[1] = DISTANCIA_MARTE_SOL;
+    mars_coord_polar[2] = angle;
+    mars_velocity_polar[1] = 0.0;
+    mars_velocity_polar[2] = sqrt(CONSTANTE_GRAVITACIONAL * MASSA_SOL / (DISTANCIA_MARTE_SOL * DISTANCIA_MARTE_SOL * DISTANCIA_MARTE_SOL));
+    mars_coord_cartesian[1] = DISTANCIA_MARTE_SOL * cos(angle);
+    mars_coord_cartesian[2] = DISTANCIA_MARTE_SOL * sin(angle);
+
+    ship_coord_cartesian[1] = mars_coord_cartesian[1] + sqrt(r_factor * r_factor - b * b) * sin(angle) - b * cos(angle);
+    ship_coord_cartesian[2] = mars_coord_cartesian[2] - sqrt(r_factor * r_factor - b * b) * cos(angle) - b * sin(angle);
+    ship_velocity_cartesian[1] = - v_init * sin(angle) - DISTANCIA_MARTE_SOL * mars_velocity_polar[2] * sin(angle);
+    ship_velocity_cartesian[2] = v_init * cos(angle) + DISTANCIA_MARTE_SOL * mars_velocity_polar[2] * cos(angle);
+
+    ship_coord_polar[1] = sqrt(ship_coord_cartesian[1] * ship_coord_cartesian[1] + ship_coord_cartesian[2] * ship_coord_cartesian[2]);
+    ship_coord_polar[2] = atan2(ship_coord_cartesian[2], ship_coord_cartesian[1]);
+    ship_velocity_polar[1] = (ship_coord_cartesian[1] * ship_velocity_cartesian[1] + ship_coord_cartesian[2] * ship_velocity_cartesian[2]) / ship_coord_polar[1];
+    ship_velocity_polar[2] = (ship_coord_cartesian[1] * ship_velocity_cartesian[2] - ship_coord_cartesian[2] * ship_velocity_cartesian[1]) / (ship_coord_polar[1] * ship_coord_polar[1]);
+    d_min = HUGE_VAL;
+
+    begin = now();
+    for (i = 0; i < n_steps; i++) {
+        div = polar_euler_step(ship_coord_polar, ship_velocity_polar, mars_coord_polar, mars_velocity_polar, dt);
+        polar_to_cartesian(mars_coord_polar, mars_velocity_polar, mars_coord_cartesian, mars_velocity_cartesian);
+        polar_to_cartesian(ship_coord_polar, ship_velocity_polar, ship_coord_cartesian, ship_velocity_cartesian);
+
+        distance = sqrt(div);
+        if (distance < d_min) d_min = distance;
+    }
+    measure->seconds = now() - begin;
+
+    sink = mars_coord_cartesian[1] + mars_velocity_cartesian[2] + ship_coord_cartesian[1] + ship_velocity_cartesian[2] + d_min;
+    measure->units = n_steps;
+    measure->bytes = 0;
+    return 0;
+}
+// ....................................................................................................................
+//      As mesmas condições iniciais do pr3c_polar, no estado cartesiano do motor de N corpos (a sonda é o único ponto).
+int bench_pr3c_nbody(bench_measure* measure) {
+    nbody_table table;
+    nbody_run run;
+    double x[2];
+    double v[2];
+    const double r_factor = BENCH_X_FATOR * RAIO_MARTE;
+    const double b = BENCH_B_FATOR * RAIO_MARTE;
+    const double angle = BENCH_ANGULO_MARTE * DEG_TO_RAD;
+    const double v_init = sqrt(BENCH_V_INFINITO * BENCH_V_INFINITO + 2 * CONSTANTE_GRAVITACIONAL * MASSA_MARTE / r_factor);
+    double mars_omega;
+    double distance;
+    double d_min;
+    double begin;
+    long i;
+
+    nbody_init(&table);
+    nbody_add_fixed(&table, "sol", CONSTANTE_GRAVITACIONAL * MASSA_SOL, 0.0, 0.0, 0.0);
+    nbody_add_circular(&table, "marte", CONSTANTE_GRAVITACIONAL * MASSA_MARTE, 0.0, 0, DISTANCIA_MARTE_SOL, angle);
+    nbody_add_circular(&table, "fobos", CONSTANTE_GRAVITACIONAL * MASSA_FOBOS, RAIO_FOBOS, 1, ORBITA_FOBOS, 0.0);
+    nbody_add_circular(&table, "deimos", CONSTANTE_GRAVITACIONAL * MASSA_DEIMOS, RAIO_DEIMOS, 1, ORBITA_DEIMOS, 0.0);
+    nbody_run_init(&run, &table, 1, 1);
+    mars_omega = table.omega[1];
+
+    x[0] = DISTANCIA_MARTE_SOL * cos(angle) + sqrt(r_factor * r_factor - b * b) * sin(angle) - b * cos(angle);
+    x[1] = DISTANCIA_MARTE_SOL * sin(angle) - sqrt(r_factor * r_factor - b * b) * cos(angle) - b * sin(angle);
+    v[0] = - v_init * sin(angle) - DISTANCIA_MARTE_SOL * mars_omega * sin(angle);
+    v[1] = v_init * cos(angle) + DISTANCIA_MARTE_SOL * mars_omega * cos(angle);
+    d_min = HUGE_VAL;
+
+    begin = now();
+    for (i = 0; i < n_steps; i++) {
+        nbody_euler_step(&run, (double) i * dt, dt, x, v, &distance);
+        if (distance < d_min) d_min = distance;
+    }
+    measure->seconds = now() - begin;
+
+    sink = x[0] + v[1] + d_min;
+    measure->units = n_steps;
+    measure->bytes = 0;
+    return 0;
+}
+// ....................................................................................................................
+int bench_leapfrog(bench_measure* measure) { return bench_integrator(INTEGRADOR_LEAPFROG, measure); }
+int bench_rk4(bench_measure* measure) { return bench_integrator(INTEGRADOR_RK4, measure); }
+int bench_yoshida(bench_measure* measure) { return bench_integrator(INTEGRADOR_YOSHIDA, measure); }
+int bench_dopri5(bench_measure* measure) { return bench_integrator(INTEGRADOR_DOPRI5, measure); }
+// ....................................................................................................................
+//      Passos de um integrador. No dopri5 todo passo é aceito com h = dt (mede o custo de um passo aceito: seis
+//  avaliações, a estimativa do erro e o FSAL), sem o controle do passo.
+int bench_integrator(const int method, bench_measure* measure) {
+    dopri5_workspace workspace;
+    double r[N_DIMS + 1];
+    double v[N_DIMS + 1];
+    double a[N_DIMS + 1];
+    double r_new[N_DIMS + 1];
+    double v_new[N_DIMS + 1];
+    double time;
+    double err;
+    double begin;
+    long i;
+
+    initial_state(r, v);
+    flyby_acceleration(0.0, &r[1], &v[1], &a[1], NULL);
+    dopri5_init(&workspace, N_DIMS);
+    err = 0.0;
+    time = 0.0;
+
+    begin = now();
+    for (i = 0; i < n_steps; i++) {
+        switch (method) {
+            case INTEGRADOR_LEAPFROG: leapfrog_step(N_DIMS, time, &r[1], &v[1], &a[1], dt, flyby_acceleration, NULL); break;
+            case INTEGRADOR_RK4: rk4_step(N_DIMS, time, &r[1], &v[1], dt, flyby_acceleration, NULL); break;
+            case INTEGRADOR_YOSHIDA: yoshida_step(N_DIMS, time, &r[1], &v[1], dt, flyby_acceleration, NULL); break;
+            default:
+                err += dopri5_step(&workspace, time, &r[1], &v[1], dt, flyby_acceleration, NULL, 1e-10, 1e-6, &r_new[1], &v_new[1]);
+                dopri5_accept(&workspace);
+                r[1] = r_new[1];
+                r[2] = r_new[2];
+                v[1] = v_new[1];
+                v[2] = v_new[2];
+                break;
+        }
+        time += dt;
+    }
+    measure->seconds = now() - begin;
+
+    sink = r[1] + r[2] + v[1] + v[2] + err;
+    measure->units = n_steps;
+    measure->bytes = 0;
+    return 0;
+}
+// ....................................................................................................................
+int bench_output_csv(bench_measure* measure) { return bench_output(SAIDA_CSV, measure); }
+int bench_output_binary(bench_measure* measure) { return bench_output(SAIDA_BINARIA, measure); }
+// ....................................................................................................................
+//      Saída de uma trajetória com n_rows linhas. Os valores variam de linha para linha (como numa trajetória real),
+//  para que a formatação do CSV não fique mais barata do que é.
+int bench_output(const int format, bench_measure* measure) {
+    trajectory_output out;
+    trajectory_store* store;
+    double values[6];
+    double r[N_DIMS + 1];
+    double v[N_DIMS + 1];
+    char directory[300];
+    char filename[350];
+    double begin;
+    long i;
+
+    sprintf(directory, "%s/output", work_directory);
+    if (mkdir(directory, 0755) != 0) return -1;
+    store = NULL;
+    initial_state(r, v);
+
+    begin = now();
+    if (format == SAIDA_BINARIA) {
+        sprintf(filename, "%s/trajectories.bin", directory);
+        store = store_open(filename, 1, "t,x,y,v_x,v_y,d");
+        if (store == NULL) return -1;
+    }
+    if (output_open(&out, format, directory, 0, "t,x,y,v_x,v_y,d", 12, store, NULL, 0) != 0) return -1;
+    for (i = 0; i < n_rows; i++) {
+        values[0] = (double) i * dt;
+        values[1] = r[1] + v[1] * values[0];
+        values[2] = r[2] - 1e-3 * (double) i;
+        values[3] = v[1] + 1e-7 * (double) i;
+        values[4] = v[2] - 3e-8 * (double) i;
+        values[5] = sqrt(values[1] * values[1] + values[2] * values[2]);
+        output_row(&out, values);
+    }
+    output_close(&out);
+    if (store_close(store) != 0) return -1;
+    measure->seconds = now() - begin;
+
+    measure->units = n_rows;
+    measure->bytes = out.bytes;
+    return remove_tree(directory);
+}
+// ....................................................................................................................
+//      Execuções completas: duas trajetórias sem colisão (b de 5 a 6 raios de Marte), com as opções padrão.
+int bench_pr2c_end_to_end(bench_measure* measure) {
+    char name[250];
+    char global[300];
+    char directory[300];
+    char dt_text[50];
+    const char* args[16];
+
+    sprintf(name, "%s/pr2c_run", work_directory);
+    sprintf(global, "%s/global_pr2c.csv", name);
+    sprintf(directory, "%s/pr2c", name);
+    sprintf(dt_text, "%.17g", dt);
+    args[0] = FLYBY_PR2C;
+    args[1] = name;
+    args[2] = "50";
+    args[3] = "2600";
+    args[4] = "5";
+    args[5] = "6";
+    args[6] = "1e10";
+    args[7] = dt_text;
+    args[8] = "--tests";
+    args[9] = "2";
+    args[10] = NULL;
+    if (bench_program(args, global, directory, measure) != 0) return -1;
+    return remove_tree(name);
+}
+
+int bench_pr3c_end_to_end(bench_measure* measure) {
+    char name[250];
+    char global[300];
+    char directory[300];
+    char dt_text[50];
+    const char* args[16];
+
+    //  O pr3c espera que a pasta do teste já exista.
+    sprintf(name, "%s/pr3c_run", work_directory);
+    if (mkdir(name, 0755) != 0) return -1;
+    sprintf(global, "%s/global_pr3c.csv", name);
+    sprintf(directory, "%s/pr3c", name);
+    sprintf(dt_text, "%.17g", dt);
+    args[0] = FLYBY_PR3C;
+    args[1] = name;
+    args[2] = "50";
+    args[3] = "-0.01";
+    args[4] = "2600";
+    args[5] = "5";
+    args[6] = "6";
+    args[7] = "1e10";
+    args[8] = dt_text;
+    args[9] = "--tests";
+    args[10] = "2";
+    args[11] = NULL;
+    if (bench_program(args, global, directory, measure) != 0) return -1;
+    return remove_tree(name);
+}
+// ....................................................................................................................
+int bench_program(const char* const* args, const char* global, const char* directory, bench_measure* measure) {
+    char line[1024];
+    char* field;
+    double begin;
+    double total_time;
+    int t_column;
+    int column;
+    int status;
+    int null;
+    pid_t child;
+    FILE* fi;
+
+    begin = now();
+    child = fork();
+    if (child < 0) return -1;
+    if (child == 0) {
+        null = open("/dev/null", O_WRONLY);
+        if (null >= 0) dup2(null, STDOUT_FILENO);
+        execv(args[0], (char* const*) args);
+        _exit(127);
+    }
+    if (waitpid(child, &status, 0) != child) return -1;
+    measure->seconds = now() - begin;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        printf("O programa %s terminou com erro (código %d).\n", args[0], WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+        return -1;
+    }
+
+    //      Passos integrados: a soma da coluna 't' dividida por dt.
+    fi = fopen(global, "r");
+    if (fi == NULL || fgets(line, sizeof(line), fi) == NULL) {
+        if (fi != NULL) fclose(fi);
+        return -1;
+    }
+    t_column = -1;
+    column = 0;
+    for (field = strtok(line, ",\n"); field != NULL; field = strtok(NULL, ",\n"), column++) if (strcmp(field, "t") == 0) t_column = column;
+    total_time = 0.0;
+    while (t_column >= 0 && fgets(line, sizeof(line), fi) != NULL) {
+        field = line;
+        for (column = 0; column < t_column && field != NULL; column++) {
+            field = strchr(field, ',');
+            if (field != NULL) field++;
+        }
+        if (field != NULL) total_time += strtod(field, NULL);
+    }
+    fclose(fi);
+
+    measure->units = llround(total_time / dt);
+    measure->bytes = directory_bytes(directory);
+    return measure->units > 0 ? 0 : -1;
+}
+// ....................................................................................................................
+//      O laço do motor de N corpos segue o do simulate do pr2c (os mesmos critérios de parada, na mesma ordem), e o
+//  resultado no ponto de parada usa o mesmo flyby_exit. A única diferença nas contas é a ordem da aceleração (μ/|r|³
+//  vezes r, em vez de μ r dividido por |r|³), então os resultados só podem diferir no arredondamento.
+int validate_nbody(void) {
+    const flyby_config config = flyby_default_config(BENCH_X_FATOR, BENCH_V_INFINITO, 1e10, dt);
+    flyby_conditions conditions;
+    flyby_result expected;
+    flyby_result result;
+    nbody_table table;
+    nbody_run run;
+    double x[2];
+    double v[2];
+    double b;
+    double time;
+    double distance;
+    double deviation;
+    double worst;
+    int failed;
+    int i;
+
+    if (flyby_check(&config) != 0) return 1;
+    flyby_conditions_init(&conditions, config.x_init_factor, config.velocity_infinity);
+    nbody_init(&table);
+    nbody_add_fixed(&table, "marte", CONSTANTE_GRAVITACIONAL * MASSA_MARTE, 0.0, 0.0, 0.0);
+    nbody_run_init(&run, &table, 1, 0);
+
+    printf("%8s %8s %10s %14s %14s %14s\n", "b/R_M", "parada", "passos", "desvio d_min", "desvio delta_v", "desvio deflexão");
+    worst = 0.0;
+    failed = 0;
+    for (i = 0; i < VALIDACAO_TESTES; i++) {
+        b = (0.5 + i) * RAIO_MARTE;
+        flyby_trajectory(&config, b, &expected, NULL, 0);
+
+        x[0] = conditions.x_init;
+        x[1] = b;
+        v[0] = conditions.v_x_init;
+        v[1] = 0.0;
+        distance = sqrt(x[0] * x[0] + x[1] * x[1]);
+        result.d_min = distance;
+        result.steps = 0;
+        result.stop = PARADA_TEMPO;
+        for (time = 0; time < config.max_time; time += dt) { // NOLINT(*-flp30-c)
+            if (distance < RAIO_MARTE) {
+                result.d_min = distance;
+                result.stop = PARADA_COLISAO;
+                break;
+            }
+            if (distance >= conditions.stop_value && time > 10 * STEPS_PARA_OUTPUT) {
+                result.stop = PARADA_DISTANCIA;
+                break;
+            }
+            result.steps++;
+            nbody_euler_step(&run, time, dt, x, v, &distance);
+            if (distance < result.d_min) result.d_min = distance;
+        }
+        flyby_exit(x, v, conditions.v_infinite_in, &result.delta_v, &result.deflection_angle);
+
+        deviation = fmax(relative_deviation(result.d_min, expected.d_min), fmax(relative_deviation(result.delta_v, expected.delta_v),
+            relative_deviation(result.deflection_angle, expected.deflection_angle)));
+        if (deviation > worst) worst = deviation;
+        if (result.stop != expected.stop || result.steps != expected.steps || deviation > VALIDACAO_TOLERANCIA) failed = 1;
+        printf("%8.2f %8d %10lld %14.3e %14.3e %14.3e\n", b / RAIO_MARTE, result.stop, result.steps, relative_deviation(result.d_min, expected.d_min),
+            relative_deviation(result.delta_v, expected.delta_v), relative_deviation(result.deflection_angle, expected.deflection_angle));
+    }
+
+    printf("Validação do motor de N corpos contra o pr2c (%d trajetórias, dt = %g s): maior desvio relativo %.3e (tolerância %.0e): %s\n",
+        VALIDACAO_TESTES, dt, worst, VALIDACAO_TOLERANCIA, failed ? "REPROVADA" : "aprovada");
+    return failed;
+}
+// ....................................................................................................................
+double relative_deviation(const double value, const double reference) {
+    return reference != 0.0 ? fabs(value - reference) / fabs(reference) : fabs(value);
+}
+// ....................................................................................................................
+void initial_state(double r[], double v[]) {
+    flyby_conditions conditions;
+
+    flyby_conditions_init(&conditions, BENCH_X_FATOR, BENCH_V_INFINITO);
+    r[1] = conditions.x_init;
+    r[2] = BENCH_B_FATOR * RAIO_MARTE;
+    v[1] = conditions.v_x_init;
+    v[2] = 0.0;
+}
+// ....................................................................................................................
+int remove_tree(const char* path) {
+    DIR* dir;
+    struct dirent* entry;
+    struct stat info;
+    char filename[600];
+    int status;
+
+    dir = opendir(path);
+    if (dir == NULL) return -1;
+    status = 0;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+        snprintf(filename, sizeof(filename), "%s/%s", path, entry->d_name);
+        if (lstat(filename, &info) == 0 && S_ISDIR(info.st_mode)) status |= remove_tree(filename);
+        else status |= remove(filename);
+    }
+    closedir(dir);
+    return status | rmdir(path);
+}
+// ....................................................................................................................
+long long directory_bytes(const char* path) {
+    DIR* dir;
+    struct dirent* entry;
+    struct stat info;
+    char filename[600];
+    long long total;
+
+    dir = opendir(path);
+    if (dir == NULL) return 0;
+    total = 0;
+    while ((entry = readdir(dir)) != NULL) {
+        snprintf(filename, sizeof(filename), "%s/%s", path, entry->d_name);
+        if (stat(filename, &info) == 0 && S_ISREG(info.st_mode)) total += (long long) info.st_size;
+    }
+    closedir(dir);
+    return total;
+}
+// ....................................................................................................................
+//      O JSON gravado tem um caso por linha, então basta procurar o nome e o ns_per_unit em cada linha.
+void compare_results(const char* path, const bench_result* results, const int n_results) {
+    char line[2048];
+    char pattern[100];
+    const char* field;
+    double before;
+    double after;
+    int found;
+    int i;
+    FILE* fi;
+
+    fi = fopen(path, "r");
+    if (fi == NULL) {
+        perror("Falha ao abrir o arquivo de comparação");
+        return;
+    }
+    printf("\nComparação com '%s' (mediana de ns por unidade; negativo é mais rápido):\n", path);
+    for (i = 0; i < n_results; i++) {
+        sprintf(pattern, "\"name\": \"%s\"", results[i].bench->name);
+        after = 1e9 * results[i].median / (double) results[i].units;
+        found = 0;
+        rewind(fi);
+        while (fgets(line, sizeof(line), fi) != NULL) {
+            if (strstr(line, pattern) == NULL) continue;
+            field = strstr(line, "\"ns_per_unit\": ");
+            if (field == NULL) continue;
+            before = strtod(field + 15, NULL);
+            printf("%-18s %14.3f → %14.3f ns  (%+.1f%%)\n", results[i].bench->name, before, after, 100.0 * (after - before) / before);
+            found = 1;
+            break;
+        }
+        if (!found) printf("%-18s sem resultado anterior\n", results[i].bench->name);
+    }
+    fclose(fi);
+}
+// ....................................................................................................................
+int compare_doubles(const void* a, const void* b) {
+    const double x = *(const double*) a;
+    const double y = *(const double*) b;
+
+    return (x > y) - (x < y);
+}
+// ....................................................................................................................
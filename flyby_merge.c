@@ -0,0 +1,581 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Comentários para desabilitar algumas funções de análise do CLion:
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ....................................................................................................................
+//      Junta as partes de uma execução feita com --shard (alvo flyby_merge do CMake, veja shard.h).
+//
+//  Uso: flyby_merge <test_name> [<pasta de uma parte> ...]. Sem as pastas, são usadas todas as pastas 'shard_*' dentro
+//  de <test_name>. As partes de cada programa (as pastas com 'shard_pr2c.txt' ou 'shard_pr3c.txt') são juntadas em
+//  <test_name>, com a organização de uma execução num único processo:
+//  - global_<programa>.csv: as linhas de todas as partes, na ordem dos testes (a coluna 'i'). Como a execução num único
+//    processo também escreve na ordem dos índices (veja sweep.h), o arquivo é idêntico ao dela, byte a byte;
+//  - <programa>/data_NNN.csv ou <programa>/trajectories.bin: as trajetórias de todas as partes (se houver). Os CSVs são
+//    idênticos; o arquivo binário tem os mesmos blocos, mas na ordem dos testes, e não na ordem em que eles terminaram;
+//  - reduce/histogram/boundary/reducers_<programa>: os redutores das partes combinados (se houver, veja reducers.h): as
+//    contagens são as mesmas, e a média e o desvio mudam apenas no arredondamento;
+//  - run_<programa>.txt: a linha de comando, sem o --shard (a mesma da execução num único processo).
+//
+//  Antes de escrever qualquer coisa, as partes são conferidas: todas precisam ter os mesmos argumentos (exceto o
+//  --shard) e o mesmo número de partes, cada parte precisa aparecer uma única vez, e cada teste precisa estar na sua
+//  parte, uma única vez, com a trajetória (se houver) presente. Uma parte incompleta (interrompida) é apontada, para
+//  ser terminada com --resume.
+// ....................................................................................................................
+//      Bibliotecas:
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "output.h"
+#include "reducers.h"
+#include "shard.h"
+// ....................................................................................................................
+#define MERGE_CAMINHO 400                               //  Tamanho máximo de um caminho.
+#define MERGE_COLUNAS 512                               //  Tamanho máximo dos nomes das colunas do arquivo binário.
+#define MERGE_BUFFER 65536                              //  Tamanho do buffer da cópia dos arquivos de trajetória.
+#define MERGE_FALTANDO 8                                //  Testes faltando listados por parte.
+// ....................................................................................................................
+//      Uma parte da execução.
+typedef struct {
+    const char* directory;                          //  Pasta da parte.
+    shard_spec shard;                               //  Índice da parte e número de partes.
+    long n_tests;                                   //  Testes da execução completa.
+    char* config;                                   //  Linha de comando da parte, sem o --shard.
+    FILE* global;                                   //  Arquivo global da parte.
+    char* header;                                   //  Cabeçalho do arquivo global.
+    long* offsets;                                  //  Posição da linha de cada teste da parte no arquivo global (-1
+                                                    //  para um teste que não está no arquivo).
+    trajectory_store* store;                        //  Arquivo binário das trajetórias (apenas no formato binary).
+} merge_part;
+// ....................................................................................................................
+//      Funções auxiliares (aqui temos um "mini-header" dentro do arquivo *.c)
+//  - Junta as partes de um programa em <test_name>. Retorna 0 em caso de sucesso.
+//  const char* test_name                   → Pasta do teste (recebe o resultado).
+//  const char* program                     → Programa (pr2c ou pr3c).
+//  const char* const* directories          → Pastas das partes (as que não têm partes do programa são ignoradas).
+//  int n_directories                       → Número de pastas.
+//  int* found                              → Recebe 1 se alguma pasta tinha uma parte do programa.
+int merge_program(const char* test_name, const char* program, const char* const* directories, int n_directories, int* found);
+
+//  - Lê a linha de comando salva numa pasta (run_<programa>.txt) e tira dela o --shard e o seu valor. Retorna NULL caso
+//  o arquivo não possa ser lido.
+char* read_config(const char* path);
+
+//  - Indexa o arquivo global de uma parte: confere o cabeçalho e guarda a posição da linha de cada teste. Retorna o
+//  número de testes faltando, ou -1 em caso de erro (que é impresso).
+long index_global(merge_part* part, const char* program);
+
+//  - Escreve o arquivo global juntando as linhas das partes, na ordem dos testes. Retorna 0 em caso de sucesso.
+int write_global(const char* path, merge_part* parts, int n_parts, long n_tests);
+
+//  - Junta as trajetórias (CSV ou binário). Retorna 0 em caso de sucesso.
+int merge_trajectories(const char* test_name, const char* program, merge_part* parts, int n_parts, long n_tests);
+
+//  - Combina os redutores das partes, se todas tiverem o estado salvo. Retorna 0 em caso de sucesso.
+int merge_reducers(const char* test_name, const char* program, const merge_part* parts, int n_parts);
+
+//  - Copia um arquivo. Retorna 0 em caso de sucesso.
+int copy_file(const char* from, const char* to);
+
+//  - Libera a memória e fecha os arquivos das partes.
+void free_parts(merge_part* parts, int n_parts);
+
+//  - Ordena nomes (qsort).
+int compare_names(const void* a, const void* b);
+// ....................................................................................................................
+//      Função de entrada do programa:
+//  Compilação: gcc flyby_merge.c shard.c output.c reducers.c -lm -lpthread -o flyby_merge
+//  Execução: ./flyby_merge <test_name> [<pasta de uma parte> ...]
+int main(const int argc, const char *argv[]) {
+    const char** directories;                           //  Pastas das partes.
+    char** names;                                       //  Pastas encontradas em <test_name> (sem pastas na linha de comando).
+    char path[MERGE_CAMINHO];
+    struct dirent* entry;
+    struct stat info;
+    DIR* dir;
+    int n_directories;
+    int capacity;
+    int found[2];
+    int status;
+    int i;
+
+    if (argc < 2 || strncmp(argv[1], "--", 2) == 0) {
+        printf("Use: %s <test_name> [<pasta de uma parte> ...]\n", argv[0]);
+        printf("Junta em <test_name> as partes de uma execução feita com --shard k/N (veja o README). Sem as pastas, são usadas todas as pastas shard_* dentro de <test_name>.\n");
+        return 1;
+    }
+    // ................................................................................................................
+    //      Pastas das partes: as da linha de comando, ou as 'shard_*' da pasta do teste (em ordem alfabética).
+    names = NULL;
+    n_directories = 0;
+    if (argc > 2) {
+        directories = malloc(sizeof(const char*) * (argc - 2));
+        if (directories == NULL) return 1;
+        for (i = 2; i < argc; i++) directories[n_directories++] = argv[i];
+    } else {
+        dir = opendir(argv[1]);
+        if (dir == NULL) {
+            perror("Falha ao abrir a pasta do teste");
+            return 1;
+        }
+        capacity = 0;
+        while ((entry = readdir(dir)) != NULL) {
+            if (strncmp(entry->d_name, "shard_", 6) != 0) continue;
+            snprintf(path, sizeof(path), "%s/%s", argv[1], entry->d_name);
+            if (stat(path, &info) != 0 || !S_ISDIR(info.st_mode)) continue;
+            if (n_directories == capacity) {
+                capacity = capacity > 0 ? 2 * capacity : 16;
+                names = realloc(names, sizeof(char*) * capacity);
+                if (names == NULL) return 1;
+            }
+            names[n_directories] = strdup(path);
+            if (names[n_directories] == NULL) return 1;
+            n_directories++;
+        }
+        closedir(dir);
+        if (n_directories > 1) qsort(names, n_directories, sizeof(char*), compare_names);
+        directories = (const char**) names;
+    }
+    // ................................................................................................................
+    //      Cada programa é juntado separadamente (as duas partes podem estar na mesma pasta).
+    status = merge_program(argv[1], "pr2c", directories, n_directories, &found[0]);
+    if (status == 0) status = merge_program(argv[1], "pr3c", directories, n_directories, &found[1]);
+    if (status == 0 && !found[0] && !found[1]) {
+        printf("Nenhuma parte encontrada (pastas com shard_pr2c.txt ou shard_pr3c.txt) em %s.\n", argc > 2 ? "nas pastas passadas" : argv[1]);
+        status = 1;
+    }
+
+    for (i = 0; names != NULL && i < n_directories; i++) free(names[i]);
+    free(names);
+    if (argc > 2) free(directories);
+    // ................................................................................................................
+    return status;
+}
+// ....................................................................................................................
+int merge_program(const char* test_name, const char* program, const char* const* directories, const int n_directories, int* found) {
+    merge_part* parts;
+    merge_part part;
+    char path[MERGE_CAMINHO];
+    char* reference;                                    //  Linha de comando da primeira parte encontrada.
+    long n_tests;
+    long missing;
+    int n_parts;
+    int problems;
+    int status;
+    int i;
+    int k;
+    FILE* fo;
+
+    *found = 0;
+    parts = NULL;
+    reference = NULL;
+    n_parts = 0;
+    n_tests = 0;
+    problems = 0;
+    // ................................................................................................................
+    //      Lê a identificação e a linha de comando de cada parte, e confere se todas são da mesma execução.
+    for (i = 0; i < n_directories; i++) {
+        memset(&part, 0, sizeof(merge_part));
+        part.directory = directories[i];
+        snprintf(path, sizeof(path), "%s/shard_%s.txt", part.directory, program);
+        if (access(path, F_OK) != 0) continue;
+        if (shard_load(path, &part.shard, &part.n_tests) != 0) {
+            printf("Arquivo da parte inválido: '%s'.\n", path);
+            problems++;
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/run_%s.txt", part.directory, program);
+        part.config = read_config(path);
+        if (part.config == NULL) {
+            printf("Falha ao ler a linha de comando da parte: '%s'.\n", path);
+            problems++;
+            continue;
+        }
+
+        if (reference == NULL) {
+            *found = 1;
+            n_parts = part.shard.count;
+            n_tests = part.n_tests;
+            reference = strdup(part.config);
+            parts = calloc(n_parts, sizeof(merge_part));
+            if (reference == NULL || parts == NULL) return 1;
+        }
+        if (part.shard.count != n_parts || part.n_tests != n_tests || strcmp(part.config, reference) != 0) {
+            printf("A parte em '%s' (%d/%d, %ld testes) não é da mesma execução das outras (%d partes, %ld testes): o número de partes, de testes ou os argumentos são diferentes.\n",
+                part.directory, part.shard.index, part.shard.count, part.n_tests, n_parts, n_tests);
+            free(part.config);
+            problems++;
+            continue;
+        }
+        if (parts[part.shard.index].directory != NULL) {
+            printf("A parte %d/%d aparece duas vezes: em '%s' e em '%s'.\n", part.shard.index, n_parts, parts[part.shard.index].directory, part.directory);
+            free(part.config);
+            problems++;
+            continue;
+        }
+        parts[part.shard.index] = part;
+    }
+    if (reference == NULL) return problems > 0;
+
+    for (k = 0; k < n_parts; k++) {
+        if (parts[k].directory == NULL) {
+            printf("A parte %d/%d do %s está faltando.\n", k, n_parts, program);
+            problems++;
+        }
+    }
+    // ................................................................................................................
+    //      Confere os testes de cada parte no seu arquivo global.
+    for (k = 0; k < n_parts && problems == 0; k++) {
+        missing = index_global(&parts[k], program);
+        if (missing < 0) problems++;
+        else if (missing > 0) {
+            printf("Na parte %d/%d ('%s') faltam %ld testes. Termine-a com o mesmo comando e --resume.\n", k, n_parts, parts[k].directory, missing);
+            problems++;
+        }
+    }
+    for (k = 1; k < n_parts && problems == 0; k++) {
+        if (strcmp(parts[k].header, parts[0].header) != 0) {
+            printf("O cabeçalho do arquivo global da parte %d/%d é diferente do da parte 0.\n", k, n_parts);
+            problems++;
+        }
+    }
+    if (problems > 0) {
+        printf("Nada foi escrito: %d problema(s) nas partes do %s.\n\n", problems, program);
+        free_parts(parts, n_parts);
+        free(reference);
+        return 1;
+    }
+    // ................................................................................................................
+    //      Escreve a execução completa. Os arquivos de uma execução anterior não são sobrescritos.
+    printf("Juntando %d partes do %s (%ld testes) em '%s' ...\n", n_parts, program, n_tests, test_name);
+    status = 0;
+    snprintf(path, sizeof(path), "%s/global_%s.csv", test_name, program);
+    if (access(path, F_OK) == 0) {
+        printf("O arquivo '%s' já existe. Apague-o (ou use outra pasta) antes de juntar as partes.\n", path);
+        status = 1;
+    }
+    if (status == 0) status = write_global(path, parts, n_parts, n_tests);
+    if (status == 0) status = merge_trajectories(test_name, program, parts, n_parts, n_tests);
+    if (status == 0) status = merge_reducers(test_name, program, parts, n_parts);
+
+    //      A linha de comando, sem o --shard, é a de uma execução completa (a configuração do journal.h).
+    if (status == 0) {
+        snprintf(path, sizeof(path), "%s/run_%s.txt", test_name, program);
+        fo = fopen(path, "w");
+        if (fo == NULL || fputs(reference, fo) < 0) status = 1;
+        if (fo != NULL && fclose(fo) != 0) status = 1;
+        if (status != 0) perror("Falha ao gravar a linha de comando da execução");
+    }
+    if (status == 0) printf("Dados globais salvos em: '%s/global_%s.csv'\n\n", test_name, program);
+
+    free_parts(parts, n_parts);
+    free(reference);
+    return status;
+}
+// ....................................................................................................................
+char* read_config(const char* path) {
+    char* config;
+    char* line;
+    char* next;
+    char* write;
+    size_t length;
+    long size;
+    FILE* fi;
+
+    fi = fopen(path, "r");
+    if (fi == NULL) return NULL;
+    fseek(fi, 0, SEEK_END);
+    size = ftell(fi);
+    fseek(fi, 0, SEEK_SET);
+
+    config = size >= 0 ? malloc((size_t) size + 1) : NULL;
+    if (config == NULL || fread(config, 1, (size_t) size, fi) != (size_t) size) {
+        free(config);
+        fclose(fi);
+        return NULL;
+    }
+    fclose(fi);
+    config[size] = '\0';
+    // ................................................................................................................
+    //      Um argumento por linha (veja o journal.c): tira a linha do --shard e a seguinte, com o valor.
+    write = config;
+    for (line = config; *line != '\0'; line = next) {
+        next = strchr(line, '\n');
+        next = next != NULL ? next + 1 : line + strlen(line);
+        length = (size_t) (next - line);
+        if (length == 8 && strncmp(line, "--shard\n", 8) == 0) {
+            next = strchr(next, '\n');
+            next = next != NULL ? next + 1 : line + strlen(line);
+            continue;
+        }
+        memmove(write, line, length);
+        write += length;
+    }
+    *write = '\0';
+
+    return config;
+}
+// ....................................................................................................................
+long index_global(merge_part* part, const char* program) {
+    const long n_part = shard_tests(&part->shard, part->n_tests);
+    char path[MERGE_CAMINHO];
+    char* line;
+    char* end;
+    size_t capacity;
+    ssize_t length;
+    long position;
+    long missing;
+    long test;
+    long j;
+
+    snprintf(path, sizeof(path), "%s/global_%s.csv", part->directory, program);
+    part->global = fopen(path, "r");
+    part->offsets = malloc(sizeof(long) * (n_part > 0 ? n_part : 1));
+    if (part->global == NULL || part->offsets == NULL) {
+        printf("Falha ao ler o arquivo global da parte: '%s'.\n", path);
+        return -1;
+    }
+    for (j = 0; j < n_part; j++) part->offsets[j] = -1;
+
+    line = NULL;
+    capacity = 0;
+    length = getline(&line, &capacity, part->global);
+    if (length <= 0 || line[length - 1] != '\n') {
+        printf("O arquivo global da parte não tem cabeçalho: '%s'.\n", path);
+        free(line);
+        return -1;
+    }
+    part->header = strdup(line);
+    // ................................................................................................................
+    //      Linhas dos testes. Uma linha cortada no fim (parte interrompida) é ignorada, e o teste conta como faltando.
+    position = ftell(part->global);
+    while ((length = getline(&line, &capacity, part->global)) > 0) {
+        if (line[length - 1] == '\n') {
+            test = strtol(line, &end, 10) - 1;
+            if (end == line || *end != ',' || test < 0 || test >= part->n_tests) {
+                printf("Linha inválida no arquivo global da parte: '%s'.\n", path);
+                free(line);
+                return -1;
+            }
+            if (!shard_member(&part->shard, test)) {
+                printf("O teste %ld está no arquivo global da parte %d/%d ('%s'), mas pertence à parte %ld.\n", test + 1, part->shard.index,
+                    part->shard.count, path, test % part->shard.count);
+                free(line);
+                return -1;
+            }
+            if (part->offsets[test / part->shard.count] >= 0) {
+                printf("O teste %ld aparece duas vezes no arquivo global da parte %d/%d ('%s').\n", test + 1, part->shard.index, part->shard.count, path);
+                free(line);
+                return -1;
+            }
+            part->offsets[test / part->shard.count] = position;
+        }
+        position = ftell(part->global);
+    }
+    free(line);
+
+    missing = 0;
+    for (j = 0; j < n_part; j++) {
+        if (part->offsets[j] >= 0) continue;
+        if (missing < MERGE_FALTANDO) printf("\t Teste faltando na parte %d/%d: %ld\n", part->shard.index, part->shard.count,
+            j * part->shard.count + part->shard.index + 1);
+        missing++;
+    }
+    return missing;
+}
+// ....................................................................................................................
+int write_global(const char* path, merge_part* parts, const int n_parts, const long n_tests) {
+    merge_part* part;
+    char* line;
+    size_t capacity;
+    long test;
+    int status;
+    FILE* fo;
+
+    fo = fopen(path, "w");
+    if (fo == NULL) {
+        perror("Falha ao criar o arquivo de dados globais");
+        return 1;
+    }
+
+    //      Os testes de uma parte estão em ordem no índice dela, então cada linha é lida com um único fseek.
+    status = fputs(parts[0].header, fo) < 0;
+    line = NULL;
+    capacity = 0;
+    for (test = 0; test < n_tests && status == 0; test++) {
+        part = &parts[test % n_parts];
+        if (fseek(part->global, part->offsets[test / n_parts], SEEK_SET) != 0 || getline(&line, &capacity, part->global) <= 0 || fputs(line, fo) < 0)
+            status = 1;
+    }
+    free(line);
+    if (fclose(fo) != 0) status = 1;
+
+    if (status != 0) perror("Falha ao escrever o arquivo de dados globais");
+    return status;
+}
+// ....................................................................................................................
+int merge_trajectories(const char* test_name, const char* program, merge_part* parts, const int n_parts, const long n_tests) {
+    char from[MERGE_CAMINHO];
+    char to[MERGE_CAMINHO];
+    char columns[MERGE_COLUNAS];
+    trajectory_store* store;
+    merge_part* part;
+    int binary;
+    int status;
+    long test;
+    int k;
+
+    //      A pasta das trajetórias existe numa execução completa mesmo sem nenhum arquivo nela.
+    snprintf(to, sizeof(to), "%s/%s", test_name, program);
+    if (mkdir(to, 0755) != 0 && errno != EEXIST) {
+        perror("Falha ao criar a pasta das trajetórias");
+        return 1;
+    }
+
+    //      O formato é o mesmo em todas as partes (os argumentos são os mesmos): o arquivo binário, os CSVs (o do
+    //  primeiro teste existe) ou nenhum arquivo de trajetória (--output none, ou o Monte Carlo sem --mc-trajectories).
+    snprintf(from, sizeof(from), "%s/%s/trajectories.bin", parts[0].directory, program);
+    binary = access(from, F_OK) == 0;
+    snprintf(from, sizeof(from), "%s/%s/data_%03d.csv", parts[0].directory, program, 1);
+    if (!binary && access(from, F_OK) != 0) return 0;
+    // ................................................................................................................
+    //      CSV: os arquivos são copiados com os mesmos nomes (o índice do teste é o mesmo da execução completa).
+    if (!binary) {
+        for (test = 0; test < n_tests; test++) {
+            snprintf(from, sizeof(from), "%s/%s/data_%03ld.csv", parts[test % n_parts].directory, program, test + 1);
+            snprintf(to, sizeof(to), "%s/%s/data_%03ld.csv", test_name, program, test + 1);
+            if (copy_file(from, to) != 0) {
+                printf("Falha ao copiar o arquivo de trajetória '%s' para '%s'.\n", from, to);
+                return 1;
+            }
+        }
+        printf("\t %ld arquivos de trajetória copiados para '%s/%s'\n", n_tests, test_name, program);
+        return 0;
+    }
+    // ................................................................................................................
+    //      Binário: os blocos vão para um único arquivo, na ordem dos testes.
+    for (k = 0; k < n_parts; k++) {
+        snprintf(from, sizeof(from), "%s/%s/trajectories.bin", parts[k].directory, program);
+        parts[k].store = store_read(from);
+        if (parts[k].store == NULL || store_trajectories(parts[k].store) != n_tests) {
+            printf("Arquivo binário das trajetórias inválido (ou com outro número de testes): '%s'.\n", from);
+            return 1;
+        }
+    }
+    if (store_columns(parts[0].store, columns, sizeof(columns)) != 0) {
+        printf("Falha ao ler as colunas do arquivo binário das trajetórias da parte 0.\n");
+        return 1;
+    }
+    snprintf(to, sizeof(to), "%s/%s/trajectories.bin", test_name, program);
+    store = store_open(to, n_tests, columns);
+    if (store == NULL) {
+        perror("Falha ao criar o arquivo binário das trajetórias");
+        return 1;
+    }
+    status = 0;
+    for (test = 0; test < n_tests && status == 0; test++) {
+        part = &parts[test % n_parts];
+        if (store_copy(store, part->store, test) != 0) {
+            printf("A trajetória do teste %ld não está no arquivo binário da parte %d/%d (ou não pôde ser copiada).\n", test + 1, part->shard.index, n_parts);
+            status = 1;
+        }
+    }
+    if (store_close(store) != 0) status = 1;
+    if (status == 0) printf("\t %ld trajetórias salvas em '%s'\n", n_tests, to);
+
+    return status;
+}
+// ....................................................................................................................
+int merge_reducers(const char* test_name, const char* program, const merge_part* parts, const int n_parts) {
+    reducer_set* total;
+    reducer_set* other;
+    char path[MERGE_CAMINHO];
+    int present;
+    int status;
+    int k;
+
+    present = 0;
+    for (k = 0; k < n_parts; k++) {
+        snprintf(path, sizeof(path), "%s/reducers_%s.txt", parts[k].directory, program);
+        present += access(path, F_OK) == 0;
+    }
+    if (present == 0) return 0;
+    if (present < n_parts) {
+        printf("Apenas %d das %d partes têm o estado dos redutores (reducers_%s.txt).\n", present, n_parts, program);
+        return 1;
+    }
+    // ................................................................................................................
+    //      Os conjuntos são grandes demais para a pilha. As contagens da soma não dependem da ordem das partes.
+    total = malloc(sizeof(reducer_set));
+    other = malloc(sizeof(reducer_set));
+    status = total == NULL || other == NULL;
+    for (k = 0; k < n_parts && status == 0; k++) {
+        snprintf(path, sizeof(path), "%s/reducers_%s.txt", parts[k].directory, program);
+        if (reducers_load(k == 0 ? total : other, path) != 0 || (k > 0 && reducers_merge(total, other) != 0)) {
+            printf("Estado dos redutores inválido (ou incompatível com o das outras partes): '%s'.\n", path);
+            status = 1;
+        }
+    }
+    if (status == 0 && reducers_write(total, test_name, program) != 0) {
+        perror("Falha ao gravar os resultados dos redutores");
+        status = 1;
+    }
+    free(total);
+    free(other);
+
+    return status;
+}
+// ....................................................................................................................
+int copy_file(const char* from, const char* to) {
+    char buffer[MERGE_BUFFER];
+    size_t n;
+    int status;
+    FILE* fi;
+    FILE* fo;
+
+    fi = fopen(from, "rb");
+    if (fi == NULL) return -1;
+    fo = fopen(to, "wb");
+    if (fo == NULL) {
+        fclose(fi);
+        return -1;
+    }
+
+    status = 0;
+    while ((n = fread(buffer, 1, sizeof(buffer), fi)) > 0) {
+        if (fwrite(buffer, 1, n, fo) != n) {
+            status = -1;
+            break;
+        }
+    }
+    if (ferror(fi)) status = -1;
+    fclose(fi);
+    if (fclose(fo) != 0) status = -1;
+
+    return status;
+}
+// ....................................................................................................................
+void free_parts(merge_part* parts, const int n_parts) {
+    int k;
+
+    for (k = 0; k < n_parts; k++) {
+        free(parts[k].config);
+        free(parts[k].header);
+        free(parts[k].offsets);
+        if (parts[k].global != NULL) fclose(parts[k].global);
+        store_close(parts[k].store);
+    }
+    free(parts);
+}
+// ....................................................................................................................
+int compare_names(const void* a, const void* b) {
+    return strcmp(*(char* const*) a, *(char* const*) b);
+}
+// ....................................................................................................................
@@ -4,6 +4,7 @@
 using CSV
 using DataFrames
 using GLMakie
+using Mmap
 using Printf
 using ProgressMeter
 # ..................................................................................................
@@ -64,6 +65,133 @@ function main()
     # ..............................................................................................
 end
 # ..................................................................................................
+#       Leitura do arquivo binário das trajetórias ('--output binary', veja output.h).
+#   → O arquivo é mapeado na memória e cada trajetória é uma matriz (linhas × colunas) que aponta
+#   direto para o arquivo, sem conversão de texto. Os valores estão em little-endian, que é a ordem
+#   nativa dos processadores usuais (x86, ARM).
+function open_trajectory_store(path::String)
+    bytes = Mmap.mmap(path, Vector{UInt8})
+    if (length(bytes) < 64 || String(bytes[1:8]) != "FLYBYTRJ")
+        error("'$path' não é um arquivo de trajetórias.")
+    end
+
+    u32(offset) = Int(ltoh(reinterpret(UInt32, bytes[offset + 1:offset + 4])[1]))
+    u64(offset) = Int(ltoh(reinterpret(UInt64, bytes[offset + 1:offset + 8])[1]))
+
+    n_columns = u32(12)
+    n_trajectories = u64(16)
+    names_offset = u64(24)
+    index_offset = u64(32)
+
+    names = [String(filter(!=(0x00), bytes[names_offset + 16 * (j - 1) + 1:names_offset + 16 * j])) for j in 1:n_columns]
+    offsets = [u64(index_offset + 16 * (i - 1)) for i in 1:n_trajectories]
+    n_rows = [u64(index_offset + 16 * (i - 1) + 8) for i in 1:n_trajectories]
+
+    return (bytes = bytes, n_columns = n_columns, names = names, offsets = offsets, n_rows = n_rows)
+end
+
+#   → Trajetória 'i' (começando em 1, como os arquivos 'data_%03d.csv').
+function read_trajectory(store, i::Int)
+    first_byte = store.offsets[i] + 1
+    last_byte = store.offsets[i] + 8 * store.n_rows[i] * store.n_columns
+    return reshape(reinterpret(Float64, view(store.bytes, first_byte:last_byte)), store.n_rows[i], store.n_columns)
+end
+
+#   → Lê um arquivo de dados globais. As linhas são escritas na ordem dos testes, mas numa retomada (--resume) as novas
+#   vão para o fim, então são ordenadas pela coluna 'i' (a linha i volta a ser o teste i).
+function read_global(path::String)
+    data = Matrix(CSV.read(path, DataFrame, delim = ","))
+    return data[sortperm(data[:, 1]), :]
+end
+
+#   → Lista as trajetórias de uma pasta (pr2c ou pr3c): (identificador, nome do arquivo de saída, leitura).
+#   Usa o arquivo binário quando ele existe, e os arquivos CSV caso contrário.
+function list_trajectories(input_path::String)
+    binary_path = joinpath(input_path, "trajectories.bin")
+    if isfile(binary_path)
+        store = open_trajectory_store(binary_path)
+        return [(i, @sprintf("data_%03d", i), () -> read_trajectory(store, i)) for i in eachindex(store.n_rows) if store.n_rows[i] > 0]
+    end
+
+    files = filter(x -> isfile(joinpath(input_path, x)), readdir(input_path))
+    files = filter(x -> x != "global.csv" && endswith(x, ".csv"), files)
+    return [(parse(Int, match(r"\d+", file).match), splitext(file)[1], () -> Matrix(CSV.read(joinpath(input_path, file), DataFrame, delim = ","))) for file in files]
+end
+# ..................................................................................................
+#       Chamadas diretas à libflyby (veja flyby.h): as trajetórias do problema de 2 corpos são calculadas dentro do
+#   próprio Julia, sem arquivos. A biblioteca escreve direto na memória das matrizes e vetores alocados aqui.
+#   → Caminho da biblioteca: a variável de ambiente LIBFLYBY, ou o build do README (cmake -B build).
+const libflyby = get(ENV, "LIBFLYBY", joinpath(@__DIR__, "build", "libflyby.so"))
+
+#   → Mesmos campos, na mesma ordem, do flyby_config e do flyby_result.
+struct FlybyConfig
+    x_init_factor::Float64
+    velocity_infinity::Float64
+    max_time::Float64
+    dt::Float64
+    output_interval::Float64
+    tol_rel::Float64
+    tol_abs::Float64
+    rows::Clong
+    integrator::Cint
+    precision::Cint
+    cadence::Cint
+end
+
+struct FlybyResult
+    b::Float64
+    d_min::Float64
+    delta_v::Float64
+    deflection_angle::Float64
+    time_end::Float64
+    steps::Clonglong
+    steps_accepted::Clonglong
+    steps_rejected::Clonglong
+    collision::Cint
+    stop::Cint
+end
+
+const flyby_integrators = Dict("euler" => 0, "leapfrog" => 1, "rk4" => 2, "yoshida" => 3, "dopri5" => 4)
+const flyby_cadences = Dict("time" => 0, "arc" => 1, "distance" => 2)
+
+#   → Configuração com os padrões do fly_by_pr2c (os argumentos posicionais são os mesmos do programa).
+function flyby_config(x_init_factor, velocity_infinity, max_time, dt; integrator = "euler", precision = "double", cadence = "time", rows = 0, output_interval = 180.0,
+    rtol = 1e-10, atol = 1e-6)
+    return FlybyConfig(x_init_factor, velocity_infinity, max_time, dt, output_interval, rtol, atol, rows, flyby_integrators[integrator], precision == "mixed" ? 1 : 0, flyby_cadences[cadence])
+end
+
+#   → Uma trajetória: (resultado, matriz linhas × (t, x, y, v_x, v_y, d)), como o read_trajectory. O tamanho inicial
+#   da matriz vem da estimativa de passos; se a trajetória não couber, ela é calculada de novo numa matriz maior.
+function flyby_trajectory(config::FlybyConfig, b::Float64)
+    result = Ref{FlybyResult}()
+    steps = ccall((:flyby_estimate_steps, libflyby), Cdouble, (Ref{FlybyConfig}, Cdouble), config, b)
+    capacity = config.rows > 0 ? config.rows : max(512, ceil(Int, 1.25 * steps * config.dt / max(config.output_interval, config.dt)) + 2)
+
+    while true
+        rows = Matrix{Float64}(undef, capacity, 6)
+        n = ccall((:flyby_trajectory, libflyby), Clong, (Ref{FlybyConfig}, Cdouble, Ref{FlybyResult}, Ptr{Float64}, Clong), config, b, result, rows, capacity)
+        n < 0 && error("Configuração inválida para a libflyby.")
+        n <= capacity && return (result[], view(rows, 1:n, :))
+        capacity = n
+    end
+end
+
+#   → Vários valores de b (apenas os resultados), com o sweep de várias threads da biblioteca.
+function flyby_sweep(config::FlybyConfig, b_values::Vector{Float64}; threads::Int = Sys.CPU_THREADS)
+    results = Vector{FlybyResult}(undef, length(b_values))
+    status = ccall((:flyby_sweep, libflyby), Cint, (Ref{FlybyConfig}, Cint, Ptr{Float64}, Ptr{FlybyResult}, Cint), config, length(b_values), b_values, results, threads)
+    status < 0 && error("Falha no sweep da libflyby (código $status).")
+    return results
+end
+
+#   → Solução analítica (hipérbole kepleriana) de um b.
+function flyby_analytic(config::FlybyConfig, b::Float64)
+    result = Ref{FlybyResult}()
+    status = ccall((:flyby_analytic, libflyby), Cint, (Ref{FlybyConfig}, Cdouble, Ref{FlybyResult}), config, b, result)
+    status < 0 && error("Configuração inválida para a libflyby.")
+    return result[]
+end
+# ..................................................................................................
 #       Processamento dos dados por simulação.
 function snapshot_pr2c(project_name::String)
     println("Inicializando processamento das trajetórias do projeto '$project_name' ...")
@@ -73,28 +201,20 @@ function snapshot_pr2c(project_name::String)
     output_path::String = joinpath(@__DIR__, project_name, "results", "snapshots", "pr2c")
     mkpath(output_path)
     # ..............................................................................................
-    #       → Lista os arquivos
-    files = filter(x -> isfile(joinpath(input_path, x)), readdir(input_path))
-    files = filter(x -> x != "global.csv", files)
+    #       → Lista as trajetórias (arquivo binário ou arquivos CSV).
+    trajectories = list_trajectories(input_path)
     # ..............................................................................................
     #       → Pega os dados globais também, para a ter o parâmetro de impacto.
-    data_global = CSV.read(joinpath(@__DIR__, project_name, "global_pr2c.csv"), DataFrame, delim = ",")
-    data_global = Matrix(data_global)
+    data_global = read_global(joinpath(@__DIR__, project_name, "global_pr2c.csv"))
     # ..............................................................................................
     #       → Painel de snapshots.
     painel = Figure(size = (1000, 1200))
     # ..............................................................................................
     #       → Abre cada um dos arquivos e processa eles
-    @showprogress for file in files
-        # ..........................................................................................
-        #       → Lê o arquivo e pega os dados
-        path = joinpath(input_path, file)
-        data = CSV.read(path, DataFrame, delim = ",")
-        data = Matrix(data)
+    @showprogress for (i, root, load) in trajectories
         # ..........................................................................................
-        #       → Pega o identificador
-        m = match(r"\d+", file)
-        i = parse(Int, m.match)
+        #       → Lê os dados da trajetória 'i'.
+        data = load()
         # ..........................................................................................
         #       → Monta a figura
         fig = Figure(size = (600, 600))
@@ -109,7 +229,6 @@ function snapshot_pr2c(project_name::String)
         axislegend(ax, position = :lc)
         # ..........................................................................................
         #       → Salva a figura.
-        root, _ = splitext(file)
         save(joinpath(output_path, "$(root).png"), fig)
         # ..........................................................................................
         #       → Verifica para a montagem do painel.
@@ -139,28 +258,20 @@ function snapshot_pr3c(project_name::String)
     output_path::String = joinpath(@__DIR__, project_name, "results", "snapshots", "pr3c")
     mkpath(output_path)
     # ..............................................................................................
-    #       → Lista os arquivos
-    files = filter(x -> isfile(joinpath(input_path, x)), readdir(input_path))
-    files = filter(x -> x != "global.csv", files)
+    #       → Lista as trajetórias (arquivo binário ou arquivos CSV).
+    trajectories = list_trajectories(input_path)
     # ..............................................................................................
     #       → Pega os dados globais também, para a ter o parâmetro de impacto.
-    data_global = CSV.read(joinpath(@__DIR__, project_name, "global_pr3c.csv"), DataFrame, delim = ",")
-    data_global = Matrix(data_global)
+    data_global = read_global(joinpath(@__DIR__, project_name, "global_pr3c.csv"))
     # ..............................................................................................
     #       → Painel de snapshots.
     painel = Figure(size = (1000, 1200))
     # ..............................................................................................
     #       → Abre cada um dos arquivos e processa eles
-    @showprogress for file in files
-        # ..........................................................................................
-        #       → Lê o arquivo e pega os dados
-        path = joinpath(input_path, file)
-        data = CSV.read(path, DataFrame, delim = ",")
-        data = Matrix(data)
+    @showprogress for (i, root, load) in trajectories
         # ..........................................................................................
-        #       → Pega o identificador
-        m = match(r"\d+", file)
-        i = parse(Int, m.match)
+        #       → Lê os dados da trajetória 'i'.
+        data = load()
         # ..........................................................................................
         #       → Monta a figura
         fig = Figure(size = (600, 600))
@@ -175,7 +286,6 @@ function snapshot_pr3c(project_name::String)
         axislegend(ax, position = :cb)
         # ..........................................................................................
         #       → Salva a figura.
-        root, _ = splitext(file)
         save(joinpath(output_path, "$(root).png"), fig)
         # ..........................................................................................
         #       → Verifica para a montagem do painel.
@@ -206,11 +316,9 @@ function global_process(project_name::String, velocidade_infinito::Float64)
     mkpath(output_path)
     # ..............................................................................................
     #       → Lê o arquivo de dados globais.
-    data_pr2c = CSV.read(joinpath(input_path, "global_pr2c.csv"), DataFrame, delim = ",")
-    data_pr2c = Matrix(data_pr2c)
+    data_pr2c = read_global(joinpath(input_path, "global_pr2c.csv"))
 
-    data_pr3c = CSV.read(joinpath(input_path, "global_pr3c.csv"), DataFrame, delim = ",")
-    data_pr3c = Matrix(data_pr3c)
+    data_pr3c = read_global(joinpath(input_path, "global_pr3c.csv"))
     # ..............................................................................................
     #       Distância mínima por parâmetro de impacto.
     fig = Figure(size = (800, 600))
@@ -313,5 +421,7 @@ function global_process(project_name::String, velocidade_infinito::Float64)
     # ..............................................................................................
 end
 # ..................................................................................................
-#       Chamada da função principal.
-out = main()
\ No newline at end of file
+#       Chamada da função principal (apenas quando o script é executado; com include, só as funções são carregadas).
+if abspath(PROGRAM_FILE) == @__FILE__
+    out = main()
+end
\ No newline at end of file
@@ -0,0 +1,93 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Comentários para desabilitar algumas funções de análise do CLion:
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ....................................................................................................................
+//      Bibliotecas:
+#include <stdlib.h>
+#include <string.h>
+
+#include "grid.h"
+// ....................................................................................................................
+//      Procura um eixo pelo nome.
+static const grid_axis* find(const grid_spec* grid, const char* name) {
+    int i;
+
+    for (i = 0; i < grid->n_axes; i++) if (strcmp(grid->axes[i].name, name) == 0) return &grid->axes[i];
+    return NULL;
+}
+// ....................................................................................................................
+int grid_add(grid_spec* grid, const char* spec) {
+    grid_axis axis;
+    const char* value;
+    char* end;
+    size_t length;
+
+    value = strchr(spec, '=');
+    if (value == NULL) return -1;
+    length = (size_t) (value - spec);
+    if (length == 0 || length >= GRID_TAMANHO_NOME) return -1;
+    memcpy(axis.name, spec, length);
+    axis.name[length] = '\0';
+
+    //      'nome=valor' ou 'nome=min:max:n'.
+    axis.min = strtod(value + 1, &end);
+    if (end == value + 1) return -1;
+    axis.max = axis.min;
+    axis.n = 1;
+    if (*end == ':') {
+        value = end + 1;
+        axis.max = strtod(value, &end);
+        if (end == value || *end != ':') return -1;
+        value = end + 1;
+        axis.n = (int) strtol(value, &end, 10);
+        if (end == value || axis.n < 1) return -1;
+    }
+    if (*end != '\0') return -1;
+
+    if (find(grid, axis.name) != NULL || grid->n_axes >= GRID_MAX_EIXOS) return -2;
+    grid->axes[grid->n_axes++] = axis;
+    return 0;
+}
+// ....................................................................................................................
+const char* grid_check(const grid_spec* grid, const char* const* names, const int n_names) {
+    int i;
+    int j;
+
+    for (i = 0; i < grid->n_axes; i++) {
+        for (j = 0; j < n_names; j++) if (strcmp(grid->axes[i].name, names[j]) == 0) break;
+        if (j == n_names) return grid->axes[i].name;
+    }
+    return NULL;
+}
+// ....................................................................................................................
+long grid_slices(const grid_spec* grid) {
+    long slices;
+    int i;
+
+    slices = 1;
+    for (i = 0; i < grid->n_axes; i++) slices *= grid->axes[i].n;
+    return slices;
+}
+// ....................................................................................................................
+double grid_value(const grid_spec* grid, const char* name, const long slice, const double fallback) {
+    long stride;
+    long index;
+    int i;
+
+    //      Os eixos depois do procurado variam mais rápido: o índice dele é (slice / produto dos seguintes) % n.
+    stride = 1;
+    for (i = grid->n_axes - 1; i >= 0; i--) {
+        if (strcmp(grid->axes[i].name, name) == 0) {
+            if (grid->axes[i].n == 1) return grid->axes[i].min;
+            index = (slice / stride) % grid->axes[i].n;
+            return grid->axes[i].min + (grid->axes[i].max - grid->axes[i].min) * (double) index / (grid->axes[i].n - 1);
+        }
+        stride *= grid->axes[i].n;
+    }
+    return fallback;
+}
+// ....................................................................................................................
@@ -0,0 +1,49 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Sweeps em várias dimensões (opção --grid), compartilhado pelos dois programas.
+//
+//  O parâmetro de impacto continua definido pelos argumentos posicionais (e pelo --tests). Cada '--grid nome=min:max:n'
+//  troca o valor do argumento posicional 'nome' por n valores igualmente espaçados entre min e max, e o sweep cobre o
+//  produto cartesiano de todos os intervalos dentro do mesmo processo. Cada combinação dos parâmetros que não são o b é
+//  uma "fatia" do grid: as quantidades que dependem apenas dela (velocidade inicial, estado inicial de Marte, ...) são
+//  calculadas uma única vez por fatia, e os testes de uma fatia são os n_b valores de b seguidos.
+//
+//  As fatias são numeradas com o primeiro eixo passado variando mais devagar (como índices de uma matriz em C).
+// ....................................................................................................................
+#ifndef FLY_BY_GRID_H
+#define FLY_BY_GRID_H
+// ....................................................................................................................
+#define GRID_MAX_EIXOS 4                                //  Número máximo de parâmetros variados com --grid.
+#define GRID_TAMANHO_NOME 32                            //  Tamanho máximo do nome de um parâmetro.
+// ....................................................................................................................
+//  - Intervalo de um parâmetro.
+typedef struct {
+    char name[GRID_TAMANHO_NOME];                       //  Nome do argumento posicional.
+    double min;                                         //  Primeiro valor.
+    double max;                                         //  Último valor.
+    int n;                                              //  Número de valores (1 para um valor fixo).
+} grid_axis;
+
+//  - Grid de uma execução.
+typedef struct {
+    int n_axes;                                         //  Número de parâmetros variados.
+    grid_axis axes[GRID_MAX_EIXOS];                     //  Intervalo de cada parâmetro, na ordem da linha de comando.
+} grid_spec;
+// ....................................................................................................................
+//  - Adiciona um intervalo no formato 'nome=min:max:n' (ou 'nome=valor'). Retorna 0 em caso de sucesso, -1 se o texto
+//  não estiver no formato esperado, e -2 se o parâmetro já estiver no grid ou se o número de eixos passar do máximo.
+int grid_add(grid_spec* grid, const char* spec);
+
+//  - Retorna o nome do primeiro eixo que não está na lista 'names' (ou NULL se todos estiverem).
+const char* grid_check(const grid_spec* grid, const char* const* names, int n_names);
+
+//  - Número de fatias (o produto dos números de valores de todos os eixos; 1 sem --grid).
+long grid_slices(const grid_spec* grid);
+
+//  - Valor do parâmetro 'name' na fatia 'slice'. Retorna 'fallback' (o valor posicional) se ele não estiver no grid.
+double grid_value(const grid_spec* grid, const char* name, long slice, double fallback);
+// ....................................................................................................................
+#endif
@@ -0,0 +1,347 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Comentários para desabilitar algumas funções de análise do CLion:
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ....................................................................................................................
+//      Bibliotecas:
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#include "integrators.h"
+// ....................................................................................................................
+int integrator_parse(const char* name) {
+    if (strcmp(name, "euler") == 0) return INTEGRADOR_EULER;
+    if (strcmp(name, "leapfrog") == 0 || strcmp(name, "verlet") == 0) return INTEGRADOR_LEAPFROG;
+    if (strcmp(name, "rk4") == 0) return INTEGRADOR_RK4;
+    if (strcmp(name, "yoshida") == 0 || strcmp(name, "forest-ruth") == 0) return INTEGRADOR_YOSHIDA;
+    if (strcmp(name, "dopri5") == 0 || strcmp(name, "dp45") == 0) return INTEGRADOR_DOPRI5;
+    return -1;
+}
+// ....................................................................................................................
+const char* integrator_name(const int method) {
+    switch (method) {
+        case INTEGRADOR_EULER: return "Euler explícito (1ª ordem)";
+        case INTEGRADOR_LEAPFROG: return "Leapfrog / velocity-Verlet (2ª ordem, simplético)";
+        case INTEGRADOR_RK4: return "Runge-Kutta clássico (4ª ordem)";
+        case INTEGRADOR_YOSHIDA: return "Yoshida / Forest-Ruth (4ª ordem, simplético)";
+        case INTEGRADOR_DOPRI5: return "Dormand-Prince 5(4) (passo adaptativo)";
+        default: return "desconhecido";
+    }
+}
+// ....................................................................................................................
+int integrator_evaluations(const int method) {
+    switch (method) {
+        case INTEGRADOR_RK4: return 4;
+        case INTEGRADOR_YOSHIDA: return 3;
+        case INTEGRADOR_DOPRI5: return 6;
+        default: return 1;
+    }
+}
+// ....................................................................................................................
+//      Leapfrog (kick-drift-kick):
+//      v(t + h/2) = v(t) + a(t) h/2
+//      x(t + h)   = x(t) + v(t + h/2) h
+//      v(t + h)   = v(t + h/2) + a(t + h) h/2
+void leapfrog_step(const int n, const double t, double* x, double* v, double* a, const double h, const accel_fn accel, void* context) {
+    int i;
+
+    for (i = 0; i < n; i++) {
+        v[i] += a[i] * 0.5 * h;
+        x[i] += v[i] * h;
+    }
+
+    accel(t + h, x, v, a, context);
+    for (i = 0; i < n; i++) v[i] += a[i] * 0.5 * h;
+}
+// ....................................................................................................................
+//      Runge-Kutta clássico aplicado ao sistema de primeira ordem (x' = v, v' = a).
+void rk4_step(const int n, const double t, double* x, double* v, const double h, const accel_fn accel, void* context) {
+    double kx[4][INTEGRATOR_MAX_DIMS];                  //  Derivadas da posição em cada estágio.
+    double kv[4][INTEGRATOR_MAX_DIMS];                  //  Derivadas da velocidade em cada estágio.
+    double xs[INTEGRATOR_MAX_DIMS];                     //  Posição do estágio.
+    double vs[INTEGRATOR_MAX_DIMS];                     //  Velocidade do estágio.
+    int i;
+
+    //  1º estágio.
+    for (i = 0; i < n; i++) kx[0][i] = v[i];
+    accel(t, x, v, kv[0], context);
+
+    //  2º estágio.
+    for (i = 0; i < n; i++) {
+        xs[i] = x[i] + 0.5 * h * kx[0][i];
+        vs[i] = v[i] + 0.5 * h * kv[0][i];
+        kx[1][i] = vs[i];
+    }
+    accel(t + 0.5 * h, xs, vs, kv[1], context);
+
+    //  3º estágio.
+    for (i = 0; i < n; i++) {
+        xs[i] = x[i] + 0.5 * h * kx[1][i];
+        vs[i] = v[i] + 0.5 * h * kv[1][i];
+        kx[2][i] = vs[i];
+    }
+    accel(t + 0.5 * h, xs, vs, kv[2], context);
+
+    //  4º estágio.
+    for (i = 0; i < n; i++) {
+        xs[i] = x[i] + h * kx[2][i];
+        vs[i] = v[i] + h * kv[2][i];
+        kx[3][i] = vs[i];
+    }
+    accel(t + h, xs, vs, kv[3], context);
+
+    //  Combinação final.
+    for (i = 0; i < n; i++) {
+        x[i] += h / 6.0 * (kx[0][i] + 2 * kx[1][i] + 2 * kx[2][i] + kx[3][i]);
+        v[i] += h / 6.0 * (kv[0][i] + 2 * kv[1][i] + 2 * kv[2][i] + kv[3][i]);
+    }
+}
+// ....................................................................................................................
+//      Yoshida / Forest-Ruth de 4ª ordem: c1 = c4 = w1/2, c2 = c3 = (w0 + w1)/2 (drifts); d1 = d3 = w1, d2 = w0 (kicks).
+void yoshida_step(const int n, const double t, double* x, double* v, const double h, const accel_fn accel, void* context) {
+    static const double c[4] = {0.5 * YOSHIDA_W1, 0.5 * (YOSHIDA_W0 + YOSHIDA_W1), 0.5 * (YOSHIDA_W0 + YOSHIDA_W1), 0.5 * YOSHIDA_W1};
+    static const double d[3] = {YOSHIDA_W1, YOSHIDA_W0, YOSHIDA_W1};
+    double a[INTEGRATOR_MAX_DIMS];
+    double tau;                                         //  Fração do passo já percorrida pelos drifts.
+    int i;
+    int k;
+
+    tau = 0.0;
+    for (k = 0; k < 3; k++) {
+        for (i = 0; i < n; i++) x[i] += c[k] * h * v[i];
+        tau += c[k];
+
+        accel(t + tau * h, x, v, a, context);
+        for (i = 0; i < n; i++) v[i] += d[k] * h * a[i];
+    }
+    for (i = 0; i < n; i++) x[i] += c[3] * h * v[i];
+}
+// ....................................................................................................................
+//      Dormand-Prince 5(4).
+//  Coeficientes da tabela de Butcher (a), pesos da solução de 5ª ordem (b = última linha de a), diferença entre as
+//  soluções de 5ª e 4ª ordem (e) e coeficientes da saída densa (d), conforme Hairer, Nørsett & Wanner (DOPRI5).
+static const double dp_c[7] = {0.0, 1.0 / 5.0, 3.0 / 10.0, 4.0 / 5.0, 8.0 / 9.0, 1.0, 1.0};
+static const double dp_a[7][6] = {
+    {0.0},
+    {1.0 / 5.0},
+    {3.0 / 40.0, 9.0 / 40.0},
+    {44.0 / 45.0, -56.0 / 15.0, 32.0 / 9.0},
+    {19372.0 / 6561.0, -25360.0 / 2187.0, 64448.0 / 6561.0, -212.0 / 729.0},
+    {9017.0 / 3168.0, -355.0 / 33.0, 46732.0 / 5247.0, 49.0 / 176.0, -5103.0 / 18656.0},
+    {35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0, 11.0 / 84.0}
+};
+static const double dp_e[7] = {71.0 / 57600.0, 0.0, -71.0 / 16695.0, 71.0 / 1920.0, -17253.0 / 339200.0, 22.0 / 525.0, -1.0 / 40.0};
+static const double dp_d[7] = {-12715105075.0 / 11282082432.0, 0.0, 87487479700.0 / 32700410799.0, -10690763975.0 / 1880347072.0,
+    701980252875.0 / 199316789632.0, -1453857185.0 / 822651844.0, 69997945.0 / 29380423.0};
+// ....................................................................................................................
+void dopri5_init(dopri5_workspace* w, const int n) {
+    w->n = n;
+    w->t = 0.0;
+    w->h = 0.0;
+    w->fsal = 0;
+}
+// ....................................................................................................................
+double dopri5_step(dopri5_workspace* w, const double t, const double* x, const double* v, const double h, const accel_fn accel,
+    void* context, const double rtol, const double atol, double* x_new, double* v_new) {
+    double xs[INTEGRATOR_MAX_DIMS];                     //  Posição do estágio.
+    double vs[INTEGRATOR_MAX_DIMS];                     //  Velocidade do estágio.
+    double sum_x;
+    double sum_v;
+    double err_x;
+    double err_v;
+    double scale;
+    double err;
+    const int n = w->n;
+    int i;
+    int j;
+    int s;
+
+    w->t = t;
+    w->h = h;
+    for (i = 0; i < n; i++) {
+        w->x0[i] = x[i];
+        w->v0[i] = v[i];
+    }
+
+    //  1º estágio (reaproveitado do passo anterior quando possível).
+    if (!w->fsal) {
+        for (i = 0; i < n; i++) w->kx[0][i] = v[i];
+        accel(t, x, v, w->kv[0], context);
+    }
+
+    //  Estágios 2 a 7. O 7º estágio é avaliado na própria solução de 5ª ordem.
+    for (s = 1; s < 7; s++) {
+        for (i = 0; i < n; i++) {
+            sum_x = 0.0;
+            sum_v = 0.0;
+            for (j = 0; j < s; j++) {
+                sum_x += dp_a[s][j] * w->kx[j][i];
+                sum_v += dp_a[s][j] * w->kv[j][i];
+            }
+            xs[i] = x[i] + h * sum_x;
+            vs[i] = v[i] + h * sum_v;
+            w->kx[s][i] = vs[i];
+        }
+        accel(t + dp_c[s] * h, xs, vs, w->kv[s], context);
+    }
+
+    //  Solução de 5ª ordem (xs, vs do último estágio) e estimativa do erro.
+    err = 0.0;
+    for (i = 0; i < n; i++) {
+        x_new[i] = w->x1[i] = xs[i];
+        v_new[i] = w->v1[i] = vs[i];
+
+        err_x = 0.0;
+        err_v = 0.0;
+        for (j = 0; j < 7; j++) {
+            err_x += dp_e[j] * w->kx[j][i];
+            err_v += dp_e[j] * w->kv[j][i];
+        }
+        err_x *= h;
+        err_v *= h;
+
+        scale = atol + rtol * fmax(fabs(x[i]), fabs(xs[i]));
+        err += (err_x / scale) * (err_x / scale);
+        scale = atol + rtol * fmax(fabs(v[i]), fabs(vs[i]));
+        err += (err_v / scale) * (err_v / scale);
+    }
+
+    return sqrt(err / (2 * n));
+}
+// ....................................................................................................................
+//      y(t + θh) = y0 + θ (Δy + (1 - θ) (h k1 - Δy + θ (Δy - h k7 - (h k1 - Δy) + (1 - θ) h Σ d_i k_i)))
+void dopri5_dense(const dopri5_workspace* w, const double theta, double* x, double* v) {
+    const double h = w->h;
+    const double theta1 = 1.0 - theta;
+    double diff;
+    double bspl;
+    double dense;
+    int i;
+    int j;
+
+    for (i = 0; i < w->n; i++) {
+        //  Posição.
+        diff = w->x1[i] - w->x0[i];
+        bspl = h * w->kx[0][i] - diff;
+        dense = 0.0;
+        for (j = 0; j < 7; j++) dense += dp_d[j] * w->kx[j][i];
+        x[i] = w->x0[i] + theta * (diff + theta1 * (bspl + theta * (diff - h * w->kx[6][i] - bspl + theta1 * h * dense)));
+
+        //  Velocidade.
+        diff = w->v1[i] - w->v0[i];
+        bspl = h * w->kv[0][i] - diff;
+        dense = 0.0;
+        for (j = 0; j < 7; j++) dense += dp_d[j] * w->kv[j][i];
+        v[i] = w->v0[i] + theta * (diff + theta1 * (bspl + theta * (diff - h * w->kv[6][i] - bspl + theta1 * h * dense)));
+    }
+}
+// ....................................................................................................................
+//      Localização de eventos. A interpolação dentro do passo (saída densa do dopri5 ou Hermite) é barata e um evento
+//  termina a trajetória, então o intervalo é dividido por bisseção até a resolução do double, sem depender da
+//  derivada do evento.
+typedef void (*interpolant_fn)(const void* data, double theta, double* x, double* v);
+
+static double bisect_event(const int n, const interpolant_fn interpolant, const void* data, double lo, double hi, const event_fn event, void* context,
+    double* x, double* v) {
+    double mid;
+    int positive;                                       //  Sinal do evento em 'hi'.
+
+    interpolant(data, hi, x, v);
+    positive = event(n, x, v, context) > 0.0;
+    while (hi - lo > DBL_EPSILON) {
+        mid = 0.5 * (lo + hi);
+        if (mid <= lo || mid >= hi) break;
+        interpolant(data, mid, x, v);
+        if ((event(n, x, v, context) > 0.0) == positive) hi = mid;
+        else lo = mid;
+    }
+
+    interpolant(data, hi, x, v);
+    return hi;
+}
+
+static void dense_interpolant(const void* data, const double theta, double* x, double* v) {
+    dopri5_dense(data, theta, x, v);
+}
+
+static void hermite_interpolant(const void* data, const double theta, double* x, double* v) {
+    hermite_interpolate(data, theta, x, v);
+}
+// ....................................................................................................................
+double dopri5_event(const dopri5_workspace* w, const double lo, const double hi, const event_fn event, void* context, double* x, double* v) {
+    return bisect_event(w->n, dense_interpolant, w, lo, hi, event, context, x, v);
+}
+// ....................................................................................................................
+//      Polinômio de Hermite de 5º grau em theta, com a posição, a velocidade e a aceleração nas duas pontas:
+//      x(θ) = H0 x0 + H1 h v0 + H2 h² a0 + H3 h² a1 + H4 h v1 + H5 x1, com
+//      H0 = 1 - 10θ³ + 15θ⁴ - 6θ⁵,     H1 = θ - 6θ³ + 8θ⁴ - 3θ⁵,       H2 = (θ² - 3θ³ + 3θ⁴ - θ⁵) / 2,
+//      H3 = (θ³ - 2θ⁴ + θ⁵) / 2,       H4 = -4θ³ + 7θ⁴ - 3θ⁵,          H5 = 10θ³ - 15θ⁴ + 6θ⁵.
+//  A velocidade é a derivada (dividida por h). Com apenas as posições e velocidades (o Hermite cúbico), a velocidade
+//  interpolada tem erro O(h³), o que com passos de um minuto já muda o delta_v de uma colisão em décimos de m/s.
+void hermite_interpolate(const hermite_step* step, const double theta, double* x, double* v) {
+    const double h = step->h;
+    const double t2 = theta * theta;
+    const double t3 = t2 * theta;
+    const double t4 = t3 * theta;
+    const double t5 = t4 * theta;
+    int i;
+
+    for (i = 0; i < step->n; i++) {
+        x[i] = (1 - 10 * t3 + 15 * t4 - 6 * t5) * step->x0[i] + (theta - 6 * t3 + 8 * t4 - 3 * t5) * h * step->v0[i] +
+            0.5 * (t2 - 3 * t3 + 3 * t4 - t5) * h * h * step->a0[i] + 0.5 * (t3 - 2 * t4 + t5) * h * h * step->a1[i] +
+            (- 4 * t3 + 7 * t4 - 3 * t5) * h * step->v1[i] + (10 * t3 - 15 * t4 + 6 * t5) * step->x1[i];
+        v[i] = (30 * t2 - 60 * t3 + 30 * t4) * (step->x1[i] - step->x0[i]) / h + (1 - 18 * t2 + 32 * t3 - 15 * t4) * step->v0[i] +
+            (theta - 4.5 * t2 + 6 * t3 - 2.5 * t4) * h * step->a0[i] + (1.5 * t2 - 4 * t3 + 2.5 * t4) * h * step->a1[i] +
+            (- 12 * t2 + 28 * t3 - 15 * t4) * step->v1[i];
+    }
+}
+// ....................................................................................................................
+double hermite_event(const hermite_step* step, const double lo, const double hi, const event_fn event, void* context, double* x, double* v) {
+    return bisect_event(step->n, hermite_interpolant, step, lo, hi, event, context, x, v);
+}
+// ....................................................................................................................
+double event_radius(const int n, const double* x, const double* v, void* context) {
+    double sum;
+    int i;
+
+    (void) v;
+    sum = 0.0;
+    for (i = 0; i < n; i++) sum += x[i] * x[i];
+    return sqrt(sum) - *(const double*) context;
+}
+// ....................................................................................................................
+double event_radial(const int n, const double* x, const double* v, void* context) {
+    double sum;
+    int i;
+
+    (void) context;
+    sum = 0.0;
+    for (i = 0; i < n; i++) sum += x[i] * v[i];
+    return sum;
+}
+// ....................................................................................................................
+void dopri5_accept(dopri5_workspace* w) {
+    int i;
+
+    for (i = 0; i < w->n; i++) {
+        w->kx[0][i] = w->kx[6][i];
+        w->kv[0][i] = w->kv[6][i];
+    }
+    w->fsal = 1;
+}
+// ....................................................................................................................
+double dopri5_next_step(const double h, const double err, const int after_reject) {
+    double factor;
+
+    factor = err > 0.0 ? 0.9 * pow(err, -0.2) : 5.0;
+    if (factor > 5.0) factor = 5.0;
+    if (factor < 0.2) factor = 0.2;
+    if (after_reject && factor > 1.0) factor = 1.0;
+
+    return h * factor;
+}
+// ....................................................................................................................
@@ -0,0 +1,122 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Integradores numéricos de ordem alta, compartilhados pelos dois programas.
+//
+//  Todos trabalham com um sistema de segunda ordem x'' = a(t, x, x'), separado em posição 'x' e velocidade 'v' (os
+//  vetores aqui começam no índice 0, então nos programas passamos &r[1], &v[1]). O método de Euler continua escrito
+//  diretamente dentro de cada simulate(), para manter os resultados originais do trabalho.
+// ....................................................................................................................
+#ifndef FLY_BY_INTEGRATORS_H
+#define FLY_BY_INTEGRATORS_H
+// ....................................................................................................................
+//      Métodos disponíveis (opção --integrator).
+#define INTEGRADOR_EULER 0                              //  Euler explícito (1ª ordem). É o método original do trabalho.
+#define INTEGRADOR_LEAPFROG 1                           //  Leapfrog / velocity-Verlet (2ª ordem, simplético).
+#define INTEGRADOR_RK4 2                                //  Runge-Kutta clássico (4ª ordem).
+#define INTEGRADOR_YOSHIDA 3                            //  Yoshida / Forest-Ruth (4ª ordem, simplético).
+#define INTEGRADOR_DOPRI5 4                             //  Dormand-Prince 5(4) com passo adaptativo e saída densa.
+
+#define INTEGRATOR_MAX_DIMS 16                          //  Tamanho máximo de 'x' aceito pelos integradores.
+
+//      Coeficientes do método de Yoshida de 4ª ordem (composição de três passos de leapfrog).
+#define YOSHIDA_W1 1.3512071919596578                   //  1 / (2 - 2^(1/3))
+#define YOSHIDA_W0 (-1.7024143839193153)                //  -2^(1/3) / (2 - 2^(1/3))
+// ....................................................................................................................
+//  - Aceleração do sistema. Deve preencher a[0..n-1] a partir do tempo, da posição e da velocidade.
+//  Os métodos simpléticos (leapfrog e Yoshida) só fazem sentido quando 'a' não depende de 'v'.
+typedef void (*accel_fn)(double t, const double* x, const double* v, double* a, void* context);
+
+//  - Função de evento (localização de eventos dentro de um passo, veja hermite_event e dopri5_event). O evento acontece
+//  onde ela troca de sinal.
+typedef double (*event_fn)(int n, const double* x, const double* v, void* context);
+
+//  - Converte o nome passado em --integrator para o identificador. Retorna -1 caso o nome seja desconhecido.
+int integrator_parse(const char* name);
+
+//  - Nome legível de um método (usado nos registros impressos pelos programas).
+const char* integrator_name(int method);
+
+//  - Número de avaliações da aceleração por passo de cada método (usado nas estimativas de custo).
+int integrator_evaluations(int method);
+
+//  - Passo de leapfrog no formato kick-drift-kick. 'a' deve chegar com a aceleração em (t, x) e sai com a aceleração
+//  no fim do passo, então cada passo custa apenas uma avaliação.
+void leapfrog_step(int n, double t, double* x, double* v, double* a, double h, accel_fn accel, void* context);
+
+//  - Passo de Runge-Kutta clássico de 4ª ordem.
+void rk4_step(int n, double t, double* x, double* v, double h, accel_fn accel, void* context);
+
+//  - Passo de Yoshida / Forest-Ruth de 4ª ordem (drift-kick-drift, três avaliações por passo).
+void yoshida_step(int n, double t, double* x, double* v, double h, accel_fn accel, void* context);
+
+//  - Passo dos métodos de passo fixo, que não têm saída densa: os estados e as acelerações nas duas pontas, para a
+//  interpolação de Hermite de 5º grau dentro dele (hermite_interpolate). Os vetores são apenas referenciados.
+typedef struct {
+    int n;                                              //  Dimensão de 'x' (e de 'v').
+    double h;                                           //  Tamanho do passo.
+    const double* x0;                                   //  Estado e aceleração no começo do passo.
+    const double* v0;
+    const double* a0;
+    const double* x1;                                   //  Estado e aceleração no fim do passo.
+    const double* v1;
+    const double* a1;
+} hermite_step;
+
+//  - Interpolação de Hermite de 5º grau dentro do passo: theta = (t_saida - t) / h, em [0, 1]. Os vetores de saída não
+//  podem ser os mesmos das pontas.
+void hermite_interpolate(const hermite_step* step, double theta, double* x, double* v);
+
+//  - Localiza um evento dentro do passo, por bisseção na interpolação de Hermite: 'event' deve ter sinais opostos em
+//  theta = lo e theta = hi. Preenche x/v com o estado no evento (do lado de 'hi', onde o evento já aconteceu) e devolve
+//  o theta correspondente.
+double hermite_event(const hermite_step* step, double lo, double hi, event_fn event, void* context, double* x, double* v);
+
+//  - Eventos prontos: a distância à origem passando por *(const double*) context (event_radius), e o periapsis ou o
+//  apoapsis, onde x·v troca de sinal (event_radial).
+double event_radius(int n, const double* x, const double* v, void* context);
+double event_radial(int n, const double* x, const double* v, void* context);
+// ....................................................................................................................
+//      Dormand-Prince 5(4) com passo adaptativo.
+//
+//  O uso é: dopri5_init uma vez por trajetória; a cada tentativa dopri5_step devolve o erro normalizado (aceita se
+//  for <= 1) e o estado proposto; ao aceitar, os pontos intermediários podem ser obtidos com dopri5_dense (antes de
+//  chamar dopri5_accept) e o próximo passo vem de dopri5_next_step. O último estágio de um passo aceito é reaproveitado
+//  como primeiro estágio do passo seguinte (FSAL), então cada passo aceito custa seis avaliações.
+typedef struct {
+    int n;                                              //  Dimensão de 'x' (e de 'v').
+    double t;                                           //  Tempo no começo da última tentativa.
+    double h;                                           //  Tamanho da última tentativa.
+    double x0[INTEGRATOR_MAX_DIMS];                     //  Estado no começo da última tentativa.
+    double v0[INTEGRATOR_MAX_DIMS];
+    double x1[INTEGRATOR_MAX_DIMS];                     //  Estado proposto (5ª ordem) no fim da última tentativa.
+    double v1[INTEGRATOR_MAX_DIMS];
+    double kx[7][INTEGRATOR_MAX_DIMS];                  //  Derivadas da posição em cada estágio.
+    double kv[7][INTEGRATOR_MAX_DIMS];                  //  Derivadas da velocidade em cada estágio.
+    int fsal;                                           //  1 se kx[0]/kv[0] já valem para o estado atual.
+} dopri5_workspace;
+
+//  - Prepara o workspace para uma nova trajetória.
+void dopri5_init(dopri5_workspace* w, int n);
+
+//  - Tenta um passo de tamanho h a partir de (t, x, v). Preenche x_new/v_new com a solução de 5ª ordem e devolve a
+//  norma RMS do erro local, escalada por atol + rtol * max(|y|, |y_new|).
+double dopri5_step(dopri5_workspace* w, double t, const double* x, const double* v, double h, accel_fn accel, void* context,
+    double rtol, double atol, double* x_new, double* v_new);
+
+//  - Saída densa (interpolação de 4ª ordem) dentro da última tentativa: theta = (t_saida - t) / h, em [0, 1].
+void dopri5_dense(const dopri5_workspace* w, double theta, double* x, double* v);
+
+//  - Localiza um evento dentro da última tentativa, como o hermite_event, mas na saída densa. Como o dopri5_dense, deve
+//  ser chamada antes do dopri5_accept.
+double dopri5_event(const dopri5_workspace* w, double lo, double hi, event_fn event, void* context, double* x, double* v);
+
+//  - Marca a última tentativa como aceita (ativa o FSAL).
+void dopri5_accept(dopri5_workspace* w);
+
+//  - Controlador do passo: h * 0.9 * err^(-1/5), limitado entre 0.2h e 5h (e sem crescer logo após uma rejeição).
+double dopri5_next_step(double h, double err, int after_reject);
+// ....................................................................................................................
+#endif
@@ -0,0 +1,194 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Comentários para desabilitar algumas funções de análise do CLion:
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ....................................................................................................................
+//      Bibliotecas:
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "journal.h"
+// ....................................................................................................................
+#define JOURNAL_CAUDA 512                               //  Bytes lidos do fim de um arquivo de trajetória.
+// ....................................................................................................................
+//      Monta a configuração: um argumento por linha, sem as opções neutras (e os seus valores) e sem a --resume.
+static char* build_config(const int argc, const char* argv[], const char* const* neutral, const int n_neutral) {
+    char* config;
+    size_t size;
+    int skip;
+    int i;
+    int j;
+
+    size = 1;
+    for (i = 1; i < argc; i++) size += strlen(argv[i]) + 1;
+    config = malloc(size);
+    if (config == NULL) return NULL;
+
+    config[0] = '\0';
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--resume") == 0) continue;
+        skip = 0;
+        for (j = 0; j < n_neutral; j++) if (strcmp(argv[i], neutral[j]) == 0) skip = 1;
+        if (skip) {
+            i++;
+            continue;
+        }
+        strcat(config, argv[i]);
+        strcat(config, "\n");
+    }
+
+    return config;
+}
+// ....................................................................................................................
+int journal_config(const char* path, const int argc, const char* argv[], const char* const* neutral, const int n_neutral, const int resume) {
+    char* config;
+    char* saved;
+    FILE* fo;
+    long size;
+    int status;
+
+    config = build_config(argc, argv, neutral, n_neutral);
+    if (config == NULL) return -2;
+
+    //      Execução nova: só salva.
+    if (!resume) {
+        fo = fopen(path, "w");
+        status = fo != NULL && fputs(config, fo) >= 0 ? 0 : -2;
+        if (fo != NULL && fclose(fo) != 0) status = -2;
+        free(config);
+        return status;
+    }
+    // ................................................................................................................
+    //      Retomada: compara com a configuração salva.
+    fo = fopen(path, "r");
+    if (fo == NULL) {
+        free(config);
+        return -2;
+    }
+    fseek(fo, 0, SEEK_END);
+    size = ftell(fo);
+    fseek(fo, 0, SEEK_SET);
+
+    saved = malloc((size_t) (size > 0 ? size : 0) + 1);
+    status = -2;
+    if (saved != NULL && size >= 0 && fread(saved, 1, (size_t) size, fo) == (size_t) size) {
+        saved[size] = '\0';
+        status = strcmp(saved, config) == 0 ? 0 : -1;
+    }
+    fclose(fo);
+    free(saved);
+    free(config);
+
+    return status;
+}
+// ....................................................................................................................
+long journal_resume(const char* path, const int n_tests, const journal_check_fn check, void* context, unsigned char* done) {
+    char temporary[300];
+    char* line;
+    char* field;
+    size_t capacity;
+    ssize_t length;
+    FILE* fi;
+    FILE* fo;
+    double time_end;
+    long n_done;
+    long test;
+    int t_column;
+    int column;
+
+    fi = fopen(path, "r");
+    if (fi == NULL) return errno == ENOENT ? 0 : -1;
+
+    snprintf(temporary, sizeof(temporary), "%s.tmp", path);
+    fo = fopen(temporary, "w");
+    if (fo == NULL) {
+        fclose(fi);
+        return -1;
+    }
+
+    line = NULL;
+    capacity = 0;
+    n_done = 0;
+    // ................................................................................................................
+    //      Cabeçalho: procura a coluna do tempo final. Um cabeçalho incompleto deixa o arquivo vazio (o programa escreve
+    //  um cabeçalho novo).
+    length = getline(&line, &capacity, fi);
+    if (length > 0 && line[length - 1] == '\n') {
+        fputs(line, fo);
+
+        t_column = -1;
+        column = 0;
+        for (field = strtok(line, ",\n"); field != NULL; field = strtok(NULL, ",\n"), column++) {
+            if (strcmp(field, "t") == 0) t_column = column;
+        }
+        // ............................................................................................................
+        //      Linhas dos testes. A última pode ter sido cortada no meio pela interrupção.
+        while ((length = getline(&line, &capacity, fi)) > 0) {
+            if (line[length - 1] != '\n') break;
+
+            test = strtol(line, &field, 10) - 1;
+            if (field == line || *field != ',' || test < 0 || test >= n_tests || journal_done(done, (int) test)) continue;
+
+            time_end = NAN;
+            if (t_column > 0) {
+                //  'field' está na vírgula antes da coluna 1; avança até a vírgula antes da coluna do tempo.
+                for (column = 1; column < t_column && field != NULL; column++) field = strchr(field + 1, ',');
+                if (field == NULL) continue;
+                time_end = strtod(field + 1, NULL);
+            }
+            if (check != NULL && !check((int) test, time_end, context)) continue;
+
+            fputs(line, fo);
+            done[test / 8] |= (unsigned char) (1 << (test % 8));
+            n_done++;
+        }
+    }
+    free(line);
+    fclose(fi);
+    // ................................................................................................................
+    //      Troca o arquivo antigo pelo filtrado.
+    if (fclose(fo) != 0 || rename(temporary, path) != 0) return -1;
+
+    return n_done;
+}
+// ....................................................................................................................
+int journal_done(const unsigned char* done, const int test) {
+    return done != NULL && (done[test / 8] >> (test % 8) & 1);
+}
+// ....................................................................................................................
+int journal_csv_complete(const char* path, const double time_end) {
+    char tail[JOURNAL_CAUDA + 1];
+    char expected[64];
+    const char* last;
+    FILE* fi;
+    long size;
+    size_t n;
+
+    fi = fopen(path, "r");
+    if (fi == NULL) return 0;
+
+    fseek(fi, 0, SEEK_END);
+    size = ftell(fi);
+    if (size > JOURNAL_CAUDA) fseek(fi, size - JOURNAL_CAUDA, SEEK_SET);
+    else fseek(fi, 0, SEEK_SET);
+    n = fread(tail, 1, JOURNAL_CAUDA, fi);
+    fclose(fi);
+    tail[n] = '\0';
+
+    //      O arquivo precisa terminar com uma linha completa, e o tempo dessa linha (sempre com 8 casas, veja output.c)
+    //  precisa ser o tempo final do teste.
+    if (n < 2 || tail[n - 1] != '\n') return 0;
+    tail[n - 1] = '\0';
+    last = strrchr(tail, '\n');
+    last = last != NULL ? last + 1 : tail;
+
+    snprintf(expected, sizeof(expected), "%.8e,", time_end);
+    return strncmp(last, expected, strlen(expected)) == 0;
+}
+// ....................................................................................................................
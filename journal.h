@@ -0,0 +1,60 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Retomada de execuções interrompidas (opção --resume), compartilhada pelos dois programas.
+//
+//  O próprio arquivo de dados globais é o diário (journal) da execução: cada teste é escrito nele assim que termina, e o
+//  arquivo é descarregado no disco pelo menos uma vez por segundo (e sempre ao fim de uma interrupção por SIGINT ou
+//  SIGTERM). Na retomada, uma linha só vale se estiver completa e se o arquivo de trajetória do teste também estiver
+//  completo; as outras são descartadas e os seus testes são refeitos. Assim, uma queda no meio da escrita (inclusive
+//  com a escrita assíncrona, em que a linha global pode chegar ao disco antes do fim da trajetória) nunca deixa um
+//  arquivo pela metade marcado como concluído.
+//
+//  Para que a retomada continue a mesma execução, a linha de comando é salva num arquivo de configuração, e a retomada
+//  só é aceita se os argumentos que mudam os resultados forem os mesmos.
+// ....................................................................................................................
+#ifndef FLY_BY_JOURNAL_H
+#define FLY_BY_JOURNAL_H
+// ....................................................................................................................
+//  - Verifica se um teste concluído segundo o arquivo global também tem o arquivo de trajetória completo.
+//  int test                                → Índice do teste (começa em 0).
+//  double time_end                         → Tempo final do teste, lido da coluna 't' do arquivo global.
+//  void* context                           → Ponteiro repassado sem alterações pelo journal_resume.
+//
+//  * Retorna 1 se o teste pode ser mantido.
+typedef int (*journal_check_fn)(int test, double time_end, void* context);
+
+//  - Salva (ou, na retomada, confere) a configuração da execução.
+//  const char* path                        → Arquivo de configuração.
+//  int argc, const char* argv[]            → Linha de comando.
+//  const char* const* neutral              → Opções (com valor) que não mudam os resultados, e por isso podem mudar
+//                                            na retomada (--threads, --writers, ...). A própria --resume é ignorada.
+//  int n_neutral                           → Número de opções em 'neutral'.
+//  int resume                              → 1 para conferir a configuração salva, 0 para salvar.
+//
+//  * Retorna 0 em caso de sucesso, -1 se a configuração salva for diferente, e -2 se o arquivo não puder ser lido (na
+//  retomada) ou escrito.
+int journal_config(const char* path, int argc, const char* argv[], const char* const* neutral, int n_neutral, int resume);
+
+//  - Lê o arquivo global de uma execução interrompida, marca os testes concluídos e reescreve o arquivo só com as
+//  linhas válidas (completas, de um teste existente, sem repetição e aprovadas por 'check').
+//  const char* path                        → Arquivo de dados globais.
+//  int n_tests                             → Número de testes da execução.
+//  journal_check_fn check                  → Verificação do arquivo de trajetória (pode ser NULL).
+//  void* context                           → Ponteiro repassado para 'check'.
+//  unsigned char* done                     → Recebe um bit para cada teste concluído ((n_tests + 7) / 8 bytes, zerados
+//                                            antes; veja journal_done).
+//
+//  * Retorna o número de testes concluídos (0 se o arquivo não existir), ou -1 em caso de erro.
+long journal_resume(const char* path, int n_tests, journal_check_fn check, void* context, unsigned char* done);
+
+//  - Retorna 1 se o teste está marcado como concluído no vetor de bits do journal_resume (0 se 'done' for NULL).
+int journal_done(const unsigned char* done, int test);
+
+//  - Confere se a última linha de um arquivo de trajetória CSV é o estado final do teste, ou seja, se o seu tempo é o
+//  mesmo da coluna 't' do arquivo global (a última linha é sempre o estado final, veja cadence.h). Retorna 1 nesse caso.
+int journal_csv_complete(const char* path, double time_end);
+// ....................................................................................................................
+#endif
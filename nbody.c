@@ -0,0 +1,369 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Comentários para desabilitar algumas funções de análise do CLion:
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ....................................................................................................................
+//      Bibliotecas:
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "nbody.h"
+// ....................................................................................................................
+#define CONSTANTE_GRAVITACIONAL 6.6743e-11              //  Constante gravitacional de Newton no sistema internacional.
+#define DEG_TO_RAD 0.0174532925                         //  Relação para converter graus para radianos.
+#define NBODY_LINHA 512                                 //  Tamanho máximo de uma linha do arquivo de corpos.
+#define NBODY_TOLERANCIA_INTERVALO (8 * DBL_EPSILON)    //  Diferença relativa (ao tempo) entre dois intervalos iguais.
+// ....................................................................................................................
+//      Funções auxiliares (aqui temos um "mini-header" dentro do arquivo *.c)
+//  - Reserva a próxima posição da tabela para um corpo. Retorna o índice, ou -1.
+static int nbody_add(nbody_table* table, const char* name, double mu, double radius, int kind);
+
+//  - Leva os ângulos guardados dos corpos em órbita circular para o instante t (veja nbody_run).
+static void nbody_angles(nbody_run* run, double t);
+
+//  - Posição de todos os corpos no instante t.
+//  const double* x                         → Estado integrado (posição dos corpos integrados).
+//  double* bx, double* by                  → Recebem as posições.
+static void nbody_positions(nbody_run* run, double t, const double* x, double* bx, double* by);
+
+//  - Aceleração de todos os pontos do estado e, se 'distance' não é NULL, a distância de cada sonda ao corpo de
+//  referência (calculada junto com a força, sem uma raiz a mais).
+static void nbody_forces(nbody_run* run, double t, const double* x, double* a, double* distance);
+// ....................................................................................................................
+void nbody_init(nbody_table* table) {
+    memset(table, 0, sizeof(nbody_table));
+}
+// ....................................................................................................................
+static int nbody_add(nbody_table* table, const char* name, const double mu, const double radius, const int kind) {
+    int body;
+
+    if (table->n >= NBODY_MAX_CORPOS || strlen(name) >= NBODY_NOME || nbody_find(table, name) >= 0) return -1;
+
+    body = table->n++;
+    strcpy(table->name[body], name);
+    table->mu[body] = mu;
+    table->radius[body] = radius;
+    table->kind[body] = kind;
+    table->center[body] = -1;
+    table->slot[body] = -1;
+    return body;
+}
+// ....................................................................................................................
+int nbody_add_fixed(nbody_table* table, const char* name, const double mu, const double radius, const double x, const double y) {
+    const int body = nbody_add(table, name, mu, radius, CORPO_FIXO);
+
+    if (body < 0) return -1;
+    table->x[body] = x;
+    table->y[body] = y;
+    return body;
+}
+// ....................................................................................................................
+int nbody_add_circular(nbody_table* table, const char* name, const double mu, const double radius, const int center, const double orbit_radius,
+    const double phase) {
+    int body;
+
+    //  O centro precisa vir antes na tabela (as posições são calculadas em ordem) e não pode ser integrado, porque a
+    //  órbita prescrita usa a velocidade angular de uma órbita circular em torno de um centro que não acelera.
+    if (center < 0 || center >= table->n || table->kind[center] == CORPO_INTEGRADO || orbit_radius <= 0) return -1;
+    body = nbody_add(table, name, mu, radius, CORPO_CIRCULAR);
+    if (body < 0) return -1;
+
+    table->center[body] = center;
+    table->orbit_radius[body] = orbit_radius;
+    table->omega[body] = sqrt(table->mu[center] / (orbit_radius * orbit_radius * orbit_radius));
+    table->phase[body] = phase;
+    return body;
+}
+// ....................................................................................................................
+int nbody_add_integrated(nbody_table* table, const char* name, const double mu, const double radius, const double x, const double y, const double vx,
+    const double vy) {
+    int body;
+
+    if (table->n_integrated >= NBODY_MAX_PONTOS - 1) return -1;
+    body = nbody_add(table, name, mu, radius, CORPO_INTEGRADO);
+    if (body < 0) return -1;
+
+    table->slot[body] = table->n_integrated;
+    table->integrated[table->n_integrated++] = body;
+    table->x[body] = x;
+    table->y[body] = y;
+    table->vx[body] = vx;
+    table->vy[body] = vy;
+    return body;
+}
+// ....................................................................................................................
+int nbody_find(const nbody_table* table, const char* name) {
+    int body;
+
+    for (body = 0; body < table->n; body++) if (strcmp(table->name[body], name) == 0) return body;
+    return -1;
+}
+// ....................................................................................................................
+int nbody_load(nbody_table* table, const char* path) {
+    char line[NBODY_LINHA];
+    char name[NBODY_LINHA];
+    char kind[NBODY_LINHA];
+    char center[NBODY_LINHA];
+    double mass;
+    double radius;
+    double p[4];
+    char* comment;
+    int number;
+    int fields;
+    int body;
+    int error;
+    FILE* fi;
+
+    fi = fopen(path, "r");
+    if (fi == NULL) return -1;
+
+    error = 0;
+    for (number = 1; fgets(line, sizeof(line), fi) != NULL; number++) {
+        comment = strchr(line, '#');
+        if (comment != NULL) *comment = '\0';
+        fields = sscanf(line, "%511s %511s %lf %lf", name, kind, &mass, &radius);
+        if (fields <= 0) continue;
+        if (fields < 4 || mass < 0 || radius < 0) {
+            error = number;
+            break;
+        }
+
+        body = -1;
+        if (strcmp(kind, "fixed") == 0) {
+            if (sscanf(line, "%*s %*s %*f %*f %lf %lf", &p[0], &p[1]) == 2)
+                body = nbody_add_fixed(table, name, CONSTANTE_GRAVITACIONAL * mass, radius, p[0], p[1]);
+        } else if (strcmp(kind, "circular") == 0) {
+            if (sscanf(line, "%*s %*s %*f %*f %511s %lf %lf", center, &p[0], &p[1]) == 3)
+                body = nbody_add_circular(table, name, CONSTANTE_GRAVITACIONAL * mass, radius, nbody_find(table, center), p[0], p[1] * DEG_TO_RAD);
+        } else if (strcmp(kind, "integrated") == 0) {
+            if (sscanf(line, "%*s %*s %*f %*f %lf %lf %lf %lf", &p[0], &p[1], &p[2], &p[3]) == 4)
+                body = nbody_add_integrated(table, name, CONSTANTE_GRAVITACIONAL * mass, radius, p[0], p[1], p[2], p[3]);
+        }
+        if (body < 0) {
+            error = number;
+            break;
+        }
+    }
+
+    fclose(fi);
+    return error;
+}
+// ....................................................................................................................
+void nbody_run_init(nbody_run* run, const nbody_table* table, const int n_probes, const int reference) {
+    run->table = table;
+    run->n_probes = n_probes;
+    run->reference = reference;
+    run->cached = 0;
+    run->rotations = 0;
+    run->n_intervals = 0;
+    run->cache_time = 0.0;
+}
+// ....................................................................................................................
+int nbody_points(const nbody_run* run) {
+    return run->n_probes + run->table->n_integrated;
+}
+// ....................................................................................................................
+void nbody_start(const nbody_run* run, double* x, double* v) {
+    const nbody_table* table = run->table;
+    int point;
+    int k;
+
+    for (k = 0; k < table->n_integrated; k++) {
+        point = run->n_probes + k;
+        x[2 * point] = table->x[table->integrated[k]];
+        x[2 * point + 1] = table->y[table->integrated[k]];
+        v[2 * point] = table->vx[table->integrated[k]];
+        v[2 * point + 1] = table->vy[table->integrated[k]];
+    }
+}
+// ....................................................................................................................
+//      Os passos fixos repetem poucos intervalos entre avaliações, então a rotação de cada um é calculada na primeira
+//  vez e reaproveitada. Um intervalo é o mesmo se a diferença cabe no arredondamento da soma dos tempos (time += dt);
+//  um intervalo novo com a tabela cheia, ou a ressincronização, calcula os ângulos diretamente.
+static void nbody_angles(nbody_run* run, const double t) {
+    const nbody_table* table = run->table;
+    const double delta = t - run->cache_time;
+    double angle;
+    double c;
+    int k;
+    int j;
+
+    if (run->cached && delta == 0.0) return;
+
+    k = -1;
+    if (run->cached && run->rotations < NBODY_RESSINCRONIZACAO) {
+        for (k = 0; k < run->n_intervals; k++) if (fabs(delta - run->interval[k]) <= NBODY_TOLERANCIA_INTERVALO * (fabs(t) + fabs(delta))) break;
+        if (k == NBODY_INTERVALOS) k = -1;
+        else if (k == run->n_intervals) {
+            run->interval[k] = delta;
+            for (j = 0; j < table->n; j++) {
+                if (table->kind[j] != CORPO_CIRCULAR) continue;
+                run->rotation_cos[k][j] = cos(table->omega[j] * delta);
+                run->rotation_sin[k][j] = sin(table->omega[j] * delta);
+            }
+            run->n_intervals++;
+        }
+    }
+
+    if (k < 0) {
+        for (j = 0; j < table->n; j++) {
+            if (table->kind[j] != CORPO_CIRCULAR) continue;
+            angle = table->phase[j] + table->omega[j] * t;
+            run->cache_cos[j] = cos(angle);
+            run->cache_sin[j] = sin(angle);
+        }
+        run->rotations = 0;
+        run->cached = 1;
+    } else {
+        for (j = 0; j < table->n; j++) {
+            if (table->kind[j] != CORPO_CIRCULAR) continue;
+            c = run->cache_cos[j] * run->rotation_cos[k][j] - run->cache_sin[j] * run->rotation_sin[k][j];
+            run->cache_sin[j] = run->cache_sin[j] * run->rotation_cos[k][j] + run->cache_cos[j] * run->rotation_sin[k][j];
+            run->cache_cos[j] = c;
+        }
+        run->rotations++;
+    }
+    run->cache_time = t;
+}
+// ....................................................................................................................
+static void nbody_positions(nbody_run* run, const double t, const double* x, double* bx, double* by) {
+    const nbody_table* table = run->table;
+    int point;
+    int j;
+
+    nbody_angles(run, t);
+    for (j = 0; j < table->n; j++) {
+        switch (table->kind[j]) {
+            case CORPO_CIRCULAR:
+                bx[j] = bx[table->center[j]] + table->orbit_radius[j] * run->cache_cos[j];
+                by[j] = by[table->center[j]] + table->orbit_radius[j] * run->cache_sin[j];
+                break;
+            case CORPO_INTEGRADO:
+                point = run->n_probes + table->slot[j];
+                bx[j] = x[2 * point];
+                by[j] = x[2 * point + 1];
+                break;
+            default:
+                bx[j] = table->x[j];
+                by[j] = table->y[j];
+                break;
+        }
+    }
+}
+// ....................................................................................................................
+//      O estado é somado ao longo da cadeia de centros: cada órbita circular acrescenta R (cos, sin) à posição e
+//  ω R (-sin, cos) à velocidade, com o cos/sin guardado, até um corpo fixo ou integrado.
+void nbody_body_state(nbody_run* run, const int body, const double t, const double* x, const double* v, double* coord, double* velocity) {
+    const nbody_table* table = run->table;
+    int point;
+    int j;
+
+    if (!run->cached || t != run->cache_time) nbody_angles(run, t);
+
+    coord[0] = 0.0;
+    coord[1] = 0.0;
+    velocity[0] = 0.0;
+    velocity[1] = 0.0;
+    for (j = body; table->kind[j] == CORPO_CIRCULAR; j = table->center[j]) {
+        coord[0] += table->orbit_radius[j] * run->cache_cos[j];
+        coord[1] += table->orbit_radius[j] * run->cache_sin[j];
+        velocity[0] -= table->orbit_radius[j] * table->omega[j] * run->cache_sin[j];
+        velocity[1] += table->orbit_radius[j] * table->omega[j] * run->cache_cos[j];
+    }
+    if (table->kind[j] == CORPO_INTEGRADO) {
+        point = run->n_probes + table->slot[j];
+        coord[0] += x[2 * point];
+        coord[1] += x[2 * point + 1];
+        velocity[0] += v[2 * point];
+        velocity[1] += v[2 * point + 1];
+    } else {
+        coord[0] += table->x[j];
+        coord[1] += table->y[j];
+    }
+}
+// ....................................................................................................................
+//      O laço interno é sobre os corpos, com os dados contíguos. A soma começa em zero e subtrai cada termo na ordem da
+//  tabela, então com o Sol e Marte ela faz as mesmas operações da acceleration_cartesian do pr3c (o Sol na origem dá
+//  dx = x - 0 = x, exatamente).
+static void nbody_forces(nbody_run* run, const double t, const double* x, double* a, double* distance) {
+    const nbody_table* table = run->table;
+    const int n_points = nbody_points(run);
+    double bx[NBODY_MAX_CORPOS];
+    double by[NBODY_MAX_CORPOS];
+    double ax;
+    double ay;
+    double dx;
+    double dy;
+    double div;
+    double root;
+    int self;
+    int i;
+    int j;
+
+    nbody_positions(run, t, x, bx, by);
+
+    for (i = 0; i < n_points; i++) {
+        self = i < run->n_probes ? -1 : table->integrated[i - run->n_probes];
+        ax = 0.0;
+        ay = 0.0;
+        for (j = 0; j < table->n; j++) {
+            if (j == self) continue;
+            dx = x[2 * i] - bx[j];
+            dy = x[2 * i + 1] - by[j];
+            div = dx * dx + dy * dy;
+            root = sqrt(div);
+            if (distance != NULL && j == run->reference && i < run->n_probes) distance[i] = root;
+            div = table->mu[j] / (div * root);
+            ax -= div * dx;
+            ay -= div * dy;
+        }
+        a[2 * i] = ax;
+        a[2 * i + 1] = ay;
+    }
+}
+// ....................................................................................................................
+void nbody_acceleration(const double t, const double* x, const double* v, double* a, void* context) {
+    (void) v;
+    nbody_forces(context, t, x, a, NULL);
+}
+// ....................................................................................................................
+void nbody_euler_step(nbody_run* run, const double t, const double dt, double* x, double* v, double* distance) {
+    const int n = 2 * nbody_points(run);
+    double a[INTEGRATOR_MAX_DIMS];
+    int i;
+
+    nbody_forces(run, t, x, a, distance);
+    for (i = 0; i < n; i++) {
+        x[i] += v[i] * dt;
+        v[i] += a[i] * dt;
+    }
+}
+// ....................................................................................................................
+int nbody_collision(nbody_run* run, const double t, const double* x, const int probe) {
+    const nbody_table* table = run->table;
+    double bx[NBODY_MAX_CORPOS];
+    double by[NBODY_MAX_CORPOS];
+    double dx;
+    double dy;
+    int positions;
+    int j;
+
+    positions = 0;
+    for (j = 0; j < table->n; j++) {
+        if (j == run->reference || table->radius[j] <= 0) continue;
+        if (!positions) {
+            nbody_positions(run, t, x, bx, by);
+            positions = 1;
+        }
+        dx = x[2 * probe] - bx[j];
+        dy = x[2 * probe + 1] - by[j];
+        if (dx * dx + dy * dy < table->radius[j] * table->radius[j]) return j;
+    }
+    return -1;
+}
+// ....................................................................................................................
@@ -0,0 +1,135 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Motor de N corpos: uma tabela de corpos com massa e um conjunto de sondas sem massa.
+//
+//  O pr2c tem apenas Marte e o pr3c tem o Sol e Marte escritos à mão nas equações; incluir Fobos, Deimos ou a
+//  perturbação de Júpiter exigiria mais uma cópia das contas. Aqui os corpos vêm de uma tabela, e cada um deles pode:
+//  - ficar parado (fixed), como o Sol no pr3c ou Marte no pr2c;
+//  - seguir uma órbita circular prescrita em torno de outro corpo da tabela (circular), como Marte no pr3c;
+//  - ser integrado junto com as sondas (integrated), sentindo a atração de todos os outros corpos com massa.
+//
+//  As sondas não atraem nada. O estado integrado (veja nbody_points) tem as sondas primeiro e depois os corpos
+//  integrados, com x e y intercalados (x_0, y_0, x_1, y_1, ...), no formato dos integradores (integrators.h). Os dados
+//  dos corpos ficam em vetores contíguos ("structure of arrays"), e a força sobre cada ponto é um laço curto sobre
+//  eles, sem nenhuma trigonometria (a posição dos corpos em órbita circular avança por rotações, veja nbody_run).
+//
+//  Com a tabela do pr3c (Sol parado e Marte na órbita circular) as contas da aceleração são as mesmas, e na mesma
+//  ordem, da acceleration_cartesian do fly_by_pr3c; com Marte parado na origem, o problema é o do pr2c.
+// ....................................................................................................................
+#ifndef FLY_BY_NBODY_H
+#define FLY_BY_NBODY_H
+// ....................................................................................................................
+#include "integrators.h"
+// ....................................................................................................................
+#define NBODY_MAX_CORPOS 16                             //  Número máximo de corpos com massa numa tabela.
+#define NBODY_MAX_PONTOS (INTEGRATOR_MAX_DIMS / 2)      //  Número máximo de pontos integrados (sondas e corpos integrados).
+#define NBODY_NOME 32                                   //  Tamanho máximo do nome de um corpo (com o '\0').
+#define NBODY_INTERVALOS 4                              //  Intervalos entre avaliações guardados (com a rotação de cada um).
+#define NBODY_RESSINCRONIZACAO 256                      //  Rotações entre dois cálculos dos ângulos com cos/sin.
+
+//      Movimento de um corpo.
+#define CORPO_FIXO 0                                    //  Parado na posição inicial.
+#define CORPO_CIRCULAR 1                                //  Órbita circular prescrita em torno de outro corpo da tabela.
+#define CORPO_INTEGRADO 2                               //  Integrado junto com as sondas.
+// ....................................................................................................................
+//  - Tabela de corpos com massa.
+typedef struct {
+    int n;                                              //          - Número de corpos.
+    int n_integrated;                                   //          - Número de corpos integrados.
+    double mu[NBODY_MAX_CORPOS];                        // [m³/s²]  - G M de cada corpo.
+    double radius[NBODY_MAX_CORPOS];                    // [m]      - Raio de cada corpo (0: sem verificação de colisão).
+    int kind[NBODY_MAX_CORPOS];                         //          - Movimento (CORPO_*).
+    int center[NBODY_MAX_CORPOS];                       //          - Corpo central da órbita circular (sempre antes na tabela).
+    int slot[NBODY_MAX_CORPOS];                         //          - Posição de um corpo integrado entre os corpos integrados.
+    int integrated[NBODY_MAX_PONTOS];                   //          - Corpo de cada posição entre os corpos integrados.
+    double orbit_radius[NBODY_MAX_CORPOS];              // [m]      - Raio da órbita circular.
+    double omega[NBODY_MAX_CORPOS];                     // [rad/s]  - Velocidade angular da órbita circular.
+    double phase[NBODY_MAX_CORPOS];                     // [rad]    - Ângulo da órbita circular em t = 0.
+    double x[NBODY_MAX_CORPOS];                         // [m]      - Posição x (fixos) ou posição x inicial (integrados).
+    double y[NBODY_MAX_CORPOS];                         // [m]      - Posição y (idem).
+    double vx[NBODY_MAX_CORPOS];                        // [m/s]    - Velocidade x inicial (integrados).
+    double vy[NBODY_MAX_CORPOS];                        // [m/s]    - Velocidade y inicial (integrados).
+    char name[NBODY_MAX_CORPOS][NBODY_NOME];            //          - Nome de cada corpo (usado como centro das órbitas).
+} nbody_table;
+
+//  - Uma integração: a tabela, o número de sondas e o corpo do sobrevoo. É o 'context' do nbody_acceleration.
+//
+//  Ela também guarda o cos/sin do ângulo de cada corpo em órbita circular no último instante avaliado. Num passo fixo
+//  os intervalos entre as avaliações se repetem (dt no Euler e no leapfrog, h/2 no RK4, os poucos sub-passos do
+//  Yoshida), então o ângulo avança por uma rotação de cada intervalo já visto, calculada uma vez, e a trigonometria
+//  só volta a cada NBODY_RESSINCRONIZACAO rotações (para que o arredondamento não se acumule).
+typedef struct {
+    const nbody_table* table;                           //          - Tabela de corpos (não é alterada durante a integração).
+    int n_probes;                                       //          - Número de sondas (os primeiros pontos do estado).
+    int reference;                                      //          - Corpo cuja distância às sondas é medida (Marte).
+    int cached;                                         //          - 1 se os ângulos em cache_time já foram calculados.
+    int rotations;                                      //          - Rotações desde o último cálculo com cos/sin.
+    int n_intervals;                                    //          - Intervalos guardados em 'interval'.
+    double cache_time;                                  // [s]      - Instante dos ângulos guardados.
+    double cache_cos[NBODY_MAX_CORPOS];                 //          - cos do ângulo de cada corpo em órbita circular.
+    double cache_sin[NBODY_MAX_CORPOS];                 //          - sin do ângulo (idem).
+    double interval[NBODY_INTERVALOS];                  // [s]      - Intervalos entre avaliações já vistos.
+    double rotation_cos[NBODY_INTERVALOS][NBODY_MAX_CORPOS];
+                                                        //          - cos(ω Δt) de cada corpo em cada intervalo.
+    double rotation_sin[NBODY_INTERVALOS][NBODY_MAX_CORPOS];
+                                                        //          - sin(ω Δt) (idem).
+} nbody_run;
+// ....................................................................................................................
+//  - Esvazia a tabela.
+void nbody_init(nbody_table* table);
+
+//  - Adicionam um corpo à tabela. Retornam o índice do corpo, ou -1 se a tabela (ou o estado, nos integrados) está
+//  cheia, o nome já existe ou o centro da órbita circular não existe.
+//  const char* name                        → Nome do corpo.
+//  double mu                               → G M do corpo, em m³/s².
+//  double radius                           → Raio do corpo, em metros (0 para não verificar colisões com ele).
+int nbody_add_fixed(nbody_table* table, const char* name, double mu, double radius, double x, double y);
+//  int center                              → Índice do corpo central (a velocidade angular é sqrt(μ_centro / R³)).
+//  double orbit_radius, double phase       → Raio da órbita (m) e ângulo em t = 0 (rad).
+int nbody_add_circular(nbody_table* table, const char* name, double mu, double radius, int center, double orbit_radius, double phase);
+int nbody_add_integrated(nbody_table* table, const char* name, double mu, double radius, double x, double y, double vx, double vy);
+
+//  - Índice do corpo com esse nome, ou -1.
+int nbody_find(const nbody_table* table, const char* name);
+
+//  - Lê corpos de um arquivo de texto e os adiciona à tabela. Uma linha por corpo (linhas vazias e comentários com '#'
+//  são ignorados), com o nome, o movimento, a massa em kg, o raio em metros e os parâmetros do movimento:
+//      <nome> fixed <massa> <raio> <x> <y>
+//      <nome> circular <massa> <raio> <centro> <raio da órbita> <ângulo inicial em graus>
+//      <nome> integrated <massa> <raio> <x> <y> <v_x> <v_y>
+//
+//  * Retorna 0 em caso de sucesso, -1 se o arquivo não pode ser lido, ou o número da primeira linha inválida.
+int nbody_load(nbody_table* table, const char* path);
+
+//  - Prepara uma integração com a tabela (que precisa estar completa), sem nenhum ângulo guardado.
+//  int n_probes                            → Número de sondas.
+//  int reference                           → Corpo cuja distância às sondas é medida.
+void nbody_run_init(nbody_run* run, const nbody_table* table, int n_probes, int reference);
+
+//  - Número de pontos do estado integrado: as sondas e os corpos integrados.
+int nbody_points(const nbody_run* run);
+
+//  - Coloca o estado inicial dos corpos integrados nos vetores do estado (depois das sondas).
+void nbody_start(const nbody_run* run, double* x, double* v);
+
+//  - Posição e velocidade de um corpo no instante t (x e v são o estado, usados pelos corpos integrados). Os corpos em
+//  órbita circular usam os ângulos guardados da integração (os mesmos das forças), então no instante de uma avaliação
+//  ou depois de um intervalo já visto não há trigonometria.
+void nbody_body_state(nbody_run* run, int body, double t, const double* x, const double* v, double* coord, double* velocity);
+
+//  - Aceleração de todos os pontos do estado, no formato dos integradores de ordem alta (context é um nbody_run).
+void nbody_acceleration(double t, const double* x, const double* v, double* a, void* context);
+
+//  - Um passo de Euler explícito de todos os pontos: a posição avança com a velocidade do começo do passo e a
+//  velocidade com a aceleração do começo do passo (como no Euler do pr3c).
+//  double* distance                        → Recebe a distância de cada sonda ao corpo de referência no começo do passo.
+void nbody_euler_step(nbody_run* run, double t, double dt, double* x, double* v, double* distance);
+
+//  - Verifica se a sonda 'probe' está dentro de algum corpo com raio, exceto o de referência (cuja colisão é tratada
+//  pelo programa junto com a distância mínima). Retorna o índice do corpo, ou -1.
+int nbody_collision(nbody_run* run, double t, const double* x, int probe);
+// ....................................................................................................................
+#endif
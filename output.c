@@ -0,0 +1,742 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Comentários para desabilitar algumas funções de análise do CLion:
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ....................................................................................................................
+//      Bibliotecas:
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "output.h"
+// ....................................................................................................................
+//      Estrutura interna do arquivo binário.
+struct trajectory_store {
+    int fd;                                             //  Descritor do arquivo.
+    int n_columns;                                      //  Número de colunas.
+    long n_trajectories;                                //  Número de trajetórias (tamanho do índice).
+    uint64_t index_offset;                              //  Posição do índice no arquivo.
+    uint64_t end;                                       //  Fim do arquivo (onde o próximo bloco será escrito).
+    int failed;                                         //  1 se alguma escrita falhou.
+    pthread_mutex_t lock;                               //  Trava da reserva de blocos.
+};
+
+//      Buffer do pool: algumas linhas de uma trajetória, ainda sem formatar.
+struct output_buffer {
+    trajectory_output* sink;                            //  Saída (cópia da thread de escrita) da trajetória.
+    double* values;                                     //  Linhas (PIPELINE_LINHAS_POR_BUFFER × OUTPUT_MAX_COLUMNS).
+    int n_rows;                                         //  Linhas preenchidas.
+    int last;                                           //  1 se a trajetória termina neste buffer.
+    output_buffer* next;                                //  Próximo buffer da fila (ou do pool).
+};
+
+//      Thread de escrita e a sua fila.
+typedef struct {
+    pthread_t thread;
+    pthread_cond_t ready;                               //  Sinalizada quando um buffer entra na fila.
+    output_buffer* head;                                //  Primeiro buffer da fila.
+    output_buffer* tail;                                //  Último buffer da fila.
+    output_pipeline* pipeline;
+} pipeline_writer;
+
+//      Escrita assíncrona. Tudo é protegido pela mesma trava (as operações dentro dela são só trocas de ponteiros).
+struct output_pipeline {
+    pthread_mutex_t lock;
+    pthread_cond_t available;                           //  Sinalizada quando um buffer volta para o pool.
+    output_buffer* buffers;                             //  Todos os buffers.
+    double* memory;                                     //  Memória das linhas de todos os buffers.
+    output_buffer* pool;                                //  Buffers livres.
+    pipeline_writer* writers;                           //  Threads de escrita.
+    int n_writers;
+    int n_buffers;
+    int stopping;                                       //  1 quando o pipeline_stop foi chamado.
+    int depth;                                          //  Buffers esperando nas filas.
+    pipeline_stats stats;                               //  Estatísticas acumuladas.
+    double depth_sum;                                   //  Soma das profundidades a cada envio (para a média).
+    struct timespec begin;                              //  Início do pipeline.
+};
+// ....................................................................................................................
+//      Conversão para little-endian. Em processadores little-endian (x86, ARM no modo usual) não faz nada.
+static uint64_t to_little_endian(const uint64_t value) {
+    const uint16_t probe = 1;
+    uint64_t swapped;
+    int i;
+
+    if (*(const uint8_t*) &probe == 1) return value;
+
+    swapped = 0;
+    for (i = 0; i < 8; i++) swapped |= ((value >> (8 * i)) & 0xFF) << (8 * (7 - i));
+    return swapped;
+}
+// ....................................................................................................................
+//      Escreve um inteiro de 32 ou 64 bits em little-endian dentro de um buffer.
+static void put_u32(unsigned char* buffer, const uint32_t value) {
+    int i;
+    for (i = 0; i < 4; i++) buffer[i] = (unsigned char) ((value >> (8 * i)) & 0xFF);
+}
+
+static void put_u64(unsigned char* buffer, const uint64_t value) {
+    int i;
+    for (i = 0; i < 8; i++) buffer[i] = (unsigned char) ((value >> (8 * i)) & 0xFF);
+}
+
+//      Lê um inteiro de 32 ou 64 bits em little-endian de um buffer.
+static uint32_t get_u32(const unsigned char* buffer) {
+    uint32_t value = 0;
+    int i;
+    for (i = 0; i < 4; i++) value |= (uint32_t) buffer[i] << (8 * i);
+    return value;
+}
+
+static uint64_t get_u64(const unsigned char* buffer) {
+    uint64_t value = 0;
+    int i;
+    for (i = 0; i < 8; i++) value |= (uint64_t) buffer[i] << (8 * i);
+    return value;
+}
+// ....................................................................................................................
+//      pwrite completo (repete até escrever tudo).
+static int write_all(const int fd, const void* data, size_t size, off_t offset) {
+    const char* bytes = data;
+    ssize_t written;
+
+    while (size > 0) {
+        written = pwrite(fd, bytes, size, offset);
+        if (written <= 0) return -1;
+        bytes += written;
+        size -= (size_t) written;
+        offset += written;
+    }
+    return 0;
+}
+// ....................................................................................................................
+//      Segundos desde 'begin' (relógio monotônico).
+static double seconds_since(const struct timespec* begin) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) (now.tv_sec - begin->tv_sec) + 1e-9 * (double) (now.tv_nsec - begin->tv_nsec);
+}
+// ....................................................................................................................
+//      Formata e grava (CSV) ou acumula (binário) algumas linhas de uma trajetória.
+static void write_rows(trajectory_output* out, const double* values, const long n_rows) {
+    double* rows;
+    long capacity;
+    long row;
+    int i;
+
+    if (out->format == SAIDA_CSV) {
+        for (row = 0; row < n_rows; row++, values += out->n_columns) {
+            out->bytes += fprintf(out->fo, "%.8e", values[0]);
+            for (i = 1; i < out->n_columns; i++) out->bytes += fprintf(out->fo, ",%.*e", out->precision, values[i]);
+            out->bytes += fprintf(out->fo, "\n");
+        }
+        return;
+    }
+
+    //      Formato binário: acumula até o fim da trajetória (o número de linhas só é conhecido no final).
+    if (out->n_rows + n_rows > out->capacity) {
+        capacity = out->capacity > 0 ? out->capacity : 1024;
+        while (capacity < out->n_rows + n_rows) capacity *= 2;
+        rows = realloc(out->rows, sizeof(double) * out->n_columns * capacity);
+        if (rows == NULL) {
+            out->store->failed = 1;
+            return;
+        }
+        out->rows = rows;
+        out->capacity = capacity;
+    }
+    memcpy(&out->rows[out->n_rows * out->n_columns], values, sizeof(double) * out->n_columns * n_rows);
+    out->n_rows += n_rows;
+}
+// ....................................................................................................................
+//      Termina a saída de uma trajetória: fecha o CSV, ou escreve o bloco no arquivo binário.
+static void finish(trajectory_output* out) {
+    trajectory_store* store = out->store;
+    uint64_t* block;
+    unsigned char entry[16];
+    uint64_t offset;
+    uint64_t bits;
+    size_t size;
+    long row;
+    int column;
+
+    if (out->format == SAIDA_CSV) {
+        if (out->fo != NULL) fclose(out->fo);
+        out->fo = NULL;
+        return;
+    }
+    // ................................................................................................................
+    //      Formato binário: transpõe as linhas para colunas e escreve o bloco numa região reservada no fim do arquivo.
+    if (out->trajectory < 0 || out->trajectory >= store->n_trajectories) store->failed = 1;
+    else {
+        size = sizeof(uint64_t) * out->n_columns * (size_t) out->n_rows;
+        block = malloc(size > 0 ? size : 1);
+        if (block == NULL) store->failed = 1;
+        else {
+            for (column = 0; column < out->n_columns; column++) {
+                for (row = 0; row < out->n_rows; row++) {
+                    memcpy(&bits, &out->rows[row * out->n_columns + column], sizeof(uint64_t));
+                    block[column * out->n_rows + row] = to_little_endian(bits);
+                }
+            }
+
+            pthread_mutex_lock(&store->lock);
+            offset = store->end;
+            store->end += size;
+            pthread_mutex_unlock(&store->lock);
+
+            put_u64(entry, offset);
+            put_u64(entry + 8, (uint64_t) out->n_rows);
+            if (write_all(store->fd, block, size, (off_t) offset) != 0 ||
+                write_all(store->fd, entry, 16, (off_t) (store->index_offset + 16 * (uint64_t) out->trajectory)) != 0) store->failed = 1;
+            else out->bytes += (long long) size + 16;
+            free(block);
+        }
+    }
+
+    free(out->rows);
+    out->rows = NULL;
+    out->n_rows = 0;
+    out->capacity = 0;
+}
+// ....................................................................................................................
+//      Tira um buffer do pool, esperando caso ele esteja vazio (back-pressure).
+static output_buffer* acquire(output_pipeline* pipeline, trajectory_output* sink) {
+    output_buffer* buffer;
+    struct timespec begin;
+
+    pthread_mutex_lock(&pipeline->lock);
+    if (pipeline->pool == NULL) {
+        pipeline->stats.waits++;
+        clock_gettime(CLOCK_MONOTONIC, &begin);
+        while (pipeline->pool == NULL) pthread_cond_wait(&pipeline->available, &pipeline->lock);
+        pipeline->stats.wait_seconds += seconds_since(&begin);
+    }
+    buffer = pipeline->pool;
+    pipeline->pool = buffer->next;
+    pthread_mutex_unlock(&pipeline->lock);
+
+    buffer->sink = sink;
+    buffer->n_rows = 0;
+    buffer->last = 0;
+    buffer->next = NULL;
+    return buffer;
+}
+// ....................................................................................................................
+//      Coloca um buffer na fila da thread de escrita responsável pela trajetória.
+static void submit(output_pipeline* pipeline, output_buffer* buffer) {
+    pipeline_writer* writer = &pipeline->writers[buffer->sink->trajectory % pipeline->n_writers];
+
+    pthread_mutex_lock(&pipeline->lock);
+    if (writer->tail != NULL) writer->tail->next = buffer;
+    else writer->head = buffer;
+    writer->tail = buffer;
+
+    pipeline->depth++;
+    if (pipeline->depth > pipeline->stats.max_depth) pipeline->stats.max_depth = pipeline->depth;
+    pipeline->depth_sum += pipeline->depth;
+    pipeline->stats.buffers++;
+    pthread_cond_signal(&writer->ready);
+    pthread_mutex_unlock(&pipeline->lock);
+}
+// ....................................................................................................................
+//      Thread de escrita: formata e grava os buffers da sua fila, na ordem, e os devolve para o pool.
+static void* writer_main(void* argument) {
+    pipeline_writer* writer = argument;
+    output_pipeline* pipeline = writer->pipeline;
+    output_buffer* buffer;
+    trajectory_output* sink;
+    struct timespec begin;
+    long long bytes;
+    double busy;
+
+    pthread_mutex_lock(&pipeline->lock);
+    for (;;) {
+        while (writer->head == NULL && !pipeline->stopping) pthread_cond_wait(&writer->ready, &pipeline->lock);
+        if (writer->head == NULL) break;
+
+        buffer = writer->head;
+        writer->head = buffer->next;
+        if (writer->head == NULL) writer->tail = NULL;
+        pipeline->depth--;
+        pthread_mutex_unlock(&pipeline->lock);
+
+        //      Formatação e escrita, fora da trava.
+        clock_gettime(CLOCK_MONOTONIC, &begin);
+        sink = buffer->sink;
+        write_rows(sink, buffer->values, buffer->n_rows);
+        bytes = 0;
+        if (buffer->last) {
+            finish(sink);
+            bytes = sink->bytes;
+            free(sink);
+        }
+        busy = seconds_since(&begin);
+
+        pthread_mutex_lock(&pipeline->lock);
+        pipeline->stats.rows += buffer->n_rows;
+        pipeline->stats.busy_seconds += busy;
+        if (buffer->last) {
+            pipeline->stats.bytes += bytes;
+            pipeline->stats.trajectories++;
+        }
+        buffer->next = pipeline->pool;
+        pipeline->pool = buffer;
+        pthread_cond_signal(&pipeline->available);
+    }
+    pthread_mutex_unlock(&pipeline->lock);
+
+    return NULL;
+}
+// ....................................................................................................................
+int output_parse(const char* name) {
+    if (strcmp(name, "csv") == 0) return SAIDA_CSV;
+    if (strcmp(name, "binary") == 0) return SAIDA_BINARIA;
+    if (strcmp(name, "none") == 0) return SAIDA_NENHUMA;
+    return -1;
+}
+// ....................................................................................................................
+trajectory_store* store_open(const char* path, const long n_trajectories, const char* columns) {
+    trajectory_store* store;
+    unsigned char* head;                                //  Cabeçalho, nomes e índice (zerado).
+    size_t head_size;
+    const char* name;
+    size_t length;
+    int n_columns;
+
+    //      Conta as colunas.
+    n_columns = 1;
+    for (name = columns; *name != '\0'; name++) if (*name == ',') n_columns++;
+    if (n_columns > OUTPUT_MAX_COLUMNS || n_trajectories < 0) return NULL;
+
+    store = malloc(sizeof(trajectory_store));
+    if (store == NULL) return NULL;
+
+    store->fd = open(path, O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    if (store->fd < 0) {
+        free(store);
+        return NULL;
+    }
+    store->n_columns = n_columns;
+    store->n_trajectories = n_trajectories;
+    store->index_offset = OUTPUT_HEADER_SIZE + (uint64_t) n_columns * OUTPUT_NAME_SIZE;
+    store->end = store->index_offset + 16 * (uint64_t) n_trajectories;
+    store->failed = 0;
+    pthread_mutex_init(&store->lock, NULL);
+    // ................................................................................................................
+    //      Cabeçalho, nomes das colunas e índice vazio.
+    head_size = (size_t) store->end;
+    head = calloc(head_size, 1);
+    if (head == NULL) {
+        close(store->fd);
+        free(store);
+        return NULL;
+    }
+
+    memcpy(head, "FLYBYTRJ", 8);
+    put_u32(head + 8, 1);
+    put_u32(head + 12, (uint32_t) n_columns);
+    put_u64(head + 16, (uint64_t) n_trajectories);
+    put_u64(head + 24, OUTPUT_HEADER_SIZE);
+    put_u64(head + 32, store->index_offset);
+    put_u64(head + 40, store->end);
+
+    name = columns;
+    for (n_columns = 0; n_columns < store->n_columns; n_columns++) {
+        length = strcspn(name, ",");
+        memcpy(head + OUTPUT_HEADER_SIZE + n_columns * OUTPUT_NAME_SIZE, name, length < OUTPUT_NAME_SIZE ? length : OUTPUT_NAME_SIZE - 1);
+        name += length + (name[length] == ',');
+    }
+
+    if (write_all(store->fd, head, head_size, 0) != 0) store->failed = 1;
+    free(head);
+
+    return store;
+}
+// ....................................................................................................................
+trajectory_store* store_reopen(const char* path, const long n_trajectories, const char* columns) {
+    trajectory_store* store;
+    unsigned char header[OUTPUT_HEADER_SIZE];
+    unsigned char* index;
+    uint64_t offset;
+    uint64_t end;
+    const char* c;
+    int n_columns;
+    long i;
+
+    n_columns = 1;
+    for (c = columns; *c != '\0'; c++) if (*c == ',') n_columns++;
+
+    store = malloc(sizeof(trajectory_store));
+    if (store == NULL) return NULL;
+
+    store->fd = open(path, O_RDWR);
+    if (store->fd < 0) {
+        free(store);
+        return NULL;
+    }
+    // ................................................................................................................
+    //      O cabeçalho precisa ser o de uma execução com as mesmas dimensões.
+    index = NULL;
+    if (pread(store->fd, header, OUTPUT_HEADER_SIZE, 0) == OUTPUT_HEADER_SIZE && memcmp(header, "FLYBYTRJ", 8) == 0 && get_u32(header + 8) == 1 &&
+        get_u32(header + 12) == (uint32_t) n_columns && get_u64(header + 16) == (uint64_t) n_trajectories) {
+        store->n_columns = n_columns;
+        store->n_trajectories = n_trajectories;
+        store->index_offset = get_u64(header + 32);
+        store->end = get_u64(header + 40);
+        index = malloc(16 * (size_t) n_trajectories + 1);
+    }
+    if (index == NULL || pread(store->fd, index, 16 * (size_t) n_trajectories, (off_t) store->index_offset) != (ssize_t) (16 * n_trajectories)) {
+        free(index);
+        close(store->fd);
+        free(store);
+        return NULL;
+    }
+
+    //      Os blocos novos vão depois do último bloco presente no índice. Um bloco que foi escrito sem que a sua entrada
+    //  no índice tenha chegado ao disco é simplesmente sobrescrito.
+    for (i = 0; i < n_trajectories; i++) {
+        offset = get_u64(index + 16 * i);
+        end = offset + sizeof(uint64_t) * (uint64_t) n_columns * get_u64(index + 16 * i + 8);
+        if (offset != 0 && end > store->end) store->end = end;
+    }
+    free(index);
+
+    store->failed = 0;
+    pthread_mutex_init(&store->lock, NULL);
+
+    return store;
+}
+// ....................................................................................................................
+long store_rows(trajectory_store* store, const long trajectory) {
+    unsigned char entry[16];
+
+    if (store == NULL || trajectory < 0 || trajectory >= store->n_trajectories) return 0;
+    if (pread(store->fd, entry, 16, (off_t) (store->index_offset + 16 * (uint64_t) trajectory)) != 16) return 0;
+    return get_u64(entry) != 0 ? (long) get_u64(entry + 8) : 0;
+}
+// ....................................................................................................................
+trajectory_store* store_read(const char* path) {
+    trajectory_store* store;
+    unsigned char header[OUTPUT_HEADER_SIZE];
+
+    store = malloc(sizeof(trajectory_store));
+    if (store == NULL) return NULL;
+
+    store->fd = open(path, O_RDONLY);
+    if (store->fd < 0) {
+        free(store);
+        return NULL;
+    }
+    if (pread(store->fd, header, OUTPUT_HEADER_SIZE, 0) != OUTPUT_HEADER_SIZE || memcmp(header, "FLYBYTRJ", 8) != 0 || get_u32(header + 8) != 1 ||
+        get_u32(header + 12) < 1 || get_u32(header + 12) > OUTPUT_MAX_COLUMNS) {
+        close(store->fd);
+        free(store);
+        return NULL;
+    }
+
+    store->n_columns = (int) get_u32(header + 12);
+    store->n_trajectories = (long) get_u64(header + 16);
+    store->index_offset = get_u64(header + 32);
+    store->end = get_u64(header + 40);
+    store->failed = 0;
+    pthread_mutex_init(&store->lock, NULL);
+
+    return store;
+}
+// ....................................................................................................................
+long store_trajectories(const trajectory_store* store) {
+    return store->n_trajectories;
+}
+// ....................................................................................................................
+int store_columns(trajectory_store* store, char* columns, const size_t size) {
+    char name[OUTPUT_NAME_SIZE + 1];
+    size_t length;
+    int column;
+
+    if (size < 1) return -1;
+    columns[0] = '\0';
+    length = 0;
+    for (column = 0; column < store->n_columns; column++) {
+        if (pread(store->fd, name, OUTPUT_NAME_SIZE, OUTPUT_HEADER_SIZE + (off_t) column * OUTPUT_NAME_SIZE) != OUTPUT_NAME_SIZE) return -1;
+        name[OUTPUT_NAME_SIZE] = '\0';
+        length += strlen(name) + (column > 0);
+        if (length >= size) return -1;
+        if (column > 0) strcat(columns, ",");
+        strcat(columns, name);
+    }
+    return 0;
+}
+// ....................................................................................................................
+//      O bloco já está no formato do arquivo (little-endian, em ordem de coluna), então é copiado sem conversão.
+int store_copy(trajectory_store* store, trajectory_store* source, const long trajectory) {
+    unsigned char entry[16];
+    unsigned char* block;
+    uint64_t offset;
+    size_t size;
+    int status;
+
+    if (trajectory < 0 || trajectory >= store->n_trajectories || trajectory >= source->n_trajectories || store->n_columns != source->n_columns) return -1;
+    if (pread(source->fd, entry, 16, (off_t) (source->index_offset + 16 * (uint64_t) trajectory)) != 16 || get_u64(entry) == 0) return -1;
+
+    size = sizeof(uint64_t) * (size_t) source->n_columns * (size_t) get_u64(entry + 8);
+    block = malloc(size > 0 ? size : 1);
+    if (block == NULL) return -1;
+    status = -1;
+    if (pread(source->fd, block, size, (off_t) get_u64(entry)) == (ssize_t) size) {
+        pthread_mutex_lock(&store->lock);
+        offset = store->end;
+        store->end += size;
+        pthread_mutex_unlock(&store->lock);
+
+        put_u64(entry, offset);
+        status = write_all(store->fd, block, size, (off_t) offset) == 0 &&
+            write_all(store->fd, entry, 16, (off_t) (store->index_offset + 16 * (uint64_t) trajectory)) == 0 ? 0 : -1;
+    }
+    if (status != 0) store->failed = 1;
+    free(block);
+
+    return status;
+}
+// ....................................................................................................................
+int store_close(trajectory_store* store) {
+    int status;
+
+    if (store == NULL) return 0;
+
+    status = store->failed ? -1 : 0;
+    if (close(store->fd) != 0) status = -1;
+    pthread_mutex_destroy(&store->lock);
+    free(store);
+
+    return status;
+}
+// ....................................................................................................................
+//      Abertura da saída (o output_open mede o tempo dela com --profile).
+static int open_output(trajectory_output* out, const int format, const char* directory, const long trajectory, const char* columns, const int precision,
+    trajectory_store* store, output_pipeline* pipeline) {
+    char filename[300];
+    const char* c;
+
+    out->format = format;
+    out->precision = precision;
+    out->trajectory = trajectory;
+    out->store = store;
+    out->fo = NULL;
+    out->rows = NULL;
+    out->n_rows = 0;
+    out->capacity = 0;
+    out->bytes = 0;
+    out->row_count = 0;
+    out->pipeline = NULL;
+    out->buffer = NULL;
+    out->sink = NULL;
+
+    out->n_columns = 1;
+    for (c = columns; *c != '\0'; c++) if (*c == ',') out->n_columns++;
+
+    if (format == SAIDA_CSV) {
+        sprintf(filename, "%s/data_%03ld.csv", directory, trajectory + 1);
+        out->fo = fopen(filename, "w");
+        if (out->fo == NULL) return -1;
+        //  Como eu não vou usar GnuPlot, vou adicionar um cabeçalho no arquivo; e meio que o formato acaba virando um CSV.
+        out->bytes += fprintf(out->fo, "%s\n", columns);
+    } else if (format == SAIDA_NENHUMA) return 0;
+    else if (store == NULL) return -1;
+
+    //      Na escrita assíncrona, a thread de escrita usa uma cópia da saída (a original fica na pilha de quem integra).
+    //  Sem memória para a cópia, a trajetória é escrita na própria thread.
+    if (pipeline != NULL) {
+        out->sink = malloc(sizeof(trajectory_output));
+        if (out->sink != NULL) {
+            *out->sink = *out;
+            out->sink->sink = NULL;
+            out->pipeline = pipeline;
+        }
+    }
+
+    return 0;
+}
+// ....................................................................................................................
+int output_open(trajectory_output* out, const int format, const char* directory, const long trajectory, const char* columns, const int precision, trajectory_store* store,
+    output_pipeline* pipeline, const int timed) {
+    struct timespec begin;
+    int status;
+
+    if (!timed) status = open_output(out, format, directory, trajectory, columns, precision, store, pipeline);
+    else {
+        clock_gettime(CLOCK_MONOTONIC, &begin);
+        status = open_output(out, format, directory, trajectory, columns, precision, store, pipeline);
+        out->file_seconds = seconds_since(&begin);
+    }
+    out->timed = timed;
+    out->row_seconds = 0.0;
+    if (!timed) out->file_seconds = 0.0;
+
+    return status;
+}
+// ....................................................................................................................
+//      Uma linha, sem a medida do tempo.
+static void append_row(trajectory_output* out, const double* values) {
+    if (out->format == SAIDA_NENHUMA) return;
+    if (out->pipeline == NULL) {
+        write_rows(out, values, 1);
+        return;
+    }
+
+    //      Escrita assíncrona: só copia a linha; o buffer é enviado quando enche.
+    if (out->buffer == NULL) out->buffer = acquire(out->pipeline, out->sink);
+    memcpy(&out->buffer->values[out->buffer->n_rows * out->n_columns], values, sizeof(double) * out->n_columns);
+    out->buffer->n_rows++;
+    if (out->buffer->n_rows == PIPELINE_LINHAS_POR_BUFFER) {
+        submit(out->pipeline, out->buffer);
+        out->buffer = NULL;
+    }
+}
+// ....................................................................................................................
+void output_row(trajectory_output* out, const double* values) {
+    struct timespec begin;
+
+    out->row_count++;
+    if (!out->timed) {
+        append_row(out, values);
+        return;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    append_row(out, values);
+    out->row_seconds += seconds_since(&begin);
+}
+// ....................................................................................................................
+//      Fim da saída, sem a medida do tempo.
+static void close_output(trajectory_output* out) {
+    if (out->format == SAIDA_NENHUMA) return;
+    if (out->pipeline == NULL) {
+        finish(out);
+        return;
+    }
+
+    //      O último buffer (mesmo vazio) avisa a thread de escrita que a trajetória terminou.
+    if (out->buffer == NULL) out->buffer = acquire(out->pipeline, out->sink);
+    out->buffer->last = 1;
+    submit(out->pipeline, out->buffer);
+    out->buffer = NULL;
+    out->sink = NULL;
+    out->pipeline = NULL;
+}
+// ....................................................................................................................
+void output_close(trajectory_output* out) {
+    struct timespec begin;
+
+    if (!out->timed) {
+        close_output(out);
+        return;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    close_output(out);
+    out->file_seconds += seconds_since(&begin);
+}
+// ....................................................................................................................
+output_pipeline* pipeline_start(const int n_writers, const int n_producers) {
+    output_pipeline* pipeline;
+    int created;
+    int i;
+
+    if (n_writers < 1 || n_producers < 1) return NULL;
+
+    pipeline = calloc(1, sizeof(output_pipeline));
+    if (pipeline == NULL) return NULL;
+
+    //      Cada trajetória aberta segura no máximo um buffer parcialmente preenchido, então com mais de um buffer por
+    //  trajetória aberta sempre sobra um buffer para a fila, e a espera no pool nunca trava.
+    pipeline->n_writers = n_writers;
+    pipeline->n_buffers = PIPELINE_BUFFERS_POR_PRODUTOR * n_producers + n_writers;
+    pipeline->buffers = calloc((size_t) pipeline->n_buffers, sizeof(output_buffer));
+    pipeline->memory = malloc(sizeof(double) * OUTPUT_MAX_COLUMNS * PIPELINE_LINHAS_POR_BUFFER * (size_t) pipeline->n_buffers);
+    pipeline->writers = calloc((size_t) n_writers, sizeof(pipeline_writer));
+    if (pipeline->buffers == NULL || pipeline->memory == NULL || pipeline->writers == NULL) {
+        free(pipeline->buffers);
+        free(pipeline->memory);
+        free(pipeline->writers);
+        free(pipeline);
+        return NULL;
+    }
+
+    for (i = 0; i < pipeline->n_buffers; i++) {
+        pipeline->buffers[i].values = &pipeline->memory[(size_t) i * OUTPUT_MAX_COLUMNS * PIPELINE_LINHAS_POR_BUFFER];
+        pipeline->buffers[i].next = pipeline->pool;
+        pipeline->pool = &pipeline->buffers[i];
+    }
+    pipeline->stats.writers = n_writers;
+    pipeline->stats.pool = pipeline->n_buffers;
+    pthread_mutex_init(&pipeline->lock, NULL);
+    pthread_cond_init(&pipeline->available, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &pipeline->begin);
+    // ................................................................................................................
+    //      Cria as threads de escrita. Se alguma falhar, as que já foram criadas são encerradas.
+    for (created = 0; created < n_writers; created++) {
+        pipeline->writers[created].pipeline = pipeline;
+        pthread_cond_init(&pipeline->writers[created].ready, NULL);
+        if (pthread_create(&pipeline->writers[created].thread, NULL, writer_main, &pipeline->writers[created]) != 0) {
+            pthread_cond_destroy(&pipeline->writers[created].ready);
+            break;
+        }
+    }
+    if (created < n_writers) {
+        pipeline->n_writers = created;
+        pipeline_stop(pipeline, NULL);
+        return NULL;
+    }
+
+    return pipeline;
+}
+// ....................................................................................................................
+int pipeline_depth(output_pipeline* pipeline) {
+    int depth;
+
+    if (pipeline == NULL) return 0;
+
+    pthread_mutex_lock(&pipeline->lock);
+    depth = pipeline->depth;
+    pthread_mutex_unlock(&pipeline->lock);
+
+    return depth;
+}
+// ....................................................................................................................
+void pipeline_stop(output_pipeline* pipeline, pipeline_stats* stats) {
+    int i;
+
+    if (pipeline == NULL) return;
+
+    //      As threads de escrita só terminam com a fila vazia.
+    pthread_mutex_lock(&pipeline->lock);
+    pipeline->stopping = 1;
+    for (i = 0; i < pipeline->n_writers; i++) pthread_cond_signal(&pipeline->writers[i].ready);
+    pthread_mutex_unlock(&pipeline->lock);
+
+    for (i = 0; i < pipeline->n_writers; i++) {
+        pthread_join(pipeline->writers[i].thread, NULL);
+        pthread_cond_destroy(&pipeline->writers[i].ready);
+    }
+
+    if (stats != NULL) {
+        *stats = pipeline->stats;
+        stats->mean_depth = pipeline->stats.buffers > 0 ? pipeline->depth_sum / (double) pipeline->stats.buffers : 0.0;
+        stats->elapsed_seconds = seconds_since(&pipeline->begin);
+    }
+
+    pthread_cond_destroy(&pipeline->available);
+    pthread_mutex_destroy(&pipeline->lock);
+    free(pipeline->buffers);
+    free(pipeline->memory);
+    free(pipeline->writers);
+    free(pipeline);
+}
+// ....................................................................................................................
@@ -0,0 +1,167 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Saída das trajetórias, compartilhada pelos dois programas.
+//
+//  Cada trajetória é escrita por um trajectory_output, em um de dois formatos (opção --output), ou em nenhum (none: as
+//  linhas são apenas contadas, para os ensembles resumidos pelos redutores de reducers.h):
+//  - csv: um arquivo 'data_%03d.csv' por trajetória, como no trabalho original.
+//  - binary: um único arquivo 'trajectories.bin' por execução, que pode ser mapeado na memória (mmap) e lido por acesso
+//  aleatório, sem nenhuma conversão de texto. O formato é (todos os inteiros e reais em little-endian):
+//
+//      [0, 64)         Cabeçalho: "FLYBYTRJ" (8 bytes), versão (u32), número de colunas (u32), número de trajetórias
+//                      (u64), posição dos nomes das colunas (u64), posição do índice (u64), posição dos dados (u64) e
+//                      16 bytes reservados (zeros).
+//      nomes           Um nome por coluna, com 16 bytes cada (completados com zeros).
+//      índice          Por trajetória: posição do bloco de dados (u64) e número de linhas (u64). Uma trajetória que não
+//                      foi escrita tem as duas entradas iguais a zero.
+//      dados           Um bloco por trajetória, na ordem em que elas terminam: as colunas em sequência, cada uma com
+//                      'número de linhas' valores float64 (ou seja, uma matriz em ordem de coluna).
+//
+//  As trajetórias podem terminar em qualquer ordem (várias threads escrevem no mesmo arquivo): cada uma reserva o seu
+//  bloco no fim do arquivo e o escreve com pwrite, então não é preciso serializar as escritas.
+//
+//  A escrita pode ser assíncrona (opção --writers): a thread que integra apenas copia as linhas, sem formatar nada, para
+//  buffers de um pool pré-alocado, e uma ou mais threads de escrita formatam e gravam os buffers cheios. Cada trajetória
+//  é sempre atendida pela mesma thread de escrita, então as suas linhas ficam na ordem certa. Quando o pool se esgota
+//  (o disco não acompanha a integração), a thread que integra espera um buffer ser devolvido.
+// ....................................................................................................................
+#ifndef FLY_BY_OUTPUT_H
+#define FLY_BY_OUTPUT_H
+
+#include <stdio.h>
+// ....................................................................................................................
+//      Formatos disponíveis (opção --output).
+#define SAIDA_CSV 0                                     //  Um arquivo CSV por trajetória (padrão).
+#define SAIDA_BINARIA 1                                 //  Um arquivo binário por execução (trajectories.bin).
+#define SAIDA_NENHUMA 2                                 //  Nenhum arquivo: as linhas são apenas contadas (none).
+
+#define OUTPUT_MAX_COLUMNS 16                           //  Número máximo de colunas de uma trajetória.
+#define OUTPUT_NAME_SIZE 16                             //  Tamanho de cada nome de coluna no arquivo binário.
+#define OUTPUT_HEADER_SIZE 64                           //  Tamanho do cabeçalho do arquivo binário.
+
+#define PIPELINE_BUFFERS_POR_PRODUTOR 4                 //  Buffers do pool por trajetória aberta ao mesmo tempo.
+#define PIPELINE_LINHAS_POR_BUFFER 256                  //  Linhas de cada buffer do pool.
+// ....................................................................................................................
+//  - Arquivo binário de uma execução (a estrutura fica escondida em output.c).
+typedef struct trajectory_store trajectory_store;
+
+//  - Escrita assíncrona (a estrutura fica escondida em output.c).
+typedef struct output_pipeline output_pipeline;
+typedef struct output_buffer output_buffer;
+
+//  - Estatísticas da escrita assíncrona, preenchidas pelo pipeline_stop.
+typedef struct {
+    int writers;                                        //  Threads de escrita.
+    int pool;                                           //  Buffers do pool.
+    long trajectories;                                  //  Trajetórias escritas.
+    long buffers;                                       //  Buffers escritos.
+    long long rows;                                     //  Linhas escritas.
+    long long bytes;                                    //  Bytes escritos.
+    int max_depth;                                      //  Maior número de buffers esperando na fila.
+    double mean_depth;                                  //  Número médio de buffers na fila (a cada envio).
+    long waits;                                         //  Vezes em que o pool estava vazio (back-pressure).
+    double wait_seconds;                                //  Tempo total de espera por um buffer livre.
+    double busy_seconds;                                //  Tempo total das threads de escrita formatando e gravando.
+    double elapsed_seconds;                             //  Tempo entre o pipeline_start e o pipeline_stop.
+} pipeline_stats;
+
+//  - Saída de uma trajetória.
+typedef struct trajectory_output {
+    int format;                                         //  SAIDA_CSV, SAIDA_BINARIA ou SAIDA_NENHUMA.
+    int n_columns;                                      //  Número de colunas de cada linha.
+    int precision;                                      //  Casas decimais das colunas do CSV (o tempo usa sempre 8).
+    FILE* fo;                                           //  Arquivo CSV (apenas no formato csv).
+    trajectory_store* store;                            //  Arquivo binário (apenas no formato binary).
+    long trajectory;                                    //  Índice da trajetória (começa em 0).
+    double* rows;                                       //  Linhas acumuladas até o fim da trajetória (apenas binary).
+    long n_rows;                                        //  Número de linhas acumuladas.
+    long capacity;                                      //  Capacidade de 'rows', em linhas.
+    long long bytes;                                    //  Bytes escritos até agora.
+    long long row_count;                                //  Linhas recebidas pelo output_row.
+    int timed;                                          //  1 para medir o tempo gasto na saída (--profile).
+    double row_seconds;                                 //  Tempo dentro do output_row (apenas com 'timed').
+    double file_seconds;                                //  Tempo dentro do output_open e do output_close (idem).
+    output_pipeline* pipeline;                          //  Escrita assíncrona (NULL para escrever na própria thread).
+    output_buffer* buffer;                              //  Buffer sendo preenchido (apenas na escrita assíncrona).
+    struct trajectory_output* sink;                     //  Cópia usada pela thread de escrita (idem).
+} trajectory_output;
+// ....................................................................................................................
+//  - Converte o nome passado em --output para o identificador. Retorna -1 caso o nome seja desconhecido.
+int output_parse(const char* name);
+
+//  - Cria o arquivo binário de uma execução.
+//  const char* path                        → Caminho do arquivo.
+//  long n_trajectories                     → Número de trajetórias (tamanho do índice).
+//  const char* columns                     → Nomes das colunas separados por vírgula (o mesmo cabeçalho do CSV).
+//
+//  * Retorna NULL caso não seja possível criar o arquivo.
+trajectory_store* store_open(const char* path, long n_trajectories, const char* columns);
+
+//  - Reabre o arquivo binário de uma execução interrompida (--resume), sem apagar as trajetórias já escritas. Os blocos
+//  novos são escritos depois do último bloco presente no índice.
+//
+//  * Retorna NULL caso não seja possível abrir o arquivo, ou caso ele não tenha o mesmo número de trajetórias e colunas.
+trajectory_store* store_reopen(const char* path, long n_trajectories, const char* columns);
+
+//  - Número de linhas de uma trajetória no arquivo binário (0 se ela ainda não foi escrita). A entrada do índice só é
+//  escrita depois do bloco, então uma trajetória presente no índice está completa.
+long store_rows(trajectory_store* store, long trajectory);
+
+//  - Abre um arquivo binário apenas para leitura, com as dimensões do próprio cabeçalho (usado pelo flyby_merge para
+//  juntar os arquivos das partes de uma execução). Retorna NULL caso ele não possa ser lido.
+trajectory_store* store_read(const char* path);
+
+//  - Número de trajetórias (tamanho do índice) de um arquivo binário.
+long store_trajectories(const trajectory_store* store);
+
+//  - Nomes das colunas separados por vírgula (o cabeçalho do CSV). Retorna 0, ou -1 se eles não couberem em 'size'.
+int store_columns(trajectory_store* store, char* columns, size_t size);
+
+//  - Copia uma trajetória de outro arquivo binário com as mesmas colunas (o bloco vai para o fim de 'store').
+//
+//  * Retorna 0 em caso de sucesso, ou -1 se a trajetória não estiver em 'source' ou se a cópia falhar.
+int store_copy(trajectory_store* store, trajectory_store* source, long trajectory);
+
+//  - Fecha o arquivo binário. Retorna 0 caso todas as escritas tenham sido bem sucedidas.
+int store_close(trajectory_store* store);
+
+//  - Começa a saída de uma trajetória.
+//  trajectory_output* out                  → Saída que será inicializada.
+//  int format                              → SAIDA_CSV, SAIDA_BINARIA ou SAIDA_NENHUMA.
+//  const char* directory                   → Pasta dos arquivos CSV ('data_%03d.csv').
+//  long trajectory                         → Índice da trajetória (começa em 0).
+//  const char* columns                     → Nomes das colunas separados por vírgula (cabeçalho do CSV).
+//  int precision                           → Casas decimais das colunas do CSV, exceto a do tempo.
+//  trajectory_store* store                 → Arquivo binário (pode ser NULL no formato csv).
+//  output_pipeline* pipeline               → Escrita assíncrona (NULL para escrever na própria thread).
+//  int timed                               → 1 para medir o tempo gasto na abertura, nas linhas e no fechamento
+//                                            (row_seconds e file_seconds; opção --profile).
+//
+//  * Retorna 0 em caso de sucesso.
+int output_open(trajectory_output* out, int format, const char* directory, long trajectory, const char* columns, int precision, trajectory_store* store,
+    output_pipeline* pipeline, int timed);
+
+//  - Adiciona uma linha (n_columns valores, o primeiro é o tempo).
+void output_row(trajectory_output* out, const double* values);
+
+//  - Termina a saída de uma trajetória (no formato binário, é aqui que o bloco é escrito).
+void output_close(trajectory_output* out);
+
+//  - Inicia a escrita assíncrona.
+//  int n_writers                           → Número de threads de escrita.
+//  int n_producers                         → Número máximo de trajetórias abertas ao mesmo tempo (threads × lanes). O
+//                                            pool tem PIPELINE_BUFFERS_POR_PRODUTOR buffers por trajetória aberta.
+//
+//  * Retorna NULL caso não seja possível alocar o pool ou criar as threads.
+output_pipeline* pipeline_start(int n_writers, int n_producers);
+
+//  - Número de buffers esperando na fila neste momento.
+int pipeline_depth(output_pipeline* pipeline);
+
+//  - Espera as threads de escrita esvaziarem a fila, encerra as threads e preenche as estatísticas (pode ser NULL).
+void pipeline_stop(output_pipeline* pipeline, pipeline_stats* stats);
+// ....................................................................................................................
+#endif
@@ -0,0 +1,83 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Comentários para desabilitar algumas funções de análise do CLion:
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ....................................................................................................................
+//      Bibliotecas:
+#include <math.h>
+
+#include "philox.h"
+// ....................................................................................................................
+//      Constantes do Philox4x32 (multiplicadores e incrementos da chave, do artigo original).
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+#define PHILOX_RODADAS 10
+
+#define DOIS_PI 6.283185307179586476925286766559
+// ....................................................................................................................
+void philox_4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]) {
+    uint32_t c[4];
+    uint32_t k[2];
+    uint64_t p0;
+    uint64_t p1;
+    int round;
+
+    c[0] = counter[0];
+    c[1] = counter[1];
+    c[2] = counter[2];
+    c[3] = counter[3];
+    k[0] = key[0];
+    k[1] = key[1];
+
+    for (round = 0; round < PHILOX_RODADAS; round++) {
+        if (round > 0) {
+            k[0] += PHILOX_W0;
+            k[1] += PHILOX_W1;
+        }
+        p0 = (uint64_t) PHILOX_M0 * c[0];
+        p1 = (uint64_t) PHILOX_M1 * c[2];
+        c[0] = (uint32_t) (p1 >> 32) ^ c[1] ^ k[0];
+        c[2] = (uint32_t) (p0 >> 32) ^ c[3] ^ k[1];
+        c[1] = (uint32_t) p1;
+        c[3] = (uint32_t) p0;
+    }
+
+    out[0] = c[0];
+    out[1] = c[1];
+    out[2] = c[2];
+    out[3] = c[3];
+}
+// ....................................................................................................................
+//      Cada uniforme usa os 53 bits mais altos de duas palavras, deslocados de meio ulp para nunca dar 0 (nem 1).
+void philox_uniform(const uint64_t seed, const uint64_t index, const uint64_t block, double u[2]) {
+    uint32_t counter[4];
+    uint32_t key[2];
+    uint32_t out[4];
+
+    counter[0] = (uint32_t) index;
+    counter[1] = (uint32_t) (index >> 32);
+    counter[2] = (uint32_t) block;
+    counter[3] = (uint32_t) (block >> 32);
+    key[0] = (uint32_t) seed;
+    key[1] = (uint32_t) (seed >> 32);
+    philox_4x32(counter, key, out);
+
+    u[0] = ((double) ((((uint64_t) out[0] << 32) | out[1]) >> 11) + 0.5) * 0x1.0p-53;
+    u[1] = ((double) ((((uint64_t) out[2] << 32) | out[3]) >> 11) + 0.5) * 0x1.0p-53;
+}
+// ....................................................................................................................
+void philox_normal(const uint64_t seed, const uint64_t index, const uint64_t block, double z[2]) {
+    double u[2];
+    double radius;
+
+    philox_uniform(seed, index, block, u);
+    radius = sqrt(-2.0 * log(u[0]));
+    z[0] = radius * cos(DOIS_PI * u[1]);
+    z[1] = radius * sin(DOIS_PI * u[1]);
+}
+// ....................................................................................................................
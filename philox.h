@@ -0,0 +1,30 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Gerador de números aleatórios baseado em contador (Philox4x32-10, Salmon et al., SC'11).
+//
+//  Um gerador comum tem um estado que avança a cada número sorteado, então o resultado depende da ordem em que as
+//  threads pedem os números. No Philox cada bloco de números é uma função pura de (semente, contador): a amostra i do
+//  Monte Carlo usa os contadores (i, 0), (i, 1), ..., e recebe sempre os mesmos números, com qualquer número de threads
+//  e em qualquer ordem (inclusive na retomada de uma execução interrompida).
+// ....................................................................................................................
+#ifndef FLY_BY_PHILOX_H
+#define FLY_BY_PHILOX_H
+// ....................................................................................................................
+#include <stdint.h>
+// ....................................................................................................................
+//  - Um bloco do Philox4x32 com 10 rodadas: quatro palavras de 32 bits a partir do contador e da chave.
+//  const uint32_t counter[4]               → Contador (128 bits).
+//  const uint32_t key[2]                   → Chave (64 bits, a semente).
+//  uint32_t out[4]                         → Recebe as quatro palavras.
+void philox_4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]);
+
+//  - Dois números uniformes no intervalo aberto (0, 1), com 53 bits cada, do bloco (index, block) da semente.
+void philox_uniform(uint64_t seed, uint64_t index, uint64_t block, double u[2]);
+
+//  - Dois números com distribuição normal padrão (Box-Muller) do bloco (index, block) da semente.
+void philox_normal(uint64_t seed, uint64_t index, uint64_t block, double z[2]);
+// ....................................................................................................................
+#endif
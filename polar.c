@@ -0,0 +1,55 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Comentários para desabilitar algumas funções de análise do CLion:
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ....................................................................................................................
+//      Bibliotecas:
+#include <math.h>
+
+#include "polar.h"
+// ....................................................................................................................
+#define CONSTANTE_GRAVITACIONAL 6.6743e-11              //  Constante gravitacional de Newton no sistema internacional.
+#define MASSA_SOL 1.9885e30                             //  Massa do Sol. (Em quilogramas)
+#define MASSA_MARTE 6.4171e23                           //  Massa de Marte. (Em quilogramas)
+// ....................................................................................................................
+double polar_euler_step(double ship_coord[], double ship_velocity[], double mars_coord[], const double mars_velocity[], const double dt) {
+    //  Cópias locais do estado: os vetores podem se sobrepor para o compilador, que então teria de reler os valores
+    //  (e recalcular os cossenos) a cada escrita.
+    const double r = ship_coord[1];                     // [m]              - Distância da sonda ao Sol.
+    const double theta = ship_coord[2];                 // [rad]            - Ângulo da sonda.
+    const double v_r = ship_velocity[1];                // [m/s]            - Velocidade radial da sonda.
+    const double omega = ship_velocity[2];              // [rad/s]          - Velocidade angular da sonda.
+    const double r_mars = mars_coord[1];                // [m]              - Distância de Marte ao Sol.
+    const double theta_mars = mars_coord[2];            // [rad]            - Ângulo de Marte.
+    double div;                                         // [mˆ2]            - Módulo quadrado da distância entre a sonda e Marte.
+
+    div = r * r + r_mars * r_mars - 2 * r * r_mars * cos(theta - theta_mars);
+
+    mars_coord[2] = theta_mars + mars_velocity[2] * dt;
+    ship_coord[1] = r + v_r * dt;
+    ship_coord[2] = theta + omega * dt;
+    ship_velocity[1] = v_r + (r * omega * omega - CONSTANTE_GRAVITACIONAL * MASSA_SOL / (r * r) -
+        CONSTANTE_GRAVITACIONAL * MASSA_MARTE * (r - r_mars * cos(theta - theta_mars)) / (div * sqrt(div))) * dt;
+    ship_velocity[2] = omega + (- CONSTANTE_GRAVITACIONAL * MASSA_MARTE * r_mars * sin(theta - theta_mars) / (r * div * sqrt(div)) -
+        2 * v_r * omega / r) * dt;
+    return div;
+}
+// ....................................................................................................................
+void polar_to_cartesian(const double coord_polar[], const double velocity_polar[], double coord_cartesian[], double velocity_cartesian[]) {
+    const double r = coord_polar[1];
+    const double c = cos(coord_polar[2]);
+    const double s = sin(coord_polar[2]);
+    const double v_r = velocity_polar[1];
+    const double omega = velocity_polar[2];
+
+    //  - Posição (x e y, em ordem).
+    coord_cartesian[1] = r * c;
+    coord_cartesian[2] = r * s;
+    //  - Velocidade (x e y, em ordem).
+    velocity_cartesian[1] = v_r * c - r * omega * s;
+    velocity_cartesian[2] = v_r * s + r * omega * c;
+}
+// ....................................................................................................................
@@ -0,0 +1,28 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Formulação polar do fly_by_pr3c (--engine polar, a padrão): o passo de Euler das Eqs~(34-38) do relatório e a
+//  conversão do estado polar para cartesianas.
+//
+//  Ficam fora do fly_by_pr3c para que o flyby_bench meça as mesmas funções que o programa usa. Os vetores começam no
+//  índice 1, como no programa: posição (r, θ) e velocidade (dr/dt, dθ/dt) heliocêntricas.
+// ....................................................................................................................
+#ifndef FLY_BY_POLAR_H
+#define FLY_BY_POLAR_H
+// ....................................................................................................................
+//  - Um passo de Euler explícito, conforme Eqs~(34-38): a sonda avança com a aceleração do Sol e de Marte do começo do
+//  passo, e Marte avança ω dt na órbita circular.
+//  double ship_coord[], double ship_velocity[] → Estado polar da sonda; recebem o estado do fim do passo.
+//  double mars_coord[]                     → Posição polar de Marte; recebe o ângulo do fim do passo.
+//  const double mars_velocity[]            → Velocidade polar de Marte (dθ/dt é a velocidade angular da órbita).
+//  double dt                               → Passo de integração.
+//
+//  * Retorna o quadrado da distância entre a sonda e Marte no começo do passo.
+double polar_euler_step(double ship_coord[], double ship_velocity[], double mars_coord[], const double mars_velocity[], double dt);
+
+//  - Posição e velocidade cartesianas de um estado polar.
+void polar_to_cartesian(const double coord_polar[], const double velocity_polar[], double coord_cartesian[], double velocity_cartesian[]);
+// ....................................................................................................................
+#endif
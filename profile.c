@@ -0,0 +1,93 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Comentários para desabilitar algumas funções de análise do CLion:
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ....................................................................................................................
+//      Bibliotecas:
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "profile.h"
+// ....................................................................................................................
+double profile_now(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + 1e-9 * (double) now.tv_nsec;
+}
+// ....................................................................................................................
+void profile_init(profile_counters* profile) {
+    memset(profile, 0, sizeof(profile_counters));
+    pthread_mutex_init(&profile->lock, NULL);
+}
+// ....................................................................................................................
+void profile_add(profile_counters* profile, const int phase, const double seconds, const long long calls) {
+    pthread_mutex_lock(&profile->lock);
+    profile->seconds[phase] += seconds;
+    profile->calls[phase] += calls;
+    pthread_mutex_unlock(&profile->lock);
+}
+// ....................................................................................................................
+void profile_trajectory(profile_counters* profile, const double wall, const double row_seconds, const double file_seconds, const long long rows,
+    const long long steps, const int stop) {
+    pthread_mutex_lock(&profile->lock);
+    profile->seconds[PERFIL_INTEGRACAO] += wall - row_seconds - file_seconds;
+    profile->calls[PERFIL_INTEGRACAO]++;
+    profile->seconds[PERFIL_SAIDA] += row_seconds;
+    profile->calls[PERFIL_SAIDA] += rows;
+    profile->seconds[PERFIL_ARQUIVOS] += file_seconds;
+    profile->calls[PERFIL_ARQUIVOS] += 2;
+    profile->steps += steps;
+    profile->stops[stop]++;
+    pthread_mutex_unlock(&profile->lock);
+}
+// ....................................................................................................................
+void profile_sweep(profile_counters* profile, const double seconds, const int n_threads) {
+    pthread_mutex_lock(&profile->lock);
+    profile->sweep_seconds += seconds;
+    profile->thread_seconds += seconds * n_threads;
+    pthread_mutex_unlock(&profile->lock);
+}
+// ....................................................................................................................
+const char* profile_stop_name(const int stop) {
+    switch (stop) {
+        case PARADA_COLISAO: return "collision";
+        case PARADA_DISTANCIA: return "soi";
+        case PARADA_TEMPO: return "max_time";
+        default: return "early_exit";
+    }
+}
+// ....................................................................................................................
+//      A porcentagem é em relação ao tempo total das threads: a preparação e a finalização (que rodam numa thread só)
+//  mais o tempo dos sweeps vezes o número de threads. A espera é o que sobra dos sweeps depois das fases medidas neles.
+void profile_report(const profile_counters* profile) {
+    static const char* names[PERFIL_FASES] = {"preparação do sweep", "integração", "linhas de saída", "abrir/fechar arquivos", "arquivo global",
+        "barra de progresso", "espera da escrita"};
+    static const char* units[PERFIL_FASES] = {"sweeps", "trajetórias", "linhas", "arquivos", "linhas", "atualizações", "sweeps"};
+    double waiting;
+    double total;
+    int i;
+
+    waiting = profile->thread_seconds;
+    for (i = PERFIL_INTEGRACAO; i <= PERFIL_PROGRESSO; i++) waiting -= profile->seconds[i];
+    if (waiting < 0) waiting = 0.0;
+    total = profile->thread_seconds + profile->seconds[PERFIL_PREPARACAO] + profile->seconds[PERFIL_FINALIZACAO];
+    if (total <= 0) total = 1e-9;
+
+    printf("Perfil da execução: %.3f s de sweep, %.3f s somando as threads.\n", profile->sweep_seconds, profile->thread_seconds);
+    printf("\t %-24s %12s %8s %14s %14s\n", "fase", "tempo [s]", "%", "chamadas", "µs/chamada");
+    for (i = 0; i < PERFIL_FASES; i++) {
+        printf("\t %-24s %12.4f %7.2f%% %14lld %14.3f  (%s)\n", names[i], profile->seconds[i], 100.0 * profile->seconds[i] / total, profile->calls[i],
+            profile->calls[i] > 0 ? 1e6 * profile->seconds[i] / (double) profile->calls[i] : 0.0, units[i]);
+    }
+    printf("\t %-24s %12.4f %7.2f%%\n", "threads esperando", waiting, 100.0 * waiting / total);
+    printf("\t Passos de integração: %lld (%.4e passos/s por thread na fase de integração)\n", profile->steps,
+        profile->seconds[PERFIL_INTEGRACAO] > 0 ? (double) profile->steps / profile->seconds[PERFIL_INTEGRACAO] : 0.0);
+    printf("\t Motivos de parada: %ld collision, %ld soi, %ld max_time, %ld early_exit\n\n", profile->stops[PARADA_COLISAO], profile->stops[PARADA_DISTANCIA],
+        profile->stops[PARADA_TEMPO], profile->stops[PARADA_ANTECIPADA]);
+}
+// ....................................................................................................................
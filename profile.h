@@ -0,0 +1,77 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Perfil da execução (opção --profile), compartilhado pelos dois programas.
+//
+//  O tempo de parede (relógio monotônico) é acumulado por fase. Cada trajetória mede o próprio tempo e o tempo gasto na
+//  saída (output.h mede a abertura, as linhas e o fechamento dos arquivos); a integração é o resto. Os totais só são
+//  atualizados uma vez por trajetória (ou por chamada da barra de progresso), então a trava quase nunca é disputada e o
+//  custo fica em duas leituras do relógio por linha exportada.
+//
+//  Com várias threads, as fases do sweep somam o tempo de todas as threads; o que sobra do tempo do sweep multiplicado
+//  pelo número de threads é o tempo em que as threads estavam esperando (por trabalho, pela trava da barra de progresso
+//  ou por um buffer da escrita assíncrona).
+// ....................................................................................................................
+#ifndef FLY_BY_PROFILE_H
+#define FLY_BY_PROFILE_H
+// ....................................................................................................................
+#include <pthread.h>
+// ....................................................................................................................
+//      Fases medidas.
+#define PERFIL_PREPARACAO 0                             //  Preparação do sweep (estimativa dos custos, lotes, threads de escrita).
+#define PERFIL_INTEGRACAO 1                             //  Integração das trajetórias (e o cálculo dos resultados).
+#define PERFIL_SAIDA 2                                  //  Linhas dos arquivos de trajetória (output_row).
+#define PERFIL_ARQUIVOS 3                               //  Abertura e fechamento dos arquivos de trajetória.
+#define PERFIL_GLOBAL 4                                 //  Linhas do arquivo de dados globais (e o fflush dele).
+#define PERFIL_PROGRESSO 5                              //  Desenho da barra de progresso.
+#define PERFIL_FINALIZACAO 6                            //  Espera pelas threads de escrita no fim do sweep.
+#define PERFIL_FASES 7                                  //  Número de fases.
+
+//      Motivo do fim de uma trajetória (coluna 'stop' do arquivo global).
+#define PARADA_COLISAO 0                                //  A sonda atingiu Marte.
+#define PARADA_DISTANCIA 1                              //  A sonda saiu da esfera de raio stop_value (esfera de influência).
+#define PARADA_TEMPO 2                                  //  O tempo máximo de integração (max_int_time) acabou.
+#define PARADA_ANTECIPADA 3                             //  A hipérbole osculadora convergiu (--early-exit).
+#define PARADA_MOTIVOS 4                                //  Número de motivos.
+// ....................................................................................................................
+//  - Totais de uma execução.
+typedef struct {
+    pthread_mutex_t lock;                               //  Trava das atualizações (várias threads).
+    double seconds[PERFIL_FASES];                       //  Tempo de cada fase, somado entre as threads.
+    long long calls[PERFIL_FASES];                      //  Vezes em que cada fase foi medida (trajetórias, linhas...).
+    double sweep_seconds;                               //  Tempo de parede dos sweeps.
+    double thread_seconds;                              //  Tempo dos sweeps multiplicado pelo número de threads.
+    long long steps;                                    //  Passos de integração de todas as trajetórias.
+    long stops[PARADA_MOTIVOS];                         //  Trajetórias que terminaram por cada motivo.
+} profile_counters;
+// ....................................................................................................................
+//  - Relógio monotônico, em segundos.
+double profile_now(void);
+
+//  - Zera os totais (e inicializa a trava).
+void profile_init(profile_counters* profile);
+
+//  - Acrescenta 'seconds' a uma fase (PERFIL_*), contando 'calls' chamadas.
+void profile_add(profile_counters* profile, int phase, double seconds, long long calls);
+
+//  - Acrescenta uma trajetória concluída.
+//  double wall                             → Tempo de parede da trajetória (ou a parte dela num lote).
+//  double row_seconds                      → Tempo gasto nas linhas da saída (trajectory_output.row_seconds).
+//  double file_seconds                     → Tempo gasto abrindo e fechando a saída (trajectory_output.file_seconds).
+//  long long rows                          → Linhas exportadas.
+//  long long steps                         → Passos de integração.
+//  int stop                                → Motivo do fim da trajetória (PARADA_*).
+void profile_trajectory(profile_counters* profile, double wall, double row_seconds, double file_seconds, long long rows, long long steps, int stop);
+
+//  - Acrescenta o tempo de parede de um sweep com n_threads threads.
+void profile_sweep(profile_counters* profile, double seconds, int n_threads);
+
+//  - Nome do motivo do fim de uma trajetória (collision, soi, max_time ou early_exit).
+const char* profile_stop_name(int stop);
+
+//  - Imprime a tabela com o tempo de cada fase, os passos por segundo e os motivos de parada.
+void profile_report(const profile_counters* profile);
+// ....................................................................................................................
+#endif
@@ -0,0 +1,165 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Comentários para desabilitar algumas funções de análise do CLion:
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ....................................................................................................................
+//      Bibliotecas:
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "profile.h"
+#include "progress.h"
+// ....................................................................................................................
+//      Soma atômica de um double (o C11 só tem atomic_fetch_add para inteiros).
+static void atomic_add_double(_Atomic double* target, const double value) {
+    double current;
+
+    current = atomic_load(target);
+    while (!atomic_compare_exchange_weak(target, &current, current + value));
+}
+// ....................................................................................................................
+//      Fração concluída (pelo custo) e tempo restante estimado. Sem nenhum job concluído não há ETA (retorna -1).
+static double estimate_remaining(const progress_state* progress, const double elapsed, double* fraction) {
+    const double done = atomic_load(&progress->cost_done);
+
+    *fraction = progress->total_cost > 0 ? done / progress->total_cost : 1.0;
+    if (*fraction > 1.0) *fraction = 1.0;
+    if (done <= 0) return -1.0;
+    return elapsed * (progress->total_cost - done) / done;
+}
+// ....................................................................................................................
+int progress_mode(const char* name) {
+    if (strcmp(name, "auto") == 0) return PROGRESSO_AUTO;
+    if (strcmp(name, "bar") == 0) return PROGRESSO_BARRA;
+    if (strcmp(name, "json") == 0) return PROGRESSO_JSON;
+    if (strcmp(name, "none") == 0) return PROGRESSO_DESLIGADO;
+    return -1;
+}
+// ....................................................................................................................
+void progress_begin(progress_state* progress, const int mode, const double interval, const int n_jobs, const int n_tests, const double total_cost) {
+    progress->mode = mode;
+    if (mode == PROGRESSO_AUTO) progress->mode = isatty(STDOUT_FILENO) ? PROGRESSO_BARRA : PROGRESSO_JSON;
+    progress->interval = interval > 0 ? interval : (progress->mode == PROGRESSO_JSON ? PROGRESSO_INTERVALO_JSON : PROGRESSO_INTERVALO_BARRA);
+    progress->n_jobs = n_jobs;
+    progress->n_tests = n_tests;
+    progress->total_cost = total_cost;
+    progress->begin = profile_now();
+    atomic_init(&progress->jobs_done, 0);
+    atomic_init(&progress->tests_done, 0);
+    atomic_init(&progress->cost_done, 0.0);
+    atomic_init(&progress->active, 0);
+    atomic_init(&progress->next_draw, progress->begin);
+}
+// ....................................................................................................................
+void progress_job_start(progress_state* progress) {
+    atomic_fetch_add(&progress->active, 1);
+}
+// ....................................................................................................................
+void progress_job_end(progress_state* progress, const double cost, const int n_tests) {
+    atomic_add_double(&progress->cost_done, cost);
+    atomic_fetch_add(&progress->tests_done, n_tests);
+    atomic_fetch_add(&progress->jobs_done, 1);
+    atomic_fetch_sub(&progress->active, 1);
+}
+// ....................................................................................................................
+//      Um registro JSON por linha: testes concluídos, fração (pelo custo), tempo, taxa em testes por segundo, ETA (null
+//  antes do primeiro job) e threads ativas.
+static void write_record(const progress_state* progress, const double elapsed, const int queue) {
+    const int tests_done = atomic_load(&progress->tests_done);
+    double fraction;
+    double remaining;
+
+    remaining = estimate_remaining(progress, elapsed, &fraction);
+    printf("{\"done\":%d,\"total\":%d,\"jobs_done\":%d,\"jobs\":%d,\"progress\":%.6f,\"elapsed\":%.3f,\"rate\":%.6e,", tests_done, progress->n_tests,
+        atomic_load(&progress->jobs_done), progress->n_jobs, fraction, elapsed, elapsed > 0 ? tests_done / elapsed : 0.0);
+    if (remaining < 0) printf("\"eta\":null,");
+    else printf("\"eta\":%.3f,", remaining);
+    printf("\"active\":%d", atomic_load(&progress->active));
+    if (queue >= 0) printf(",\"write_queue\":%d", queue);
+    printf("}\n");
+}
+// ....................................................................................................................
+//      Barrinha de progresso (modo avançado com ETA) =D
+//  Só desenha se o intervalo já passou; o compare-exchange garante que duas chamadas simultâneas não desenhem juntas.
+int progress_report(progress_state* progress, const int queue) {
+    const double now = profile_now();
+    const double elapsed = now - progress->begin;
+    char elapsed_str[50];
+    char remaining_str[50];
+    double fraction;
+    double remaining;
+    double next;
+    int j;
+
+    if (progress->mode == PROGRESSO_DESLIGADO) return 0;
+    next = atomic_load(&progress->next_draw);
+    if (now < next || !atomic_compare_exchange_strong(&progress->next_draw, &next, now + progress->interval)) return 0;
+
+    if (progress->mode == PROGRESSO_JSON) {
+        write_record(progress, elapsed, queue);
+        fflush(stdout);
+        return 1;
+    }
+
+    remaining = estimate_remaining(progress, elapsed, &fraction);
+    format_time(elapsed, elapsed_str);
+    if (remaining < 0) strcpy(remaining_str, "?");
+    else format_time(remaining, remaining_str);
+
+    printf("\r");       //  Limpa
+    for (j = 0; j < 220; j++) printf(" ");
+
+    printf("\r[");
+    for (j = 0; j < 100; j++) printf(100 * fraction >= j ? "#" : " ");
+    printf("] %.2lf%%, Elapsed: %s, ETA: %s", 100 * fraction, elapsed_str, remaining_str);
+    if (queue >= 0) printf(", Fila de escrita: %d", queue);
+
+    fflush(stdout);     //  Força a impressão =V
+    return 1;
+}
+// ....................................................................................................................
+void progress_end(progress_state* progress, const int interrupted) {
+    const double elapsed = profile_now() - progress->begin;
+    char elapsed_str[50];
+    int i;
+
+    format_time(elapsed, elapsed_str);
+    if (progress->mode == PROGRESSO_BARRA) {
+        printf("\r");       //  Limpa
+        for (i = 0; i < 220; i++) printf(" ");
+        printf("\r");
+    } else if (progress->mode == PROGRESSO_JSON) write_record(progress, elapsed, -1);
+
+    if (interrupted) printf("Interrompido depois de %d de %d testes, em %s.", atomic_load(&progress->tests_done), progress->n_tests, elapsed_str);
+    else if (progress->mode == PROGRESSO_BARRA) {
+        printf("[");
+        for (i = 0; i < 100; i++) printf("#");
+        printf("] 100.00%%, Total time: %s", elapsed_str);
+    } else printf("Total time: %s", elapsed_str);
+    fflush(stdout);
+}
+// ....................................................................................................................
+//      ** Função para mostrar o tempo no ETA em segundos, minutos, etc.
+void format_time(const double seconds, char *buffer) {
+    const int sec = (int) seconds;
+    if (sec < 60) {
+        sprintf(buffer, "%d segundos", sec);
+    } else if (sec < 3600) {
+        const int m = sec / 60;
+        const int s = sec % 60;
+        sprintf(buffer, "%d minutos e %d segundos", m, s);
+    } else if (sec < 86400) {
+        const int h = sec / 3600;
+        const int m = (sec % 3600) / 60;
+        sprintf(buffer, "%d horas e %d minutos", h, m);
+    } else {
+        const int d = sec / 86400;
+        const int h = (sec % 86400) / 3600;
+        sprintf(buffer, "%d dias e %d horas", d, h);
+    }
+}
+// ....................................................................................................................
@@ -0,0 +1,73 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Progresso de um sweep (barra com ETA, ou registros JSON), compartilhado pelos dois programas.
+//
+//  O tempo é o de parede (relógio monotônico, profile_now), não o de CPU: com várias threads o clock() soma o tempo de
+//  todas elas. As threads do sweep atualizam os contadores com operações atômicas, sem trava, e só uma chamada a cada
+//  'interval' segundos desenha alguma coisa, então o custo por trajetória fica em poucas operações atômicas.
+//
+//  O ETA é ponderado pelo custo estimado de cada job (o mesmo que o sweep.c usa para ordenar os testes): como as
+//  trajetórias mais caras começam primeiro, contar apenas os testes concluídos subestimaria bastante o tempo restante.
+// ....................................................................................................................
+#ifndef FLY_BY_PROGRESS_H
+#define FLY_BY_PROGRESS_H
+// ....................................................................................................................
+#include <stdatomic.h>
+// ....................................................................................................................
+//      Formatos do progresso (--progress).
+#define PROGRESSO_AUTO 0                                //  Barra num terminal, JSON quando a saída é um arquivo ou um pipe.
+#define PROGRESSO_BARRA 1                               //  Barra redesenhada na mesma linha, com ETA.
+#define PROGRESSO_JSON 2                                //  Um objeto JSON por linha.
+#define PROGRESSO_DESLIGADO 3                           //  Nada durante o sweep (apenas o resumo no fim).
+
+#define PROGRESSO_INTERVALO_BARRA 0.25                  //  Intervalo padrão entre dois desenhos da barra, em segundos.
+#define PROGRESSO_INTERVALO_JSON 5.0                    //  Intervalo padrão entre dois registros JSON, em segundos.
+// ....................................................................................................................
+//  - Estado do progresso de um sweep.
+typedef struct {
+    int mode;                                           //  Formato (PROGRESSO_BARRA, PROGRESSO_JSON ou PROGRESSO_DESLIGADO).
+    double interval;                                    //  Intervalo mínimo entre dois desenhos, em segundos.
+    int n_jobs;                                         //  Número de jobs do sweep.
+    int n_tests;                                        //  Número de testes do sweep (maior que n_jobs com lotes).
+    double total_cost;                                  //  Soma dos custos estimados dos jobs.
+    double begin;                                       //  Início do sweep (profile_now).
+    atomic_int jobs_done;                               //  Jobs concluídos.
+    atomic_int tests_done;                              //  Testes concluídos.
+    _Atomic double cost_done;                           //  Custo dos jobs concluídos.
+    atomic_int active;                                  //  Threads integrando um job neste momento.
+    _Atomic double next_draw;                           //  Momento a partir do qual o próximo desenho é permitido.
+} progress_state;
+// ....................................................................................................................
+//  - Converte o nome de um formato (auto, bar, json ou none) em PROGRESSO_*. Retorna -1 para um nome desconhecido.
+int progress_mode(const char* name);
+
+//  - Prepara o progresso de um sweep e marca o seu início.
+//  int mode                                → Formato (PROGRESSO_*). PROGRESSO_AUTO escolhe pelo isatty da saída.
+//  double interval                         → Intervalo entre dois desenhos, em segundos (0 para o padrão do formato).
+//  int n_jobs                              → Número de jobs do sweep.
+//  int n_tests                             → Número de testes do sweep.
+//  double total_cost                       → Soma dos custos estimados dos jobs (a mesma unidade do progress_job_end).
+void progress_begin(progress_state* progress, int mode, double interval, int n_jobs, int n_tests, double total_cost);
+
+//  - Chamadas pelas threads do sweep no começo e no fim de um job (sem trava). O fim recebe o custo estimado do job e
+//  o número de testes dele.
+void progress_job_start(progress_state* progress);
+void progress_job_end(progress_state* progress, double cost, int n_tests);
+
+//  - Desenha a barra (ou escreve um registro JSON) se o intervalo desde o último desenho já passou.
+//  int queue                               → Buffers na fila da escrita assíncrona (negativo quando não há fila).
+//
+//  * Retorna 1 se algo foi desenhado.
+int progress_report(progress_state* progress, int queue);
+
+//  - Resumo do fim do sweep: a barra completa (ou o registro JSON final) e o tempo total, ou o aviso de interrupção.
+//  int interrupted                         → 1 se o sweep foi interrompido antes de todos os testes.
+void progress_end(progress_state* progress, int interrupted);
+
+//  - Converte um tempo em segundos numa “string” legível (segundos, minutos, horas ou dias).
+void format_time(double seconds, char *buffer);
+// ....................................................................................................................
+#endif
@@ -0,0 +1,709 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Comentários para desabilitar algumas funções de análise do CLion:
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ....................................................................................................................
+//      Bibliotecas:
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "reducers.h"
+// ....................................................................................................................
+#define REDUTOR_VERSAO 1                                //  Versão do arquivo de estado.
+#define REDUTOR_LINHA 512                               //  Tamanho máximo de uma linha do arquivo de estado.
+#define Z_95 1.959963984540054                          //  Quantil de 97,5% da normal (intervalo de 95%).
+// ....................................................................................................................
+//      Funções auxiliares (aqui temos um "mini-header" dentro do arquivo *.c)
+//  - Move a janela das caixas para incluir os índices [low, high] (juntando as caixas dos menores módulos, se preciso).
+//  A janela fica sempre em max(min_index, max_index - REDUTOR_CAIXAS_QUANTIS + 1), então o estado final não depende da
+//  ordem dos valores.
+static void bins_extend(reducer_bins* bins, int low, int high);
+
+//  - Acrescenta um valor de índice 'index' às caixas.
+static void bins_add(reducer_bins* bins, int index);
+
+//  - Soma as caixas de 'other' às de 'bins' (as contagens, como se os valores fossem acrescentados um a um).
+static void bins_merge(reducer_bins* bins, const reducer_bins* other);
+
+//  - Índice da caixa de um módulo positivo, e o valor que representa uma caixa (com erro relativo de no máximo α para
+//  todos os módulos dela).
+static int bins_index(double magnitude);
+static double bins_value(int index);
+
+//  - Caixas lineares: expoente das caixas para os valores em [min, max], mudança de expoente e de base (juntando as
+//  caixas), inclusão de um valor e soma de dois conjuntos de caixas.
+static int linear_exponent(double min, double max);
+static void linear_extend(reducer_linear* linear, double min, double max);
+static void linear_add(reducer_linear* linear, double x);
+static void linear_merge(reducer_linear* linear, const reducer_linear* other);
+
+//  - floor(i / 2^shift), para índices negativos também.
+static long long floor_shift(long long i, int shift);
+
+//  - Soma dois reducer_stats.
+static void stats_merge(reducer_stats* stats, const reducer_stats* other);
+
+//  - Escreve e lê um sinal do esboço: a janela (linha "bins <quantidade> <sinal> ...") e as caixas não vazias (uma
+//  linha "bin" para cada).
+static void bins_save(FILE* fo, int quantity, char sign, const reducer_bins* bins);
+static int bins_load(reducer_sketch* sketch, const char* line);
+
+//  - Escreve e lê as caixas lineares do esboço: o expoente, a base e os extremos (linha "linear <quantidade> ...") e
+//  as caixas não vazias (uma linha "lbin" para cada).
+static void linear_save(FILE* fo, int quantity, const reducer_linear* linear);
+static int linear_load(reducer_linear* linear, const char* line);
+
+//  - Quantil p do indicador de colisão (exato: os testes sem colisão vêm primeiro no ranking).
+static int indicator_quantile(const reducer_set* set, double p);
+
+//  - Caixa do rastreador da fronteira de um valor de b (os valores de fora vão para as pontas).
+static int boundary_cell(const reducer_boundary* boundary, double b);
+
+//  - Escreve os intervalos da fronteira da colisão. Retorna o número de mudanças encontradas.
+static int boundary_write(FILE* fo, const reducer_boundary* boundary);
+// ....................................................................................................................
+int reducers_init(reducer_set* set, const int n_quantities, const char* const* names, const int histogram_quantity, const double b_min,
+    const double b_max, const double y_min, const double y_max) {
+    int k;
+
+    if (n_quantities < 1 || n_quantities > REDUTOR_MAX_QUANTIDADES || histogram_quantity < 0 || histogram_quantity >= n_quantities) return -1;
+    if (!(b_max >= b_min) || !(y_max > y_min)) return -1;
+
+    memset(set, 0, sizeof(reducer_set));
+    for (k = 0; k < n_quantities; k++) {
+        if (strlen(names[k]) >= REDUTOR_NOME) return -1;
+        strcpy(set->names[k], names[k]);
+    }
+    set->n_quantities = n_quantities;
+    set->histogram_quantity = histogram_quantity;
+
+    //  Um intervalo de b com um único valor (um único teste, ou --tests 1) ganha uma largura mínima, para as caixas
+    //  terem tamanho.
+    set->histogram.x_min = b_min;
+    set->histogram.x_max = b_max > b_min ? b_max : b_min + (fabs(b_min) > 0 ? 1e-9 * fabs(b_min) : 1.0);
+    set->histogram.y_min = y_min;
+    set->histogram.y_max = y_max;
+    set->boundary.x_min = set->histogram.x_min;
+    set->boundary.x_max = set->histogram.x_max;
+    return 0;
+}
+// ....................................................................................................................
+void reducers_add(reducer_set* set, const double b, const int collision, const double* values) {
+    reducer_stats* stats;
+    reducer_sketch* sketch;
+    reducer_histogram* histogram = &set->histogram;
+    reducer_boundary* boundary = &set->boundary;
+    double delta;
+    double x;
+    int cell;
+    int i;
+    int j;
+    int k;
+
+    set->samples++;
+    if (collision) set->collisions++;
+
+    for (k = 0; k < set->n_quantities; k++) {
+        x = values[k];
+        if (!isfinite(x)) continue;
+
+        stats = &set->stats[k];
+        stats->n++;
+        delta = x - stats->mean;
+        stats->mean += delta / stats->n;
+        stats->m2 += delta * (x - stats->mean);
+        if (stats->n == 1 || x < stats->min) stats->min = x;
+        if (stats->n == 1 || x > stats->max) stats->max = x;
+
+        sketch = &set->sketches[k];
+        if (x > 0) bins_add(&sketch->positive, bins_index(x));
+        else if (x < 0) bins_add(&sketch->negative, bins_index(-x));
+        else sketch->zeros++;
+        linear_add(&sketch->linear, x);
+    }
+
+    //  - Histograma: o intervalo é fechado à direita, para o último valor de b (b_max) cair na última caixa.
+    x = values[set->histogram_quantity];
+    if (isfinite(x)) {
+        if (b < histogram->x_min || b > histogram->x_max || x < histogram->y_min || x > histogram->y_max) histogram->outside++;
+        else {
+            i = (int) ((b - histogram->x_min) / (histogram->x_max - histogram->x_min) * REDUTOR_HISTOGRAMA_B);
+            j = (int) ((x - histogram->y_min) / (histogram->y_max - histogram->y_min) * REDUTOR_HISTOGRAMA_Y);
+            if (i >= REDUTOR_HISTOGRAMA_B) i = REDUTOR_HISTOGRAMA_B - 1;
+            if (j >= REDUTOR_HISTOGRAMA_Y) j = REDUTOR_HISTOGRAMA_Y - 1;
+            histogram->counts[i][j]++;
+        }
+    }
+
+    //  - Fronteira da colisão.
+    cell = boundary_cell(boundary, b);
+    if (collision) {
+        if (boundary->hits[cell] == 0 || b < boundary->hit_min[cell]) boundary->hit_min[cell] = b;
+        if (boundary->hits[cell] == 0 || b > boundary->hit_max[cell]) boundary->hit_max[cell] = b;
+        boundary->hits[cell]++;
+    } else {
+        if (boundary->misses[cell] == 0 || b < boundary->miss_min[cell]) boundary->miss_min[cell] = b;
+        if (boundary->misses[cell] == 0 || b > boundary->miss_max[cell]) boundary->miss_max[cell] = b;
+        boundary->misses[cell]++;
+    }
+}
+// ....................................................................................................................
+int reducers_merge(reducer_set* set, const reducer_set* other) {
+    reducer_boundary* boundary = &set->boundary;
+    const reducer_boundary* source = &other->boundary;
+    int i;
+    int j;
+    int k;
+
+    if (set->n_quantities != other->n_quantities || set->histogram_quantity != other->histogram_quantity) return -1;
+    for (k = 0; k < set->n_quantities; k++) if (strcmp(set->names[k], other->names[k]) != 0) return -1;
+    if (set->histogram.x_min != other->histogram.x_min || set->histogram.x_max != other->histogram.x_max || set->histogram.y_min != other->histogram.y_min ||
+        set->histogram.y_max != other->histogram.y_max) return -1;
+
+    set->samples += other->samples;
+    set->collisions += other->collisions;
+    for (k = 0; k < set->n_quantities; k++) {
+        stats_merge(&set->stats[k], &other->stats[k]);
+        bins_merge(&set->sketches[k].positive, &other->sketches[k].positive);
+        bins_merge(&set->sketches[k].negative, &other->sketches[k].negative);
+        set->sketches[k].zeros += other->sketches[k].zeros;
+        linear_merge(&set->sketches[k].linear, &other->sketches[k].linear);
+    }
+
+    set->histogram.outside += other->histogram.outside;
+    for (i = 0; i < REDUTOR_HISTOGRAMA_B; i++) for (j = 0; j < REDUTOR_HISTOGRAMA_Y; j++) set->histogram.counts[i][j] += other->histogram.counts[i][j];
+
+    for (i = 0; i < REDUTOR_CAIXAS_FRONTEIRA; i++) {
+        if (source->hits[i] > 0) {
+            if (boundary->hits[i] == 0 || source->hit_min[i] < boundary->hit_min[i]) boundary->hit_min[i] = source->hit_min[i];
+            if (boundary->hits[i] == 0 || source->hit_max[i] > boundary->hit_max[i]) boundary->hit_max[i] = source->hit_max[i];
+            boundary->hits[i] += source->hits[i];
+        }
+        if (source->misses[i] > 0) {
+            if (boundary->misses[i] == 0 || source->miss_min[i] < boundary->miss_min[i]) boundary->miss_min[i] = source->miss_min[i];
+            if (boundary->misses[i] == 0 || source->miss_max[i] > boundary->miss_max[i]) boundary->miss_max[i] = source->miss_max[i];
+            boundary->misses[i] += source->misses[i];
+        }
+    }
+    return 0;
+}
+// ....................................................................................................................
+//      O quantil p é o valor de posição p (n - 1) no ranking (a mesma convenção da interpolação linear, sem a
+//  interpolação). Nas caixas logarítmicas, o ranking começa nos negativos de maior módulo, passa pelos zeros e termina
+//  nos positivos de maior módulo, e o erro máximo é α vezes o valor; nas lineares, o erro máximo é meia caixa. O valor
+//  escolhido é limitado ao mínimo e ao máximo exatos.
+double reducers_quantile(const reducer_set* set, const int quantity, const double p) {
+    const reducer_stats* stats = &set->stats[quantity];
+    const reducer_sketch* sketch = &set->sketches[quantity];
+    const reducer_linear* linear = &sketch->linear;
+    const reducer_bins* bins;
+    long long rank;
+    long long seen;
+    double value;
+    int i;
+
+    if (stats->n == 0) return 0.0;
+    rank = (long long) floor(p * (double) (stats->n - 1));
+    if (rank < 0) rank = 0;
+    if (rank > stats->n - 1) rank = stats->n - 1;
+
+    value = stats->max;
+    seen = 0;
+    bins = &sketch->negative;
+    for (i = REDUTOR_CAIXAS_QUANTIS - 1; i >= 0 && bins->total > 0; i--) {
+        seen += bins->counts[i];
+        if (seen > rank) {
+            value = - bins_value(bins->offset + i);
+            break;
+        }
+    }
+    if (seen <= rank) {
+        seen += sketch->zeros;
+        if (seen > rank) value = 0.0;
+    }
+    bins = &sketch->positive;
+    for (i = 0; seen <= rank && i < REDUTOR_CAIXAS_QUANTIS && bins->total > 0; i++) {
+        seen += bins->counts[i];
+        if (seen > rank) value = bins_value(bins->offset + i);
+    }
+
+    seen = 0;
+    for (i = 0; i < REDUTOR_CAIXAS_LINEARES; i++) {
+        seen += linear->counts[i];
+        if (seen > rank) break;
+    }
+    if (i < REDUTOR_CAIXAS_LINEARES && ldexp(0.5, linear->exponent) < REDUTOR_ERRO_RELATIVO * fabs(value))
+        value = ldexp((double) (linear->base + i) + 0.5, linear->exponent);
+
+    if (value < stats->min) value = stats->min;
+    if (value > stats->max) value = stats->max;
+    return value;
+}
+// ....................................................................................................................
+int reducers_save(const reducer_set* set, const char* path) {
+    const reducer_histogram* histogram = &set->histogram;
+    const reducer_boundary* boundary = &set->boundary;
+    const reducer_stats* stats;
+    int status;
+    int i;
+    int j;
+    int k;
+    FILE* fo;
+
+    fo = fopen(path, "w");
+    if (fo == NULL) return 1;
+
+    //  Os reais são escritos em hexadecimal (%a), que volta exatamente para o mesmo número no strtod.
+    fprintf(fo, "flyby-reducers %d\n", REDUTOR_VERSAO);
+    fprintf(fo, "set %d %d %lld %lld\n", set->n_quantities, set->histogram_quantity, set->samples, set->collisions);
+    for (k = 0; k < set->n_quantities; k++) {
+        stats = &set->stats[k];
+        fprintf(fo, "quantity %d %s %lld %a %a %a %a %lld\n", k, set->names[k], stats->n, stats->mean, stats->m2, stats->min, stats->max,
+            set->sketches[k].zeros);
+        bins_save(fo, k, '+', &set->sketches[k].positive);
+        bins_save(fo, k, '-', &set->sketches[k].negative);
+        linear_save(fo, k, &set->sketches[k].linear);
+    }
+    fprintf(fo, "histogram %d %d %a %a %a %a %lld\n", REDUTOR_HISTOGRAMA_B, REDUTOR_HISTOGRAMA_Y, histogram->x_min, histogram->x_max, histogram->y_min,
+        histogram->y_max, histogram->outside);
+    for (i = 0; i < REDUTOR_HISTOGRAMA_B; i++) for (j = 0; j < REDUTOR_HISTOGRAMA_Y; j++)
+        if (histogram->counts[i][j] > 0) fprintf(fo, "cell %d %d %lld\n", i, j, histogram->counts[i][j]);
+    fprintf(fo, "boundary %d %a %a\n", REDUTOR_CAIXAS_FRONTEIRA, boundary->x_min, boundary->x_max);
+    for (i = 0; i < REDUTOR_CAIXAS_FRONTEIRA; i++) {
+        if (boundary->hits[i] == 0 && boundary->misses[i] == 0) continue;
+        fprintf(fo, "edge %d %lld %a %a %lld %a %a\n", i, boundary->hits[i], boundary->hit_min[i], boundary->hit_max[i], boundary->misses[i],
+            boundary->miss_min[i], boundary->miss_max[i]);
+    }
+    fprintf(fo, "end\n");
+
+    status = ferror(fo) != 0;
+    if (fclose(fo) != 0) status = 1;
+    return status;
+}
+// ....................................................................................................................
+//      Cada linha começa por uma palavra-chave; a primeira precisa ser a versão e a última, "end" (um arquivo cortado
+//  no meio não é aceito).
+int reducers_load(reducer_set* set, const char* path) {
+    char line[REDUTOR_LINHA];
+    char name[REDUTOR_LINHA];
+    char text[7][64];
+    reducer_stats* stats;
+    long long counts[2];
+    int values[3];
+    int number;
+    int error;
+    int ended;
+    FILE* fi;
+
+    fi = fopen(path, "r");
+    if (fi == NULL) return -1;
+
+    memset(set, 0, sizeof(reducer_set));
+    error = 0;
+    ended = 0;
+    for (number = 1; !error && !ended && fgets(line, sizeof(line), fi) != NULL; number++) {
+        if (number == 1) {
+            if (sscanf(line, "flyby-reducers %d", &values[0]) != 1 || values[0] != REDUTOR_VERSAO) error = number;
+        } else if (strncmp(line, "set ", 4) == 0) {
+            if (sscanf(line, "set %d %d %lld %lld", &set->n_quantities, &set->histogram_quantity, &set->samples, &set->collisions) != 4 ||
+                set->n_quantities < 1 || set->n_quantities > REDUTOR_MAX_QUANTIDADES || set->histogram_quantity < 0 ||
+                set->histogram_quantity >= set->n_quantities) error = number;
+        } else if (strncmp(line, "quantity ", 9) == 0) {
+            if (sscanf(line, "quantity %d %511s %lld %63s %63s %63s %63s %lld", &values[0], name, &counts[0], text[0], text[1], text[2], text[3],
+                    &counts[1]) != 8 || values[0] < 0 || values[0] >= set->n_quantities || strlen(name) >= REDUTOR_NOME) error = number;
+            else {
+                strcpy(set->names[values[0]], name);
+                stats = &set->stats[values[0]];
+                stats->n = counts[0];
+                stats->mean = strtod(text[0], NULL);
+                stats->m2 = strtod(text[1], NULL);
+                stats->min = strtod(text[2], NULL);
+                stats->max = strtod(text[3], NULL);
+                set->sketches[values[0]].zeros = counts[1];
+            }
+        } else if (strncmp(line, "bins ", 5) == 0 || strncmp(line, "bin ", 4) == 0) {
+            if (sscanf(line, "%*s %d", &values[0]) != 1 || values[0] < 0 || values[0] >= set->n_quantities) error = number;
+            else if (bins_load(&set->sketches[values[0]], line) != 0) error = number;
+        } else if (strncmp(line, "linear ", 7) == 0 || strncmp(line, "lbin ", 5) == 0) {
+            if (sscanf(line, "%*s %d", &values[0]) != 1 || values[0] < 0 || values[0] >= set->n_quantities) error = number;
+            else if (linear_load(&set->sketches[values[0]].linear, line) != 0) error = number;
+        } else if (strncmp(line, "histogram ", 10) == 0) {
+            if (sscanf(line, "histogram %d %d %63s %63s %63s %63s %lld", &values[0], &values[1], text[0], text[1], text[2], text[3],
+                    &set->histogram.outside) != 7 || values[0] != REDUTOR_HISTOGRAMA_B || values[1] != REDUTOR_HISTOGRAMA_Y) error = number;
+            else {
+                set->histogram.x_min = strtod(text[0], NULL);
+                set->histogram.x_max = strtod(text[1], NULL);
+                set->histogram.y_min = strtod(text[2], NULL);
+                set->histogram.y_max = strtod(text[3], NULL);
+            }
+        } else if (strncmp(line, "cell ", 5) == 0) {
+            if (sscanf(line, "cell %d %d %lld", &values[0], &values[1], &counts[0]) != 3 || values[0] < 0 || values[0] >= REDUTOR_HISTOGRAMA_B ||
+                values[1] < 0 || values[1] >= REDUTOR_HISTOGRAMA_Y) error = number;
+            else set->histogram.counts[values[0]][values[1]] = counts[0];
+        } else if (strncmp(line, "boundary ", 9) == 0) {
+            if (sscanf(line, "boundary %d %63s %63s", &values[0], text[0], text[1]) != 3 || values[0] != REDUTOR_CAIXAS_FRONTEIRA) error = number;
+            else {
+                set->boundary.x_min = strtod(text[0], NULL);
+                set->boundary.x_max = strtod(text[1], NULL);
+            }
+        } else if (strncmp(line, "edge ", 5) == 0) {
+            if (sscanf(line, "edge %d %lld %63s %63s %lld %63s %63s", &values[0], &counts[0], text[0], text[1], &counts[1], text[2], text[3]) != 7 ||
+                values[0] < 0 || values[0] >= REDUTOR_CAIXAS_FRONTEIRA) error = number;
+            else {
+                set->boundary.hits[values[0]] = counts[0];
+                set->boundary.hit_min[values[0]] = strtod(text[0], NULL);
+                set->boundary.hit_max[values[0]] = strtod(text[1], NULL);
+                set->boundary.misses[values[0]] = counts[1];
+                set->boundary.miss_min[values[0]] = strtod(text[2], NULL);
+                set->boundary.miss_max[values[0]] = strtod(text[3], NULL);
+            }
+        } else if (strcmp(line, "end\n") == 0 || strcmp(line, "end") == 0) ended = 1;
+        else error = number;
+    }
+    if (!error && (!ended || set->n_quantities == 0)) error = number;
+
+    fclose(fi);
+    return error;
+}
+// ....................................................................................................................
+int reducers_write(const reducer_set* set, const char* directory, const char* program) {
+    const reducer_histogram* histogram = &set->histogram;
+    const double x_width = (histogram->x_max - histogram->x_min) / REDUTOR_HISTOGRAMA_B;
+    const double y_width = (histogram->y_max - histogram->y_min) / REDUTOR_HISTOGRAMA_Y;
+    const reducer_stats* stats;
+    const long long n = set->samples;
+    char filename[300];
+    double p;
+    double center;
+    double half;
+    int changes;
+    int status;
+    int i;
+    int j;
+    int k;
+    FILE* fo;
+
+    //  - Resumo. A colisão entra como a média de um indicador, com o desvio padrão amostral dele.
+    sprintf(filename, "%s/reduce_%s.csv", directory, program);
+    fo = fopen(filename, "w");
+    if (fo == NULL) return 1;
+    p = n > 0 ? (double) set->collisions / n : 0.0;
+    fprintf(fo, "quantity,n,mean,std,min,p05,p50,p95,max\n");
+    fprintf(fo, "collision,%lld,%.15e,%.15e,%d,%d,%d,%d,%d\n", n, p, n > 1 ? sqrt(p * (1 - p) * n / (n - 1)) : 0.0, indicator_quantile(set, 0.0),
+        indicator_quantile(set, 0.05), indicator_quantile(set, 0.5), indicator_quantile(set, 0.95), indicator_quantile(set, 1.0));
+    for (k = 0; k < set->n_quantities; k++) {
+        stats = &set->stats[k];
+        fprintf(fo, "%s,%lld,%.15e,%.15e,%.15e,%.15e,%.15e,%.15e,%.15e\n", set->names[k], stats->n, stats->mean,
+            stats->n > 1 ? sqrt(stats->m2 / (stats->n - 1)) : 0.0, stats->min, reducers_quantile(set, k, 0.05), reducers_quantile(set, k, 0.5),
+            reducers_quantile(set, k, 0.95), stats->max);
+    }
+    status = fclose(fo) != 0;
+
+    //  - Histograma: uma linha por célula (inclusive as vazias), com b variando mais devagar.
+    sprintf(filename, "%s/histogram_%s.csv", directory, program);
+    fo = fopen(filename, "w");
+    if (fo == NULL) return 1;
+    fprintf(fo, "b_low,b_high,%s_low,%s_high,count\n", set->names[set->histogram_quantity], set->names[set->histogram_quantity]);
+    for (i = 0; i < REDUTOR_HISTOGRAMA_B; i++) for (j = 0; j < REDUTOR_HISTOGRAMA_Y; j++)
+        fprintf(fo, "%.15e,%.15e,%.15e,%.15e,%lld\n", histogram->x_min + i * x_width, histogram->x_min + (i + 1) * x_width,
+            histogram->y_min + j * y_width, histogram->y_min + (j + 1) * y_width, histogram->counts[i][j]);
+    if (fclose(fo) != 0) status = 1;
+
+    //  - Fronteira da colisão.
+    sprintf(filename, "%s/boundary_%s.csv", directory, program);
+    fo = fopen(filename, "w");
+    if (fo == NULL) return 1;
+    changes = boundary_write(fo, &set->boundary);
+    if (fclose(fo) != 0) status = 1;
+
+    //  - Estado, para combinar com outras execuções.
+    sprintf(filename, "%s/reducers_%s.txt", directory, program);
+    if (reducers_save(set, filename) != 0) status = 1;
+
+    //  - Resumo na tela (o intervalo da probabilidade é o de Wilson, que continua válido com p perto de 0 ou de 1).
+    center = n > 0 ? (p + Z_95 * Z_95 / (2.0 * n)) / (1 + Z_95 * Z_95 / n) : 0.0;
+    half = n > 0 ? Z_95 / (1 + Z_95 * Z_95 / n) * sqrt(p * (1 - p) / n + Z_95 * Z_95 / (4.0 * n * n)) : 0.0;
+    printf("\nRedutores com %lld testes:\n", n);
+    printf("\t Probabilidade de colisão: %.6f ± %.6f (intervalo de 95%%: [%.6f; %.6f])\n", p, n > 0 ? sqrt(p * (1 - p) / n) : 0.0, center - half,
+        center + half);
+    for (k = 0; k < set->n_quantities; k++) {
+        stats = &set->stats[k];
+        printf("\t %s (%lld testes): média %.6e, desvio padrão %.6e, p05 %.6e, mediana %.6e, p95 %.6e\n", set->names[k], stats->n, stats->mean,
+            stats->n > 1 ? sqrt(stats->m2 / (stats->n - 1)) : 0.0, reducers_quantile(set, k, 0.05), reducers_quantile(set, k, 0.5),
+            reducers_quantile(set, k, 0.95));
+    }
+    printf("\t Mudanças do indicador de colisão em b: %d; fora do histograma: %lld testes.\n", changes, histogram->outside);
+    printf("Os resultados dos redutores foram salvos em: '%s/{reduce,histogram,boundary,reducers}_%s.*'\n\n", directory, program);
+    return status;
+}
+// ....................................................................................................................
+static int bins_index(const double magnitude) {
+    static const double log_gamma = 0.020000666706669;  //  ln((1 + α) / (1 - α)) para α = 0.01.
+
+    return (int) ceil(log(magnitude) / log_gamma);
+}
+// ....................................................................................................................
+static double bins_value(const int index) {
+    const double gamma = (1 + REDUTOR_ERRO_RELATIVO) / (1 - REDUTOR_ERRO_RELATIVO);
+
+    return 2.0 * pow(gamma, index) / (gamma + 1);
+}
+// ....................................................................................................................
+static void bins_extend(reducer_bins* bins, const int low, const int high) {
+    reducer_bins moved;
+    int min_index;
+    int max_index;
+    int offset;
+    int target;
+    int i;
+
+    min_index = bins->total > 0 && bins->min_index < low ? bins->min_index : low;
+    max_index = bins->total > 0 && bins->max_index > high ? bins->max_index : high;
+    offset = max_index - REDUTOR_CAIXAS_QUANTIS + 1 > min_index ? max_index - REDUTOR_CAIXAS_QUANTIS + 1 : min_index;
+
+    //  A janela só anda quando o intervalo dos índices muda; as caixas que saem por baixo vão para a primeira.
+    if (bins->total > 0 && offset != bins->offset) {
+        memset(moved.counts, 0, sizeof(moved.counts));
+        for (i = 0; i < REDUTOR_CAIXAS_QUANTIS; i++) {
+            if (bins->counts[i] == 0) continue;
+            target = bins->offset + i > offset ? bins->offset + i - offset : 0;
+            moved.counts[target] += bins->counts[i];
+        }
+        memcpy(bins->counts, moved.counts, sizeof(moved.counts));
+    }
+
+    bins->offset = offset;
+    bins->min_index = min_index;
+    bins->max_index = max_index;
+}
+// ....................................................................................................................
+static void bins_add(reducer_bins* bins, const int index) {
+    bins_extend(bins, index, index);
+    bins->counts[index > bins->offset ? index - bins->offset : 0]++;
+    bins->total++;
+}
+// ....................................................................................................................
+//      A janela vai direto para a posição final (a do intervalo de índices dos dois), e as caixas de 'other' caem
+//  dentro dela. A primeira caixa de 'other' só junta índices abaixo do offset dele se ele já estava cheio, e nesse caso
+//  o offset novo não é menor que o dele, então o resultado é o mesmo de acrescentar os valores um a um.
+static void bins_merge(reducer_bins* bins, const reducer_bins* other) {
+    int index;
+    int i;
+
+    if (other->total == 0) return;
+    bins_extend(bins, other->min_index, other->max_index);
+    for (i = 0; i < REDUTOR_CAIXAS_QUANTIS; i++) {
+        if (other->counts[i] == 0) continue;
+        index = other->offset + i;
+        bins->counts[index > bins->offset ? index - bins->offset : 0] += other->counts[i];
+    }
+    bins->total += other->total;
+}
+// ....................................................................................................................
+static int linear_exponent(const double min, const double max) {
+    const double magnitude = fabs(min) > fabs(max) ? fabs(min) : fabs(max);
+    int exponent;
+
+    //  O menor expoente deixa o maior módulo em 2^60 caixas, com folga para os índices no long long.
+    exponent = magnitude > 0 ? ilogb(magnitude) - 60 : -1074;
+    if (exponent < -1074) exponent = -1074;
+    while (floor(ldexp(max, -exponent)) - floor(ldexp(min, -exponent)) >= REDUTOR_CAIXAS_LINEARES) exponent++;
+    return exponent;
+}
+// ....................................................................................................................
+static long long floor_shift(const long long i, const int shift) {
+    if (shift <= 0) return i;
+    if (shift >= 63) return i < 0 ? -1 : 0;
+    return i >= 0 ? i >> shift : - ((- i - 1) >> shift) - 1;
+}
+// ....................................................................................................................
+static void linear_extend(reducer_linear* linear, const double min, const double max) {
+    long long moved[REDUTOR_CAIXAS_LINEARES];
+    double new_min;
+    double new_max;
+    long long base;
+    int exponent;
+    int i;
+
+    new_min = linear->total > 0 && linear->min < min ? linear->min : min;
+    new_max = linear->total > 0 && linear->max > max ? linear->max : max;
+    exponent = linear_exponent(new_min, new_max);
+    base = (long long) floor(ldexp(new_min, -exponent));
+
+    //  O expoente nunca diminui (o intervalo e o maior módulo só crescem), então cada caixa antiga cabe inteira numa
+    //  caixa nova.
+    if (linear->total > 0 && (exponent != linear->exponent || base != linear->base)) {
+        memset(moved, 0, sizeof(moved));
+        for (i = 0; i < REDUTOR_CAIXAS_LINEARES; i++) {
+            if (linear->counts[i] == 0) continue;
+            moved[floor_shift(linear->base + i, exponent - linear->exponent) - base] += linear->counts[i];
+        }
+        memcpy(linear->counts, moved, sizeof(moved));
+    }
+
+    linear->exponent = exponent;
+    linear->base = base;
+    linear->min = new_min;
+    linear->max = new_max;
+}
+// ....................................................................................................................
+static void linear_add(reducer_linear* linear, const double x) {
+    if (linear->total == 0 || x < linear->min || x > linear->max) linear_extend(linear, x, x);
+    linear->counts[(long long) floor(ldexp(x, -linear->exponent)) - linear->base]++;
+    linear->total++;
+}
+// ....................................................................................................................
+static void linear_merge(reducer_linear* linear, const reducer_linear* other) {
+    int i;
+
+    if (other->total == 0) return;
+    linear_extend(linear, other->min, other->max);
+    for (i = 0; i < REDUTOR_CAIXAS_LINEARES; i++) {
+        if (other->counts[i] == 0) continue;
+        linear->counts[floor_shift(other->base + i, linear->exponent - other->exponent) - linear->base] += other->counts[i];
+    }
+    linear->total += other->total;
+}
+// ....................................................................................................................
+static void stats_merge(reducer_stats* stats, const reducer_stats* other) {
+    const long long n = stats->n + other->n;
+    const double delta = other->mean - stats->mean;
+
+    if (other->n == 0) return;
+    if (stats->n == 0) {
+        *stats = *other;
+        return;
+    }
+    stats->mean += delta * other->n / n;
+    stats->m2 += other->m2 + delta * delta * ((double) stats->n * other->n / n);
+    if (other->min < stats->min) stats->min = other->min;
+    if (other->max > stats->max) stats->max = other->max;
+    stats->n = n;
+}
+// ....................................................................................................................
+static void bins_save(FILE* fo, const int quantity, const char sign, const reducer_bins* bins) {
+    int i;
+
+    if (bins->total == 0) return;
+    fprintf(fo, "bins %d %c %d %d %d\n", quantity, sign, bins->offset, bins->min_index, bins->max_index);
+    for (i = 0; i < REDUTOR_CAIXAS_QUANTIS; i++) if (bins->counts[i] > 0) fprintf(fo, "bin %d %c %d %lld\n", quantity, sign, i, bins->counts[i]);
+}
+// ....................................................................................................................
+static int bins_load(reducer_sketch* sketch, const char* line) {
+    reducer_bins* bins;
+    long long count;
+    int quantity;
+    int i;
+    char sign;
+
+    if (sscanf(line, "%*s %d %c", &quantity, &sign) != 2 || (sign != '+' && sign != '-')) return 1;
+    bins = sign == '+' ? &sketch->positive : &sketch->negative;
+
+    //  - "bins": a janela; "bin": uma caixa não vazia dela.
+    if (strncmp(line, "bins ", 5) == 0) {
+        if (sscanf(line, "bins %*d %*c %d %d %d", &bins->offset, &bins->min_index, &bins->max_index) != 3) return 1;
+        return bins->min_index > bins->max_index || bins->offset < bins->min_index || bins->offset > bins->max_index;
+    }
+    if (sscanf(line, "bin %*d %*c %d %lld", &i, &count) != 2 || i < 0 || i >= REDUTOR_CAIXAS_QUANTIS || count <= 0) return 1;
+    bins->counts[i] = count;
+    bins->total += count;
+    return 0;
+}
+// ....................................................................................................................
+static void linear_save(FILE* fo, const int quantity, const reducer_linear* linear) {
+    int i;
+
+    if (linear->total == 0) return;
+    fprintf(fo, "linear %d %d %lld %a %a\n", quantity, linear->exponent, linear->base, linear->min, linear->max);
+    for (i = 0; i < REDUTOR_CAIXAS_LINEARES; i++) if (linear->counts[i] > 0) fprintf(fo, "lbin %d %d %lld\n", quantity, i, linear->counts[i]);
+}
+// ....................................................................................................................
+static int linear_load(reducer_linear* linear, const char* line) {
+    char text[2][64];
+    long long count;
+    int i;
+
+    if (strncmp(line, "linear ", 7) == 0) {
+        if (sscanf(line, "linear %*d %d %lld %63s %63s", &linear->exponent, &linear->base, text[0], text[1]) != 4) return 1;
+        linear->min = strtod(text[0], NULL);
+        linear->max = strtod(text[1], NULL);
+        return !(linear->max >= linear->min) || linear->exponent != linear_exponent(linear->min, linear->max);
+    }
+    if (sscanf(line, "lbin %*d %d %lld", &i, &count) != 2 || i < 0 || i >= REDUTOR_CAIXAS_LINEARES || count <= 0) return 1;
+    linear->counts[i] = count;
+    linear->total += count;
+    return 0;
+}
+// ....................................................................................................................
+static int indicator_quantile(const reducer_set* set, const double p) {
+    if (set->samples == 0) return 0;
+    return (long long) floor(p * (double) (set->samples - 1)) >= set->samples - set->collisions;
+}
+// ....................................................................................................................
+static int boundary_cell(const reducer_boundary* boundary, const double b) {
+    int cell;
+
+    cell = (int) floor((b - boundary->x_min) / (boundary->x_max - boundary->x_min) * REDUTOR_CAIXAS_FRONTEIRA);
+    if (cell < 0) cell = 0;
+    if (cell >= REDUTOR_CAIXAS_FRONTEIRA) cell = REDUTOR_CAIXAS_FRONTEIRA - 1;
+    return cell;
+}
+// ....................................................................................................................
+//      Cada caixa vira um ou dois trechos de b com o mesmo indicador (os testes com e sem colisão dela, do menor b para
+//  o maior), e trechos vizinhos com indicadores diferentes têm uma mudança entre eles: o intervalo [fim do primeiro,
+//  começo do segundo]. Se os dois trechos de uma caixa se sobrepõem (mais de uma mudança dentro dela), o intervalo
+//  cobre a sobreposição e a coluna 'resolved' é 0: a caixa é larga demais para aquela região.
+static int boundary_write(FILE* fo, const reducer_boundary* boundary) {
+    double low[2];                                      //  Trechos da caixa (até dois), na ordem de b.
+    double high[2];
+    int kind[2];
+    double last_high;                                   //  Fim do último trecho.
+    int last_kind;                                      //  Indicador do último trecho (-1 antes do primeiro).
+    int n_parts;
+    int changes;
+    int part;
+    int i;
+
+    fprintf(fo, "b_low,b_high,b,collision_below,collision_above,resolved\n");
+    last_kind = -1;
+    last_high = 0.0;
+    changes = 0;
+    for (i = 0; i < REDUTOR_CAIXAS_FRONTEIRA; i++) {
+        n_parts = 0;
+        if (boundary->misses[i] > 0) {
+            low[n_parts] = boundary->miss_min[i];
+            high[n_parts] = boundary->miss_max[i];
+            kind[n_parts++] = 0;
+        }
+        if (boundary->hits[i] > 0) {
+            low[n_parts] = boundary->hit_min[i];
+            high[n_parts] = boundary->hit_max[i];
+            kind[n_parts++] = 1;
+        }
+        if (n_parts == 2 && low[1] < low[0]) {
+            low[0] = boundary->hit_min[i];
+            high[0] = boundary->hit_max[i];
+            kind[0] = 1;
+            low[1] = boundary->miss_min[i];
+            high[1] = boundary->miss_max[i];
+            kind[1] = 0;
+        }
+
+        for (part = 0; part < n_parts; part++) {
+            if (last_kind >= 0 && kind[part] != last_kind) {
+                fprintf(fo, "%.15e,%.15e,%.15e,%d,%d,%d\n", last_high < low[part] ? last_high : low[part], last_high < low[part] ? low[part] : last_high,
+                    0.5 * (last_high + low[part]), last_kind, kind[part], last_high < low[part]);
+                changes++;
+            }
+            if (last_kind < 0 || kind[part] != last_kind || high[part] > last_high) last_high = high[part];
+            last_kind = kind[part];
+        }
+    }
+    return changes;
+}
+// ....................................................................................................................
@@ -0,0 +1,156 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Redutores de streaming dos resultados (opção --reduce), compartilhados pelos dois programas.
+//
+//  Num ensemble grande (milhões de trajetórias), guardar um arquivo por trajetória custa mais que a integração, e o que
+//  se quer no fim são resumos e histogramas. Os redutores recebem cada teste junto com a linha dele no arquivo global
+//  (na ordem dos índices) e guardam apenas um estado de tamanho fixo, que não depende do número de testes:
+//  - média, variância (Welford), mínimo e máximo de cada quantidade;
+//  - um esboço de quantis com dois histogramas de tamanho fixo: caixas logarítmicas (no estilo do DDSketch), com erro
+//  relativo de no máximo REDUTOR_ERRO_RELATIVO, e caixas lineares cuja largura (uma potência de 2) dobra quando os
+//  valores não cabem mais nelas, com erro de no máximo meia caixa. O quantil vem do histograma com o menor erro: o
+//  logarítmico para distribuições que cobrem várias ordens de grandeza, o linear para as estreitas (como as do Monte
+//  Carlo, em que 1% do valor é maior que a própria dispersão);
+//  - um histograma 2-D do parâmetro de impacto contra a deflexão;
+//  - um rastreador da fronteira da colisão: caixas de b com o número de testes com e sem colisão e o menor e o maior b
+//  de cada classe, de onde saem os intervalos de b que contêm uma mudança do indicador de colisão.
+//
+//  Todos os redutores podem ser combinados (reducers_merge): o estado de dois conjuntos de testes disjuntos, somado, é
+//  o estado do conjunto todo. As contagens (quantis, histograma e fronteira) não dependem da ordem dos testes; a média
+//  e a variância, só pelo arredondamento. O estado pode ser salvo e lido de um arquivo de texto, para juntar execuções
+//  feitas em processos (ou máquinas) diferentes.
+// ....................................................................................................................
+#ifndef FLY_BY_REDUCERS_H
+#define FLY_BY_REDUCERS_H
+// ....................................................................................................................
+#define REDUTOR_MAX_QUANTIDADES 8                       //  Número máximo de quantidades de um conjunto de redutores.
+#define REDUTOR_NOME 32                                 //  Tamanho máximo do nome de uma quantidade (com o '\0').
+#define REDUTOR_ERRO_RELATIVO 0.01                      //  Erro relativo dos quantis do esboço.
+#define REDUTOR_CAIXAS_QUANTIS 1024                     //  Caixas do esboço para cada sinal (cobrem um fator de ~7e8
+                                                        //  entre o menor e o maior módulo; abaixo disso, as caixas
+                                                        //  dos menores módulos são juntadas).
+#define REDUTOR_CAIXAS_LINEARES 2048                    //  Caixas lineares do esboço (a largura fica entre 1/2048 e
+                                                        //  1/1024 do intervalo dos valores).
+#define REDUTOR_HISTOGRAMA_B 100                        //  Caixas do histograma no eixo do parâmetro de impacto.
+#define REDUTOR_HISTOGRAMA_Y 90                         //  Caixas do histograma no eixo da deflexão.
+#define REDUTOR_CAIXAS_FRONTEIRA 1024                   //  Caixas de b do rastreador da fronteira da colisão.
+// ....................................................................................................................
+//  - Média, variância, mínimo e máximo (algoritmo de Welford; a combinação é a de Chan et al.).
+typedef struct {
+    long long n;                                        //  Número de valores.
+    double mean;                                        //  Média.
+    double m2;                                          //  Soma dos quadrados dos desvios em relação à média.
+    double min;                                         //  Menor valor.
+    double max;                                         //  Maior valor.
+} reducer_stats;
+
+//  - Caixas logarítmicas de um sinal do esboço. A caixa de índice i guarda os módulos em (γ^(i-1), γ^i], com
+//  γ = (1 + α) / (1 - α). A janela cobre os índices [offset, offset + REDUTOR_CAIXAS_QUANTIS); a primeira caixa
+//  também recebe todos os índices abaixo do offset (os menores módulos, que perdem a precisão primeiro).
+typedef struct {
+    long long total;                                    //  Número de valores.
+    int offset;                                         //  Índice da primeira caixa da janela.
+    int min_index;                                      //  Menor índice já recebido.
+    int max_index;                                      //  Maior índice já recebido.
+    long long counts[REDUTOR_CAIXAS_QUANTIS];           //  Contagem de cada caixa da janela.
+} reducer_bins;
+
+//  - Caixas lineares do esboço. A caixa de índice i guarda os valores x com floor(x / 2^exponent) = i, então a grade é a
+//  mesma para quaisquer valores com o mesmo expoente, e dobrar a largura é só juntar as caixas duas a duas. O expoente
+//  é o menor em que o intervalo [min, max] cabe em REDUTOR_CAIXAS_LINEARES caixas (e não muito menor que o maior
+//  módulo, para os índices caberem num inteiro de 64 bits), então ele só depende dos valores, e não da ordem deles.
+typedef struct {
+    long long total;                                    //  Número de valores.
+    int exponent;                                       //  Largura das caixas: 2^exponent.
+    long long base;                                     //  Índice da primeira caixa (a do menor valor).
+    double min;                                         //  Menor e maior valor.
+    double max;
+    long long counts[REDUTOR_CAIXAS_LINEARES];          //  Contagem de cada caixa.
+} reducer_linear;
+
+//  - Esboço de quantis: caixas logarítmicas para os valores positivos, os negativos (pelo módulo) e os zeros, e caixas
+//  lineares para todos eles.
+typedef struct {
+    reducer_bins positive;
+    reducer_bins negative;
+    long long zeros;
+    reducer_linear linear;
+} reducer_sketch;
+
+//  - Histograma 2-D de tamanho fixo. Os valores fora dos intervalos são apenas contados.
+typedef struct {
+    double x_min, x_max;                                //  Intervalo do eixo x (parâmetro de impacto).
+    double y_min, y_max;                                //  Intervalo do eixo y (deflexão).
+    long long outside;                                  //  Valores fora dos intervalos.
+    long long counts[REDUTOR_HISTOGRAMA_B][REDUTOR_HISTOGRAMA_Y];
+} reducer_histogram;
+
+//  - Rastreador da fronteira da colisão: por caixa de b, os testes com colisão e sem colisão.
+typedef struct {
+    double x_min, x_max;                                //  Intervalo de b (os valores de fora vão para as caixas das pontas).
+    long long hits[REDUTOR_CAIXAS_FRONTEIRA];           //  Testes com colisão.
+    long long misses[REDUTOR_CAIXAS_FRONTEIRA];         //  Testes sem colisão.
+    double hit_min[REDUTOR_CAIXAS_FRONTEIRA];           //  Menor e maior b com colisão.
+    double hit_max[REDUTOR_CAIXAS_FRONTEIRA];
+    double miss_min[REDUTOR_CAIXAS_FRONTEIRA];          //  Menor e maior b sem colisão.
+    double miss_max[REDUTOR_CAIXAS_FRONTEIRA];
+} reducer_boundary;
+
+//  - Conjunto de redutores de uma execução.
+typedef struct {
+    int n_quantities;                                   //  Número de quantidades.
+    char names[REDUTOR_MAX_QUANTIDADES][REDUTOR_NOME];  //  Nome de cada quantidade (colunas do resumo).
+    int histogram_quantity;                             //  Quantidade do eixo y do histograma.
+    long long samples;                                  //  Testes recebidos.
+    long long collisions;                               //  Testes com colisão.
+    reducer_stats stats[REDUTOR_MAX_QUANTIDADES];
+    reducer_sketch sketches[REDUTOR_MAX_QUANTIDADES];
+    reducer_histogram histogram;
+    reducer_boundary boundary;
+} reducer_set;
+// ....................................................................................................................
+//  - Prepara um conjunto vazio.
+//  int n_quantities, const char* const* names → Quantidades de cada teste e os seus nomes.
+//  int histogram_quantity                  → Índice da quantidade do eixo y do histograma.
+//  double b_min, double b_max              → Intervalo do parâmetro de impacto (histograma e fronteira).
+//  double y_min, double y_max              → Intervalo da quantidade do eixo y do histograma.
+//
+//  * Retorna 0, ou -1 se houver quantidades demais, um nome longo demais ou um intervalo vazio.
+int reducers_init(reducer_set* set, int n_quantities, const char* const* names, int histogram_quantity, double b_min, double b_max, double y_min,
+    double y_max);
+
+//  - Acrescenta um teste.
+//  double b                                → Parâmetro de impacto.
+//  int collision                           → Indicador de colisão.
+//  const double* values                    → Quantidades do teste (n_quantities valores; NaN para uma quantidade que
+//                                            não existe nesse teste, como o Δv de uma colisão).
+void reducers_add(reducer_set* set, double b, int collision, const double* values);
+
+//  - Soma o estado de 'other' ao de 'set'. Retorna 0, ou -1 se os dois não tiverem as mesmas quantidades e intervalos.
+int reducers_merge(reducer_set* set, const reducer_set* other);
+
+//  - Quantil p (de 0 a 1) da quantidade 'quantity', a partir do esboço (0 se ela não tiver nenhum valor). Das duas
+//  estimativas (caixas logarítmicas e lineares), vale a de menor erro máximo.
+double reducers_quantile(const reducer_set* set, int quantity, double p);
+
+//  - Salva o estado num arquivo de texto (que o reducers_load lê de volta, sem perda). Retorna 0 em caso de sucesso.
+int reducers_save(const reducer_set* set, const char* path);
+
+//  - Lê um estado salvo pelo reducers_save.
+//
+//  * Retorna 0 em caso de sucesso, -1 se o arquivo não pode ser lido, ou o número da primeira linha inválida.
+int reducers_load(reducer_set* set, const char* path);
+
+//  - Escreve os resultados numa pasta e imprime o resumo:
+//      reduce_<program>.csv                → Por quantidade: n, média, desvio padrão, mínimo, p05, p50, p95 e máximo.
+//      histogram_<program>.csv             → Células do histograma 2-D (com os limites de cada uma).
+//      boundary_<program>.csv              → Intervalos de b que contêm uma mudança do indicador de colisão.
+//      reducers_<program>.txt              → Estado dos redutores (reducers_save), para combinar execuções.
+//
+//  * Retorna 0 em caso de sucesso.
+int reducers_write(const reducer_set* set, const char* directory, const char* program);
+// ....................................................................................................................
+#endif
@@ -0,0 +1,117 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Comentários para desabilitar algumas funções de análise do CLion:
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ....................................................................................................................
+//      Bibliotecas:
+#include <math.h>
+#include <stdlib.h>
+
+#include "refine.h"
+// ....................................................................................................................
+//      Intervalo candidato: entre as amostras 'left' e 'left + 1' (depois da ordenação).
+typedef struct {
+    int left;
+    int level;                                          //  Maior nível dos dois extremos.
+    double score;                                       //  Maior variação encontrada, em unidades do limiar.
+} candidate;
+// ....................................................................................................................
+static int compare_samples(const void* a, const void* b) {
+    const refine_sample* x = a;
+    const refine_sample* y = b;
+
+    return (x->b > y->b) - (x->b < y->b);
+}
+// ....................................................................................................................
+//      Menor nível primeiro; depois a maior variação; depois a ordem em b (para o resultado não depender do qsort).
+static int compare_candidates(const void* a, const void* b) {
+    const candidate* x = a;
+    const candidate* y = b;
+
+    if (x->level != y->level) return x->level - y->level;
+    if (x->score != y->score) return x->score < y->score ? 1 : -1;
+    return x->left - y->left;
+}
+// ....................................................................................................................
+int refine_select(refine_sample* samples, const int n, const double threshold, const int max_new, double* b_new, int* level_new) {
+    candidate* candidates;
+    double* scores;                                     //  Variação de cada intervalo, em unidades do limiar.
+    double range[REFINAMENTO_QUANTIDADES];              //  Variação total de cada quantidade (sem as colisões).
+    double low;
+    double high;
+    double value;
+    double min_width;
+    int n_candidates;
+    int count;
+    int found;
+    int i;
+    int k;
+
+    if (n < 2 || max_new <= 0) return 0;
+    qsort(samples, n, sizeof(refine_sample), compare_samples);
+
+    candidates = malloc(sizeof(candidate) * (n - 1));
+    scores = malloc(sizeof(double) * (n - 1));
+    if (candidates == NULL || scores == NULL) {
+        free(candidates);
+        free(scores);
+        return -1;
+    }
+
+    for (k = 0; k < REFINAMENTO_QUANTIDADES; k++) {
+        low = HUGE_VAL;
+        high = - HUGE_VAL;
+        for (i = 0; i < n; i++) {
+            if (samples[i].collision) continue;
+            if (samples[i].values[k] < low) low = samples[i].values[k];
+            if (samples[i].values[k] > high) high = samples[i].values[k];
+        }
+        range[k] = high > low ? high - low : 1.0;
+    }
+    min_width = REFINAMENTO_LARGURA_MINIMA * (samples[n - 1].b - samples[0].b);
+    // ................................................................................................................
+    //      Variação de cada intervalo e curvatura em cada amostra interna (que marca os dois intervalos vizinhos).
+    for (i = 0; i < n - 1; i++) {
+        scores[i] = 0.0;
+        if (samples[i].collision != samples[i + 1].collision) scores[i] = HUGE_VAL;
+        else if (!samples[i].collision) {
+            for (k = 0; k < REFINAMENTO_QUANTIDADES; k++) {
+                value = fabs(samples[i + 1].values[k] - samples[i].values[k]) / range[k] / threshold;
+                if (value > scores[i]) scores[i] = value;
+            }
+        }
+    }
+    for (i = 1; i < n - 1; i++) {
+        if (samples[i - 1].collision || samples[i].collision || samples[i + 1].collision) continue;
+        for (k = 0; k < REFINAMENTO_QUANTIDADES; k++) {
+            value = fabs(samples[i - 1].values[k] - 2 * samples[i].values[k] + samples[i + 1].values[k]) / range[k] / threshold;
+            if (value > scores[i - 1]) scores[i - 1] = value;
+            if (value > scores[i]) scores[i] = value;
+        }
+    }
+    // ................................................................................................................
+    n_candidates = 0;
+    for (i = 0; i < n - 1; i++) {
+        if (scores[i] <= 1.0 || samples[i + 1].b - samples[i].b <= min_width) continue;
+        candidates[n_candidates].left = i;
+        candidates[n_candidates].level = samples[i].level > samples[i + 1].level ? samples[i].level : samples[i + 1].level;
+        candidates[n_candidates].score = scores[i];
+        n_candidates++;
+    }
+    qsort(candidates, n_candidates, sizeof(candidate), compare_candidates);
+
+    found = n_candidates < max_new ? n_candidates : max_new;
+    for (count = 0; count < found; count++) {
+        i = candidates[count].left;
+        b_new[count] = 0.5 * (samples[i].b + samples[i + 1].b);
+        level_new[count] = candidates[count].level + 1;
+    }
+
+    free(candidates);
+    free(scores);
+    return found;
+}
+// ....................................................................................................................
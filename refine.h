@@ -0,0 +1,45 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Refinamento adaptativo do parâmetro de impacto (opção --refine), compartilhado pelos dois programas.
+//
+//  O sweep começa com a grade uniforme de --tests valores de b (nível 0) e, a cada rodada, divide ao meio os intervalos
+//  entre amostras vizinhas em que:
+//  - o indicador de colisão muda (a fronteira da colisão fica dentro do intervalo);
+//  - a variação de alguma quantidade (deflexão, Δv) passa do limiar, medido como fração da variação total dela;
+//  - a segunda diferença (curvatura) de alguma quantidade, nas três amostras em volta, passa do mesmo limiar.
+//  O ponto novo tem nível igual ao maior nível dos extremos mais 1. Quando há mais intervalos marcados do que o orçamento
+//  permite, os de menor nível vêm primeiro (e, entre eles, os de maior variação), para que nenhuma região concentre todo
+//  o orçamento. O sweep para quando o orçamento de trajetórias acaba ou quando nenhum intervalo é marcado.
+// ....................................................................................................................
+#ifndef FLY_BY_REFINE_H
+#define FLY_BY_REFINE_H
+// ....................................................................................................................
+#define REFINAMENTO_QUANTIDADES 2                       //  Quantidades comparadas entre amostras (deflexão e Δv).
+#define REFINAMENTO_LIMIAR 0.02                         //  Limiar padrão (opção --refine-tol), em fração da variação
+                                                        //  total de cada quantidade.
+#define REFINAMENTO_LARGURA_MINIMA 1e-9                 //  Intervalos mais estreitos que isso (em fração do intervalo de
+                                                        //  b) não são mais divididos.
+// ....................................................................................................................
+//  - Uma amostra já calculada.
+typedef struct {
+    double b;                                           //  Parâmetro de impacto.
+    double values[REFINAMENTO_QUANTIDADES];             //  Quantidades comparadas (ignoradas numa colisão).
+    int collision;                                      //  Indicador de colisão.
+    int level;                                          //  Nível de refinamento (0 na grade inicial).
+} refine_sample;
+// ....................................................................................................................
+//  - Escolhe os valores de b da próxima rodada.
+//  refine_sample* samples                  → Amostras calculadas até agora (são ordenadas por b aqui).
+//  int n                                   → Número de amostras.
+//  double threshold                        → Limiar, em fração da variação total de cada quantidade.
+//  int max_new                             → Número máximo de amostras novas (o que resta do orçamento).
+//  double* b_new                           → Recebe os valores de b novos (max_new posições).
+//  int* level_new                          → Recebe o nível de cada um (idem).
+//
+//  * Retorna o número de amostras novas (0 quando nada mais precisa ser refinado), ou -1 se faltar memória.
+int refine_select(refine_sample* samples, int n, double threshold, int max_new, double* b_new, int* level_new);
+// ....................................................................................................................
+#endif
@@ -0,0 +1,107 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Comentários para desabilitar algumas funções de análise do CLion:
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ....................................................................................................................
+//      Bibliotecas:
+#include <float.h>
+#include <math.h>
+
+#include "roots.h"
+// ....................................................................................................................
+//      Método de Brent (na forma do zbrent do Numerical Recipes). 'b' é sempre a melhor aproximação, 'c' é o outro
+//  extremo do intervalo que contém a raiz e 'a' é o valor anterior de 'b'. Cada iteração tenta uma interpolação (secante
+//  ou quadrática inversa) e cai para a bisseção quando a interpolação sai do intervalo ou converge devagar.
+int brent_solve(const root_function f, void* context, double a, double b, double fa, double fb, const double tol, const int max_evaluations, double* root,
+    int* evaluations) {
+    double c;
+    double fc;
+    double d;                                           //  Passo atual.
+    double e;                                           //  Passo anterior.
+    double p;
+    double q;
+    double r;
+    double s;
+    double tol1;
+    double xm;                                          //  Metade do intervalo [b, c].
+
+    *evaluations = 0;
+    *root = b;
+    if (isnan(fa) || isnan(fb)) return RAIZ_INDEFINIDA;
+    if (fa == 0) {
+        *root = a;
+        return RAIZ_ENCONTRADA;
+    }
+    if (fb == 0) return RAIZ_ENCONTRADA;
+    if ((fa > 0) == (fb > 0)) return RAIZ_SEM_INTERVALO;
+
+    c = b;
+    fc = fb;
+    d = b - a;
+    e = d;
+    while (1) {
+        //  Mantém a raiz entre b e c, com b o ponto de menor |f|.
+        if ((fb > 0) == (fc > 0)) {
+            c = a;
+            fc = fa;
+            d = b - a;
+            e = d;
+        }
+        if (fabs(fc) < fabs(fb)) {
+            a = b;
+            b = c;
+            c = a;
+            fa = fb;
+            fb = fc;
+            fc = fa;
+        }
+
+        tol1 = 2 * DBL_EPSILON * fabs(b) + 0.5 * tol;
+        xm = 0.5 * (c - b);
+        *root = b;
+        if (fabs(xm) <= tol1 || fb == 0) return RAIZ_ENCONTRADA;
+        if (*evaluations >= max_evaluations) return RAIZ_SEM_CONVERGENCIA;
+
+        if (fabs(e) >= tol1 && fabs(fa) > fabs(fb)) {
+            //  Interpolação: secante (dois pontos) ou quadrática inversa (três pontos).
+            s = fb / fa;
+            if (a == c) {
+                p = 2 * xm * s;
+                q = 1 - s;
+            } else {
+                q = fa / fc;
+                r = fb / fc;
+                p = s * (2 * xm * q * (q - r) - (b - a) * (r - 1));
+                q = (q - 1) * (r - 1) * (s - 1);
+            }
+            if (p > 0) q = - q;
+            p = fabs(p);
+
+            //  Aceita a interpolação apenas se ela cair dentro do intervalo e encolher mais rápido que a bisseção.
+            if (2 * p < fmin(3 * xm * q - fabs(tol1 * q), fabs(e * q))) {
+                e = d;
+                d = p / q;
+            } else {
+                d = xm;
+                e = d;
+            }
+        } else {
+            d = xm;
+            e = d;
+        }
+
+        a = b;
+        fa = fb;
+        b += fabs(d) > tol1 ? d : (xm > 0 ? tol1 : - tol1);
+        fb = f(b, context);
+        (*evaluations)++;
+        if (isnan(fb)) {
+            *root = b;
+            return RAIZ_INDEFINIDA;
+        }
+    }
+}
+// ....................................................................................................................
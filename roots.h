@@ -0,0 +1,39 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Busca de raízes em uma variável (usada pelo modo --target).
+//
+//  Método de Brent: combina bisseção, secante e interpolação quadrática inversa. A raiz fica sempre dentro de um
+//  intervalo [a, b] com f(a) e f(b) de sinais opostos, então a convergência é garantida como na bisseção, mas perto da
+//  raiz o método converge de forma superlinear (tipicamente 5 a 10 avaliações para 1e-9 do intervalo inicial). Cada
+//  avaliação de f é uma trajetória integrada, por isso o número de avaliações é o que importa aqui.
+// ....................................................................................................................
+#ifndef FLY_BY_ROOTS_H
+#define FLY_BY_ROOTS_H
+// ....................................................................................................................
+//      Retornos do brent_solve.
+#define RAIZ_ENCONTRADA 0                               //  Convergiu.
+#define RAIZ_SEM_INTERVALO (-1)                         //  f(a) e f(b) têm o mesmo sinal.
+#define RAIZ_INDEFINIDA (-2)                            //  f retornou NaN em algum ponto.
+#define RAIZ_SEM_CONVERGENCIA (-3)                      //  O número máximo de avaliações foi atingido.
+// ....................................................................................................................
+//  - Função da qual se busca a raiz. Pode retornar NaN para indicar que não está definida no ponto.
+typedef double (*root_function)(double x, void* context);
+
+//  - Procura a raiz de f em [a, b] pelo método de Brent.
+//  root_function f                         → Função.
+//  void* context                           → Ponteiro repassado sem alterações para f.
+//  double a, double b                      → Extremos do intervalo.
+//  double fa, double fb                    → f(a) e f(b), já calculados por quem chama.
+//  double tol                              → Tolerância absoluta em x.
+//  int max_evaluations                     → Número máximo de avaliações de f (sem contar as dos extremos).
+//  double* root                            → Recebe a melhor aproximação da raiz (sempre um ponto em que f foi avaliada).
+//  int* evaluations                        → Recebe o número de avaliações de f.
+//
+//  * Retorna RAIZ_ENCONTRADA ou um dos códigos de erro acima.
+int brent_solve(root_function f, void* context, double a, double b, double fa, double fb, double tol, int max_evaluations, double* root,
+    int* evaluations);
+// ....................................................................................................................
+#endif
@@ -0,0 +1,74 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Comentários para desabilitar algumas funções de análise do CLion:
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ....................................................................................................................
+//      Bibliotecas:
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "shard.h"
+// ....................................................................................................................
+#define SHARD_VERSAO 1                                  //  Versão do arquivo que identifica a parte.
+// ....................................................................................................................
+int shard_parse(const char* text, shard_spec* shard) {
+    const char* value;
+    char* end;
+    long index;
+    long count;
+
+    index = strtol(text, &end, 10);
+    if (end == text || *end != '/') return -1;
+    value = end + 1;
+    count = strtol(value, &end, 10);
+    if (end == value || *end != '\0' || count < 1 || count > 1000000 || index < 0 || index >= count) return -1;
+
+    shard->index = (int) index;
+    shard->count = (int) count;
+    return 0;
+}
+// ....................................................................................................................
+int shard_member(const shard_spec* shard, const long test) {
+    return test % shard->count == shard->index;
+}
+// ....................................................................................................................
+long shard_tests(const shard_spec* shard, const long n_tests) {
+    return n_tests > shard->index ? (n_tests - shard->index + shard->count - 1) / shard->count : 0;
+}
+// ....................................................................................................................
+int shard_directory(const shard_spec* shard, const char* test_name, char* directory, const size_t size) {
+    const int length = snprintf(directory, size, "%s/shard_%d_of_%d", test_name, shard->index, shard->count);
+
+    return length < 0 || (size_t) length >= size ? -1 : 0;
+}
+// ....................................................................................................................
+int shard_save(const char* path, const shard_spec* shard, const long n_tests) {
+    FILE* fo;
+    int status;
+
+    fo = fopen(path, "w");
+    if (fo == NULL) return -1;
+
+    status = fprintf(fo, "flyby-shard %d\nshard %d %d\ntests %ld\n", SHARD_VERSAO, shard->index, shard->count, n_tests) < 0 ? -1 : 0;
+    if (fclose(fo) != 0) status = -1;
+    return status;
+}
+// ....................................................................................................................
+int shard_load(const char* path, shard_spec* shard, long* n_tests) {
+    FILE* fi;
+    int version;
+    int fields;
+
+    fi = fopen(path, "r");
+    if (fi == NULL) return -1;
+
+    fields = fscanf(fi, "flyby-shard %d shard %d %d tests %ld", &version, &shard->index, &shard->count, n_tests);
+    fclose(fi);
+
+    if (fields != 4 || version != SHARD_VERSAO || shard->count < 1 || shard->index < 0 || shard->index >= shard->count || *n_tests < 0) return -1;
+    return 0;
+}
+// ....................................................................................................................
@@ -0,0 +1,46 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Execução em partes (opção --shard), compartilhada pelos dois programas e pelo flyby_merge.
+//
+//  Com '--shard k/N', o processo integra apenas os testes i (começando em 0) com i % N = k. A divisão é intercalada:
+//  cada parte recebe testes espalhados por todo o intervalo de b (e por todas as fatias do grid), então as partes têm
+//  quase o mesmo custo, e os testes de uma parte não dependem de quantos processos existem nem de onde eles rodam. Tudo
+//  o que não depende do teste (os valores de b, as fatias, os intervalos dos redutores) é calculado igual em todas as
+//  partes, e o índice de cada teste (a coluna 'i' e o nome do arquivo de trajetória) é o mesmo da execução completa.
+//
+//  Cada parte escreve na sua própria pasta, '<test_name>/shard_<k>_of_<N>', com a mesma organização de uma execução
+//  completa, mais um arquivo 'shard_<programa>.txt' que identifica a parte. O flyby_merge junta as pastas das partes em
+//  '<test_name>', como se tudo tivesse rodado num único processo.
+// ....................................................................................................................
+#ifndef FLY_BY_SHARD_H
+#define FLY_BY_SHARD_H
+
+#include <stddef.h>
+// ....................................................................................................................
+//  - Parte de uma execução. Com count = 1 (sem --shard), a parte é a execução inteira.
+typedef struct {
+    int index;                                          //  Índice da parte, k (de 0 a count - 1).
+    int count;                                          //  Número de partes, N.
+} shard_spec;
+// ....................................................................................................................
+//  - Lê o texto passado em --shard ('k/N', com 0 ≤ k < N). Retorna 0, ou -1 se o texto não estiver no formato esperado.
+int shard_parse(const char* text, shard_spec* shard);
+
+//  - Retorna 1 se o teste 'test' (começando em 0) pertence à parte.
+int shard_member(const shard_spec* shard, long test);
+
+//  - Número de testes da parte numa execução com n_tests testes.
+long shard_tests(const shard_spec* shard, long n_tests);
+
+//  - Pasta da parte dentro da pasta do teste ('<test_name>/shard_<k>_of_<N>'). Retorna 0, ou -1 se o nome não couber.
+int shard_directory(const shard_spec* shard, const char* test_name, char* directory, size_t size);
+
+//  - Salva (e lê) o arquivo que identifica a parte: o índice, o número de partes e o número de testes da execução
+//  completa. Os dois retornam 0 em caso de sucesso.
+int shard_save(const char* path, const shard_spec* shard, long n_tests);
+int shard_load(const char* path, shard_spec* shard, long* n_tests);
+// ....................................................................................................................
+#endif
@@ -0,0 +1,357 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Comentários para desabilitar algumas funções de análise do CLion:
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ....................................................................................................................
+//      Bibliotecas:
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+
+#include "sweep.h"
+// ....................................................................................................................
+//      Estruturas internas.
+//  - Fila de testes de uma thread. Os testes ficam ordenados do mais caro para o mais barato, e tanto a dona da fila
+//  quanto as threads que roubam trabalho retiram sempre do começo (o teste mais caro restante).
+typedef struct {
+    int* jobs;                                          //  Índices dos testes na fila.
+    double* costs;                                      //  Custo estimado de cada teste da fila.
+    int head;                                           //  Posição do próximo teste a ser retirado.
+    int tail;                                           //  Posição após o último teste.
+    double remaining;                                   //  Custo estimado que ainda resta na fila.
+    pthread_mutex_t lock;                               //  Trava de acesso à fila.
+} sweep_queue;
+
+//  - Par (custo, índice) usado para ordenar os testes.
+typedef struct {
+    double cost;
+    int job;
+} sweep_item;
+
+//  - Estado compartilhado entre as threads.
+typedef struct {
+    sweep_queue* queues;                                //  Uma fila por thread.
+    int n_threads;                                      //  Número de threads.
+    int n_jobs;                                         //  Número de testes.
+
+    sweep_cost_fn cost;                                 //  Função que estima o custo de um teste (ou NULL).
+    sweep_job_fn job;                                   //  Função que executa um teste.
+    sweep_done_fn done;                                 //  Função chamada após cada teste.
+    sweep_ordered_fn ordered;                           //  Função chamada para cada teste, na ordem dos índices.
+    void* context;                                      //  Contexto do programa.
+
+    int window;                                         //  Testes por janela.
+    int opened;                                         //  Janelas já abertas (distribuídas entre as filas).
+    int n_windows;                                      //  Número de janelas.
+    sweep_item* items;                                  //  Testes da janela sendo aberta.
+    unsigned char* finished;                            //  1 para os testes concluídos e ainda sem o 'ordered'
+                                                        //  (anel de 2 janelas, na posição job % (2 × window)).
+    int flushed;                                        //  Testes já entregues ao 'ordered' (o prefixo contíguo).
+    int n_done;                                         //  Testes concluídos.
+    pthread_mutex_t done_lock;                          //  Serializa 'cost', 'done', 'ordered' e a abertura das janelas.
+    pthread_cond_t flushed_cond;                        //  Sinalizada quando 'flushed' avança.
+} sweep_pool;
+
+//  - Pedido de interrupção (SIGINT/SIGTERM). Só é escrito pelo tratador do sinal, e lido entre um teste e outro.
+static volatile sig_atomic_t interrupted = 0;
+
+//  - Argumento passado para cada thread.
+typedef struct {
+    sweep_pool* pool;
+    int id;
+} sweep_worker;
+// ....................................................................................................................
+//      Ordena do maior custo para o menor; em caso de empate mantém a ordem natural, para a distribuição ser
+//  sempre a mesma para as mesmas entradas.
+static int compare_items(const void* a, const void* b) {
+    const sweep_item* x = a;
+    const sweep_item* y = b;
+    if (x->cost > y->cost) return -1;
+    if (x->cost < y->cost) return 1;
+    return x->job - y->job;
+}
+// ....................................................................................................................
+//      Retira o próximo teste de uma fila. Retorna -1 caso a fila esteja vazia.
+static int queue_pop(sweep_queue* queue) {
+    int job = -1;
+
+    pthread_mutex_lock(&queue->lock);
+    if (queue->head < queue->tail) {
+        queue->remaining -= queue->costs[queue->head];
+        job = queue->jobs[queue->head++];
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return job;
+}
+// ....................................................................................................................
+//      Rouba um teste da fila com o maior custo restante. Retorna -1 caso não exista mais trabalho.
+static int steal(sweep_pool* pool, const int self) {
+    int i;
+    int job;
+    int victim;
+    double best;
+
+    while (1) {
+        victim = -1;
+        best = 0.0;
+        for (i = 0; i < pool->n_threads; i++) {
+            if (i == self) continue;
+            pthread_mutex_lock(&pool->queues[i].lock);
+            if (pool->queues[i].head < pool->queues[i].tail && (victim < 0 || pool->queues[i].remaining > best)) {
+                victim = i;
+                best = pool->queues[i].remaining;
+            }
+            pthread_mutex_unlock(&pool->queues[i].lock);
+        }
+
+        if (victim < 0) return -1;
+
+        job = queue_pop(&pool->queues[victim]);
+        if (job >= 0) return job;
+        //  Outra thread esvaziou a vítima antes de nós; tenta de novo.
+    }
+}
+// ....................................................................................................................
+//      Distribui os testes da próxima janela entre as filas (chamada com done_lock). Os testes são ordenados pelo
+//  custo estimado (os mais caros primeiro) e distribuídos de forma alternada (round-robin), assim cada thread começa
+//  com uma mistura parecida de testes caros e baratos.
+static void fill_window(sweep_pool* pool) {
+    const int first = pool->opened * pool->window;
+    const int count = pool->n_jobs - first < pool->window ? pool->n_jobs - first : pool->window;
+    sweep_queue* queue;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        pool->items[i].cost = pool->cost != NULL ? pool->cost(first + i, pool->context) : 1.0;
+        pool->items[i].job = first + i;
+    }
+    if (pool->cost != NULL) qsort(pool->items, count, sizeof(sweep_item), compare_items);
+
+    for (i = 0; i < pool->n_threads; i++) {
+        queue = &pool->queues[i];
+        pthread_mutex_lock(&queue->lock);
+        queue->head = 0;
+        queue->tail = 0;
+        queue->remaining = 0.0;
+        pthread_mutex_unlock(&queue->lock);
+    }
+    for (i = 0; i < count; i++) {
+        queue = &pool->queues[i % pool->n_threads];
+        pthread_mutex_lock(&queue->lock);
+        queue->jobs[queue->tail] = pool->items[i].job;
+        queue->costs[queue->tail++] = pool->items[i].cost;
+        queue->remaining += pool->items[i].cost;
+        pthread_mutex_unlock(&queue->lock);
+    }
+    pool->opened++;
+}
+// ....................................................................................................................
+//      Abre a próxima janela quando todas as filas estão vazias. A janela n só é aberta depois que as janelas até n - 2
+//  foram entregues ao 'ordered', então os testes em aberto cabem no anel 'finished'. Retorna 0 se há (ou pode haver)
+//  trabalho nas filas e -1 quando não há mais testes para começar.
+static int open_window(sweep_pool* pool) {
+    int i;
+    int empty;
+
+    pthread_mutex_lock(&pool->done_lock);
+    while (1) {
+        if (interrupted || pool->opened == pool->n_windows) {
+            pthread_mutex_unlock(&pool->done_lock);
+            return -1;
+        }
+
+        //  Outra thread pode ter aberto a janela enquanto esperávamos pela trava.
+        empty = 1;
+        for (i = 0; i < pool->n_threads && empty; i++) {
+            pthread_mutex_lock(&pool->queues[i].lock);
+            if (pool->queues[i].head < pool->queues[i].tail) empty = 0;
+            pthread_mutex_unlock(&pool->queues[i].lock);
+        }
+        if (!empty) break;
+
+        if (pool->flushed >= (pool->opened - 1) * pool->window) {
+            fill_window(pool);
+            break;
+        }
+        //  Todos os testes das janelas abertas já começaram; eles vão terminar e fazer 'flushed' avançar.
+        pthread_cond_wait(&pool->flushed_cond, &pool->done_lock);
+    }
+    pthread_mutex_unlock(&pool->done_lock);
+
+    return 0;
+}
+// ....................................................................................................................
+//      Marca um teste como concluído e entrega ao 'ordered' o prefixo contíguo que ficou completo (chamada com
+//  done_lock).
+static void finish(sweep_pool* pool, const int job) {
+    const int ring = 2 * pool->window;
+    const int before = pool->flushed;
+
+    pool->finished[job % ring] = 1;
+    while (pool->flushed < pool->n_jobs && pool->finished[pool->flushed % ring]) {
+        pool->finished[pool->flushed % ring] = 0;
+        if (pool->ordered != NULL) pool->ordered(pool->flushed, pool->context);
+        pool->flushed++;
+    }
+    if (pool->flushed != before) pthread_cond_broadcast(&pool->flushed_cond);
+}
+// ....................................................................................................................
+//      Tratador de SIGINT/SIGTERM: apenas marca a interrupção. Ele é instalado com SA_RESETHAND, então um segundo sinal
+//  já encontra o comportamento padrão e encerra o programa na hora, e com SA_RESTART, para que as escritas em andamento
+//  não falhem com EINTR.
+static void on_signal(const int signal_number) {
+    (void) signal_number;
+    interrupted = 1;
+}
+// ....................................................................................................................
+//      Laço de trabalho de cada thread (sai sem pegar um teste novo quando a execução foi interrompida).
+static void* worker_main(void* arg) {
+    const sweep_worker* worker = arg;
+    sweep_pool* pool = worker->pool;
+    int job;
+
+    while (!interrupted) {
+        job = queue_pop(&pool->queues[worker->id]);
+        if (job < 0) job = steal(pool, worker->id);
+        if (job < 0) {
+            if (open_window(pool) != 0) break;
+            continue;
+        }
+
+        pool->job(job, pool->context);
+
+        pthread_mutex_lock(&pool->done_lock);
+        pool->n_done++;
+        if (pool->done != NULL) pool->done(job, pool->n_done, pool->context);
+        finish(pool, job);
+        pthread_mutex_unlock(&pool->done_lock);
+    }
+
+    return NULL;
+}
+// ....................................................................................................................
+int sweep_slots(const int n_threads) {
+    return 2 * SWEEP_JOBS_POR_THREAD * (n_threads > 1 ? n_threads : 1);
+}
+// ....................................................................................................................
+int sweep_run(const int n_jobs, int n_threads, const sweep_cost_fn cost, const sweep_job_fn job, const sweep_done_fn done,
+    const sweep_ordered_fn ordered, void* context) {
+    sweep_pool pool;
+    sweep_worker* workers;
+    pthread_t* threads;
+    int created;
+    int status;
+    int i;
+
+    if (n_jobs <= 0) return 0;
+    if (n_threads < 1) n_threads = 1;
+    // ................................................................................................................
+    //      O tamanho da janela segue o número de threads pedido (o mesmo do sweep_slots), mesmo quando há menos testes
+    //  do que threads.
+    pool.window = sweep_slots(n_threads) / 2;
+    pool.n_windows = (n_jobs + pool.window - 1) / pool.window;
+    if (n_threads > n_jobs) n_threads = n_jobs;
+
+    pool.queues = calloc(n_threads, sizeof(sweep_queue));
+    pool.n_threads = n_threads;
+    pool.n_jobs = n_jobs;
+    pool.cost = cost;
+    pool.job = job;
+    pool.done = done;
+    pool.ordered = ordered;
+    pool.context = context;
+    pool.opened = 0;
+    pool.items = malloc(sizeof(sweep_item) * pool.window);
+    pool.finished = calloc(2 * pool.window, sizeof(unsigned char));
+    pool.flushed = 0;
+    pool.n_done = 0;
+
+    workers = malloc(sizeof(sweep_worker) * n_threads);
+    threads = malloc(sizeof(pthread_t) * n_threads);
+
+    if (pool.queues == NULL || pool.items == NULL || pool.finished == NULL || workers == NULL || threads == NULL) {
+        free(pool.queues);
+        free(pool.items);
+        free(pool.finished);
+        free(workers);
+        free(threads);
+        return -1;
+    }
+
+    for (i = 0; i < n_threads; i++) {
+        pool.queues[i].jobs = malloc(sizeof(int) * (pool.window / n_threads + 1));
+        pool.queues[i].costs = malloc(sizeof(double) * (pool.window / n_threads + 1));
+        pthread_mutex_init(&pool.queues[i].lock, NULL);
+        workers[i].pool = &pool;
+        workers[i].id = i;
+    }
+
+    status = 0;
+    for (i = 0; i < n_threads; i++) if (pool.queues[i].jobs == NULL || pool.queues[i].costs == NULL) status = -1;
+
+    if (status == 0) {
+        pthread_mutex_init(&pool.done_lock, NULL);
+        pthread_cond_init(&pool.flushed_cond, NULL);
+        fill_window(&pool);
+        // ............................................................................................................
+        //      Cria as threads extras; a thread atual faz o papel da thread 0.
+        created = 0;
+        for (i = 1; i < n_threads; i++) {
+            if (pthread_create(&threads[i], NULL, worker_main, &workers[i]) != 0) {
+                status = -1;
+                break;
+            }
+            created++;
+        }
+
+        //  Mesmo que alguma thread não tenha sido criada, as filas dela serão esvaziadas por roubo.
+        worker_main(&workers[0]);
+        for (i = 1; i <= created; i++) pthread_join(threads[i], NULL);
+
+        //      Numa interrupção, os testes concluídos depois da primeira lacuna ainda não passaram pelo 'ordered':
+        //  eles são entregues agora, na ordem dos índices, pulando os que não começaram.
+        for (i = pool.flushed; i < pool.opened * pool.window && i < n_jobs; i++) {
+            if (!pool.finished[i % (2 * pool.window)]) continue;
+            pool.finished[i % (2 * pool.window)] = 0;
+            if (ordered != NULL) ordered(i, context);
+        }
+
+        pthread_cond_destroy(&pool.flushed_cond);
+        pthread_mutex_destroy(&pool.done_lock);
+        if (status != 0 && pool.n_done == n_jobs) status = 0;
+        if (status == 0 && pool.n_done < n_jobs) status = 1;
+    }
+    // ................................................................................................................
+    //      Libera a memória.
+    for (i = 0; i < n_threads; i++) {
+        pthread_mutex_destroy(&pool.queues[i].lock);
+        free(pool.queues[i].jobs);
+        free(pool.queues[i].costs);
+    }
+    free(pool.queues);
+    free(pool.items);
+    free(pool.finished);
+    free(workers);
+    free(threads);
+
+    return status;
+}
+// ....................................................................................................................
+void sweep_catch_signals(void) {
+    struct sigaction action;
+
+    action.sa_handler = on_signal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESETHAND | SA_RESTART;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+}
+// ....................................................................................................................
+int sweep_interrupted(void) {
+    return interrupted != 0;
+}
+// ....................................................................................................................
@@ -0,0 +1,76 @@
+//
+//  File in Portuguese.
+//  Author: Gabriel V. Ferreira (2025)
+//  GitHub: https://github.com/gabriel-ferr/Fly-by
+// ....................................................................................................................
+//      Distribuição das trajetórias de um "sweep" entre várias threads.
+//
+//  As trajetórias têm custos muito diferentes (colisões param cedo, trajetórias rasantes ou com b grande vão até o
+//  stop_value), então a divisão é dinâmica: cada thread tem a sua fila, as trajetórias mais caras (segundo uma
+//  estimativa barata fornecida pelo programa) são distribuídas primeiro e uma thread sem trabalho "rouba" a próxima
+//  trajetória da fila com maior custo restante.
+//
+//  Os testes são distribuídos em janelas de SWEEP_JOBS_POR_THREAD × n_threads testes consecutivos: a ordenação pelo
+//  custo e o roubo valem dentro de cada janela, e a janela seguinte só é aberta quando a anterior à atual já foi toda
+//  entregue ao 'ordered'. Assim no máximo duas janelas estão abertas, o 'ordered' recebe os testes na ordem dos índices
+//  (cada prefixo contíguo assim que ele termina) e a memória do sweep não depende do número de testes: o programa
+//  pode guardar o resultado de cada teste numa posição job % sweep_slots(n_threads), liberada depois do 'ordered'.
+//
+//  A execução pode ser interrompida (SIGINT/SIGTERM, veja sweep_catch_signals): as threads terminam os testes que já
+//  começaram e não pegam nenhum teste novo, então tudo o que foi concluído chega ao 'done' e ao 'ordered' (nesse caso
+//  os testes depois de uma lacuna também são entregues, em ordem) e pode ser salvo.
+// ....................................................................................................................
+#ifndef FLY_BY_SWEEP_H
+#define FLY_BY_SWEEP_H
+// ....................................................................................................................
+#define SWEEP_JOBS_POR_THREAD 128                       //  Testes de uma janela do sweep, por thread.
+// ....................................................................................................................
+//  - Função que estima o custo de um teste (qualquer unidade). É chamada uma vez por teste, quando a janela dele é
+//  aberta, e nunca em paralelo com o 'done' ou o 'ordered'.
+//  int job                                 → Índice do teste.
+//  void* context                           → Ponteiro repassado sem alterações pelo sweep_run.
+typedef double (*sweep_cost_fn)(int job, void* context);
+
+//  - Função chamada para executar um teste (trajetória) do sweep.
+//  int job                                 → Índice do teste.
+//  void* context                           → Ponteiro repassado sem alterações pelo sweep_run.
+typedef void (*sweep_job_fn)(int job, void* context);
+
+//  - Função chamada após cada teste concluído, na ordem em que eles terminam. É serializada pelo próprio sweep (nunca
+//  roda em paralelo), então pode imprimir a barra de progresso sem cuidado extra.
+//  int job                                 → Índice do teste que acabou de ser concluído.
+//  int done                                → Número de testes concluídos até agora.
+//  void* context                           → Ponteiro repassado sem alterações pelo sweep_run.
+typedef void (*sweep_done_fn)(int job, int done, void* context);
+
+//  - Função chamada para cada teste concluído na ordem dos índices (0, 1, 2, ...), assim que todos os anteriores
+//  terminam. Também é serializada com o 'done', então pode escrever o arquivo global sem trava.
+//  int job                                 → Índice do teste.
+//  void* context                           → Ponteiro repassado sem alterações pelo sweep_run.
+typedef void (*sweep_ordered_fn)(int job, void* context);
+
+//  - Executa os testes [0, n_jobs) usando n_threads threads (a thread que chama também trabalha).
+//  int n_jobs                              → Número de testes.
+//  int n_threads                           → Número de threads. Com 1 thread nada é criado e tudo roda na chamadora.
+//  sweep_cost_fn cost                      → Custo estimado de cada teste. Pode ser NULL, e nesse caso os testes de
+//                                            cada janela são tomados na ordem natural.
+//  sweep_job_fn job                        → Função que executa um teste.
+//  sweep_done_fn done                      → Função chamada após cada teste, na ordem em que terminam (pode ser NULL).
+//  sweep_ordered_fn ordered                → Função chamada para cada teste na ordem dos índices (pode ser NULL).
+//  void* context                           → Ponteiro repassado para cost, job, done e ordered.
+//
+//  * Retorna 0 em caso de sucesso, 1 caso a execução tenha sido interrompida antes de todos os testes, e -1 caso não
+//  tenha sido possível alocar memória ou criar as threads.
+int sweep_run(int n_jobs, int n_threads, sweep_cost_fn cost, sweep_job_fn job, sweep_done_fn done, sweep_ordered_fn ordered, void* context);
+
+//  - Número de testes que podem estar abertos ao mesmo tempo (terminados ou não, mas ainda sem o 'ordered') num sweep
+//  com n_threads threads: o teste 'job' pode usar a posição job % sweep_slots(n_threads) de um vetor do programa.
+int sweep_slots(int n_threads);
+
+//  - Passa a tratar SIGINT e SIGTERM como um pedido de interrupção do sweep. Um segundo sinal encerra o programa na hora.
+void sweep_catch_signals(void);
+
+//  - Retorna 1 se a execução foi interrompida por um sinal.
+int sweep_interrupted(void);
+// ....................................................................................................................
+#endif